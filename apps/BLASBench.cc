@@ -0,0 +1,183 @@
+/*
+ * Micro-Benchmark der dichten Kernel (GEMM, GEMV, AXPY, DOT):
+ * Vergleich der naiven Schleifen über get()/set() mit der geblockten
+ * in-tree Implementierung und dem BLAS-Pfad aus BLASWrap.
+ *
+ * Aufruf: blasbench [n1 n2 ...]
+ *   (Standard: typische Größen von Stöchiometrie- und Kernmatrizen)
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include "MMatrix.h"
+#include "MVector.h"
+#include "BLASWrap.h"
+
+using namespace flux::la;
+
+static double now()
+{
+	return std::chrono::duration< double >(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void fill(MMatrix & A, unsigned int seed)
+{
+	srand(seed);
+	for (size_t i=0; i<A.rows(); i++)
+		for (size_t j=0; j<A.cols(); j++)
+			A(i,j) = double(rand()) / RAND_MAX - .5;
+}
+
+static void fill(MVector & x, unsigned int seed)
+{
+	srand(seed);
+	for (size_t i=0; i<x.dim(); i++)
+		x(i) = double(rand()) / RAND_MAX - .5;
+}
+
+// bisherige Implementierung von MMatrix::operator*(MMatrix)
+static void naive_gemm(MMatrix const & A, MMatrix const & B, MMatrix & C)
+{
+	size_t i,j,k;
+	double sum;
+	for (i=0; i<C.rows(); i++)
+		for (j=0; j<C.cols(); j++)
+		{
+			for (sum=0.,k=0; k<A.cols(); k++)
+				sum += A.get(i,k) * B.get(k,j);
+			C.set(i,j,sum);
+		}
+}
+
+// bisherige Implementierung von MMatrix::operator*(MVector)
+static void naive_gemv(MMatrix const & A, MVector const & x, MVector & y)
+{
+	size_t i,k;
+	double sum;
+	for (i=0; i<A.rows(); i++)
+	{
+		for (sum=0.,k=0; k<A.cols(); k++)
+			sum += A.get(i,k) * x.get(k);
+		y.set(i,sum);
+	}
+}
+
+static double max_diff(double const * a, double const * b, size_t n)
+{
+	double d = 0.;
+	for (size_t i=0; i<n; i++)
+		d = fmax(d, fabs(a[i]-b[i]));
+	return d;
+}
+
+/**
+ * Führt f so oft aus, dass mindestens 0.2s vergehen, und gibt die
+ * mittlere Zeit pro Aufruf zurück.
+ */
+template< typename F > static double timeit(F f)
+{
+	size_t reps = 1, r;
+	double t;
+	for (;;)
+	{
+		t = now();
+		for (r=0; r<reps; r++)
+			f();
+		t = now() - t;
+		if (t >= .2)
+			return t / reps;
+		reps *= (t < .02) ? 10 : 2;
+	}
+}
+
+static void bench_gemm(size_t n)
+{
+	MMatrix A(n,n), B(n,n), C0(n,n), C1(n,n), C2(n,n);
+	fill(A,1);
+	fill(B,2);
+	double flop = 2. * n * n * n;
+
+	double t0 = timeit([&]() { naive_gemm(A,B,C0); });
+	blas::setBackend(blas::be_intree);
+	double t1 = timeit([&]() { C1 = A * B; });
+	blas::setBackend(blas::be_blas);
+	double t2 = timeit([&]() { C2 = A * B; });
+	blas::setBackend(blas::be_auto);
+
+	printf("gemm %5d  naive %8.3f  in-tree %8.3f  blas %8.3f GFLOP/s"
+		"  |d| %.1e %.1e\n", int(n),
+		flop/t0*1e-9, flop/t1*1e-9, flop/t2*1e-9,
+		max_diff(C0,C1,n*n), max_diff(C0,C2,n*n));
+}
+
+static void bench_gemv(size_t n)
+{
+	MMatrix A(n,n);
+	MVector x(n), y0(n), y1(n), y2(n);
+	fill(A,3);
+	fill(x,4);
+	double flop = 2. * n * n;
+
+	double t0 = timeit([&]() { naive_gemv(A,x,y0); });
+	blas::setBackend(blas::be_intree);
+	double t1 = timeit([&]() { y1 = A * x; });
+	blas::setBackend(blas::be_blas);
+	double t2 = timeit([&]() { y2 = A * x; });
+	blas::setBackend(blas::be_auto);
+
+	printf("gemv %5d  naive %8.3f  in-tree %8.3f  blas %8.3f GFLOP/s"
+		"  |d| %.1e %.1e\n", int(n),
+		flop/t0*1e-9, flop/t1*1e-9, flop/t2*1e-9,
+		max_diff(y0,y1,n), max_diff(y0,y2,n));
+}
+
+static void bench_vec(size_t n)
+{
+	MVector x(n), y(n);
+	fill(x,5);
+	fill(y,6);
+	double s1 = 0., s2 = 0.;
+
+	blas::setBackend(blas::be_intree);
+	double t1 = timeit([&]() { s1 += x * y; });
+	double t3 = timeit([&]() { blas::axpy(n, 1e-9, x, y); });
+	blas::setBackend(blas::be_blas);
+	double t2 = timeit([&]() { s2 += x * y; });
+	double t4 = timeit([&]() { blas::axpy(n, 1e-9, x, y); });
+	blas::setBackend(blas::be_auto);
+
+	printf("dot  %5d  in-tree %8.3f  blas %8.3f GFLOP/s\n",
+		int(n), 2.*n/t1*1e-9, 2.*n/t2*1e-9);
+	printf("axpy %5d  in-tree %8.3f  blas %8.3f GFLOP/s\n",
+		int(n), 2.*n/t3*1e-9, 2.*n/t4*1e-9);
+	if (s1 != s1 or s2 != s2)
+		puts("(NaN)");
+}
+
+int main(int argc, char ** argv)
+{
+	std::vector< size_t > sizes;
+	int i;
+
+	for (i=1; i<argc; i++)
+		sizes.push_back(size_t(atoi(argv[i])));
+	if (sizes.empty())
+	{
+		// Stöchiometrie- / Kern-Matrizen typischer Netzwerke
+		size_t def[] = { 8, 16, 32, 64, 128, 256, 512 };
+		sizes.assign(def, def + sizeof(def)/sizeof(def[0]));
+	}
+
+	for (i=0; i<int(sizes.size()); i++)
+		bench_gemm(sizes[i]);
+	for (i=0; i<int(sizes.size()); i++)
+		bench_gemv(sizes[i]);
+	for (i=0; i<int(sizes.size()); i++)
+		bench_vec(sizes[i] * sizes[i]);
+	return 0;
+}
+
@@ -13,9 +13,14 @@ void Constraint::normalize()
 {
 	try
 	{
-		LinearExpression lE(constraint_);
-		delete constraint_;
-		constraint_ = lE.get()->clone();
+		{
+			// Zwischenergebnisse der Linearisierung sind temporär;
+			// nur das Ergebnis wird auf den Heap kopiert
+			ExprTree::Arena arena;
+			LinearExpression lE(constraint_);
+			delete constraint_;
+			constraint_ = ExprTree::Arena::persist(lE.get());
+		}
 		// evtl. vorhandenes unäres Minus beseitigen
 		constraint_->Rval()->eval(true);
 
@@ -44,7 +49,11 @@ bool Constraint::checkLinearity(ExprTree const * expr)
 		return false;
 	if (not (expr->isEquality() or expr->isInEquality()))
 		return false;
-	try { LinearExpression lE(expr); }
+	try
+	{
+		ExprTree::Arena arena;
+		LinearExpression lE(expr);
+	}
 	catch (ExprTreeException) { return false; }
 	return true;
 }
@@ -61,6 +70,7 @@ bool Constraint::checkSimplicity(
 		return false;
 	try
 	{
+		ExprTree::Arena arena;
 		LinearExpression lE(expr);
 		charptr_map< double > const & C = lE.getLinearCoeffs();
 
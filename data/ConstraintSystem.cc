@@ -1,16 +1,30 @@
 #include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <vector>
 #include <gmpxx.h>
 #include "fluxml_config.h" // MACHEPS für GMatrixOps.h
 #include "Error.h"
 #include "ExprTree.h"
 #include "LinearExpression.h"
+#include "ExprDAG.h"
 #include "MMatrix.h"
 #include "MVector.h"
 #include "MMatrixOps.h"
 #include "GMatrixOps.h"
+#include "ExactOps.h"
 #include "LAPackWrap.h"
+#include "BLASWrap.h"
+#include "SIMDKernels.h"
+#include "Threads.h"
+#include "CSMatrix.h"
+#include "BlockTriangular.h"
 #include "StoichMatrixInteger.h"
 #include "StandardForm.h"
+#include "BoundedSimplex.h"
 #include "Constraint.h"
 #include "ConstraintSystem.h"
 
@@ -46,7 +60,7 @@ ConstraintSystem::ConstraintSystem(
 	    vnet_(S_.cols()), vxch_(S_.cols()),
 	    Pcnet_(S_.cols()), Pcxch_(S_.cols()),
 	    v_type_net_(S_.cols()), v_type_xch_(S_.cols()),
-	    cons_tol_(1.e-9),fluxes_dirty_(true),
+	    cons_tol_(1.e-9),check_residual_(true),fluxes_dirty_(true),
 	    change_count_(0u), 
             is_stationary_(stationary),
             fPools_size_(fPools_size),
@@ -150,7 +164,7 @@ void ConstraintSystem::make_free_flux_suggestion(int dfree, bool net)
 bool ConstraintSystem::prepare()
 {
 	int idx, rank;
-	size_t i,j;
+	size_t i,j,k;
 	size_t inet, ixch, knet, kxch;
 	size_t nfree_net = fFluxes_net_.size();
 	size_t nfree_xch = fFluxes_xch_.size();
@@ -172,12 +186,22 @@ bool ConstraintSystem::prepare()
 
 	// Um ein überbestimmtes System zu vermeiden, wird die Stöchiometrie
 	// zunächst Zeilen-reduziert (Integer-Arithmetik):
-	GMatrix< int64_t > Sr(S_);
+	// Die Arbeitskopie wird aus der CSR-Form gefüllt; im QR-Fall
+	// entsteht nur die double-Kopie.
+	CSMatrix const & Scsr = S_.getCSR();
+	size_t const * sptr = Scsr.ptr();
+	size_t const * sidx = Scsr.idx();
+	double const * sval = Scsr.val();
+	GMatrix< int64_t > Sr;
 	try
 	{
-		if (Sr.rows() <= Sr.cols())
+		if (S_.rows() <= S_.cols())
 		{
 			// der exakte Gauss-Jordan-Algorithmus kann verwendet werden
+			Sr = GMatrix< int64_t >(S_.rows(),S_.cols());
+			for (i=0; i<S_.rows(); i++)
+				for (k=sptr[i]; k<sptr[i+1]; k++)
+					Sr(i,sidx[k]) = int64_t(sval[k]);
 			MMatrixOps::rowReduce(Sr);
 			fINFO("size of stoichiometry is (%dx%d); exact rank is %d.",
 				int(S_.rows()), int(S_.cols()), int(Sr.rows()));
@@ -186,10 +210,10 @@ bool ConstraintSystem::prepare()
 		{
 			// verwende numerischen QR-Algorithmus
 			// nach double konvertieren
-			MMatrix Sn(Sr.rows(),Sr.cols());
-			for (std::size_t i=0; i<Sn.rows(); ++i)
-				for (std::size_t j=0; j<Sn.cols(); ++j)
-					Sn(i,j) = double(Sr(i,j));
+			MMatrix Sn(S_.rows(),S_.cols());
+			for (i=0; i<S_.rows(); i++)
+				for (k=sptr[i]; k<sptr[i+1]; k++)
+					Sn(i,sidx[k]) = sval[k];
 			MMatrixOps::rowReduceQR(Sn);
 			// wieder nach int64_t konvertieren (verlustfrei!)
 			Sr = GMatrix< int64_t >(Sn.rows(),Sn.cols());
@@ -397,6 +421,7 @@ bool ConstraintSystem::prepare()
 		{
 			// das Constraint in eine (hoffentlich) lineare
 			// Gleichung umwandeln: (...)=0
+			ExprTree::Arena arena;
 			LinearExpression lE( ci->getConstraint() );
                         
 			// Koeffizienten der linearen Gleichung
@@ -816,6 +841,9 @@ bool ConstraintSystem::solve()
 
 	fASSERT( validation_state_ == cm_unvalidated
 		or validation_state_ == cm_too_few_constr );
+
+	// CSR-Form der Stöchiometrie für eval() vorab erstellen
+	S_.compress();
 	
 	// Listen freier Flüsse zurücksetzen
 	fFluxes_xch_.clear();
@@ -895,17 +923,8 @@ bool ConstraintSystem::solve()
 			return false;
 		}
 #endif
-		// Arbitrary-Precision-Alternative ...
-		GMatrix< mpq_class > qN(Nnet_.rows(),Nnet_.cols());
-		GVector< mpq_class > qb(bnet_.dim());
-		GMatrix< mpq_class > qV;
-		for (j=0; j<qN.rows(); ++j)
-			for (k=0; k<qN.cols(); ++k)
-				qN(j,k) = Nnet_.get(j,k);
-		for (k=0; k<qb.dim(); ++k)
-			qb(k) = bnet_.get(k);
-
-		if (not (result = GMatrixOps::gaussJordan(qN,qb,qV,Pcnet_,rank)))
+		// exakt: Bareiss (int64), multi-modular, mpq_class
+		if (not (result = ExactOps::gaussJordan(Nnet_,bnet_,Vnet_,Pcnet_,rank)))
 		{
 			fWARNING("solution of the NET constraint system failed:");
 			switch (-rank)
@@ -926,12 +945,6 @@ bool ConstraintSystem::solve()
 			validation_state_ = cm_invalid_free_vars;
 			return false;
 		}
-		// double-Matrix Vnet aus qV aufbauen:
-		Vnet_ = MMatrix(qV.rows(),qV.cols());
-		for (j=0; j<qV.rows(); j++)
-			for (k=0; k<qV.cols(); k++)
-				Vnet_(j,k) = qV.get(j,k).get_d();
-
 		// Bei nicht erfüllbaren Constraints wird eine leere Matrix
 		// zurückgegeben. Der Benutzer hat dann entweder zu viele Freie
 		// Flüsse oder zu viele Constraints eingegeben
@@ -1061,17 +1074,8 @@ bool ConstraintSystem::solve()
 				return false;
 			}
 #endif
-			// Arbitrary-Precision-Alternative ...
-			GMatrix< mpq_class > qN(Nxch_.rows(),Nxch_.cols());
-			GVector< mpq_class > qb(bxch_.dim());
-			GMatrix< mpq_class > qV;
-			for (j=0; j<qN.rows(); ++j)
-				for (k=0; k<qN.cols(); ++k)
-					qN(j,k) = Nxch_.get(j,k);
-			for (k=0; k<qb.dim(); ++k)
-				qb(k) = bxch_.get(k);
-	
-			if (not (result = GMatrixOps::gaussJordan(qN,qb,qV,Pcxch_,rank)))
+			// exakt: Bareiss (int64), multi-modular, mpq_class
+			if (not (result = ExactOps::gaussJordan(Nxch_,bxch_,Vxch_,Pcxch_,rank)))
 			{
 				fWARNING("solution of the XCH constraint system failed:");
 				switch (-rank)
@@ -1093,12 +1097,6 @@ bool ConstraintSystem::solve()
 				validation_state_ = cm_invalid_free_vars;
 				return false;
 			}
-			// double-Matrix Vxch aus qV aufbauen:
-			Vxch_ = MMatrix(qV.rows(),qV.cols());
-			for (j=0; j<qV.rows(); j++)
-				for (k=0; k<qV.cols(); k++)
-					Vxch_(j,k) = qV.get(j,k).get_d();
-
 			// Bei nicht erfüllbaren Constraints wird eine leere Matrix
 			// zurückgegeben. Der Benutzer hat dann entweder zu viele Freie
 			// Flüsse oder zu viele Constraints eingegeben
@@ -1181,17 +1179,8 @@ bool ConstraintSystem::solve()
 	{
 		if (Npool_.rows() <= Npool_.cols())
 		{
-			// Arbitrary-Precision-Alternative ...
-			GMatrix< mpq_class > qN(Npool_.rows(),Npool_.cols());
-			GVector< mpq_class > qb(bpool_.dim());
-			GMatrix< mpq_class > qV;
-			for (j=0; j<qN.rows(); ++j)
-				for (k=0; k<qN.cols(); ++k)
-					qN(j,k) = Npool_.get(j,k);
-			for (k=0; k<qb.dim(); ++k)
-				qb(k) = bpool_.get(k);
-	
-			if (not (result = GMatrixOps::gaussJordan(qN,qb,qV,Pcpool_,rank)))
+			// exakt: Bareiss (int64), multi-modular, mpq_class
+			if (not (result = ExactOps::gaussJordan(Npool_,bpool_,Vpool_,Pcpool_,rank)))
 			{
 				fWARNING("solution of the POOL constraint system failed:");
 				switch (-rank)
@@ -1213,12 +1202,6 @@ bool ConstraintSystem::solve()
 				validation_state_ = cm_invalid_free_vars;
 				return false;
 			}
-			// double-Matrix Vxch aus qV aufbauen:
-			Vpool_ = MMatrix(qV.rows(),qV.cols());
-			for (j=0; j<qV.rows(); j++)
-				for (k=0; k<qV.cols(); k++)
-					Vpool_(j,k) = qV.get(j,k).get_d();
-
 			// Bei nicht erf�llbaren Constraints wird eine leere Matrix
 			// zur�ckgegeben. Der Benutzer hat dann entweder zu viele Freie
 			// Poolgrößen oder zu viele Constraints eingegeben
@@ -1305,6 +1288,9 @@ bool ConstraintSystem::solve()
 		return false;
 	}
 	
+	// Ungleichungen für die schnelle Prüfung in eval() übersetzen:
+	compile_ineqs();
+
 	// mit der gewonnenen Aufteilung in freie/abhängige Flüsse
 	// ist es jetzt möglich die Ungleichungen auf feasibility
 	// zu prüfen -- es muss allerdings v_const_ angelegt sein,
@@ -1331,6 +1317,8 @@ bool ConstraintSystem::solve()
 	for (pc=pcons.begin(); pc!=pcons.end(); ++pc)
 		v_type_pool_(pool2idx_[*pc]) = p_quasicons;
 
+	// Matrizen für die Stapel-Auswertung vorbereiten:
+	prepare_batch();
 	return true;
 } // ConstraintSystem::solve()
 
@@ -1423,6 +1411,74 @@ void ConstraintSystem::impose_constraints()
 	}
 } // void ConstraintSystem::impose_constraints()
 
+// Kopiert die zu den Indizes idx gehörenden Spalten von V nach B
+static void batch_columns(
+	MMatrix const & V,
+	PMatrix const & Pc_inv,
+	size_t ndep,
+	GVector< size_t > const & idx,
+	MMatrix & B
+	)
+{
+	size_t i, k, col;
+	B = MMatrix(V.rows(), idx.dim());
+	for (k=0; k<idx.dim(); ++k)
+	{
+		// Spalte 0 von V ist die spezielle Lösung:
+		col = Pc_inv.get(idx.get(k)) - ndep + 1;
+		for (i=0; i<V.rows(); ++i)
+			B(i,k) = V.get(i,col);
+	}
+}
+
+// wird von ConstraintSystem::solve() aufgerufen
+void ConstraintSystem::prepare_batch()
+{
+	size_t k;
+	charptr_array names;
+	charptr_array::const_iterator ni;
+
+	// Netto: Reihenfolge der freien Flüsse wie in getFluxNamesByType
+	names = getFluxNamesByType(f_free,true);
+	GVector< size_t > idx_net(names.size());
+	for (ni=names.begin(),k=0; ni!=names.end(); ++ni,++k)
+		idx_net(k) = *(flux2idx_.findPtr(*ni));
+	batch_columns(Vnet_, Pcnet_.inverse(), S_.cols()-(Vnet_.cols()-1),
+		idx_net, Bnet_);
+	cnet_ = Vnet_ * v_const_net_;
+
+	// Exchange
+	names = getFluxNamesByType(f_free,false);
+	GVector< size_t > idx_xch(names.size());
+	for (ni=names.begin(),k=0; ni!=names.end(); ++ni,++k)
+		idx_xch(k) = *(flux2idx_.findPtr(*ni));
+	batch_columns(Vxch_, Pcxch_.inverse(), S_.cols()-(Vxch_.cols()-1),
+		idx_xch, Bxch_);
+	cxch_ = Vxch_ * v_const_xch_;
+
+	// Poolgrößen
+	names = getPoolNamesByType(p_free);
+	GVector< size_t > idx_pool(names.size());
+	for (ni=names.begin(),k=0; ni!=names.end(); ++ni,++k)
+		idx_pool(k) = *(pool2idx_.findPtr(*ni));
+	batch_columns(Vpool_, Pcpool_.inverse(), S_.rows()-(Vpool_.cols()-1),
+		idx_pool, Bpool_);
+	cpool_ = Vpool_ * v_const_pool_;
+
+	// Einmalige Prüfung des Stöchiometrie-Residuums für alle möglichen
+	// Werte freier Flüsse: S*cnet_ = 0 und S*Bnet_ = 0
+	double norm2 = S_.residualNorm2(cnet_);
+	for (k=0; k<Bnet_.cols(); ++k)
+	{
+		double nk = S_.residualNorm2((double const *)Bnet_ + k*Bnet_.rows());
+		if (nk > norm2)
+			norm2 = nk;
+	}
+	fDEBUG(0, "residual of stoichiometry in kernel basis is %g", norm2);
+	if (norm2 > 1e-4)
+		fWARNING("bad residual of stoichiometry in kernel basis: %g", norm2);
+} // ConstraintSystem::prepare_batch()
+
 // wird von ConstraintSystem::solve() aufgerufen
 bool ConstraintSystem::validate_ineqs_feasibility() const
 {
@@ -1440,8 +1496,17 @@ bool ConstraintSystem::validate_ineqs_feasibility() const
 		fWARNING("constraints / inequalities leave no degree of freedom");
 		return true;
 	}
-	else if (not SF.isFeasible())
+	
+	MVector x0;
+	double radius;
+	if (not SF.findInteriorPoint(x0,radius))
 	{
+		// LP nicht konvergiert oder zu groß: nicht als Fehler werten
+		if (std::isnan(radius))
+		{
+			fWARNING("feasibility of inequality constraints could not be decided");
+			return true;
+		}
 		fERROR("infeasible system of inequality constraints");
 		validation_state_ = cm_ineqs_infeasible;
                 SF.dump();
@@ -1498,28 +1563,34 @@ void ConstraintSystem::eval() const
 		if (v_type_pool_.get(Pcpool_.get(j)) == p_free)
 			v_free_pool(j-ndep_pool+1) = vpool_.get(Pcpool_.get(j));
         
-	// Berechnung der Flüsse und Poolgrößen ...
-	vnet_ = Vnet_ * (v_free_net + v_const_net_);
-	vxch_ = Vxch_ * (v_free_xch + v_const_xch_);
-        vpool_ = Vpool_ * (v_free_pool + v_const_pool_);
-
-	// Prüfung des Stöchiometrie-Residuums
-	MMatrix S(S_);
-	double norm2 = (S*vnet_).norm2();
-	fDEBUG(0, "residual of stoichiometry is ||S*v_(net)||_2 = %g ... ", norm2);
-	norm2 = log10(norm2);
-	/*
-	if (norm2 <= log10(MACHEPS))
-		fINFO("excellent!");
-	else if (norm2 <= -6)
-		fINFO("passed!");
-	else if (norm2 <= -4)
-		fINFO("CRITICAL!");
-	else
-		fINFO("FAILED! continuing anyway...");
-	*/
-	if (norm2 > -4)
-		fWARNING("bad residual of stoichiometry: ||S*v_(net)||_2 = %g", norm2);
+	// Berechnung der Flüsse und Poolgrößen (ohne Temporäre):
+	// v = V*(v_free + v_const)
+	v_free_net += v_const_net_;
+	v_free_xch += v_const_xch_;
+	v_free_pool += v_const_pool_;
+	gemv(1., Vnet_, v_free_net, 0., vnet_);
+	gemv(1., Vxch_, v_free_xch, 0., vxch_);
+	gemv(1., Vpool_, v_free_pool, 0., vpool_);
+
+	// Prüfung des Stöchiometrie-Residuums (sparse, ohne Kopie von S)
+	if (check_residual_)
+	{
+		double norm2 = S_.residualNorm2(vnet_);
+		fDEBUG(0, "residual of stoichiometry is ||S*v_(net)||_2 = %g ... ", norm2);
+		norm2 = log10(norm2);
+		/*
+		if (norm2 <= log10(MACHEPS))
+			fINFO("excellent!");
+		else if (norm2 <= -6)
+			fINFO("passed!");
+		else if (norm2 <= -4)
+			fINFO("CRITICAL!");
+		else
+			fINFO("FAILED! continuing anyway...");
+		*/
+		if (norm2 > -4)
+			fWARNING("bad residual of stoichiometry: ||S*v_(net)||_2 = %g", norm2);
+	}
 	
 	// die Flusswerte sind jetzt aktuell:
 	fluxes_dirty_ = false;
@@ -1531,118 +1602,1042 @@ void ConstraintSystem::eval() const
 		validation_state_ = cm_ok;
 } // ConstraintSystem::eval()
 
-bool ConstraintSystem::validate_ineqs() const
+// V = c*[1,...,1] + B*F: c wird in alle Spalten von V kopiert, danach
+// ein einziges DGEMM mit beta=1 über den ganzen Batch
+static void batch_affine(
+	MMatrix const & B,
+	MVector const & c,
+	size_t N,
+	double const * F,
+	double * V
+	)
 {
-	bool result = true;
-	fASSERT( fluxes_dirty_ == false );
-	std::list< Constraint >::const_iterator ci;
-	for (ci=cInEqList_.begin(); ci!=cInEqList_.end(); ci++)
+	size_t k;
+	size_t m = B.rows(), n = B.cols();
+	double const * c0 = c;
+
+	for (k=0; k<N; ++k)
+		std::copy(c0, c0+m, V + k*m);
+	blas::gemm('N', 'N', m, N, n, 1., B, m, F, n, 1., V, m);
+}
+
+bool ConstraintSystem::evalBatch(
+	size_t N,
+	double const * free_net,
+	double const * free_xch,
+	double const * free_pool,
+	double * vnet,
+	double * vxch,
+	double * vpool
+	) const
+{
+	switch (validation_state_)
 	{
-		LinearExpression lE( ci->getConstraint() );
-		bool violated = false;
-		double sum = 0.;
+	case cm_ok:
+	case cm_too_few_constr:
+	case cm_linear_dep_constr:
+	case cm_ineqs_violated:
+		break;
+	default:
+		fWARNING("failed to evaluate fluxes (inconsistent system)");
+		return false;
+	}
 
-		// Koeffizienten der linearen Gleichung
-		charptr_map< double > const & C = lE.getLinearCoeffs();
-		charptr_map< double >::const_iterator coeff_i;
+	if (free_net and vnet)
+		batch_affine(Bnet_, cnet_, N, free_net, vnet);
+	if (free_xch and vxch)
+		batch_affine(Bxch_, cxch_, N, free_xch, vxch);
+	if (free_pool and vpool)
+		batch_affine(Bpool_, cpool_, N, free_pool, vpool);
+	return true;
+} // ConstraintSystem::evalBatch()
+
+bool ConstraintSystem::evalBatch(
+	MMatrix const & F_net,
+	MMatrix const & F_xch,
+	MMatrix const & F_pool,
+	MMatrix & V_net,
+	MMatrix & V_xch,
+	MMatrix & V_pool
+	) const
+{
+	size_t N = F_net.cols();
+	fASSERT(F_xch.cols() == N and F_pool.cols() == N);
+	fASSERT(F_net.rows() == Bnet_.cols());
+	fASSERT(F_xch.rows() == Bxch_.cols());
+	fASSERT(F_pool.rows() == Bpool_.cols());
+
+	if (V_net.rows() != S_.cols() or V_net.cols() != N)
+		V_net = MMatrix(S_.cols(),N);
+	if (V_xch.rows() != S_.cols() or V_xch.cols() != N)
+		V_xch = MMatrix(S_.cols(),N);
+	if (V_pool.rows() != S_.rows() or V_pool.cols() != N)
+		V_pool = MMatrix(S_.rows(),N);
+
+	return evalBatch(N, F_net, F_xch, F_pool, V_net, V_xch, V_pool);
+} // ConstraintSystem::evalBatch()
+
+GVector< ConstraintSystem::FluxHandle > ConstraintSystem::getFreeHandles(
+	ParameterType parameter_type
+	) const
+{
+	size_t k;
+	charptr_array names;
+	charptr_array::const_iterator ni;
+
+	// Reihenfolge wie in prepare_batch()
+	names = (parameter_type == POOL) ? getPoolNamesByType(p_free)
+		: getFluxNamesByType(f_free, parameter_type == NET);
+	GVector< FluxHandle > free(names.size());
+	for (ni=names.begin(),k=0; ni!=names.end(); ++ni,++k)
+		free(k) = FluxHandle(parameter_type, var_index(parameter_type, *ni));
+	return free;
+} // ConstraintSystem::getFreeHandles()
+
+void ConstraintSystem::getJacobian(
+	ParameterType parameter_type,
+	MMatrix & J,
+	GVector< FluxHandle > & free
+	) const
+{
+	// die Spalten von B sind die Ableitungen nach den freien Werten
+	switch (parameter_type)
+	{
+	case NET: J = Bnet_; break;
+	case XCH: J = Bxch_; break;
+	case POOL: J = Bpool_; break;
+	}
+	free = getFreeHandles(parameter_type);
+	fASSERT(free.dim() == J.cols());
+} // ConstraintSystem::getJacobian()
 
-		// Eintragen der Koeffizienten:
-		for (coeff_i = C.begin(); coeff_i != C.end(); coeff_i++)
+void ConstraintSystem::getJacobianCSC(
+	ParameterType parameter_type,
+	GVector< size_t > & col_ptr,
+	GVector< size_t > & row_idx,
+	MVector & val,
+	GVector< FluxHandle > & free
+	) const
+{
+	size_t i, j, k, nz;
+	MMatrix const & B = parameter_type == NET ? Bnet_
+		: (parameter_type == XCH ? Bxch_ : Bpool_);
+	double const * b = B;
+
+	for (nz=0,k=0; k<B.rows()*B.cols(); k++)
+		if (b[k] != 0.)
+			nz++;
+
+	col_ptr = GVector< size_t >(B.cols()+1);
+	row_idx = GVector< size_t >(nz);
+	val = MVector(nz);
+	for (k=0,j=0; j<B.cols(); j++)
+	{
+		col_ptr(j) = k;
+		for (i=0; i<B.rows(); i++)
 		{
-			// ist der Koeffizent ein "echter" Koeffizient oder
-			// gehört er zur speziellen Variable "1" (Konstante)?
-			if (strcmp(coeff_i->key, "1") == 0)
-				sum += coeff_i->value;
-			else
-			{
-				double net, xch;
-                             
-				// falls die Reaktionsbezeichnung unbekannt ist,
-				// ist das ein Fehler der FluxML-Datei
-                bool found;
-				double pool;
-				switch(ci->getParameterType())
-				{
-					case NET:
-						found = getFlux(coeff_i->key,net,xch);
-						fASSERT(found);
-						sum += (coeff_i->value) * net;
-						break;
-					case XCH:
-						found = getFlux(coeff_i->key,net,xch);
-						fASSERT(found);
-						sum += (coeff_i->value) * xch;
-						break;
-					case POOL:
-						found = getPoolSize(coeff_i->key,pool);
-						fASSERT(found);
-						sum += (coeff_i->value) * pool;
-
-				}
-			}
+			double bij = b[j*B.rows()+i];
+			if (bij == 0.)
+				continue;
+			row_idx(k) = i;
+			val(k) = bij;
+			k++;
 		}
+	}
+	col_ptr(B.cols()) = k;
+	free = getFreeHandles(parameter_type);
+	fASSERT(free.dim() == B.cols());
+} // ConstraintSystem::getJacobianCSC()
+
+void ConstraintSystem::getJacobian(
+	ParameterType parameter_type,
+	CSMatrix & J,
+	GVector< FluxHandle > & free
+	) const
+{
+	GVector< size_t > col_ptr, row_idx;
+	MVector val;
+	size_t m = (parameter_type == NET ? Bnet_
+		: (parameter_type == XCH ? Bxch_ : Bpool_)).rows();
+
+	getJacobianCSC(parameter_type,col_ptr,row_idx,val,free);
+	J = CSMatrix(m, free.dim(), CSMatrix::csc, std::move(col_ptr),
+		std::move(row_idx), std::move(val));
+} // ConstraintSystem::getJacobian()
+
+// wird von ConstraintSystem::solve() aufgerufen
+void ConstraintSystem::compile_ineqs()
+{
+	size_t i, k, n = cInEqList_.size();
+	std::list< Constraint >::const_iterator ci;
+	charptr_map< double >::const_iterator coeff_i;
+	// Koeffizienten werden in einem Durchlauf gesammelt (jede
+	// Ungleichung wird nur einmal linearisiert)
+	std::vector< size_t > idx_list;
+	std::vector< double > val_list;
+
+	ineq_ptr_ = GVector< size_t >(n+1);
+	ineq_const_ = MVector(n);
+	ineq_ptype_ = GVector< ParameterType >(n);
+	ineq_rel_ = GVector< ExprType >(n);
+	ineq_lo_ = MVector(n);
+	ineq_hi_ = MVector(n);
+	ineq_cons_ = GVector< Constraint const * >(n);
+	ineq_lhs_ = MVector(n);
+	ineq_viol_ = MVector(n);
+
+	for (k=0,i=0,ci=cInEqList_.begin(); ci!=cInEqList_.end(); ci++,i++)
+	{
+		LinearExpression lE( ci->getConstraint() );
+		charptr_map< double > const & C = lE.getLinearCoeffs();
 
-		switch (ci->getConstraint()->getNodeType())
+		ineq_ptr_(i) = k;
+		ineq_ptype_(i) = ci->getParameterType();
+		ineq_rel_(i) = ci->getConstraint()->getNodeType();
+		// Relation als Intervall [lo,hi] der linken Seite
+		switch (ineq_rel_(i))
 		{
 		case et_op_leq:
-			violated = not (sum <= 0.+cons_tol_);
-			break;
 		case et_op_lt:
-			violated = not (sum < 0.+cons_tol_);
+			ineq_lo_(i) = -std::numeric_limits< double >::infinity();
+			ineq_hi_(i) = 0.;
 			break;
 		case et_op_geq:
-			violated = not (sum >= 0.-cons_tol_);
-			break;
 		case et_op_gt:
-			violated = not (sum > 0.-cons_tol_);
+			ineq_lo_(i) = 0.;
+			ineq_hi_(i) = std::numeric_limits< double >::infinity();
 			break;
 		case et_op_neq:
-			violated = not (::fabs(sum) < cons_tol_);
+			ineq_lo_(i) = ineq_hi_(i) = 0.;
 			break;
 		default:
-			violated = true;
+			// leeres Intervall: immer verletzt
+			ineq_lo_(i) = std::numeric_limits< double >::infinity();
+			ineq_hi_(i) = -std::numeric_limits< double >::infinity();
 			fASSERT_NONREACHABLE(); // keine Ungleichung!
 		}
+		ineq_cons_(i) = &(*ci);
 
-		if (violated)
+		for (coeff_i = C.begin(); coeff_i != C.end(); coeff_i++)
 		{
-			result = false;
-                        switch(ci->getParameterType())
-                        {
-                                case NET:
-                                        fWARNING("%s ineq. constraint \"%s\""
-                                                " [%s] is violated by %e",
-                                                "NET",
-                                                ci->getName(),
-                                                ci->getConstraint()->toString().c_str(),
-                                                sum
-                                                );
-                                        break;
-                                case XCH:
-                                        fWARNING("%s ineq. constraint \"%s\""
-                                                " [%s] is violated by %e",
-                                                "XCH",
-                                                ci->getName(),
-                                                ci->getConstraint()->toString().c_str(),
-                                                sum
-                                                );
-                                        break;
-                                case POOL:
-                                        fWARNING("%s ineq. constraint \"%s\""
-                                                " [%s] is violated by %e",
-                                                "POOL",
-                                                ci->getName(),
-                                                ci->getConstraint()->toString().c_str(),
-                                                sum
-                                                );
-                                        break;
-
-                        }
+			// Konstante (spezielle Variable "1")
+			if (strcmp(coeff_i->key, "1") == 0)
+			{
+				ineq_const_(i) += coeff_i->value;
+				continue;
+			}
+
+			// falls die Bezeichnung unbekannt ist, ist das ein
+			// Fehler der FluxML-Datei
+			size_t * idx = (ineq_ptype_(i) == POOL)
+				? pool2idx_.findPtr(coeff_i->key)
+				: flux2idx_.findPtr(coeff_i->key);
+			fASSERT(idx != 0);
+			if (idx == 0)
+				continue;
+			idx_list.push_back(*idx);
+			val_list.push_back(coeff_i->value);
+			k++;
 		}
 	}
-	return result;
+	ineq_ptr_(n) = k;
+
+	ineq_idx_ = GVector< size_t >(k);
+	ineq_val_ = GVector< double >(k);
+	for (i=0; i<k; i++)
+	{
+		ineq_idx_(i) = idx_list[i];
+		ineq_val_(i) = val_list[i];
+	}
+} // ConstraintSystem::compile_ineqs()
+
+// Auswertung der übersetzten Ungleichungen; liefert die Anzahl der
+// verletzten Ungleichungen
+static size_t check_ineqs(
+	size_t n,
+	size_t const * ptr,
+	size_t const * idx,
+	double const * val,
+	double const * cnst,
+	ParameterType const * ptype,
+	double const * lo,
+	double const * hi,
+	double const * const x[3],
+	double tol,
+	double * lhs,
+	double * viol
+	)
+{
+	size_t i, k;
+	double sum;
+
+	// lhs = A*x + c
+	for (i=0; i<n; i++)
+	{
+		double const * xi = x[ptype[i]];
+		sum = cnst[i];
+		for (k=ptr[i]; k<ptr[i+1]; k++)
+			sum += val[k] * xi[idx[k]];
+		lhs[i] = sum;
+	}
+
+	// Vergleich mit den Schranken der Relation: lo-tol <= lhs <= hi+tol
+	return simd::checkBounds(n, lhs, lo, hi, tol, viol);
+}
+
+bool ConstraintSystem::validate_ineqs() const
+{
+	fASSERT( fluxes_dirty_ == false );
+	double const * const x[3] = { vnet_, vxch_, vpool_ };
+
+	// wird von jedem eval() aufgerufen: keine Meldungen (siehe
+	// reportIneqViolations)
+	return check_ineqs(ineq_rel_.dim(), ineq_ptr_, ineq_idx_, ineq_val_,
+		ineq_const_, ineq_ptype_, ineq_lo_, ineq_hi_, x, cons_tol_,
+		ineq_lhs_, ineq_viol_) == 0;
 } // ConstraintSystem::validate_ineqs()
 
+size_t ConstraintSystem::getIneqViolations(
+	GVector< size_t > & idx,
+	MVector & amount
+	) const
+{
+	size_t i, k, nviol, n = ineq_rel_.dim();
+
+	fASSERT( validation_state_ == cm_ok
+		|| validation_state_ == cm_too_few_constr
+		|| validation_state_ == cm_too_many_constr
+		|| validation_state_ == cm_ineqs_violated);
+	// eval() prüft die Ungleichungen bereits (validate_ineqs), sobald
+	// es die Werte berechnet hat; dann genügt ineq_viol_
+	bool checked = false;
+	if (fluxes_dirty_)
+	{
+		eval();
+		checked = not fluxes_dirty_;
+	}
+
+	if (checked)
+	{
+		for (nviol=0,i=0; i<n; i++)
+			if (ineq_viol_.get(i) >= 0.)
+				nviol++;
+	}
+	else
+	{
+		double const * const x[3] = { vnet_, vxch_, vpool_ };
+		nviol = check_ineqs(n, ineq_ptr_, ineq_idx_, ineq_val_, ineq_const_,
+			ineq_ptype_, ineq_lo_, ineq_hi_, x, cons_tol_,
+			ineq_lhs_, ineq_viol_);
+	}
+
+	idx = GVector< size_t >(nviol);
+	amount = MVector(nviol);
+	for (k=0,i=0; i<n; i++)
+	{
+		if (ineq_viol_.get(i) < 0.)
+			continue;
+		idx(k) = i;
+		amount(k) = ineq_viol_.get(i);
+		k++;
+	}
+	return nviol;
+} // ConstraintSystem::getIneqViolations()
+
+size_t ConstraintSystem::reportIneqViolations() const
+{
+	size_t i, nviol = 0;
+
+	if (fluxes_dirty_)
+		eval();
+	if (fluxes_dirty_)
+		return 0;
+
+	for (i=0; i<ineq_rel_.dim(); i++)
+	{
+		if (ineq_viol_.get(i) < 0.)
+			continue;
+		Constraint const & c = *(ineq_cons_.get(i));
+		fWARNING("%s ineq. constraint \"%s\" [%s] is violated by %e",
+			c.getParameterType() == NET ? "NET"
+				: (c.getParameterType() == XCH ? "XCH" : "POOL"),
+			c.getName(),
+			c.getConstraint()->toString().c_str(),
+			ineq_lhs_.get(i)
+			);
+		nviol++;
+	}
+	return nviol;
+} // ConstraintSystem::reportIneqViolations()
+
+// x - y; Auslöschung auf Rundungsniveau ergibt exakt 0 (Quasi-Constraints
+// werden über V(i,j) == 0 erkannt)
+static inline double sub_cancel(double x, double y)
+{
+	double d = x - y;
+	return (::fabs(d) <= 8.*MACHEPS*::fabs(y)) ? 0. : d;
+}
+
+// Pivot-Schritt auf der Kern-Matrix V: die freie Variable der Spalte s
+// wird abhängig, die abhängige Variable der Zeile d wird frei (Spalte s).
+// Rang-1-Aktualisierung V <- V - V(:,s)*V(d,:)/V(d,s), Spalte s <- V(:,s)/V(d,s)
+static void kernel_pivot(MMatrix & V, size_t d, size_t s)
+{
+	size_t i, c, m = V.rows(), n = V.cols();
+	double p = V.get(d,s);
+	MVector a(m), r(n);
+
+	for (i=0; i<m; i++)
+		a(i) = V.get(i,s) / p;
+	for (c=0; c<n; c++)
+		r(c) = V.get(d,c);
+
+	for (c=0; c<n; c++)
+	{
+		double rc = r(c);
+		if (c == s or rc == 0.)
+			continue;
+		double * vc = (double *)V + c*m;
+		for (i=0; i<m; i++)
+			if (a(i) != 0.)
+				vc[i] = sub_cancel(vc[i], a(i) * rc);
+	}
+	for (i=0; i<m; i++)
+		V(i,s) = a(i);
+}
+
+// Eliminiert die freie Variable der Spalte s über die Gleichung
+// w'*[1;y] = beta (w = a'*V); Spalte s entfällt
+static MMatrix kernel_eliminate(
+	MMatrix const & V,
+	MVector const & w,
+	double beta,
+	size_t s
+	)
+{
+	size_t i, c, cc, m = V.rows(), n = V.cols();
+	double const * vs = (double const *)V + s*m;
+	double f, ws = w.get(s);
+	MMatrix W(m, n-1);
+
+	for (c=0,cc=0; c<n; c++)
+	{
+		if (c == s)
+			continue;
+		// Spalte 0: spezielle Lösung, y_s = (beta-w(0))/w(s) - ...
+		f = (c == 0) ? (w.get(0) - beta) / ws : w.get(c) / ws;
+		double const * vc = (double const *)V + c*m;
+		double * wc = (double *)W + cc*m;
+		for (i=0; i<m; i++)
+			wc[i] = (f == 0. or vs[i] == 0.) ? vc[i] : sub_cancel(vc[i], vs[i] * f);
+		cc++;
+	}
+	return W;
+}
+
+// Erweitert den Lösungsraum um die Richtung z; die bisher abhängige
+// Variable d (z(d) != 0) wird freie Variable der neuen, letzten Spalte
+static MMatrix kernel_extend(
+	MMatrix const & V,
+	MVector const & z,
+	size_t d
+	)
+{
+	size_t i, c, m = V.rows(), n = V.cols();
+	double zd = z.get(d);
+	MMatrix W(m, n+1);
+
+	for (c=0; c<n; c++)
+	{
+		double f = V.get(d,c) / zd;
+		for (i=0; i<m; i++)
+			W(i,c) = (f == 0. or z.get(i) == 0.) ? V.get(i,c)
+				: sub_cancel(V.get(i,c), z.get(i) * f);
+	}
+	for (i=0; i<m; i++)
+		W(i,n) = z.get(i) / zd;
+	return W;
+}
+
+// Baut Pc wie GMatrixOps::gaussJordan auf (abhängige Variablen aufsteigend,
+// dann freie Variablen aufsteigend) und sortiert die Spalten 1.. von V
+// passend um. colvar(j) ist die Variable der Spalte j>0 von V.
+static void kernel_reorder(
+	MMatrix & V,
+	GVector< size_t > const & colvar,
+	PMatrix & Pc
+	)
+{
+	size_t i, j, k, m = V.rows(), n = V.cols();
+	std::vector< size_t > col_of(m, 0);
+	MMatrix W(m, n);
+
+	for (j=1; j<n; j++)
+		col_of[colvar.get(j)] = j;
+
+	Pc = PMatrix(m);
+	for (k=0,i=0; i<m; i++)
+		if (col_of[i] == 0)
+			Pc(k++) = i;
+	for (i=0; i<m; i++)
+		if (col_of[i] != 0)
+			Pc(k++) = i;
+
+	for (i=0; i<m; i++)
+		W(i,0) = V.get(i,0);
+	for (j=1; j<n; j++)
+	{
+		size_t c = col_of[Pc.get(m-n+j)];
+		for (i=0; i<m; i++)
+			W(i,j) = V.get(i,c);
+	}
+	V = W;
+}
+
+// Relatives Residuum von N*V = [b,0]
+static double kernel_residual(
+	MMatrix const & N,
+	MVector const & b,
+	MMatrix const & V
+	)
+{
+	size_t i, j, k;
+	double r, s, res = 0.;
+
+	for (i=0; i<N.rows(); i++)
+	{
+		for (j=0; j<V.cols(); j++)
+		{
+			r = (j == 0) ? -b.get(i) : 0.;
+			s = ::fabs(r);
+			for (k=0; k<N.cols(); k++)
+			{
+				double nik = N.get(i,k);
+				if (nik == 0.)
+					continue;
+				r += nik * V.get(k,j);
+				s += ::fabs(nik * V.get(k,j));
+			}
+			if (s > 0. and ::fabs(r) / s > res)
+				res = ::fabs(r) / s;
+		}
+	}
+	return res;
+}
+
+ConstraintSystem::FluxType ConstraintSystem::get_var_type(
+	ParameterType parameter_type,
+	size_t k
+	) const
+{
+	switch (parameter_type)
+	{
+	case NET: return v_type_net_.get(k);
+	case XCH: return v_type_xch_.get(k);
+	case POOL:
+		// PoolType und FluxType sind gleich aufgebaut
+		return FluxType(v_type_pool_.get(k));
+	}
+	return f_undefined;
+}
+
+void ConstraintSystem::set_var_type(
+	ParameterType parameter_type,
+	size_t k,
+	FluxType t
+	)
+{
+	switch (parameter_type)
+	{
+	case NET: v_type_net_(k) = t; break;
+	case XCH: v_type_xch_(k) = t; break;
+	case POOL: v_type_pool_(k) = PoolType(t); break;
+	}
+}
+
+size_t ConstraintSystem::var_index(
+	ParameterType parameter_type,
+	char const * name
+	) const
+{
+	size_t * idx = (parameter_type == POOL)
+		? pool2idx_.findPtr(name)
+		: flux2idx_.findPtr(name);
+	return idx ? *idx : size_t(-1);
+}
+
+bool ConstraintSystem::constraint_row(
+	Constraint const & c,
+	MVector & a,
+	double & beta
+	) const
+{
+	size_t idx;
+	a = MVector(c.getParameterType() == POOL ? S_.rows() : S_.cols());
+	beta = 0.;
+	try
+	{
+		// wie in prepare(): (...)=0, Konstante auf die rechte Seite
+		ExprTree::Arena arena;
+		LinearExpression lE( c.getConstraint() );
+		charptr_map< double > const & C = lE.getLinearCoeffs();
+		charptr_map< double >::const_iterator coeff_i;
+		for (coeff_i = C.begin(); coeff_i != C.end(); coeff_i++)
+		{
+			if (strcmp(coeff_i->key, "1") == 0)
+			{
+				beta = - coeff_i->value;
+				continue;
+			}
+			idx = var_index(c.getParameterType(), coeff_i->key);
+			if (idx == size_t(-1))
+				return false;
+			a(idx) = coeff_i->value;
+		}
+	}
+	catch (ExprTreeException &)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool ConstraintSystem::commit_update(
+	ParameterType parameter_type,
+	MMatrix & N,
+	MVector & b,
+	MMatrix & V,
+	GVector< size_t > const & colvar,
+	size_t k_mod,
+	FluxType t_mod,
+	bool check_feasibility
+	)
+{
+	size_t j, k, n = V.rows();
+	size_t nfree = V.cols() - 1;
+	PMatrix Pc;
+	MMatrix & N_ = parameter_type == NET ? Nnet_ : (parameter_type == XCH ? Nxch_ : Npool_);
+	MVector & b_ = parameter_type == NET ? bnet_ : (parameter_type == XCH ? bxch_ : bpool_);
+	MMatrix & V_ = parameter_type == NET ? Vnet_ : (parameter_type == XCH ? Vxch_ : Vpool_);
+	PMatrix & Pc_ = parameter_type == NET ? Pcnet_ : (parameter_type == XCH ? Pcxch_ : Pcpool_);
+	MVector & vc_ = parameter_type == NET ? v_const_net_
+		: (parameter_type == XCH ? v_const_xch_ : v_const_pool_);
+
+	kernel_reorder(V, colvar, Pc);
+
+	// Rundungsfehler der Aktualisierungen: bei Bedarf exakt neu lösen
+	// (die Aufteilung in freie/abhängige Variablen bleibt erhalten)
+	double res = kernel_residual(N, b, V);
+	fDEBUG(0, "residual of updated kernel: %g", res);
+	if (res > 1e-10)
+	{
+		int rank;
+		PMatrix Pcf(n);
+		Pcf.fill(1);
+		for (j=n-nfree; j<n; j++)
+			Pcf(Pc.get(j)) = 0;
+		fINFO("re-solving %s constraint system (residual %g)",
+			parameter_type == NET ? "NET"
+				: (parameter_type == XCH ? "XCH" : "POOL"), res);
+		if (not ExactOps::gaussJordan(N, b, V, Pcf, rank)
+			or V.rows() != n or V.cols() != nfree + 1)
+			return false;
+		Pc = Pcf;
+	}
+
+	// bisherigen Zustand sichern
+	ValidationState state_old = validation_state_;
+	MMatrix N_old(N_), V_old(V_);
+	MVector b_old(b_), vc_old(vc_);
+	PMatrix Pc_old(Pc_);
+	GVector< FluxType > t_old(n);
+	for (k=0; k<n; k++)
+		t_old(k) = get_var_type(parameter_type, k);
+
+	N_ = N;
+	b_ = b;
+	V_ = V;
+	Pc_ = Pc;
+
+	// Typen: abhängig / frei / Constraint
+	for (j=0; j<n-nfree; j++)
+		set_var_type(parameter_type, Pc.get(j), f_dependent);
+	for (; j<n; j++)
+	{
+		k = Pc.get(j);
+		if (k == k_mod)
+			set_var_type(parameter_type, k, t_mod);
+		else
+			set_var_type(parameter_type, k,
+				t_old.get(k) == f_constraint ? f_constraint : f_free);
+	}
+	impose_constraints();
+
+	if (check_feasibility and not validate_ineqs_feasibility())
+	{
+		// Änderung verwerfen
+		N_ = N_old;
+		b_ = b_old;
+		V_ = V_old;
+		Pc_ = Pc_old;
+		vc_ = vc_old;
+		for (k=0; k<n; k++)
+			set_var_type(parameter_type, k, t_old.get(k));
+		validation_state_ = state_old;
+		return false;
+	}
+
+	// Liste freier Variablen wie in solve() neu aufbauen
+	charptr_array pcons;
+	charptr_array::const_iterator pc;
+	switch (parameter_type)
+	{
+	case NET:
+	case XCH:
+		{
+		charptr_array & ff = parameter_type == NET ? fFluxes_net_ : fFluxes_xch_;
+		ff.clear();
+		for (j=n-nfree; j<n; j++)
+			if (get_var_type(parameter_type, Pc.get(j)) == f_free)
+				ff.add(S_.getReactionName(Pc.get(j)));
+		pcons = reportQuasiConstraintFluxes(parameter_type == NET);
+		}
+		break;
+	case POOL:
+		fPools_size_.clear();
+		for (j=n-nfree; j<n; j++)
+			if (get_var_type(POOL, Pc.get(j)) == f_free)
+				fPools_size_.add(S_.getMetaboliteName(Pc.get(j)));
+		pcons = reportQuasiConstraintPools(logQUIET);
+		break;
+	}
+	for (pc=pcons.begin(); pc!=pcons.end(); ++pc)
+		set_var_type(parameter_type, var_index(parameter_type, *pc), f_quasicons);
+
+	prepare_batch();
+	fluxes_dirty_ = true;
+	change_count_++;
+	return true;
+} // ConstraintSystem::commit_update()
+
+// akzeptierte Zustände für eine inkrementelle Aktualisierung
+static inline bool incremental_state(ConstraintSystem::ValidationState s)
+{
+	return s == ConstraintSystem::cm_ok
+		or s == ConstraintSystem::cm_too_few_constr
+		or s == ConstraintSystem::cm_ineqs_violated;
+}
+
+bool ConstraintSystem::exchangeFreeFlux(
+	char const * free_name,
+	char const * dep_name,
+	ParameterType parameter_type
+	)
+{
+	size_t j, f, d, s;
+	double rmax = 0.;
+
+	if (not incremental_state(validation_state_))
+		return false;
+	// aktuelle Werte als Ausgangspunkt
+	if (fluxes_dirty_)
+		eval();
+	f = var_index(parameter_type, free_name);
+	d = var_index(parameter_type, dep_name);
+	if (f == size_t(-1) or d == size_t(-1)
+		or get_var_type(parameter_type, f) != f_free
+		or (get_var_type(parameter_type, d) != f_dependent
+			and get_var_type(parameter_type, d) != f_quasicons))
+		return false;
+
+	MMatrix N(parameter_type == NET ? Nnet_ : (parameter_type == XCH ? Nxch_ : Npool_));
+	MVector b(parameter_type == NET ? bnet_ : (parameter_type == XCH ? bxch_ : bpool_));
+	MMatrix V(parameter_type == NET ? Vnet_ : (parameter_type == XCH ? Vxch_ : Vpool_));
+	PMatrix const & Pc = parameter_type == NET ? Pcnet_
+		: (parameter_type == XCH ? Pcxch_ : Pcpool_);
+	size_t ndep = V.rows() - (V.cols() - 1);
+
+	GVector< size_t > colvar(V.cols());
+	for (s=0,j=1; j<V.cols(); j++)
+	{
+		colvar(j) = Pc.get(ndep+j-1);
+		if (colvar(j) == f)
+			s = j;
+		rmax = MAX2(rmax, ::fabs(V.get(d,j)));
+	}
+	fASSERT(s > 0);
+
+	// d muss von f abhängen; zu kleine Pivots vermeiden
+	if (V.get(d,s) == 0. or ::fabs(V.get(d,s)) <= 1e-8 * rmax)
+	{
+		fWARNING("free variable %s cannot be exchanged for %s",
+			free_name, dep_name);
+		return false;
+	}
+
+	kernel_pivot(V, d, s);
+	colvar(s) = d;
+	return commit_update(parameter_type, N, b, V, colvar,
+		size_t(-1), f_undefined, false);
+} // ConstraintSystem::exchangeFreeFlux()
+
+bool ConstraintSystem::addEquality(Constraint const & c)
+{
+	size_t i, j, k, s;
+	ParameterType parameter_type = c.getParameterType();
+
+	if (not incremental_state(validation_state_) or not c.isEquality())
+		return false;
+	if (fluxes_dirty_)
+		eval();
+
+	MMatrix N(parameter_type == NET ? Nnet_ : (parameter_type == XCH ? Nxch_ : Npool_));
+	MVector b(parameter_type == NET ? bnet_ : (parameter_type == XCH ? bxch_ : bpool_));
+	MMatrix V(parameter_type == NET ? Vnet_ : (parameter_type == XCH ? Vxch_ : Vpool_));
+	PMatrix const & Pc = parameter_type == NET ? Pcnet_
+		: (parameter_type == XCH ? Pcxch_ : Pcpool_);
+	size_t ndep = V.rows() - (V.cols() - 1);
+
+	GVector< size_t > colvar(V.cols());
+	for (j=1; j<V.cols(); j++)
+		colvar(j) = Pc.get(ndep+j-1);
+
+	if (c.isSimple())
+	{
+		// Wert-Constraint: die Variable muss frei sein
+		k = var_index(parameter_type, c.getSimpleVarName());
+		if (k == size_t(-1) or get_var_type(parameter_type, k) == f_constraint)
+			return false;
+
+		if (get_var_type(parameter_type, k) != f_free)
+		{
+			// Pivot mit der betragsgrößten freien Spalte
+			double pmax = 0.;
+			for (s=0,j=1; j<V.cols(); j++)
+				if (get_var_type(parameter_type, colvar.get(j)) == f_free
+					and ::fabs(V.get(k,j)) > pmax)
+				{
+					pmax = ::fabs(V.get(k,j));
+					s = j;
+				}
+			if (s == 0)
+			{
+				fWARNING("constraint %s: %s is already determined by constraints",
+					c.getName(), c.getSimpleVarName());
+				return false;
+			}
+			kernel_pivot(V, k, s);
+			colvar(s) = k;
+		}
+		return commit_update(parameter_type, N, b, V, colvar,
+			k, f_constraint, true);
+	}
+
+	// echtes Constraint a'*x = beta
+	MVector a;
+	double beta;
+	if (not constraint_row(c, a, beta))
+		return false;
+
+	// w = a'*V; die Gleichung lautet w'*[1;y] = beta
+	MVector w(V.cols()), wabs(V.cols());
+	for (j=0; j<V.cols(); j++)
+		for (i=0; i<V.rows(); i++)
+			if (a.get(i) != 0.)
+			{
+				w(j) += a.get(i) * V.get(i,j);
+				wabs(j) += ::fabs(a.get(i) * V.get(i,j));
+			}
+
+	// zu eliminierende freie Variable: betragsgrößtes w(s)
+	double wmax = 0.;
+	for (s=0,j=1; j<V.cols(); j++)
+		if (get_var_type(parameter_type, colvar.get(j)) == f_free
+			and ::fabs(w.get(j)) > 1e-9 * wabs.get(j)
+			and ::fabs(w.get(j)) > wmax)
+		{
+			wmax = ::fabs(w.get(j));
+			s = j;
+		}
+	if (s == 0)
+	{
+		// redundant oder widersprüchlich
+		fWARNING("constraint %s does not restrict the free variables",
+			c.getName());
+		return false;
+	}
+
+	V = kernel_eliminate(V, w, beta, s);
+	GVector< size_t > colvar_new(V.cols());
+	for (k=1,j=1; j<colvar.dim(); j++)
+		if (j != s)
+			colvar_new(k++) = colvar.get(j);
+
+	MMatrix N_new(N.rows()+1, a.dim());
+	MVector b_new(N.rows()+1);
+	for (i=0; i<N.rows(); i++)
+	{
+		for (j=0; j<a.dim(); j++)
+			N_new(i,j) = N.get(i,j);
+		b_new(i) = b.get(i);
+	}
+	for (j=0; j<a.dim(); j++)
+		N_new(N.rows(),j) = a.get(j);
+	b_new(N.rows()) = beta;
+
+	return commit_update(parameter_type, N_new, b_new, V, colvar_new,
+		size_t(-1), f_undefined, true);
+} // ConstraintSystem::addEquality()
+
+bool ConstraintSystem::removeEquality(Constraint const & c)
+{
+	size_t i, j, k, r, d;
+	ParameterType parameter_type = c.getParameterType();
+
+	if (not incremental_state(validation_state_) or not c.isEquality())
+		return false;
+	if (fluxes_dirty_)
+		eval();
+
+	MMatrix N(parameter_type == NET ? Nnet_ : (parameter_type == XCH ? Nxch_ : Npool_));
+	MVector b(parameter_type == NET ? bnet_ : (parameter_type == XCH ? bxch_ : bpool_));
+	MMatrix V(parameter_type == NET ? Vnet_ : (parameter_type == XCH ? Vxch_ : Vpool_));
+	PMatrix const & Pc = parameter_type == NET ? Pcnet_
+		: (parameter_type == XCH ? Pcxch_ : Pcpool_);
+	size_t ndep = V.rows() - (V.cols() - 1);
+
+	GVector< size_t > colvar(V.cols());
+	for (j=1; j<V.cols(); j++)
+		colvar(j) = Pc.get(ndep+j-1);
+
+	if (c.isSimple())
+	{
+		// Wert-Constraint: die Variable wird frei und behält ihren Wert
+		k = var_index(parameter_type, c.getSimpleVarName());
+		if (k == size_t(-1) or get_var_type(parameter_type, k) != f_constraint)
+			return false;
+		if (not commit_update(parameter_type, N, b, V, colvar,
+			k, f_free, false))
+			return false;
+		switch (parameter_type)
+		{
+		case NET: vnet_(k) = c.getSimpleVarValue(); break;
+		case XCH: vxch_(k) = c.getSimpleVarValue(); break;
+		case POOL: vpool_(k) = c.getSimpleVarValue(); break;
+		}
+		return true;
+	}
+
+	// echtes Constraint: Zeile in N suchen (nach einer Zeilen-Reduktion
+	// in prepare() ist sie nicht mehr auffindbar)
+	MVector a;
+	double beta;
+	if (not constraint_row(c, a, beta) or N.rows() == 0 or a.dim() != N.cols())
+		return false;
+	for (r=0; r<N.rows(); r++)
+	{
+		if (b.get(r) != beta)
+			continue;
+		for (j=0; j<N.cols() and N.get(r,j) == a.get(j); j++)
+			;
+		if (j == N.cols())
+			break;
+	}
+	if (r == N.rows())
+		return false;
+	fASSERT(N.rows() == ndep);
+
+	// Richtung z mit N*z = e_r: z(D) = B^-1 * e_r, B = N(:,D). B ist
+	// (wie die Stöchiometrie) dünn besetzt und zerfällt in kleine
+	// Diagonalblöcke, die nacheinander gelöst werden. Die Spalten von B
+	// werden aus der CSC-Form von N übernommen.
+	CSMatrix Ns(N, CSMatrix::csc);
+	size_t const * nptr = Ns.ptr();
+	size_t const * nidx = Ns.idx();
+	double const * nval = Ns.val();
+	size_t nz = 0;
+	for (j=0; j<ndep; j++)
+		nz += nptr[Pc.get(j)+1] - nptr[Pc.get(j)];
+	GVector< size_t > bptr(ndep+1), bidx(nz);
+	MVector bval(nz);
+	for (k=0,j=0; j<ndep; j++)
+	{
+		size_t pj = Pc.get(j);
+		bptr(j) = k;
+		for (i=nptr[pj]; i<nptr[pj+1]; i++,k++)
+		{
+			bidx(k) = nidx[i];
+			bval(k) = nval[i];
+		}
+	}
+	bptr(ndep) = k;
+	CSMatrix Bs(ndep, ndep, CSMatrix::csc,
+		std::move(bptr), std::move(bidx), std::move(bval));
+	MVector u(ndep);
+	BlockTriangular bt(Bs);
+	if (bt.isStructurallySingular())
+		return false;
+	u(r) = 1.;
+	if (not bt.solve(Bs, u))
+		return false;
+
+	// neue freie Variable: betragsgrößte Komponente von u
+	double umax = 0.;
+	for (d=ndep,j=0; j<ndep; j++)
+		if (::fabs(u.get(j)) > umax)
+		{
+			umax = ::fabs(u.get(j));
+			d = j;
+		}
+	if (d == ndep)
+		return false;
+
+	MVector z(V.rows());
+	for (j=0; j<ndep; j++)
+		z(Pc.get(j)) = u.get(j);
+	d = Pc.get(d);
+
+	V = kernel_extend(V, z, d);
+	GVector< size_t > colvar_new(V.cols());
+	for (j=1; j<colvar.dim(); j++)
+		colvar_new(j) = colvar.get(j);
+	colvar_new(V.cols()-1) = d;
+
+	MMatrix N_new;
+	MVector b_new;
+	if (N.rows() > 1)
+	{
+		N_new = MMatrix(N.rows()-1, N.cols());
+		b_new = MVector(N.rows()-1);
+		for (k=0,i=0; i<N.rows(); i++)
+		{
+			if (i == r)
+				continue;
+			for (j=0; j<N.cols(); j++)
+				N_new(k,j) = N.get(i,j);
+			b_new(k++) = b.get(i);
+		}
+	}
+
+	return commit_update(parameter_type, N_new, b_new, V, colvar_new,
+		size_t(-1), f_undefined, false);
+} // ConstraintSystem::removeEquality()
+
+bool ConstraintSystem::updateInequalities()
+{
+	if (not incremental_state(validation_state_))
+		return false;
+	compile_ineqs();
+	fluxes_dirty_ = true;
+	change_count_++;
+	if (not validate_ineqs_feasibility())
+	{
+		validation_state_ = cm_ineqs_infeasible;
+		return false;
+	}
+	return true;
+} // ConstraintSystem::updateInequalities()
+
 bool ConstraintSystem::getFlux(
 	char const * fluxname,
 	double & net,
@@ -1772,6 +2767,117 @@ bool ConstraintSystem::setFlux(
 	return rv;
 } // ConstraintSystem::setFlux()
 
+ConstraintSystem::FluxHandle ConstraintSystem::resolveFlux(
+	char const * fluxname
+	) const
+{
+	bool is_net;
+	if (strEndsWith(fluxname,".n"))
+		is_net = true;
+	else if (strEndsWith(fluxname,".x"))
+		is_net = false;
+	else
+		return FluxHandle();
+
+	char * fn = strdup_alloc(fluxname);
+	fn[strlen(fn)-2] = '\0';
+	FluxHandle h = resolveFlux(fn,is_net);
+	delete[] fn;
+	return h;
+} // ConstraintSystem::resolveFlux()
+
+ConstraintSystem::FluxHandle ConstraintSystem::resolveFlux(
+	char const * fluxname,
+	bool net
+	) const
+{
+	size_t * idx = flux2idx_.findPtr(fluxname);
+	if (idx == 0)
+		return FluxHandle();
+	return FluxHandle(net ? NET : XCH, *idx);
+} // ConstraintSystem::resolveFlux()
+
+ConstraintSystem::FluxHandle ConstraintSystem::resolvePool(
+	char const * poolname
+	) const
+{
+	size_t * idx = pool2idx_.findPtr(poolname);
+	if (idx == 0)
+		return FluxHandle();
+	return FluxHandle(POOL, *idx);
+} // ConstraintSystem::resolvePool()
+
+bool ConstraintSystem::setValue(
+	FluxHandle const & h,
+	double val
+	)
+{
+	fASSERT( h.valid() );
+	MVector * v;
+	switch (h.type)
+	{
+	case NET:
+		if (v_type_net_(h.idx) != f_free)
+		{
+			fERROR("%s (net) is not free", S_.getReactionName(h.idx));
+			fASSERT_NONREACHABLE();
+			return false;
+		}
+		v = &vnet_;
+		break;
+	case XCH:
+		if (v_type_xch_(h.idx) != f_free)
+		{
+			fERROR("%s (xch) is not free", S_.getReactionName(h.idx));
+			fASSERT_NONREACHABLE();
+			return false;
+		}
+		v = &vxch_;
+		break;
+	default:
+		if (v_type_pool_(h.idx) != p_free)
+		{
+			fERROR("%s (pool) is not free", S_.getMetaboliteName(h.idx));
+			fASSERT_NONREACHABLE();
+			return false;
+		}
+		v = &vpool_;
+		break;
+	}
+
+	if ((*v)(h.idx) != val)
+	{
+		fluxes_dirty_ = true;
+		change_count_++;
+		(*v)(h.idx) = val;
+	}
+	return true;
+} // ConstraintSystem::setValue()
+
+void ConstraintSystem::getValues(
+	FluxHandle const * h,
+	size_t n,
+	double * val
+	) const
+{
+	size_t i;
+	for (i=0; i<n; ++i)
+		val[i] = getValue(h[i]);
+} // ConstraintSystem::getValues()
+
+bool ConstraintSystem::setValues(
+	FluxHandle const * h,
+	size_t n,
+	double const * val
+	)
+{
+	size_t i;
+	bool rv = true;
+	for (i=0; i<n; ++i)
+		rv = setValue(h[i],val[i]) and rv;
+	return rv;
+} // ConstraintSystem::setValues()
+
 charptr_array ConstraintSystem::getFluxNames() const
 {
 	charptr_array fnames = flux2idx_.getKeys();
@@ -2415,6 +3521,53 @@ ExprTree * ConstraintSystem::getSymbolicFluxFwdBwd(
 		return ExprTree::netxch2bwd(net,xch);
 } // ConstraintSystem::getSymbolicFluxFwdBwd()
 
+void ConstraintSystem::getSymbolicDAG(
+	symb::ExprDAG & dag,
+	bool formula
+	) const
+{
+	charptr_array names = getFluxNames();
+	charptr_array::const_iterator ni;
+	std::string rn;
+
+	for (ni=names.begin(); ni!=names.end(); ++ni)
+	{
+		// alle Ausdrucksbäume sind temporär (der DAG kopiert); eine
+		// Arena je Fluss hält den Spitzenverbrauch klein
+		ExprTree::Arena arena;
+		// wie getSymbolicFluxFwdBwd; fwd/bwd teilen sich net/xch
+		ExprTree * net = getSymbolicFluxNetXch(*ni,data::NET,formula);
+		ExprTree * xch = getSymbolicFluxNetXch(*ni,data::XCH,formula);
+		LinearExpression Lnet(net); delete net;
+		LinearExpression Lxch(xch); delete xch;
+		net = Lnet.get()->clone();
+		xch = Lxch.get()->clone();
+
+		rn = std::string(*ni) + ".n";
+		dag.add(net, rn.c_str());
+		rn = std::string(*ni) + ".x";
+		dag.add(xch, rn.c_str());
+
+		ExprTree * fwd = ExprTree::netxch2fwd(net->clone(),xch->clone());
+		rn = std::string(*ni) + ".f";
+		dag.add(fwd, rn.c_str());
+		delete fwd;
+		ExprTree * bwd = ExprTree::netxch2bwd(net,xch);
+		rn = std::string(*ni) + ".b";
+		dag.add(bwd, rn.c_str());
+		delete bwd;
+	}
+
+	names = getPoolNames();
+	for (ni=names.begin(); ni!=names.end(); ++ni)
+	{
+		ExprTree::Arena arena;
+		ExprTree * pool = getSymbolicPoolFlux(*ni,POOL,formula);
+		LinearExpression Lpool(pool); delete pool;
+		dag.add(Lpool.get(), *ni);
+	}
+} // ConstraintSystem::getSymbolicDAG()
+
 // Forward/Backward => net/xch
 //   net = fwd - bwd;
 //   xch = min(fwd,bwd);
@@ -2789,6 +3942,175 @@ bool ConstraintSystem::fillStandardForm(
 	return status;
 } // ConstraintSystem::fillStandardForm()
 
+// FVA für einen Block von Werten v = c + B*f mit f aus SF
+static bool fva_block(
+	StandardForm const & SF,
+	charptr_array const & fnames,
+	MMatrix const & B,
+	MVector const & c,
+	MVector & vmin,
+	MVector & vmax,
+	unsigned int nthreads
+	)
+{
+	size_t i, k;
+	size_t nv = SF.getNumVars();
+	double const inf = std::numeric_limits< double >::infinity();
+
+	vmin = MVector(c);
+	vmax = MVector(c);
+	if (B.cols() == 0)
+		return true;
+
+	// Spalte der StandardForm zu jeder Spalte von B
+	GVector< size_t > col(B.cols());
+	for (k=0; k<B.cols(); k++)
+	{
+		int idx = SF.indexOf(fnames[k]);
+		fASSERT(idx >= 0);
+		col(k) = size_t(idx);
+	}
+
+	// nur Werte mit Abhängigkeit von freien Werten erfordern LPs
+	std::vector< size_t > rows;
+	for (i=0; i<B.rows(); i++)
+		for (k=0; k<B.cols(); k++)
+			if (B.get(i,k) != 0.)
+			{
+				rows.push_back(i);
+				break;
+			}
+	if (rows.empty())
+		return true;
+
+	if (not BoundedSimplex::fitsTableau(SF.getLHS().rows(),nv))
+	{
+		fWARNING("FVA: system too large for dense simplex (%lu rows, %lu variables)",
+			(unsigned long)SF.getLHS().rows(), (unsigned long)nv);
+		return false;
+	}
+
+	MVector lo, up;
+	SF.getBounds(lo,up);
+	BoundedSimplex LP(SF.getLHS(),SF.getRHS(),lo,up);
+	switch (LP.findFeasible())
+	{
+	case BoundedSimplex::lp_optimal:
+		break;
+	case BoundedSimplex::lp_iterlimit:
+		fWARNING("FVA: no feasible point found (iteration limit)");
+		return false;
+	default:
+		fWARNING("FVA: inequality constraints are infeasible");
+		return false;
+	}
+
+	// jeder Thread arbeitet auf einer Kopie des zulässigen LPs
+	std::atomic< size_t > next(0);
+	std::atomic< size_t > nfailed(0);
+	double * pmin = vmin;
+	double * pmax = vmax;
+
+	// Wert eines gelösten LPs; nicht gelöste LPs (Iterationslimit,
+	// numerisch unzulässig) liefern NaN
+	auto bound = [&](BoundedSimplex::Status st, BoundedSimplex const & lp,
+		double ci, double unbounded)
+	{
+		switch (st)
+		{
+		case BoundedSimplex::lp_optimal:
+			return ci + lp.getObjective();
+		case BoundedSimplex::lp_unbounded:
+			return unbounded;
+		default:
+			nfailed++;
+			return std::numeric_limits< double >::quiet_NaN();
+		}
+	};
+
+	auto worker = [&](BoundedSimplex lp)
+	{
+		size_t r, j;
+		MVector obj(nv);
+		while ((r = next++) < rows.size())
+		{
+			size_t ri = rows[r];
+			obj.fill(0.);
+			for (j=0; j<B.cols(); j++)
+				obj(col.get(j)) += B.get(ri,j);
+
+			pmax[ri] = bound(lp.maximize(obj), lp, c.get(ri), inf);
+			pmin[ri] = bound(lp.minimize(obj), lp, c.get(ri), -inf);
+		}
+	};
+
+	nthreads = num_threads(nthreads, rows.size(), 1, rows.size());
+	run_threads(nthreads, [&](unsigned int) { worker(LP); });
+
+	if (nfailed > 0)
+		fWARNING("FVA: %lu LPs not solved (iteration limit or numerical "
+			"trouble); their bounds are NaN", (unsigned long)nfailed.load());
+	return true;
+}
+
+bool ConstraintSystem::computeFluxVariability(
+	MVector & net_min,
+	MVector & net_max,
+	MVector & xch_min,
+	MVector & xch_max,
+	MVector & pool_min,
+	MVector & pool_max,
+	unsigned int nthreads
+	) const
+{
+	charptr_array fnames, names;
+	charptr_array::const_iterator fi;
+
+	switch (validation_state_)
+	{
+	case cm_ok:
+	case cm_too_few_constr:
+	case cm_linear_dep_constr:
+	case cm_ineqs_violated:
+		break;
+	default:
+		fWARNING("flux variability analysis requires a consistent system");
+		return false;
+	}
+
+	// Netto-Flüsse
+	{
+		StandardForm SF;
+		fillStandardForm(SF,true,false,false);
+		names = getFluxNamesByType(f_free,true);
+		fnames.clear();
+		for (fi=names.begin(); fi!=names.end(); fi++)
+			fnames.add("%s.n", *fi);
+		if (not fva_block(SF,fnames,Bnet_,cnet_,net_min,net_max,nthreads))
+			return false;
+	}
+	// Exchange-Flüsse
+	{
+		StandardForm SF;
+		fillStandardForm(SF,false,true,false);
+		names = getFluxNamesByType(f_free,false);
+		fnames.clear();
+		for (fi=names.begin(); fi!=names.end(); fi++)
+			fnames.add("%s.x", *fi);
+		if (not fva_block(SF,fnames,Bxch_,cxch_,xch_min,xch_max,nthreads))
+			return false;
+	}
+	// Poolgrößen
+	{
+		StandardForm SF;
+		fillStandardForm(SF,false,false,true);
+		fnames = getPoolNamesByType(p_free);
+		if (not fva_block(SF,fnames,Bpool_,cpool_,pool_min,pool_max,nthreads))
+			return false;
+	}
+	return true;
+} // ConstraintSystem::computeFluxVariability()
+
 
 charptr_array ConstraintSystem::reportQuasiConstraintFluxes(
 	bool net,
@@ -2877,6 +4199,8 @@ void ConstraintSystem::dump() const
 	default:
 		fWARNING("dumping invalid stoichiometry");
 	}
+	if (validation_state_ == cm_ineqs_violated)
+		reportIneqViolations();
 
 	char sn[][5] = {"UDEF", "DEPD", "QCON", "FREE", "CONS", "COFA"};
 
@@ -8,10 +8,12 @@
 #include "charptr_map.h"
 #include "MMatrix.h"
 #include "MVector.h"
+#include "CSMatrix.h"
 #include "StandardForm.h"
 #include "StoichMatrixInteger.h"
 #include "ExprTree.h"
 #include "LinearExpression.h"
+#include "ExprDAG.h"
 #include "Constraint.h"
 
 namespace flux {
@@ -67,6 +69,25 @@ public:
 		p_free,                 // freier Poolgröße
 		p_constraint
 	};
+
+	/**
+	 * Handle auf einen Netto-/Exchange-Fluss oder eine Poolgröße.
+	 * Wird einmalig per resolveFlux/resolvePool aufgelöst und erlaubt
+	 * anschließend den Zugriff ohne String-Vergleiche / Hashing.
+	 */
+	struct FluxHandle
+	{
+		/** Art des Werts (NET, XCH, POOL) */
+		ParameterType type;
+		/** Index in vnet_, vxch_ bzw. vpool_; size_t(-1) falls ungültig */
+		size_t idx;
+
+		FluxHandle() : type(NET), idx(size_t(-1)) { }
+		FluxHandle(ParameterType t, size_t i) : type(t), idx(i) { }
+
+		/** @return true, falls das Handle aufgelöst werden konnte */
+		inline bool valid() const { return idx != size_t(-1); }
+	};
         
 private:
 	/** Stöchiometrie */
@@ -114,6 +135,8 @@ private:
 	charptr_map< size_t > flux2idx_;
 	/** Toleranz für Constraintverletzung (default: 1e-9) */
 	double cons_tol_;
+	/** Stöchiometrie-Residuum in eval() prüfen? (default: true) */
+	bool check_residual_;
 	/** Müssen Flüsse vor dem Auslesen neu berechnet werden? */
 	mutable bool fluxes_dirty_;
 	/** Zähler für Änderungen an freien Flüssen */
@@ -138,6 +161,41 @@ private:
 	la::MMatrix Vpool_;
 	/** Der Vektor mit den konstanten Constraint-Poolgrößen */
 	la::MVector v_const_pool_;        
+	/** Batch-Auswertung: Spalten von Vnet_ der freien Netto-Flüsse */
+	la::MMatrix Bnet_;
+	/** Batch-Auswertung: Spalten von Vxch_ der freien Exchange-Flüsse */
+	la::MMatrix Bxch_;
+	/** Batch-Auswertung: Spalten von Vpool_ der freien Poolgrößen */
+	la::MMatrix Bpool_;
+	/** Batch-Auswertung: konstanter Anteil Vnet_*v_const_net_ */
+	la::MVector cnet_;
+	/** Batch-Auswertung: konstanter Anteil Vxch_*v_const_xch_ */
+	la::MVector cxch_;
+	/** Batch-Auswertung: konstanter Anteil Vpool_*v_const_pool_ */
+	la::MVector cpool_;
+
+	/** Übersetzte Ungleichungen (CSR): Zeilenanfänge, #Ungleichungen+1 */
+	la::GVector< size_t > ineq_ptr_;
+	/** Übersetzte Ungleichungen: Index in vnet_, vxch_ bzw. vpool_ */
+	la::GVector< size_t > ineq_idx_;
+	/** Übersetzte Ungleichungen: Koeffizienten */
+	la::GVector< double > ineq_val_;
+	/** Übersetzte Ungleichungen: konstanter Anteil */
+	la::MVector ineq_const_;
+	/** Übersetzte Ungleichungen: Art der Werte (NET, XCH, POOL) */
+	la::GVector< ParameterType > ineq_ptype_;
+	/** Übersetzte Ungleichungen: Relation (et_op_leq, et_op_geq, ...) */
+	la::GVector< symb::ExprType > ineq_rel_;
+	/** Übersetzte Ungleichungen: Schranken der linken Seite (aus ineq_rel_) */
+	la::MVector ineq_lo_;
+	/** Übersetzte Ungleichungen: Schranken der linken Seite (aus ineq_rel_) */
+	la::MVector ineq_hi_;
+	/** Übersetzte Ungleichungen: Zeiger auf die Constraints */
+	la::GVector< Constraint const * > ineq_cons_;
+	/** Werte der linken Seiten bei der letzten Prüfung */
+	mutable la::MVector ineq_lhs_;
+	/** Beträge der Verletzung bei der letzten Prüfung (<0: erfüllt) */
+	mutable la::MVector ineq_viol_;
         
 private:
 	/** Validiert die feasibility der Ungleichungen */
@@ -151,8 +209,31 @@ private:
 	bool solve();
 	/** Generiert statische Flusswert-Constraints v_const_ */
 	void impose_constraints();
+	/** Erstellt Bnet_, Bxch_, Bpool_ und cnet_, cxch_, cpool_ */
+	void prepare_batch();
+	/** Übersetzt die Ungleichungen in eine dünnbesetzte Matrix */
+	void compile_ineqs();
 	/** Validiert die Ungleichungen mit den aktuellen Flusswerten */
 	bool validate_ineqs() const;
+	/** Flusstyp (bzw. Pool-Typ als FluxType) einer Variablen */
+	FluxType get_var_type(ParameterType parameter_type, size_t k) const;
+	/** Setzt den Flusstyp (bzw. Pool-Typ) einer Variablen */
+	void set_var_type(ParameterType parameter_type, size_t k, FluxType t);
+	/** Index einer Variablen; size_t(-1) falls unbekannt */
+	size_t var_index(ParameterType parameter_type, char const * name) const;
+	/** Koeffizientenzeile eines (nicht-einfachen) Gleichungs-Constraints */
+	bool constraint_row(Constraint const & c, la::MVector & a, double & beta) const;
+	/** Übernimmt ein inkrementell aktualisiertes Teilsystem */
+	bool commit_update(
+		ParameterType parameter_type,
+		la::MMatrix & N,
+		la::MVector & b,
+		la::MMatrix & V,
+		la::GVector< size_t > const & colvar,
+		size_t k_mod,
+		FluxType t_mod,
+		bool check_feasibility
+		);
 	
 public:
 	/**
@@ -161,6 +242,184 @@ public:
 	 * Ungleichungen.
 	 */
 	void eval() const;
+
+	/**
+	 * Stapel-Auswertung für N Vektoren freier Werte.
+	 * Die Vektoren liegen spaltenweise (Fortran-Ordnung) in einem
+	 * fortlaufenden Speicherbereich, d.h. free_net ist eine
+	 * (#freie Netto-Flüsse x N)-Matrix. Die Reihenfolge der freien Werte
+	 * innerhalb eines Vektors entspricht der (sortierten) Reihenfolge von
+	 * getFluxNamesByType(f_free,..) bzw. getPoolNamesByType(p_free).
+	 * Berechnet wird vnet = Vnet_*[1;v_free]+v_const für alle N Spalten
+	 * in einem Matrix-Matrix-Produkt; Ergebnis sind (S.cols() x N)- bzw.
+	 * (S.rows() x N)-Matrizen. Der Zustand des Objekts (freie Flüsse,
+	 * Änderungszähler) bleibt unverändert; Ungleichungen und
+	 * Stöchiometrie-Residuum werden nicht geprüft.
+	 * Ist ein Paar (free_*, v*) ein 0-Zeiger, wird es übersprungen.
+	 *
+	 * @param N Anzahl der Vektoren
+	 * @param free_net Werte freier Netto-Flüsse (in)
+	 * @param free_xch Werte freier Exchange-Flüsse (in)
+	 * @param free_pool Werte freier Poolgrößen (in)
+	 * @param vnet Netto-Flusswerte (out)
+	 * @param vxch Exchange-Flusswerte (out)
+	 * @param vpool Poolgrößen (out)
+	 * @return false, falls das System inkonsistent ist
+	 */
+	bool evalBatch(
+		size_t N,
+		double const * free_net,
+		double const * free_xch,
+		double const * free_pool,
+		double * vnet,
+		double * vxch,
+		double * vpool
+		) const;
+
+	/**
+	 * Stapel-Auswertung für N Vektoren freier Werte (Matrix-Variante).
+	 * Jede Spalte von F_net, F_xch, F_pool ist ein Vektor freier Werte;
+	 * V_net, V_xch, V_pool werden passend dimensioniert.
+	 *
+	 * @param F_net Werte freier Netto-Flüsse, spaltenweise (in)
+	 * @param F_xch Werte freier Exchange-Flüsse, spaltenweise (in)
+	 * @param F_pool Werte freier Poolgrößen, spaltenweise (in)
+	 * @param V_net Netto-Flusswerte, spaltenweise (out)
+	 * @param V_xch Exchange-Flusswerte, spaltenweise (out)
+	 * @param V_pool Poolgrößen, spaltenweise (out)
+	 * @return false, falls das System inkonsistent ist
+	 */
+	bool evalBatch(
+		la::MMatrix const & F_net,
+		la::MMatrix const & F_xch,
+		la::MMatrix const & F_pool,
+		la::MMatrix & V_net,
+		la::MMatrix & V_xch,
+		la::MMatrix & V_pool
+		) const;
+
+	/**
+	 * Gibt die Anzahl der Ungleichungs-Constraints zurück.
+	 *
+	 * @return Anzahl der Ungleichungen
+	 */
+	inline size_t getNumIneqs() const { return ineq_rel_.dim(); }
+
+	/**
+	 * Gibt das i-te Ungleichungs-Constraint zurück (Reihenfolge wie in
+	 * der Liste der Ungleichungen).
+	 *
+	 * @param i Index der Ungleichung
+	 * @return Ungleichungs-Constraint
+	 */
+	inline Constraint const & getIneq(size_t i) const
+	{
+		return *(ineq_cons_.get(i));
+	}
+
+	/**
+	 * Prüft die Ungleichungen mit den aktuellen Werten und gibt die
+	 * Indizes und Beträge der verletzten Ungleichungen zurück. Es werden
+	 * keine Meldungen ausgegeben.
+	 *
+	 * @param idx Indizes der verletzten Ungleichungen (out)
+	 * @param amount Beträge der Verletzung (out)
+	 * @return Anzahl der verletzten Ungleichungen
+	 */
+	size_t getIneqViolations(
+		la::GVector< size_t > & idx,
+		la::MVector & amount
+		) const;
+
+	/**
+	 * Gibt für jede mit den aktuellen Werten verletzte Ungleichung eine
+	 * Warnung aus (Bezeichnung, Ungleichung, Betrag). Die Prüfung in
+	 * eval() bleibt stumm; diese Funktion dient der Diagnose und wird
+	 * von dump() verwendet.
+	 *
+	 * @return Anzahl der verletzten Ungleichungen
+	 */
+	size_t reportIneqViolations() const;
+
+	/**
+	 * Gibt die Anzahl der Werte eines Vektors freier Werte für
+	 * evalBatch zurück.
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @return Anzahl freier Werte
+	 */
+	inline size_t getNumBatchFree(ParameterType parameter_type) const
+	{
+		switch (parameter_type)
+		{
+		case NET: return Bnet_.cols();
+		case XCH: return Bxch_.cols();
+		case POOL: return Bpool_.cols();
+		}
+		return 0;
+	}
+
+	/**
+	 * Gibt die Handles der freien Werte in der Reihenfolge von
+	 * evalBatch bzw. getJacobian zurück (sortiert nach Bezeichnung, wie
+	 * getFluxNamesByType(f_free,..) bzw. getPoolNamesByType(p_free)).
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @return Handles der freien Flüsse bzw. Poolgrößen
+	 */
+	la::GVector< FluxHandle > getFreeHandles(ParameterType parameter_type) const;
+
+	/**
+	 * Jacobi-Matrix J = d(v)/d(v_free) der (affinen) Abbildung der
+	 * freien Werte auf alle Flüsse bzw. Poolgrößen (dicht). Zeile i
+	 * gehört zum Handle (parameter_type,i), d.h. die Zeilen sind nach
+	 * Fluss- bzw. Pool-Index geordnet; Spalte j gehört zu free(j).
+	 * Zeilen freier Werte sind Einheitsvektoren, Zeilen von
+	 * Constraint-Werten sind 0.
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @param J Jacobi-Matrix (out)
+	 * @param free Handles der freien Werte (Spalten von J) (out)
+	 */
+	void getJacobian(
+		ParameterType parameter_type,
+		la::MMatrix & J,
+		la::GVector< FluxHandle > & free
+		) const;
+
+	/**
+	 * Jacobi-Matrix wie getJacobian im dünnbesetzten, spaltenweise
+	 * komprimierten Format (CSC): die Einträge der Spalte j stehen in
+	 * row_idx/val an den Positionen col_ptr(j) .. col_ptr(j+1)-1,
+	 * aufsteigend nach Zeile sortiert.
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @param col_ptr Spaltenanfänge (Länge #freie Werte + 1) (out)
+	 * @param row_idx Zeilenindizes der Einträge (out)
+	 * @param val Werte der Einträge (out)
+	 * @param free Handles der freien Werte (Spalten von J) (out)
+	 */
+	void getJacobianCSC(
+		ParameterType parameter_type,
+		la::GVector< size_t > & col_ptr,
+		la::GVector< size_t > & row_idx,
+		la::MVector & val,
+		la::GVector< FluxHandle > & free
+		) const;
+
+	/**
+	 * Jacobi-Matrix wie getJacobian als CSMatrix (CSC-Format), z.B. für
+	 * Produkte mit CSMatrix::spmv/spmm.
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @param J Jacobi-Matrix (out)
+	 * @param free Handles der freien Werte (Spalten von J) (out)
+	 */
+	void getJacobian(
+		ParameterType parameter_type,
+		la::CSMatrix & J,
+		la::GVector< FluxHandle > & free
+		) const;
 	
 	/**
 	 * Constructor.
@@ -244,6 +503,83 @@ public:
 	 */
 	bool setFlux(char const * fluxname, double val);
 
+	/**
+	 * Löst eine Flußbezeichnung mit Suffix (.n, .x) in ein Handle auf.
+	 *
+	 * @param fluxname Flussbezeichnung mit Suffix
+	 * @return Handle; ungültig, falls der Fluß nicht existiert
+	 */
+	FluxHandle resolveFlux(char const * fluxname) const;
+
+	/**
+	 * Löst eine Flußbezeichnung (ohne Suffix) in ein Handle auf.
+	 *
+	 * @param fluxname Flussbezeichnung
+	 * @param net true für Netto-, false für Exchange-Fluß
+	 * @return Handle; ungültig, falls der Fluß nicht existiert
+	 */
+	FluxHandle resolveFlux(char const * fluxname, bool net) const;
+
+	/**
+	 * Löst eine Poolbezeichnung in ein Handle auf.
+	 *
+	 * @param poolname Poolbezeichnung
+	 * @return Handle; ungültig, falls der Pool nicht existiert
+	 */
+	FluxHandle resolvePool(char const * poolname) const;
+
+	/**
+	 * Gibt den Wert zu einem Handle zurück (Fluß oder Poolgröße).
+	 *
+	 * @param h gültiges Handle
+	 * @return Fluß- bzw. Poolgrößen-Wert
+	 */
+	inline double getValue(FluxHandle const & h) const
+	{
+		fASSERT( h.valid() );
+		fASSERT( validation_state_ == cm_ok
+			|| validation_state_ == cm_too_few_constr
+			|| validation_state_ == cm_too_many_constr
+			|| validation_state_ == cm_ineqs_violated);
+		if (fluxes_dirty_)
+			eval();
+		switch (h.type)
+		{
+		case NET: return vnet_.get(h.idx);
+		case XCH: return vxch_.get(h.idx);
+		case POOL: break;
+		}
+		return vpool_.get(h.idx);
+	}
+
+	/**
+	 * Setzt einen freien Wert zu einem Handle (Fluß oder Poolgröße).
+	 *
+	 * @param h gültiges Handle
+	 * @param val neuer Wert
+	 * @return true, falls der freie Wert erfolgreich belegt wurde
+	 */
+	bool setValue(FluxHandle const & h, double val);
+
+	/**
+	 * Gibt die Werte zu einem Array von Handles zurück.
+	 *
+	 * @param h Array von n gültigen Handles
+	 * @param n Anzahl der Handles
+	 * @param val Array für n Werte (out)
+	 */
+	void getValues(FluxHandle const * h, size_t n, double * val) const;
+
+	/**
+	 * Setzt die Werte zu einem Array von Handles.
+	 *
+	 * @param h Array von n gültigen Handles
+	 * @param n Anzahl der Handles
+	 * @param val Array mit n Werten
+	 * @return true, falls alle Werte erfolgreich belegt wurden
+	 */
+	bool setValues(FluxHandle const * h, size_t n, double const * val);
+
 	/**
 	 * Gibt den Validierungszustand zurück.
 	 *
@@ -251,6 +587,66 @@ public:
 	 */
 	inline ValidationState getValidationState() const { return validation_state_; }
 
+	/**
+	 * Inkrementelle Re-Validierung: Tauscht einen freien gegen einen
+	 * abhängigen Fluss (bzw. Poolgröße) aus. Statt das System neu zu
+	 * lösen, wird ein Pivot-Schritt (Rang-1-Aktualisierung) auf der
+	 * Kern-Matrix V ausgeführt. Der Lösungsraum bleibt unverändert,
+	 * daher entfällt die Prüfung der Ungleichungen.
+	 *
+	 * @param free_name bisher freier Fluss (f_free)
+	 * @param dep_name bisher abhängiger Fluss
+	 * @param parameter_type NET, XCH oder POOL
+	 * @return false, falls der Austausch nicht möglich ist (der abhängige
+	 * 	Fluss hängt nicht vom freien Fluss ab); das System bleibt dann
+	 * 	unverändert
+	 */
+	bool exchangeFreeFlux(
+		char const * free_name,
+		char const * dep_name,
+		ParameterType parameter_type
+		);
+
+	/**
+	 * Inkrementelle Re-Validierung: Nimmt ein Gleichungs-Constraint auf,
+	 * das bereits an die Liste der Gleichungs-Constraints (cEqList_)
+	 * angehängt wurde. Ein Wert-Constraint macht die Variable zur
+	 * Constraint-Variablen (ggf. nach einem Pivot-Schritt); ein echtes
+	 * Constraint eliminiert eine freie Variable aus V
+	 * (Rang-1-Aktualisierung) und erweitert N um eine Zeile.
+	 *
+	 * @param c neues Gleichungs-Constraint (Element von cEqList_)
+	 * @return false, falls das Constraint nicht inkrementell aufgenommen
+	 * 	werden kann (redundant, widersprüchlich, Ungleichungen
+	 * 	unerfüllbar, ...); das System bleibt dann unverändert und muss
+	 * 	neu aufgebaut werden
+	 */
+	bool addEquality(Constraint const & c);
+
+	/**
+	 * Inkrementelle Re-Validierung: Entfernt ein Gleichungs-Constraint,
+	 * das bereits aus der Liste der Gleichungs-Constraints (cEqList_)
+	 * entfernt wurde. Ein Wert-Constraint macht die Variable zur freien
+	 * Variablen; für ein echtes Constraint wird die zugehörige Zeile aus
+	 * N entfernt und eine abhängige Variable wird frei. Die neue
+	 * Richtung im Lösungsraum ergibt sich aus einer Spalte der inversen
+	 * Basis-Matrix (eine LU-Zerlegung).
+	 *
+	 * @param c entferntes Gleichungs-Constraint (Kopie)
+	 * @return false, falls das Constraint nicht inkrementell entfernt
+	 * 	werden kann (z.B. nach einer Zeilen-Reduktion von N); das System
+	 * 	bleibt dann unverändert und muss neu aufgebaut werden
+	 */
+	bool removeEquality(Constraint const & c);
+
+	/**
+	 * Übersetzt die Ungleichungen nach einer Änderung der Liste der
+	 * Ungleichungs-Constraints neu und prüft sie auf feasibility.
+	 *
+	 * @return true, falls die Ungleichungen erfüllbar sind
+	 */
+	bool updateInequalities();
+
 	/**
 	 * Gibt ein Array mit den Flussbezeichnungen zurück. Es wird kein Suffix
 	 * für netto / exchange angehängt.
@@ -326,6 +722,21 @@ public:
 		bool formula
 		) const;
 
+	/**
+	 * Trägt die "semi-analytischen" Lösungen aller Flüsse (net, xch,
+	 * fwd, bwd) und Pools als Wurzeln in einen DAG ein. Gemeinsame
+	 * Teilausdrücke werden nur einmal gespeichert. Bezeichnungen der
+	 * Wurzeln: "<fluss>.n", "<fluss>.x", "<fluss>.f", "<fluss>.b",
+	 * "<pool>".
+	 *
+	 * @param dag Ausdrucks-DAG (in/out)
+	 * @param formula Const-Flüsse nicht in Werte umsetzen, falls true
+	 */
+	void getSymbolicDAG(
+		symb::ExprDAG & dag,
+		bool formula
+		) const;
+
 	/**
 	 * Gibt true zurück, falls der Vorwärtsfluss einer Reaktion
 	 * prinzipiell zulässig ist.
@@ -387,6 +798,37 @@ public:
                 bool fill_pool = true
 		) const;
 
+	/**
+	 * Flux Variability Analysis (FVA). Bestimmt für jeden Netto- und
+	 * Exchange-Fluss und jede Poolgröße den minimalen und maximalen Wert
+	 * unter Stöchiometrie, Gleichungen und Ungleichungen. Pro Wert
+	 * werden zwei LPs über den freien Werten gelöst; die LPs werden auf
+	 * nthreads Threads verteilt und innerhalb eines Threads ausgehend von
+	 * der letzten optimalen Basis gelöst. Unbeschränkte Richtungen
+	 * liefern -inf bzw. +inf; LPs, die nicht gelöst werden
+	 * (Iterationslimit, numerische Probleme), liefern NaN und eine
+	 * Warnung. Die Ergebnisvektoren sind wie die
+	 * Stöchiometrie indiziert (Spalten: Flüsse, Zeilen: Pools).
+	 *
+	 * @param net_min minimale Netto-Flüsse (out)
+	 * @param net_max maximale Netto-Flüsse (out)
+	 * @param xch_min minimale Exchange-Flüsse (out)
+	 * @param xch_max maximale Exchange-Flüsse (out)
+	 * @param pool_min minimale Poolgrößen (out)
+	 * @param pool_max maximale Poolgrößen (out)
+	 * @param nthreads Anzahl der Threads (0: Anzahl der Prozessoren)
+	 * @return false, falls die Ungleichungen nicht erfüllbar sind
+	 */
+	bool computeFluxVariability(
+		la::MVector & net_min,
+		la::MVector & net_max,
+		la::MVector & xch_min,
+		la::MVector & xch_max,
+		la::MVector & pool_min,
+		la::MVector & pool_max,
+		unsigned int nthreads = 0
+		) const;
+
 	/**
 	 * Gibt die Stöchiometrie des Netzwerks zurück
 	 *
@@ -444,6 +886,29 @@ public:
 		return cons_tol_;
 	}
 
+	/**
+	 * Schaltet die Prüfung des Stöchiometrie-Residuums ||S*v_net||_2
+	 * bei jeder Auswertung (eval) ein oder aus. Unabhängig davon wird das
+	 * Residuum einmalig beim Lösen des Constraint-Systems geprüft.
+	 *
+	 * @param check true, falls das Residuum geprüft werden soll
+	 */
+	inline void setResidualCheck(bool check)
+	{
+		check_residual_ = check;
+	}
+
+	/**
+	 * Gibt zurück, ob das Stöchiometrie-Residuum bei jeder Auswertung
+	 * geprüft wird.
+	 *
+	 * @return true, falls das Residuum geprüft wird
+	 */
+	inline bool getResidualCheck() const
+	{
+		return check_residual_;
+	}
+
 	/**
 	 * Gibt den Wert des Änderungszählers zurück.
 	 *
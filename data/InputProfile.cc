@@ -11,7 +11,9 @@
 #include "cstringtools.h"
 #include "InputProfile.h"
 #include "ExprTree.h"
+#include "ExprProgram.h"
 #include <limits>
+#include <utility>
 
 using namespace flux::symb;
 
@@ -19,34 +21,72 @@ namespace flux {
 namespace data {
 
     
+/**
+ * Wertet ein übersetztes Profil-Segment aus; einzige Variable ist t
+ * (geprüft in addValue).
+ */
+static double eval_segment(symb::ExprProgram const & P, double t)
+{
+    return P.run< double >([t](size_t) { return t; });
+}
+
+void InputProfile::addValue(symb::ExprTree * value)
+{
+    symb::ExprProgram P(value);
+    for (size_t i=0; i<P.slots(); i++)
+    {
+        if (P.slotName(i) == 0 or strcmp(P.slotName(i),"t") != 0)
+        {
+            fERROR("profile %s: invalid variable \"%s\" in %s",
+                name_.c_str(), P.slotExpr(i).toString().c_str(),
+                value->toString().c_str());
+            fTHROW(DataException);
+        }
+    }
+    values_.push_back(*value);
+    programs_.push_back(std::move(P));
+    jit_.reset();
+}
+
+bool InputProfile::compile()
+{
+    std::shared_ptr< symb::ExprJIT > jit(new symb::ExprJIT);
+    std::list<symb::ExprTree>::const_iterator iv;
+    for (iv=values_.begin(); iv!=values_.end(); ++iv)
+        jit->add(&(*iv));
+    // einzige Variable ist t (geprüft in addValue)
+    fASSERT(jit->vars() <= 1);
+    if (not jit->compile())
+    {
+        jit_.reset();
+        return false;
+    }
+    jit_ = jit;
+    return true;
+}
+
 double InputProfile::eval(double t, bool* status)
 {
     std::list<double>::iterator ic;
-    std::list<symb::ExprTree>::const_iterator iv= values_.begin();
-    symb::ExprTree * ts = symb::ExprTree::val(t);
+    std::list<symb::ExprProgram>::const_iterator ip = programs_.begin();
+    size_t k = 0;
     double val=0.;
     /** Ausnahmefall: profile nicht explizit definiert (d.h Bedingungsliste
      *  enthält nur 0)
      **/
     if(conditions_.size()==1)
     {
-        ExprTree * v_tmp = iv->clone();
-        v_tmp->subst("t", ts);
-        v_tmp->eval(true);
-        val = v_tmp->getDoubleValue();
+        val = jit_ ? jit_->eval(0, &t) : eval_segment(*ip, t);
         *status= true;
 //            fWARNING("eval: t=%.6f \t--> val: %.3f", t, val);
-        delete ts;
-        delete v_tmp;
         return val;
     }
 
     double act_val=0., next_val=0.;
     bool fulfilled= false;
 
-    for(ic = conditions_.begin();iv!=values_.end();++iv)
+    for(ic = conditions_.begin();ip!=programs_.end();++ip,++k)
     {
-        ExprTree * v_tmp = iv->clone();
         act_val = *ic;
         ++ic;
         if(ic!=conditions_.end())
@@ -56,19 +96,14 @@ double InputProfile::eval(double t, bool* status)
 
         if(t >= act_val and t < next_val)
         {
-            v_tmp->subst("t", ts);
-            v_tmp->eval(true);
-            val = v_tmp->getDoubleValue();
+            val = jit_ ? jit_->eval(k, &t) : eval_segment(*ip, t);
             fulfilled= true;
 //                fWARNING("eval: %.2f <= t=%.6f < %.2f \t--> val: %.3f", act_val,t,next_val, val);
-            delete v_tmp;
             break;
         }
-        delete v_tmp;
     }
 
     *status= fulfilled;
-    delete ts;
     return val;
 }
 
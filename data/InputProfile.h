@@ -11,10 +11,14 @@ extern "C"
 #include "Error.h"
 #include <string>
 #include <list>
+#include <memory>
 #include "LinearExpression.h"
 #include <cstring>
 #include "cstringtools.h"
 #include "ExprTree.h"
+#include "ExprProgram.h"
+#include "ExprJIT.h"
+#include "DataException.h"
 
 namespace flux {
 namespace data {
@@ -33,6 +37,10 @@ private:
 	std::list<double> conditions_;
         /** List von Werten des Profiles */
 	std::list<symb::ExprTree> values_;
+	/** übersetzte Werte des Profiles (Variable: t) */
+	std::list<symb::ExprProgram> programs_;
+	/** native Übersetzung der Werte (0: Interpreter); von Kopien geteilt */
+	std::shared_ptr< symb::ExprJIT > jit_;
 	/** true, falls Profile gültig */
 	bool is_valid_;
 
@@ -92,7 +100,22 @@ public:
     
         inline void addCondition(double condition) { conditions_.push_back(condition); }
             
-        inline void addValue(symb::ExprTree * value) { values_.push_back(*value); }
+        /**
+	 * Fügt den Wert eines Segments hinzu. Der Ausdruck wird übersetzt;
+	 * einzige zulässige Variable ist t.
+	 *
+	 * @param value Wert des Segments (Ausdruck in t)
+	 * @exception DataException falls andere Variablen vorkommen
+	 */
+        void addValue(symb::ExprTree * value);
+
+	/**
+	 * Übersetzt die Werte aller Segmente nativ (ExprJIT). Ist kein
+	 * Compiler verfügbar, werden die Werte weiter interpretiert.
+	 *
+	 * @return true, falls die Auswertung nativ erfolgt
+	 */
+	bool compile();
             
         double eval(double t, bool* status);
 };
@@ -302,6 +302,48 @@ void Configuration::validate(
 	// den (linearen) constraint-Gleichungen und den Fluß/Poolgröße-Werten
 	// (Constraint-Flüsse Netto/Exchange, Freie Flüsse und freie Poolgrößen).
 	fASSERT( CS_ == 0 );
+	build_constraint_system(stoich_matrix);
+	update_validation_state();
+
+	// soweit keine größeren Probleme auftreten erfolgt jetzt eine
+	// Ausgabe:
+	if (isValid(2))
+	{
+		fINFO("using the following stoichiometry ...");
+		CS_->dump();
+	}
+	else
+	{
+		fWARNING("validation failed!");
+	}
+
+	// Für Simulationstyp "auto" (sim_type_ == simt_auto) werden die
+	// Simulationsmuster aus den Messmodellspezifikationen generiert
+	if (isValid(3) and (sim_type_ == simt_auto or sim_type_ == simt_explicit))
+	{
+		// im "Automatikmodus" ist es in FluxML unmöglich separate
+		// simulationsmuster anzugeben:
+		fASSERT(sim_atom_patterns_.size() == 0);
+		fASSERT(sim_unknown_patterns_.size() == 0);
+
+		fINFO("tayloring simulation for measurement specifications ...");
+
+		switch (sim_method_)
+		{
+		case simm_Cumomer:
+			generateSimPatternsFromMeasurementSpecs_Cumomer();
+			break;
+		case simm_EMU:
+			generateSimPatternsFromMeasurementSpecs_EMU();
+			break;
+		}
+	} // if (isValid(3) and sim_type_ == simt_auto)
+} // validate()
+
+void Configuration::build_constraint_system(
+	const la::StoichMatrixInteger * stoich_matrix
+	)
+{
 	fDEBUG(0,"building and evaluating the constraint system ...");
 	CS_ = new ConstraintSystem(
 		*stoich_matrix,
@@ -348,7 +390,10 @@ void Configuration::validate(
 	default:
 		break;
 	}
+} // build_constraint_system()
 
+void Configuration::update_validation_state()
+{
 	switch (CS_->getValidationState())
 	{
 	case ConstraintSystem::cm_ok:
@@ -406,41 +451,139 @@ void Configuration::validate(
 		validation_state_ = cfg_ineqs_infeasible;
 		fERROR("infesible inequalities!");
 	}
+} // update_validation_state()
 
-	// soweit keine größeren Probleme auftreten erfolgt jetzt eine
-	// Ausgabe:
-	if (isValid(2))
+void Configuration::finish_revalidation(bool incremental)
+{
+	charptr_array keys;
+	charptr_array::const_iterator ki;
+
+	if (incremental)
 	{
-		fINFO("using the following stoichiometry ...");
-		CS_->dump();
+		// freie Flüsse, die zu abhängigen Flüssen wurden, entfernen
+		keys = sim_opt_free_fluxes_net_.getKeys();
+		for (ki=keys.begin(); ki!=keys.end(); ++ki)
+			if (CS_->getFluxType(*ki,true) != ConstraintSystem::f_free)
+				sim_opt_free_fluxes_net_.erase(*ki);
+		keys = sim_opt_free_fluxes_xch_.getKeys();
+		for (ki=keys.begin(); ki!=keys.end(); ++ki)
+			if (CS_->getFluxType(*ki,false) != ConstraintSystem::f_free)
+				sim_opt_free_fluxes_xch_.erase(*ki);
+		keys = sim_opt_free_poolsizes_.getKeys();
+		for (ki=keys.begin(); ki!=keys.end(); ++ki)
+			if (CS_->getPoolType(*ki) != ConstraintSystem::p_free)
+				sim_opt_free_poolsizes_.erase(*ki);
+
+		switch (CS_->getValidationState())
+		{
+		case ConstraintSystem::cm_ok:
+		case ConstraintSystem::cm_too_few_constr:
+		case ConstraintSystem::cm_ineqs_violated:
+			CS_->eval();
+			break;
+		default:
+			break;
+		}
 	}
 	else
 	{
-		fWARNING("validation failed!");
+		// die Stöchiometrie gehört nicht zum ConstraintSystem
+		la::StoichMatrixInteger const * S = &(CS_->getStoichiometry());
+		fINFO("incremental update failed; rebuilding the constraint system ...");
+		delete CS_;
+		CS_ = 0;
+		build_constraint_system(S);
 	}
+	update_validation_state();
+} // finish_revalidation()
 
-	// Für Simulationstyp "auto" (sim_type_ == simt_auto) werden die
-	// Simulationsmuster aus den Messmodellspezifikationen generiert
-	if (isValid(3) and (sim_type_ == simt_auto or sim_type_ == simt_explicit))
+bool Configuration::revalidateAddConstraint(
+	char const * name,
+	ExprTree const * constraint,
+	ParameterType parameter_type
+	)
+{
+	size_t neq = constraint_eq_.size();
+	size_t nineq = constraint_ineq_.size();
+
+	fASSERT( CS_ != 0 );
+	if (not createConstraint(name,constraint,parameter_type))
+		return false;
+
+	if (constraint_eq_.size() > neq)
+		finish_revalidation(CS_->addEquality(constraint_eq_.back()));
+	else if (constraint_ineq_.size() > nineq)
+		// zusätzliche Ungleichungen machen ein unerfüllbares System
+		// nicht wieder erfüllbar:
+		finish_revalidation(CS_->updateInequalities()
+			or CS_->getValidationState() == ConstraintSystem::cm_ineqs_infeasible);
+	return true;
+} // revalidateAddConstraint()
+
+bool Configuration::revalidateRemoveConstraint(char const * name)
+{
+	std::list< Constraint >::iterator ci;
+
+	fASSERT( CS_ != 0 );
+	for (ci=constraint_eq_.begin(); ci!=constraint_eq_.end(); ci++)
 	{
-		// im "Automatikmodus" ist es in FluxML unmöglich separate
-		// simulationsmuster anzugeben:
-		fASSERT(sim_atom_patterns_.size() == 0);
-		fASSERT(sim_unknown_patterns_.size() == 0);
+		if (strcmp(ci->getName(),name) != 0)
+			continue;
+		// das ConstraintSystem erwartet die aktualisierte Liste
+		Constraint C(*ci);
+		constraint_eq_.erase(ci);
+		finish_revalidation(CS_->removeEquality(C));
+		return true;
+	}
+	for (ci=constraint_ineq_.begin(); ci!=constraint_ineq_.end(); ci++)
+	{
+		if (strcmp(ci->getName(),name) != 0)
+			continue;
+		constraint_ineq_.erase(ci);
+		finish_revalidation(CS_->updateInequalities());
+		return true;
+	}
+	return false;
+} // revalidateRemoveConstraint()
 
-		fINFO("tayloring simulation for measurement specifications ...");
+bool Configuration::revalidateExchangeFreeFlux(
+	char const * free_name,
+	char const * dep_name,
+	ParameterType parameter_type
+	)
+{
+	double net, xch, size;
 
-		switch (sim_method_)
+	fASSERT( CS_ != 0 );
+	switch (parameter_type)
+	{
+	case NET:
+	case XCH:
+		if (not CS_->getFlux(dep_name,net,xch)
+			or not CS_->exchangeFreeFlux(free_name,dep_name,parameter_type))
+			return false;
+		if (parameter_type == NET)
 		{
-		case simm_Cumomer:
-			generateSimPatternsFromMeasurementSpecs_Cumomer();
-			break;
-		case simm_EMU:
-			generateSimPatternsFromMeasurementSpecs_EMU();
-			break;
+			sim_opt_free_fluxes_net_.erase(free_name);
+			addFreeFluxNet(dep_name,false,0.,false,0.,false,0.,true,net);
 		}
-	} // if (isValid(3) and sim_type_ == simt_auto)
-} // validate()
+		else
+		{
+			sim_opt_free_fluxes_xch_.erase(free_name);
+			addFreeFluxXch(dep_name,false,0.,false,0.,false,0.,true,xch);
+		}
+		break;
+	case POOL:
+		if (not CS_->getPoolSize(dep_name,size)
+			or not CS_->exchangeFreeFlux(free_name,dep_name,POOL))
+			return false;
+		sim_opt_free_poolsizes_.erase(free_name);
+		addFreePoolSize(dep_name,false,0.,false,0.,false,0.,true,size);
+		break;
+	}
+	finish_revalidation(true);
+	return true;
+} // revalidateExchangeFreeFlux()
 
 void Configuration::generateSimPatternsFromMeasurementSpecs_Cumomer()
 {
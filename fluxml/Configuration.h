@@ -226,6 +226,33 @@ private:
 	 */
 	void generateSimPatternsFromMeasurementSpecs_EMU();
 
+	/**
+	 * Erzeugt das ConstraintSystem, überträgt die Startwerte freier
+	 * Flüsse / Poolgrößen und wertet es aus.
+	 * wird von der Validierung (validate()) aufgerufen
+	 *
+	 * @param stoich_matrix Stöchiometrische Matrix
+	 */
+	void build_constraint_system(
+		const la::StoichMatrixInteger * stoich_matrix
+		);
+
+	/**
+	 * Übernimmt den Validierungszustand des ConstraintSystems.
+	 * wird von der Validierung (validate()) aufgerufen
+	 */
+	void update_validation_state();
+
+	/**
+	 * Abschluss einer inkrementellen Re-Validierung. Ist die
+	 * inkrementelle Aktualisierung gescheitert, wird das
+	 * ConstraintSystem neu aufgebaut.
+	 *
+	 * @param incremental true, falls das ConstraintSystem aktualisiert
+	 * 	werden konnte
+	 */
+	void finish_revalidation(bool incremental);
+
 public:
 	/**
 	 * Erzeugt und Registiert ein InputPool-Objekt
@@ -615,6 +642,52 @@ public:
 		const la::StoichMatrixInteger * stoich_matrix
 		);
 
+	/**
+	 * Inkrementelle Re-Validierung: Fügt ein Constraint hinzu (siehe
+	 * createConstraint) und aktualisiert das bestehende ConstraintSystem
+	 * (ConstraintSystem::addEquality bzw. updateInequalities), statt es
+	 * neu aufzubauen. Freie Flüsse, die dabei zu abhängigen Flüssen
+	 * werden, werden aus der Konfiguration entfernt. Ist eine
+	 * inkrementelle Aktualisierung nicht möglich, wird das
+	 * ConstraintSystem neu aufgebaut. Voraussetzung ist ein vorheriger
+	 * Aufruf von validate().
+	 *
+	 * @param name Bezeichnung des Constraints
+	 * @param constraint Constraint-Gleichung oder Ungleichung
+	 * @param parameter_type NET, XCH oder POOL
+	 * @return false, falls das Constraint ungültig ist
+	 */
+	bool revalidateAddConstraint(
+		char const * name,
+		symb::ExprTree const * constraint,
+		ParameterType parameter_type
+		);
+
+	/**
+	 * Inkrementelle Re-Validierung: Entfernt das (erste) Constraint mit
+	 * der Bezeichnung name und aktualisiert das ConstraintSystem.
+	 *
+	 * @param name Bezeichnung des Constraints
+	 * @return false, falls es kein Constraint mit dieser Bezeichnung gibt
+	 */
+	bool revalidateRemoveConstraint(char const * name);
+
+	/**
+	 * Inkrementelle Re-Validierung: Tauscht einen freien Fluss (bzw. eine
+	 * freie Poolgröße) gegen einen abhängigen aus. Der neue freie Fluss
+	 * übernimmt seinen aktuellen Wert als Startwert.
+	 *
+	 * @param free_name bisher freier Fluss
+	 * @param dep_name bisher abhängiger Fluss
+	 * @param parameter_type NET, XCH oder POOL
+	 * @return false, falls der Austausch nicht möglich ist
+	 */
+	bool revalidateExchangeFreeFlux(
+		char const * free_name,
+		char const * dep_name,
+		ParameterType parameter_type
+		);
+
 	/* Schnittstelle zum ConstraintSystem: */
 
 	/**
@@ -671,6 +744,121 @@ public:
 		return CS_->setXchFlux(fluxname,xch);
 	}
 
+	/**
+	 * Löst eine Flußbezeichnung mit Suffix (.n, .x) in ein Handle auf.
+	 *
+	 * @param fluxname Flussbezeichnung mit Suffix
+	 * @return Handle; ungültig, falls der Fluß nicht existiert
+	 */
+	inline ConstraintSystem::FluxHandle resolveFlux(
+		char const * fluxname
+		) const
+	{
+		fASSERT( CS_ != 0 );
+		return CS_->resolveFlux(fluxname);
+	}
+
+	/**
+	 * Löst eine Poolbezeichnung in ein Handle auf.
+	 *
+	 * @param poolname Poolbezeichnung
+	 * @return Handle; ungültig, falls der Pool nicht existiert
+	 */
+	inline ConstraintSystem::FluxHandle resolvePool(
+		char const * poolname
+		) const
+	{
+		fASSERT( CS_ != 0 );
+		return CS_->resolvePool(poolname);
+	}
+
+	/**
+	 * Gibt den Wert zu einem Handle zurück.
+	 *
+	 * @param h gültiges Handle
+	 * @return Fluß- bzw. Poolgrößen-Wert
+	 */
+	inline double getValue(ConstraintSystem::FluxHandle const & h) const
+	{
+		fASSERT( CS_ != 0 );
+		return CS_->getValue(h);
+	}
+
+	/**
+	 * Setzt einen freien Wert zu einem Handle.
+	 *
+	 * @param h gültiges Handle
+	 * @param val neuer Wert
+	 * @return true, falls der freie Wert erfolgreich belegt wurde
+	 */
+	inline bool setValue(
+		ConstraintSystem::FluxHandle const & h,
+		double val
+		)
+	{
+		fASSERT( CS_ != 0 );
+		return CS_->setValue(h,val);
+	}
+
+	/**
+	 * Jacobi-Matrix d(v)/d(v_free) aller Flüsse bzw. Poolgrößen nach
+	 * den freien Werten (dicht, siehe ConstraintSystem::getJacobian).
+	 * Zeile i gehört zum Handle (parameter_type,i), Spalte j zu free(j).
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @param J Jacobi-Matrix (out)
+	 * @param free Handles der freien Werte (out)
+	 */
+	inline void getJacobian(
+		ParameterType parameter_type,
+		la::MMatrix & J,
+		la::GVector< ConstraintSystem::FluxHandle > & free
+		) const
+	{
+		fASSERT( CS_ != 0 );
+		CS_->getJacobian(parameter_type,J,free);
+	}
+
+	/**
+	 * Jacobi-Matrix d(v)/d(v_free) im CSC-Format (siehe
+	 * ConstraintSystem::getJacobianCSC).
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @param col_ptr Spaltenanfänge (out)
+	 * @param row_idx Zeilenindizes (out)
+	 * @param val Werte (out)
+	 * @param free Handles der freien Werte (out)
+	 */
+	inline void getJacobianCSC(
+		ParameterType parameter_type,
+		la::GVector< size_t > & col_ptr,
+		la::GVector< size_t > & row_idx,
+		la::MVector & val,
+		la::GVector< ConstraintSystem::FluxHandle > & free
+		) const
+	{
+		fASSERT( CS_ != 0 );
+		CS_->getJacobianCSC(parameter_type,col_ptr,row_idx,val,free);
+	}
+
+	/**
+	 * Jacobi-Matrix d(v)/d(v_free) als CSMatrix (siehe
+	 * ConstraintSystem::getJacobian).
+	 *
+	 * @param parameter_type NET, XCH oder POOL
+	 * @param J Jacobi-Matrix (out)
+	 * @param free Handles der freien Werte (out)
+	 */
+	inline void getJacobian(
+		ParameterType parameter_type,
+		la::CSMatrix & J,
+		la::GVector< ConstraintSystem::FluxHandle > & free
+		) const
+	{
+		fASSERT( CS_ != 0 );
+		CS_->getJacobian(parameter_type,J,free);
+	}
+
 	/**
 	 * Gibt die Bezeichnungen alles Flüsse zurück.
 	 *
@@ -882,6 +1070,47 @@ public:
 		CS_->setConstraintViolationTolerance(cons_tol);
 	}
 
+	/**
+	 * Flux Variability Analysis: minimale und maximale Werte aller
+	 * Netto-/Exchange-Flüsse und Poolgrößen (siehe
+	 * ConstraintSystem::computeFluxVariability).
+	 *
+	 * @param net_min minimale Netto-Flüsse (out)
+	 * @param net_max maximale Netto-Flüsse (out)
+	 * @param xch_min minimale Exchange-Flüsse (out)
+	 * @param xch_max maximale Exchange-Flüsse (out)
+	 * @param pool_min minimale Poolgrößen (out)
+	 * @param pool_max maximale Poolgrößen (out)
+	 * @param nthreads Anzahl der Threads (0: Anzahl der Prozessoren)
+	 * @return false, falls die Ungleichungen nicht erfüllbar sind
+	 */
+	inline bool computeFluxVariability(
+		la::MVector & net_min,
+		la::MVector & net_max,
+		la::MVector & xch_min,
+		la::MVector & xch_max,
+		la::MVector & pool_min,
+		la::MVector & pool_max,
+		unsigned int nthreads = 0
+		) const
+	{
+		fASSERT( CS_ != 0 );
+		return CS_->computeFluxVariability(net_min,net_max,
+			xch_min,xch_max,pool_min,pool_max,nthreads);
+	}
+
+	/**
+	 * Schaltet die Prüfung des Stöchiometrie-Residuums bei jeder
+	 * Auswertung ein oder aus.
+	 *
+	 * @param check true, falls das Residuum geprüft werden soll
+	 */
+	inline void setResidualCheck(bool check)
+	{
+		fASSERT( CS_ != 0 );
+		CS_->setResidualCheck(check);
+	}
+
 	/**
 	 * Gibt die Anzahl der Änderungen an der Stöchiometrie zurück.
 	 *
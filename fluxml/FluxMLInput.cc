@@ -479,6 +479,8 @@ void FluxMLInput::parseInput(DOMNode * input)
                 fTHROW(XMLException,label,"The specified profile values of fraction %s and profile conditions are inconsistent with each other!",
                        (char const *)utf_cfg);
 
+            // Segmentwerte nativ übersetzen (sonst Interpreter)
+            input_profile_->compile();
             profiles.insert(utf_cfg,*input_profile_);
         }
                 // Next Sep-Element
@@ -716,7 +718,14 @@ void FluxMLInput::parseProfileMathML(
                                     *vni, input_profile_->getName(), expr->toString().c_str());
                 };
                 
-                input_profile_->addValue(expr);
+                try { input_profile_->addValue(expr); }
+                catch (data::DataException &)
+                {
+                        fTHROW(XMLException,node,
+                                "profile \"%s\": only variable t allowed in "
+                                "profile value (%s)",
+                                input_profile_->getName(), expr->toString().c_str());
+                }
                 l_iter++;
 	}
 
@@ -802,7 +811,14 @@ void FluxMLInput::parseProfileTextual(
                                             *vni, input_profile_->getName(), nv_pair[ci]);
                         };
                         
-                        input_profile_->addValue(expr);
+                        try { input_profile_->addValue(expr); }
+                        catch (data::DataException &)
+                        {
+                                fTHROW(XMLException,child,
+                                        "profile \"%s\": only variable t allowed in "
+                                        "profile value (%s)",
+                                        input_profile_->getName(), nv_pair[ci]);
+                        }
                         
 			delete[] cname;
 			delete expr;
@@ -12,6 +12,16 @@ using namespace flux::symb;
 namespace flux {
 namespace xml {
 
+// in Fluss- und Poolformeln erlaubte Operatoren
+#define FLUXPOOL_ALLOWED_OPS \
+	(MGROUP_GENERIC_ALLOWED_OPS \
+	| ExprProgram::opMask(et_op_pow) \
+	| ExprProgram::opMask(et_op_sqrt) \
+	| ExprProgram::opMask(et_op_log) \
+	| ExprProgram::opMask(et_op_log2) \
+	| ExprProgram::opMask(et_op_log10) \
+	| ExprProgram::opMask(et_op_exp))
+
 /*
  * --- MGroup ---
  */
@@ -1942,6 +1952,7 @@ MGroupGeneric::MGroupGeneric(MGroupGeneric const & copy)
 	E_ = new ExprTree*[rows_ + 1];
 	E_[rows_] = 0;
 	sub_groups_ = new charptr_map< MetaboliteMGroup* >[rows_];
+	P_ = copy.P_;
 
 	for (size_t r=0; r<rows_; r++)
 	{
@@ -1963,6 +1974,7 @@ MGroupGeneric& MGroupGeneric::operator= (MGroupGeneric const & copy)
 	E_ = new ExprTree*[rows_ + 1];
 	E_[rows_] = 0;
 	sub_groups_ = new charptr_map< MetaboliteMGroup* >[rows_];
+	P_ = copy.P_;
 
 	for (size_t r=0; r<rows_; r++)
 	{
@@ -1987,10 +1999,12 @@ MGroupGeneric::MGroupGeneric(
 {
 	row_mvalue_map_ = new std::map< double,MValue* >[rows_];
 	charptr_array spec;
+	P_.resize(rows_);
 	for (size_t i=0; i<rows_; ++i)
 	{
 		row_spec_[i] = strdup_alloc(E_[i]->toString().c_str());
 		spec.add(row_spec_[i]);
+		P_[i].compile(E_[i]);
 	}
 	spec_ = strdup_alloc(spec.concat(";"));
 }
@@ -2322,74 +2336,132 @@ uint32_t MGroupGeneric::computeCheckSum(uint32_t crc, int crc_scope) const
 	return crc;
 }
 
-double MGroupFlux::evaluateRek(
-	ExprTree * E,
-	charptr_map< double > const & values
-	) const
+ExprProgramCache::~ExprProgramCache()
 {
-	double L=0., R=0.;
-	double * fv;
+	std::list< std::pair< symb::ExprTree*,symb::ExprProgram > >::iterator i;
+	for (i=progs_.begin(); i!=progs_.end(); ++i)
+		delete i->first;
+}
 
-	if (E->Lval())
-		L = evaluateRek(E->Lval(),values);
-	if (E->Rval())
-		R = evaluateRek(E->Rval(),values);
+symb::ExprProgram const & ExprProgramCache::get(symb::ExprTree const * E)
+{
+	size_t h = E->hashValue();
+	std::lock_guard< std::mutex > lock(mtx_);
+	std::list< std::pair< symb::ExprTree*,symb::ExprProgram > >::iterator i;
+	for (i=progs_.begin(); i!=progs_.end(); ++i)
+		if (i->first->hashValue() == h and *(i->first) == *E)
+			return i->second;
 
-	switch (E->getNodeType())
-	{
-	case symb::et_op_add:
-		return L+R;
-	case symb::et_op_sub:
-		return L-R;
-	case symb::et_op_uminus:
-		return -L;
-	case symb::et_op_mul:
-		return L*R;
-	case symb::et_op_div:
-		return L/R;
-	case symb::et_op_min:
-		return L<=R?L:R;
-	case symb::et_op_max:
-		return L>=R?L:R;
-	case symb::et_op_sqr:
-		return L*L;
-	case symb::et_op_abs:
-		if (L<0) return -L;
-		return L;
-	case symb::et_literal:
-		return E->getDoubleValue();
-	case symb::et_variable:
-		fv = values.findPtr(E->getVarName());
-		if (fv == 0)
-			fTHROW(XMLException,"Error: missing flux/pool value \"%s\"",
-				E->getVarName());
-		return *fv;
-	case symb::et_op_pow:
-		return ::pow(L,R);
-	case symb::et_op_sqrt:
-		return ::sqrt(L);
-	case symb::et_op_log:
-		return ::log(L);
-	case symb::et_op_log2:
-		return ::log(L)/::log(2.);
-	case symb::et_op_log10:
-		return ::log10(L);
-	case symb::et_op_exp:
-		return ::exp(L);
-	case symb::et_op_eq:
-	case symb::et_op_neq:
-	case symb::et_op_leq:
-	case symb::et_op_geq:
-	case symb::et_op_lt:
-	case symb::et_op_gt:
-	case symb::et_op_diff:
-	case symb::et_op_sin:
-	case symb::et_op_cos:
-		fTHROW(XMLException,"Error: invalid operator (%s) found flux measurement formula",
-			E->nodeToString().c_str());
-	}
+	symb::ExprTree * C = E->clone();
+	progs_.push_back(std::make_pair(C,symb::ExprProgram(C)));
+	return progs_.back().second;
+}
 
-	return evaluateRek(E,values);
+/**
+ * Prüft eine übersetzte Fluss-/Poolformel: Vergleiche, Ableitungen und
+ * Winkelfunktionen sind nicht erlaubt.
+ *
+ * @param P übersetzte Formel
+ * @param kind "flux" oder "pool" (für die Fehlermeldung)
+ * @param spec Spezifikation der Messgruppe (für die Fehlermeldung)
+ */
+static void fluxpool_check_ops(
+	symb::ExprProgram const & P,
+	char const * kind,
+	char const * spec
+	)
+{
+	if (not P.usesOnly(FLUXPOOL_ALLOWED_OPS))
+		fTHROW(XMLException,"Error: invalid operator found in %s measurement formula (%s)",
+			kind, spec);
+}
+
+/**
+ * Wert der Variablen eines Slots einer übersetzten Fluss-/Poolformel.
+ *
+ * @param P übersetzte Formel
+ * @param values Fluss- bzw. Poolwerte
+ * @param i Slot-Index
+ * @return Wert der Variablen
+ */
+static double fluxpool_value(
+	symb::ExprProgram const & P,
+	charptr_map< double > const & values,
+	size_t i
+	)
+{
+	double * fv = values.findPtr(P.slotName(i));
+	if (fv == 0)
+		fTHROW(XMLException,"Error: missing flux/pool value \"%s\"",
+			P.slotName(i));
+	return *fv;
+}
+
+/**
+ * Auswertung einer übersetzten Fluss-/Poolformel.
+ *
+ * @param P übersetzte Formel
+ * @param values Fluss- bzw. Poolwerte
+ * @param kind "flux" oder "pool" (für die Fehlermeldung)
+ * @param spec Spezifikation der Messgruppe (für die Fehlermeldung)
+ * @return Ergebnis der Auswertung
+ */
+static double fluxpool_run(
+	symb::ExprProgram const & P,
+	charptr_map< double > const & values,
+	char const * kind,
+	char const * spec
+	)
+{
+	fluxpool_check_ops(P, kind, spec);
+	return P.run< double >([&](size_t i) {
+		return fluxpool_value(P, values, i);
+	});
+}
+
+/**
+ * Auswertung einer übersetzten Fluss-/Poolformel samt Gradient.
+ *
+ * @param P übersetzte Formel
+ * @param values Fluss- bzw. Poolwerte
+ * @param grad Ableitungen nach den Variablen der Formel (out)
+ * @param kind "flux" oder "pool" (für die Fehlermeldung)
+ * @param spec Spezifikation der Messgruppe (für die Fehlermeldung)
+ * @return Ergebnis der Auswertung
+ */
+static double fluxpool_gradient(
+	symb::ExprProgram const & P,
+	charptr_map< double > const & values,
+	charptr_map< double > & grad,
+	char const * kind,
+	char const * spec
+	)
+{
+	fluxpool_check_ops(P, kind, spec);
+	std::vector< double > g(P.slots());
+	double f = P.gradient([&](size_t i) {
+		return fluxpool_value(P, values, i);
+	}, g.data());
+
+	for (size_t i=0; i<g.size(); i++)
+		grad[P.slotName(i)] = g[i];
+	return f;
+}
+
+double MGroupFlux::run(
+	symb::ExprProgram const & P,
+	charptr_map< double > const & values
+	) const
+{
+	return fluxpool_run(P, values, "flux", spec_);
+}
+
+double MGroupFlux::evaluate(
+	charptr_map< double > const & values,
+	charptr_map< double > & grad
+	) const
+{
+	return fluxpool_gradient(prog_, values, grad, "flux", spec_);
 }
 
 double MGroupFlux::devaluate(
@@ -2397,7 +2469,7 @@ double MGroupFlux::devaluate(
 	charptr_map< double > const & values
 	) const
 {
-	return evaluateRek(dexpr,values);
+	return run(dprogs_.get(dexpr),values);
 }
 
 uint32_t MGroupFlux::computeCheckSum(uint32_t crc, int crc_scope) const
@@ -2411,74 +2483,20 @@ uint32_t MGroupFlux::computeCheckSum(uint32_t crc, int crc_scope) const
 	return crc;
 }
 
-double MGroupPool::evaluateRek(
-	ExprTree * E,
+double MGroupPool::run(
+	symb::ExprProgram const & P,
 	charptr_map< double > const & values
 	) const
 {
-	double L=0., R=0.;
-	double * fv;
-
-	if (E->Lval())
-		L = evaluateRek(E->Lval(),values);
-	if (E->Rval())
-		R = evaluateRek(E->Rval(),values);
-
-	switch (E->getNodeType())
-	{
-	case symb::et_op_add:
-		return L+R;
-	case symb::et_op_sub:
-		return L-R;
-	case symb::et_op_uminus:
-		return -L;
-	case symb::et_op_mul:
-		return L*R;
-	case symb::et_op_div:
-		return L/R;
-	case symb::et_op_min:
-		return L<=R?L:R;
-	case symb::et_op_max:
-		return L>=R?L:R;
-	case symb::et_op_sqr:
-		return L*L;
-	case symb::et_op_abs:
-		if (L<0) return -L;
-		return L;
-	case symb::et_literal:
-		return E->getDoubleValue();
-	case symb::et_variable:
-		fv = values.findPtr(E->getVarName());
-		if (fv == 0)
-			fTHROW(XMLException,"Error: missing flux/pool value \"%s\"",
-				E->getVarName());
-		return *fv;
-	case symb::et_op_pow:
-		return ::pow(L,R);
-	case symb::et_op_sqrt:
-		return ::sqrt(L);
-	case symb::et_op_log:
-		return ::log(L);
-	case symb::et_op_log2:
-		return ::log(L)/::log(2.);
-	case symb::et_op_log10:
-		return ::log10(L);
-	case symb::et_op_exp:
-		return ::exp(L);
-	case symb::et_op_eq:
-	case symb::et_op_neq:
-	case symb::et_op_leq:
-	case symb::et_op_geq:
-	case symb::et_op_lt:
-	case symb::et_op_gt:
-	case symb::et_op_diff:
-	case symb::et_op_sin:
-	case symb::et_op_cos:
-		fTHROW(XMLException,"Error: invalid operator (%s) found flux measurement formula",
-			E->nodeToString().c_str());
-	}
+	return fluxpool_run(P, values, "pool", spec_);
+}
 
-	return evaluateRek(E,values);
+double MGroupPool::evaluate(
+	charptr_map< double > const & values,
+	charptr_map< double > & grad
+	) const
+{
+	return fluxpool_gradient(prog_, values, grad, "pool", spec_);
 }
 
 double MGroupPool::devaluate(
@@ -2486,7 +2504,7 @@ double MGroupPool::devaluate(
 	charptr_map< double > const & values
 	) const
 {
-	return evaluateRek(dexpr,values);
+	return run(dprogs_.get(dexpr),values);
 }
 
 uint32_t MGroupPool::computeCheckSum(uint32_t crc, int crc_scope) const
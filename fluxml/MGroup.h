@@ -12,6 +12,7 @@ extern "C"
 #include <sstream>
 #include <set>
 #include <map>
+#include <mutex>
 #include "fluxml_config.h"
 #include "Error.h"
 #include "charptr_array.h"
@@ -22,12 +23,26 @@ extern "C"
 #include "cstringtools.h"
 #include "Notation.h"
 #include "ExprTree.h"
+#include "ExprProgram.h"
+#include "ExprAD.h"
 #include "XMLException.h"
 #include "MValue.h"
 #include "MVector.h"
 #include "MMatrix.h"
 #include "Conversions.h"
 
+// in generischen Messgruppen erlaubte Operatoren
+#define MGROUP_GENERIC_ALLOWED_OPS \
+	(flux::symb::ExprProgram::opMask(flux::symb::et_op_add) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_sub) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_uminus) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_mul) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_div) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_min) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_max) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_sqr) \
+	| flux::symb::ExprProgram::opMask(flux::symb::et_op_abs))
+
 namespace flux {
 namespace xml {
 
@@ -376,12 +391,15 @@ protected:
 		//
 		
 		Stype vx, n_sum, d_sum;
+		la::VectorView< Stype const > xs = x_sim.view();
+		la::VectorView< double const > xm = x_meas.view();
+		la::VectorView< double const > sd = x_stddev.view();
 		n_sum = d_sum = 0.;
-		for (size_t i=0; i<x_sim.dim(); i++)
+		for (size_t i=0; i<xs.dim(); i++)
 		{
-			vx = x_stddev.get(i); vx *= vx;
-			n_sum += x_sim.get(i) * x_meas.get(i) / vx;
-			d_sum += x_sim.get(i) * x_sim.get(i) / vx;
+			vx = sd(i); vx *= vx;
+			n_sum += xs(i) * xm(i) / vx;
+			d_sum += xs(i) * xs(i) / vx;
 		}
 		// alle simulierten Werte 0?
 		if (d_sum <= 10.*MACHEPS)
@@ -466,14 +484,18 @@ protected:
 		fASSERT( x_stddev.dim() == dim_ );
 		fASSERT( dx_sim_dflux.dim() == dim_ );
 
+		la::VectorView< Stype const > xs = x_sim.view();
+		la::VectorView< Stype const > dxs = dx_sim_dflux.view();
+		la::VectorView< double const > xm = x_meas.view();
+		la::VectorView< double const > sd = x_stddev.view();
 		for (size_t i=0; i<dim_; i++)
 		{
 			// Varianz
-			V = x_stddev.get(i); V *= V;
-			S1 += x_meas.get(i) * dx_sim_dflux.get(i) / V;
-			S2 += x_sim.get(i) * x_meas.get(i) / V;
-			S3 += x_sim.get(i) * dx_sim_dflux.get(i) / V;
-			S4 += x_sim.get(i) * x_sim.get(i) / V;
+			V = sd(i); V *= V;
+			S1 += xm(i) * dxs(i) / V;
+			S2 += xs(i) * xm(i) / V;
+			S3 += xs(i) * dxs(i) / V;
+			S4 += xs(i) * xs(i) / V;
 		}
 		
 		// alle simulierten Werte 0?
@@ -739,15 +761,18 @@ protected:
 //                    printf("%g, ", toDouble<Stype>(x_meas[i]));
 //                printf("\n\n");
                 
-		for (i=0; i<x_sim.dim(); i++)
+		la::VectorView< Stype const > xs = x_sim.view();
+		la::VectorView< double const > xm = x_meas.view();
+		la::VectorView< double const > sd = x_stddev.view();
+		for (i=0; i<xs.dim(); i++)
 		{
 			// (Relativen) Wichtungsfaktor aus Standardabweichung berechnen
 			// entspricht (x_sim-x_meas)^T*Sigma^-1*(x_sim-x_meas)
-			w = 1./x_stddev.get(i);
+			w = 1./sd(i);
 			w = w * w;
 
 			// Norm
-			ni = x_sim.get(i)-x_meas.get(i);
+			ni = xs(i)-xm(i);
 			ni = w*ni*ni;
 
 			n += ni;
@@ -2546,6 +2571,8 @@ protected:
 	std::map< double,MValue* > * row_mvalue_map_;
 	/** Array von Ausdrücken */
 	symb::ExprTree ** E_;
+	/** übersetzte Ausdrücke (je Zeile) */
+	std::vector< symb::ExprProgram > P_;
 	/** Anzahl der Unterausdrücke */
 	size_t rows_;
 	/** Array von Abbildungen auf die Messgruppen von E_[i] */
@@ -2747,7 +2774,7 @@ public:
 	{
 		la::GVector< Stype > x_sim(dim_);
 		for (size_t r=0; r<rows_; r++)
-			x_sim.set(r,evaluateRek<Stype,Ftype>(ts,values,E_[r],r));
+			x_sim.set(r,evaluateRow<Stype,Ftype>(ts,values,0,P_[r],r));
 
 		if (allow_scaling and scale_auto_ and x_sim.dim() > 1)
 		{
@@ -2947,33 +2974,18 @@ public:
 		la::GVector< Stype > xsim = evaluate(ts,values,false,gs);
 		la::MVector xmeas(dim_), xstddev(dim_);
 		la::GVector< Stype > dxsim_dflux(rows_);
-		char fxn[] = "__reserved_flux__";
 		size_t r;
 
+		// Ableitung der Zeilengleichungen nach dem Fluss per
+		// Vorwärts-Differentiation (ohne symbolische Ableitung)
 		for (r=0; r<rows_; r++)
-		{
-			charptr_array rowvars = getVarNames(r);
-			charptr_array::const_iterator rvi;
-			charptr_map< charptr_array > dsymmap;
-
-			// Variablen vom Fluss fxn abhängig machen
-			for (rvi=rowvars.begin(); rvi!=rowvars.end(); rvi++)
-				dsymmap[*rvi] = fxn;
-
-			// Ableitung der Zeilengleichung nach fxn
-			symb::ExprTree * dE_dflux = E_[r]->deval(fxn,&dsymmap);
-
-			// Ableitung rekursiv auswerten
-			dxsim_dflux(r) = evaluateRekDiff<Stype,Ftype>(
+			dxsim_dflux(r) = evaluateRow<Stype,Ftype>(
 						ts,
 						values,
-						dvalues_dflux,
-						dE_dflux,
+						&dvalues_dflux,
+						P_[r],
 						r
 						);
-
-			delete dE_dflux;
-		}
 		//
 		// Jetzt geht's weiter wie oben:
 		//
@@ -3005,333 +3017,119 @@ public:
 
 protected:
 	/**
-	 * Rekursiver Worker zur Auswertung der Formel
+	 * Auswertung der Untergruppe einer Variablen
 	 * (geeignet für Cumomer und EMU).
 	 *
-	 * @param values Simulierte EMUs/Cumomer-Fractions
 	 * @param ts Timestamp
-	 * @param E Ausdrucksknoten
-	 * @param row die E zugeordnete Zeile
-	 * @return simulierter Messwert (Skalar)
+	 * @param values Simulierte EMUs/Cumomer-Fractions (oder Ableitungen)
+	 * @param vname Variable (Spezifikation der Untergruppe)
+	 * @param row Zeile der Variable
+	 * @return simulierter Messwert der Untergruppe (Skalar)
 	 */
-	template< typename Stype,typename Ftype > Stype evaluateRek(
+	template< typename Stype,typename Ftype > Stype evaluateSubGroup(
 		double ts,
 		charptr_map<
 			fhash_map< BitArray,Ftype,BitArray_hashf > const *
 			> const & values,
-		symb::ExprTree * E,
+		char const * vname,
 		size_t row
 		) const
 	{
-		Stype gs,L(0.),R(0.);
+		Stype gs;
+		MetaboliteMGroup * G = getSubGroup(vname,row);
+		fASSERT( G != 0 );
 
-		if (E->isOperator())
-		{
-			if (E->Lval())
-				L = evaluateRek<Stype,Ftype>(ts,values,E->Lval(),row);
-			if (E->Rval())
-				R = evaluateRek<Stype,Ftype>(ts,values,E->Rval(),row);
-		}
+		fhash_map< BitArray,Ftype,BitArray_hashf > const ** valuesM
+			= values.findPtr(G->getMetaboliteName());
+		if (valuesM == 0)
+			fTHROW(XMLException,"simulation data for metabolite [%s] not found in supplied map",
+				G->getMetaboliteName());
 
-		switch (E->getNodeType())
+		switch (G->getType())
 		{
-		case symb::et_op_add:
-			return L+R;
-		case symb::et_op_sub:
-			return L-R;
-		case symb::et_op_uminus:
-			return -L;
-		case symb::et_op_mul:
-			return L*R;
-		case symb::et_op_div:
-			return L/R;
-		case symb::et_op_min:
-			return L<=R?L:R;
-		case symb::et_op_max:
-			return L>=R?L:R;
-		case symb::et_op_sqr:
-			return L*L;
-		case symb::et_op_abs:
-			if (L<0) return -L;
-			return L;
-		case symb::et_literal:
-			return E->getDoubleValue();
-		case symb::et_variable:
+		case mg_MS:
 			{
-			MetaboliteMGroup * G = getSubGroup(E->getVarName(),row);
-			fASSERT( G != 0 );
-
-			fhash_map< BitArray,Ftype,BitArray_hashf > const ** valuesM
-				= values.findPtr(G->getMetaboliteName());
-			if (valuesM == 0)
-				fTHROW(XMLException,"Isotopomer array for metabolite [%s] not found in supplied map",
-						G->getMetaboliteName());
-
-			switch (G->getType())
+			MGroupMS * Gms = static_cast< MGroupMS * >(G);
+			return (Gms->evaluate(ts,*(*valuesM),false,gs)).get(0);
+			}
+		case mg_MIMS:
 			{
-			case mg_MS:
-				{
-				MGroupMS * Gms = static_cast< MGroupMS * >(G);
-				return (Gms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_MIMS:
-				{
-				MGroupMIMS * Gmims = static_cast< MGroupMIMS * >(G);
-				return (Gmims->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_MSMS:
-				{
-				MGroupMSMS * Gmsms = static_cast< MGroupMSMS * >(G);
-				return (Gmsms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_1HNMR:
-				{
-				MGroup1HNMR * G1hnmr = static_cast< MGroup1HNMR * >(G);
-				return (G1hnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_13CNMR:
-				{
-				MGroup13CNMR * G13cnmr = static_cast< MGroup13CNMR * >(G);
-				return (G13cnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_CUMOMER:
-				{
-				MGroupCumomer * Gcumo = static_cast< MGroupCumomer * >(G);
-				return (Gcumo->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_GENERIC:
-			case mg_FLUX:
-			case mg_POOL:
-				fASSERT_NONREACHABLE();
-				break;
+			MGroupMIMS * Gmims = static_cast< MGroupMIMS * >(G);
+			return (Gmims->evaluate(ts,*(*valuesM),false,gs)).get(0);
 			}
-			return Stype(0.);
+		case mg_MSMS:
+			{
+			MGroupMSMS * Gmsms = static_cast< MGroupMSMS * >(G);
+			return (Gmsms->evaluate(ts,*(*valuesM),false,gs)).get(0);
+			}
+		case mg_1HNMR:
+			{
+			MGroup1HNMR * G1hnmr = static_cast< MGroup1HNMR * >(G);
+			return (G1hnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
+			}
+		case mg_13CNMR:
+			{
+			MGroup13CNMR * G13cnmr = static_cast< MGroup13CNMR * >(G);
+			return (G13cnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
+			}
+		case mg_CUMOMER:
+			{
+			MGroupCumomer * Gcumo = static_cast< MGroupCumomer * >(G);
+			return (Gcumo->evaluate(ts,*(*valuesM),false,gs)).get(0);
 			}
-		case symb::et_op_sin:
-		case symb::et_op_cos:
-		case symb::et_op_pow:
-//			return ::pow(L,R);
-		case symb::et_op_sqrt:
-//			return ::sqrt(L);
-		case symb::et_op_log:
-//			return ::log(L);
-		case symb::et_op_log2:
-//			return ::log(L)/::log(2.);
-		case symb::et_op_log10:
-//			return ::log10(L);
-		case symb::et_op_exp:
-//			return ::exp(L);
-		case symb::et_op_eq:
-		case symb::et_op_neq:
-		case symb::et_op_leq:
-		case symb::et_op_geq:
-		case symb::et_op_lt:
-		case symb::et_op_gt:
-		case symb::et_op_diff:
-			fTHROW(XMLException,"Error: invalid operator (%s) found in generic group spec",
-				E->nodeToString().c_str());
+		case mg_GENERIC:
+		case mg_FLUX:
+		case mg_POOL:
+			fASSERT_NONREACHABLE();
+			break;
 		}
 		return Stype(0.);
 	}
 
 	/**
-	 * Rekursiver Worker zur Auswertung der abgeleiteten Formel.
+	 * Auswertung einer übersetzten Zeilenformel; Variablen werden über
+	 * ihre Untergruppen ausgewertet. Sind Ableitungen dvalues_dflux
+	 * angegeben, wird statt des Werts die Ableitung nach dem Fluss
+	 * berechnet (Vorwärts-Differentiation mit dualen Zahlen; die
+	 * Ableitung einer Variablen ist ihre Untergruppe, ausgewertet mit
+	 * dvalues_dflux).
 	 *
-	 * @param values Simulierte Werte (EMUs oder Cumomer-Fractions)
-	 * @param dvalues_dflux Ableitungen der simulierten Werte
 	 * @param ts Timestamp
-	 * @param E Ausdrucksknoten
-	 * @param row die E zugeordnete Zeile
-	 * @return Ableitung des simulierten Messwerts (Skalar)
+	 * @param values Simulierte EMUs/Cumomer-Fractions
+	 * @param dvalues_dflux Ableitungen der simulierten Werte (oder 0)
+	 * @param P übersetzte Formel
+	 * @param row die P zugeordnete Zeile
+	 * @return simulierter Messwert bzw. dessen Ableitung (Skalar)
 	 */
-	template< typename Stype,typename Ftype > Stype evaluateRekDiff(
+	template< typename Stype,typename Ftype > Stype evaluateRow(
 		double ts,
 		charptr_map<
 			fhash_map< BitArray,Ftype,BitArray_hashf > const *
 			> const & values,
 		charptr_map<
 			fhash_map< BitArray,Ftype,BitArray_hashf > const *
-			> const & dvalues_dflux,
-		symb::ExprTree * E,
+			> const * dvalues_dflux,
+		symb::ExprProgram const & P,
 		size_t row
 		) const
 	{
-		Stype L(0.),R(0.);
-		
-		// rekursiv absteigen und auswerten.
-		// Es wird nicht abgestiegen, falls es sich um einen
-		// diff-Operator handelt, da hier einfach die bereits
-		// zuvor berechneten Werte der Ableitungen eingesetzt
-		// werden.
-		if (E->isOperator() and E->getNodeType() != symb::et_op_diff)
-		{
-			if (E->Lval())
-				L = evaluateRekDiff<Stype,Ftype>(ts,values,dvalues_dflux,E->Lval(),row);
-			if (E->Rval())
-				R = evaluateRekDiff<Stype,Ftype>(ts,values,dvalues_dflux,E->Rval(),row);
-		}
-
-		switch (E->getNodeType())
-		{
-		case symb::et_op_add:
-			return L+R;
-		case symb::et_op_sub:
-			return L-R; 
-		case symb::et_op_uminus:
-			return -L;
-		case symb::et_op_mul:
-			return L*R;
-		case symb::et_op_div:
-			return L/R;
-		case symb::et_op_abs:
-			if (L<0) return -L;
-			return L;
-		case symb::et_op_min:
-			return L<=R?L:R;
-		case symb::et_op_max:
-			return L>=R?L:R;
-		case symb::et_op_sqr:
-			return L*L;
-		case symb::et_literal:
-			return E->getDoubleValue();
-		case symb::et_variable:
-			// je nach Operator im ursprünglichen Ausdruck kommt hier
-			// noch die Variable in ihrer Reinform vor:
-			{
-			Stype gs;
-			MetaboliteMGroup * G = getSubGroup(E->getVarName(),row);
-			fASSERT( G != 0 );
-
-			fhash_map< BitArray,Ftype,BitArray_hashf > const ** valuesM
-				= values.findPtr(G->getMetaboliteName());
-			if (valuesM == 0)
-				fTHROW(XMLException,"simulation data for metabolite [%s] not found in supplied map",
-					G->getMetaboliteName());
-	
-			switch (G->getType())
-			{
-			case mg_MS:
-				{
-				MGroupMS * Gms = static_cast< MGroupMS * >(G);
-				return (Gms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_MIMS:
-				{
-				MGroupMIMS * Gms = static_cast< MGroupMIMS * >(G);
-				return (Gms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_MSMS:
-				{
-				MGroupMSMS * Gmsms = static_cast< MGroupMSMS * >(G);
-				return (Gmsms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_1HNMR:
-				{
-				MGroup1HNMR * G1hnmr = static_cast< MGroup1HNMR * >(G);
-				return (G1hnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_13CNMR:
-				{
-				MGroup13CNMR * G13cnmr = static_cast< MGroup13CNMR * >(G);
-				return (G13cnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_CUMOMER:
-				{
-				MGroupCumomer * Gcumo = static_cast< MGroupCumomer * >(G);
-				return (Gcumo->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_GENERIC:
-			case mg_FLUX:
-			case mg_POOL:
-				fASSERT_NONREACHABLE();
-				break;
-			}
-			return Stype(0.);
-			}
-		case symb::et_op_sin:
-		case symb::et_op_cos:
-		case symb::et_op_pow:
-//			return ::pow(L,R);
-		case symb::et_op_sqrt:
-//			return ::sqrt(L);
-		case symb::et_op_log:
-//			return ::log(L);
-		case symb::et_op_log2:
-//			return ::log(L)/::log(2.);
-		case symb::et_op_log10:
-//			return ::log10(L);
-		case symb::et_op_exp:
-//			return ::exp(L);
-		case symb::et_op_eq:
-		case symb::et_op_neq:
-		case symb::et_op_leq:
-		case symb::et_op_geq:
-		case symb::et_op_lt:
-		case symb::et_op_gt:
-			fTHROW(XMLException,"Error: invalid operator (%s) found in generic group spec",
-				E->nodeToString().c_str());
-			break;
-		case symb::et_op_diff:
-			{
-			// E->Lval() eine Variable mit der Spezifikation,
-			// E->Rval() ist eine Variable mit Namen "__reserved_flux__"
-			fASSERT( E->Lval()->isVariable() );
-			fASSERT( E->Rval()->isVariable() );
-			
-			Stype gs;
-			MetaboliteMGroup * G = getSubGroup(E->Lval()->getVarName(),row);
-			fASSERT( G != 0 );
-			
-			// MGroup.*::evaluate() wird hier mit der Ableitung (dvalues_dflux)
-			// aufgerufen ...
-			fhash_map< BitArray,Ftype,BitArray_hashf > const ** valuesM
-				= dvalues_dflux.findPtr(G->getMetaboliteName());
-			if (valuesM == 0)
-				fTHROW(XMLException,"Simulation data for metabolite [%s] not found in supplied map",
-					G->getMetaboliteName());
-	
-			switch (G->getType())
-			{
-			case mg_MS:
-				{
-				MGroupMS * Gms = static_cast< MGroupMS * >(G);
-				return (Gms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_MIMS:
-				{
-				MGroupMIMS * Gmims = static_cast< MGroupMIMS * >(G);
-				return (Gmims->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_MSMS:
-				{
-				MGroupMSMS * Gmsms = static_cast< MGroupMSMS * >(G);
-				return (Gmsms->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_1HNMR:
-				{
-				MGroup1HNMR * G1hnmr = static_cast< MGroup1HNMR * >(G);
-				return (G1hnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_13CNMR:
-				{
-				MGroup13CNMR * G13cnmr = static_cast< MGroup13CNMR * >(G);
-				return (G13cnmr->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_CUMOMER:
-				{
-				MGroupCumomer * Gcumo = static_cast< MGroupCumomer * >(G);
-				return (Gcumo->evaluate(ts,*(*valuesM),false,gs)).get(0);
-				}
-			case mg_GENERIC:
-			case mg_FLUX:
-			case mg_POOL:
-				fASSERT_NONREACHABLE();
-				break;
-			}
-			return Stype(0.);
-			}
-		}
-		return Stype(0.);
+		if (not P.usesOnly(MGROUP_GENERIC_ALLOWED_OPS))
+			fTHROW(XMLException,"Error: invalid operator found in generic group spec (%s)",
+				getSpec(row));
+
+		if (dvalues_dflux == 0)
+			return P.template run< Stype >([&](size_t i) {
+				return evaluateSubGroup<Stype,Ftype>(
+					ts,values,P.slotName(i),row);
+			});
+
+		return P.template run< symb::Dual< Stype > >([&](size_t i) {
+			return symb::Dual< Stype >(
+				evaluateSubGroup<Stype,Ftype>(
+					ts,values,P.slotName(i),row),
+				evaluateSubGroup<Stype,Ftype>(
+					ts,*dvalues_dflux,P.slotName(i),row));
+		}).d;
 	}
 
 public:
@@ -3367,6 +3165,37 @@ public:
 
 }; // class MGroupGeneric
 
+/**
+ * Cache für übersetzte (differenzierte) Fluss-/Poolformeln.
+ * Die Formeln werden strukturell (Hash-Wert und operator==)
+ * verglichen, so dass jede Formel nur einmal übersetzt wird.
+ * Kopien beginnen mit einem leeren Cache.
+ */
+class ExprProgramCache
+{
+private:
+	/** Kopien der Formeln und zugehörige Programme */
+	std::list< std::pair< symb::ExprTree*,symb::ExprProgram > > progs_;
+	/** Schützt progs_ bei nebenläufiger Auswertung */
+	mutable std::mutex mtx_;
+
+public:
+	inline ExprProgramCache() { }
+	inline ExprProgramCache(ExprProgramCache const &) { }
+	inline ExprProgramCache & operator= (ExprProgramCache const &) { return *this; }
+	~ExprProgramCache();
+
+	/**
+	 * Gibt das übersetzte Programm einer Formel zurück; übersetzt die
+	 * Formel beim ersten Aufruf.
+	 *
+	 * @param E Formel
+	 * @return übersetztes Programm (gültig bis zur Zerstörung des Caches)
+	 */
+	symb::ExprProgram const & get(symb::ExprTree const * E);
+
+}; // class ExprProgramCache
+
 /*
  * *****************************************************************************
  * Messgruppen-Klasse zur Flussmessung.
@@ -3381,6 +3210,10 @@ class MGroupFlux : public SimpleMGroup
 protected:
 	/** Formel zur Flussmessung */
 	symb::ExprTree * expr_;
+	/** übersetzte Formel zur Flussmessung */
+	symb::ExprProgram prog_;
+	/** übersetzte differenzierte Flussformeln (für devaluate) */
+	mutable ExprProgramCache dprogs_;
 	/** Flussliste */
 	charptr_array fluxes_;
 	/** Flag; bezieht sich Flussliste auf Netto oder Exchange-Flüsse? */
@@ -3403,6 +3236,7 @@ protected:
 	{
 		expr_->evalUnaryMinus();
 		fluxes_ = expr_->getVarNames();
+		prog_.compile(expr_);
 	}
 
 public:
@@ -3413,7 +3247,7 @@ public:
 	 */
 	inline MGroupFlux(MGroupFlux const & copy)
 		: SimpleMGroup(copy),expr_(copy.expr_->clone()),
-		  fluxes_(copy.fluxes_), is_net_(copy.is_net_) { }
+		  prog_(copy.prog_), fluxes_(copy.fluxes_), is_net_(copy.is_net_) { }
 
 	/**
 	 * Destructor.
@@ -3484,7 +3318,7 @@ public:
 		charptr_map< double > const & values
 		) const
 	{
-		return evaluateRek(expr_,values);
+		return run(prog_,values);
 	}
 
 	/**
@@ -3499,15 +3333,29 @@ public:
 		charptr_map< double > const & values
 		) const;
 
+	/**
+	 * Auswertung der Formel samt Gradient (Rückwärts-Differentiation;
+	 * ohne symbolische Ableitung).
+	 *
+	 * @param values Werte der Variablen der Formel
+	 * @param grad Ableitungen nach den Variablen der Formel (out)
+	 * @return Ergebnis der Auswertung
+	 */
+	double evaluate(
+		charptr_map< double > const & values,
+		charptr_map< double > & grad
+		) const;
+
 private:
 	/**
-	 * Rekursiver Worker zur Auswertung der Formel.
+	 * Auswertung einer übersetzten Formel.
 	 *
-	 * @param expr (Unter-)Ausdruck der Flussformel
-	 * @param values Flusswerte
+	 * @param P übersetzte (ggfs. differenzierte) Formel
+	 * @param values Werte der Variablen
+	 * @return Ergebnis der Auswertung
 	 */
-	double evaluateRek(
-		symb::ExprTree * expr,
+	double run(
+		symb::ExprProgram const & P,
 		charptr_map< double > const & values
 		) const;
 
@@ -3552,6 +3400,8 @@ class MGroupPool : public SimpleMGroup
 {
 protected:
 	symb::ExprTree * expr_;
+	symb::ExprProgram prog_;
+	mutable ExprProgramCache dprogs_;
 	charptr_array pools_;
 
 protected:
@@ -3560,7 +3410,7 @@ protected:
 		symb::ExprTree * expr
 		)
 		: SimpleMGroup(mg_POOL,expr->toString().c_str()),
-		  expr_(expr->clone())
+		  expr_(expr->clone()), prog_(expr_)
 	{
 		pools_ = expr_->getVarNames();
 	}
@@ -3573,7 +3423,8 @@ public:
 	 */
 	inline MGroupPool(MGroupPool const & copy)
 		: SimpleMGroup(copy),
-		  expr_(copy.expr_->clone()), pools_(copy.pools_) { }
+		  expr_(copy.expr_->clone()), prog_(copy.prog_),
+		  pools_(copy.pools_) { }
 
 	/**
 	 * Destructor.
@@ -3643,7 +3494,7 @@ public:
 		charptr_map< double > const & values
 		) const
 	{
-		return evaluateRek(expr_,values);
+		return run(prog_,values);
 	}
 
 	/**
@@ -3658,15 +3509,29 @@ public:
 		charptr_map< double > const & values
 		) const;
 
+	/**
+	 * Auswertung der Formel samt Gradient (Rückwärts-Differentiation;
+	 * ohne symbolische Ableitung).
+	 *
+	 * @param values Werte der Variablen der Formel
+	 * @param grad Ableitungen nach den Variablen der Formel (out)
+	 * @return Ergebnis der Auswertung
+	 */
+	double evaluate(
+		charptr_map< double > const & values,
+		charptr_map< double > & grad
+		) const;
+
 private:
 	/**
-	 * Rekursiver Worker zur Auswertung der Formel.
+	 * Auswertung einer übersetzten Formel.
 	 *
-	 * @param expr (Unter-)Ausdruck der Flussformel
-	 * @param values Flusswerte
+	 * @param P übersetzte (ggfs. differenzierte) Formel
+	 * @param values Werte der Variablen
+	 * @return Ergebnis der Auswertung
 	 */
-	double evaluateRek(
-		symb::ExprTree * expr,
+	double run(
+		symb::ExprProgram const & P,
 		charptr_map< double > const & values
 		) const;
 
@@ -1,4 +1,6 @@
+#include <cmath>
 #include "fhash_map.h"
+#include "charptr_map.h"
 #include "BitArray.h"
 #include "Error.h"
 #include "MGroup.h"
@@ -91,5 +93,41 @@ int main()
 	{
 		printf("exc: %s\n", (char const*)e);
 	}
+
+	// Gradient einer Flussformel (Rückwärts-Differentiation) gegen
+	// zentrale Differenzenquotienten
+	try
+	{
+		MGroupFlux * F = MGroupFlux::parseSpec(
+			"v1*v2 + sqrt(v3)/(1+v1^2) - 2*log(v2*v2) + exp(-v3)", true);
+		charptr_map< double > v, grad;
+		charptr_map< double >::const_iterator vi;
+		v["v1"] = 0.7;
+		v["v2"] = -1.3;
+		v["v3"] = 2.1;
+
+		double f = F->evaluate(v,grad);
+		printf("f = %.15f\n", f);
+		fASSERT( fabs(f - F->evaluate(v)) <= 1e-14*(1.+fabs(f)) );
+		for (vi=v.begin(); vi!=v.end(); ++vi)
+		{
+			double h = 1e-6;
+			charptr_map< double > vp(v), vm(v);
+			vp[vi->key] += h;
+			vm[vi->key] -= h;
+			double fd = (F->evaluate(vp) - F->evaluate(vm)) / (2.*h);
+			double * g = grad.findPtr(vi->key);
+			fASSERT( g != 0 );
+			printf("df/d%s = %.10f (FD: %.10f)\n", vi->key, *g, fd);
+			fASSERT( fabs(*g - fd) <= 1e-6*(1.+fabs(fd)) );
+		}
+		delete F;
+	}
+	catch (XMLException & e)
+	{
+		printf("exc: %s\n", (char const*)e);
+		return 1;
+	}
+	return 0;
 }
 
@@ -873,3 +873,82 @@ uint32_t update_crc32(void const * data, size_t len, uint32_t crc)
 	return crc;
 }
 
+void sha256(void const * data, size_t len, uint8_t digest[32])
+{
+	static const uint32_t K[64] =
+	{
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+	0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+	0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+	0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+	uint32_t H[8] =
+	{
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+#define ROTR32(x,n) (((x) >> (n)) | ((x) << (32-(n))))
+	uint8_t const * ptr = (uint8_t const *)data;
+	uint8_t block[64];
+	uint32_t W[64], a, b, c, d, e, f, g, h, t1, t2;
+	size_t i, j, nblocks = (len + 8) / 64 + 1;
+	uint64_t bits = uint64_t(len) * 8;
+
+	for (i=0; i<nblocks; i++)
+	{
+		// Block i der aufgefüllten Nachricht (1-Bit, Nullen, Länge)
+		for (j=0; j<64; j++)
+		{
+			size_t p = i*64 + j;
+			if (p < len)
+				block[j] = ptr[p];
+			else if (p == len)
+				block[j] = 0x80;
+			else if (i == nblocks-1 and j >= 56)
+				block[j] = uint8_t(bits >> (8*(63-j)));
+			else
+				block[j] = 0;
+		}
+
+		for (j=0; j<16; j++)
+			W[j] = (uint32_t(block[4*j]) << 24) | (uint32_t(block[4*j+1]) << 16)
+				| (uint32_t(block[4*j+2]) << 8) | uint32_t(block[4*j+3]);
+		for (j=16; j<64; j++)
+		{
+			uint32_t s0 = ROTR32(W[j-15],7) ^ ROTR32(W[j-15],18) ^ (W[j-15] >> 3);
+			uint32_t s1 = ROTR32(W[j-2],17) ^ ROTR32(W[j-2],19) ^ (W[j-2] >> 10);
+			W[j] = W[j-16] + s0 + W[j-7] + s1;
+		}
+
+		a = H[0]; b = H[1]; c = H[2]; d = H[3];
+		e = H[4]; f = H[5]; g = H[6]; h = H[7];
+		for (j=0; j<64; j++)
+		{
+			t1 = h + (ROTR32(e,6) ^ ROTR32(e,11) ^ ROTR32(e,25))
+				+ ((e & f) ^ (~e & g)) + K[j] + W[j];
+			t2 = (ROTR32(a,2) ^ ROTR32(a,13) ^ ROTR32(a,22))
+				+ ((a & b) ^ (a & c) ^ (b & c));
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+		H[0] += a; H[1] += b; H[2] += c; H[3] += d;
+		H[4] += e; H[5] += f; H[6] += g; H[7] += h;
+	}
+#undef ROTR32
+
+	for (j=0; j<8; j++)
+	{
+		digest[4*j] = uint8_t(H[j] >> 24);
+		digest[4*j+1] = uint8_t(H[j] >> 16);
+		digest[4*j+2] = uint8_t(H[j] >> 8);
+		digest[4*j+3] = uint8_t(H[j]);
+	}
+}
+
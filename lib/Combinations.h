@@ -555,5 +555,14 @@ void rationalize(double x, int64_t & n, int64_t & d, int64_t maxd = INT_MAX);
  */
 uint32_t update_crc32(void const * data, size_t len, uint32_t crc);
 
+/**
+ * SHA-256 Prüfsummenberechnung (FIPS 180-4)
+ *
+ * @param data Zeiger auf Daten
+ * @param len Anzahl der Bytes in data
+ * @param digest Speicher für die 32 Bytes der Prüfsumme (out)
+ */
+void sha256(void const * data, size_t len, uint8_t digest[32]);
+
 #endif
 
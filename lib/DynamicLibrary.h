@@ -3,6 +3,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include "Error.h"
 #include "cstringtools.h"
 
@@ -12,7 +13,6 @@ extern "C"
 #include <windows.h>
 #else
 #include <dlfcn.h>
-#include "fexpand.h"
 #endif
 }
 
@@ -72,7 +72,7 @@ public:
 #ifdef P_WIN32
 		lib_name_ = strdup_alloc(lib_name);
 #else
-		lib_name_ = fexpand(lib_name);
+		lib_name_ = strdup(lib_name);
 #endif
 	}
 
@@ -0,0 +1,129 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cmath>
+extern "C"
+{
+#include <stdint.h>
+}
+
+/**
+ * Zähler-basierter Zufallszahlengenerator Philox4x32-10
+ * (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11).
+ * Die Zufallszahlen sind eine reine Funktion von Schlüssel (seed),
+ * Strom-Nummer (z.B. Nummer der Markov-Kette) und Zähler. Damit lassen
+ * sich unabhängige, reproduzierbare Ströme für parallele Threads
+ * erzeugen, ohne einen Zustand zwischen den Threads zu teilen.
+ */
+class Philox4x32
+{
+private:
+	/** Schlüssel (seed) */
+	uint32_t key_[2];
+	/** Zähler; ctr_[2], ctr_[3] enthalten die Strom-Nummer */
+	uint32_t ctr_[4];
+	/** Puffer für den aktuellen Block */
+	uint32_t out_[4];
+	/** Anzahl der verbrauchten Worte in out_ */
+	unsigned int used_;
+	/** zwischengespeicherte zweite Normalverteilte Zahl */
+	double gauss_;
+	/** Ist gauss_ gültig? */
+	bool have_gauss_;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param seed Schlüssel
+	 * @param stream Nummer des Stroms (z.B. Kette / Thread)
+	 */
+	inline Philox4x32(uint64_t seed, uint64_t stream = 0)
+		: used_(4), gauss_(0.), have_gauss_(false)
+	{
+		key_[0] = uint32_t(seed);
+		key_[1] = uint32_t(seed >> 32);
+		ctr_[0] = ctr_[1] = 0;
+		ctr_[2] = uint32_t(stream);
+		ctr_[3] = uint32_t(stream >> 32);
+	}
+
+	/**
+	 * Gibt eine gleichverteilte 32-Bit-Zahl zurück.
+	 *
+	 * @return Zufallszahl
+	 */
+	inline uint32_t next32()
+	{
+		if (used_ == 4)
+		{
+			block();
+			used_ = 0;
+		}
+		return out_[used_++];
+	}
+
+	/**
+	 * Gibt eine gleichverteilte Zahl aus [0,1) mit 53 Bit zurück.
+	 *
+	 * @return Zufallszahl aus [0,1)
+	 */
+	inline double uniform()
+	{
+		uint32_t a = next32() >> 5, b = next32() >> 6;
+		return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+	}
+
+	/**
+	 * Gibt eine standard-normalverteilte Zahl zurück (Box-Muller).
+	 *
+	 * @return Zufallszahl aus N(0,1)
+	 */
+	inline double gauss()
+	{
+		if (have_gauss_)
+		{
+			have_gauss_ = false;
+			return gauss_;
+		}
+		double u1, u2, r;
+		do u1 = uniform(); while (u1 == 0.);
+		u2 = uniform();
+		r = sqrt(-2. * log(u1));
+		gauss_ = r * sin(2. * M_PI * u2);
+		have_gauss_ = true;
+		return r * cos(2. * M_PI * u2);
+	}
+
+private:
+	/**
+	 * Berechnet den nächsten Block von 4 Zufallsworten (10 Runden)
+	 * und inkrementiert den Zähler.
+	 */
+	inline void block()
+	{
+		uint32_t c[4] = { ctr_[0], ctr_[1], ctr_[2], ctr_[3] };
+		uint32_t k[2] = { key_[0], key_[1] };
+		for (int r=0; r<10; r++)
+		{
+			uint64_t p0 = uint64_t(0xD2511F53u) * c[0];
+			uint64_t p1 = uint64_t(0xCD9E8D57u) * c[2];
+			uint32_t hi0 = uint32_t(p0 >> 32), lo0 = uint32_t(p0);
+			uint32_t hi1 = uint32_t(p1 >> 32), lo1 = uint32_t(p1);
+			c[0] = hi1 ^ c[1] ^ k[0];
+			c[1] = lo1;
+			c[2] = hi0 ^ c[3] ^ k[1];
+			c[3] = lo0;
+			k[0] += 0x9E3779B9u;
+			k[1] += 0xBB67AE85u;
+		}
+		out_[0] = c[0]; out_[1] = c[1];
+		out_[2] = c[2]; out_[3] = c[3];
+		if (++ctr_[0] == 0)
+			++ctr_[1];
+	}
+
+}; // class Philox4x32
+
+#endif
+
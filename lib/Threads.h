@@ -0,0 +1,81 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace flux {
+
+/**
+ * Anzahl der Threads für eine parallele Operation. Bei nthreads==0
+ * wird die Anzahl der Prozessorkerne verwendet, aber nur so viele
+ * Threads, dass jeder mindestens min_work Operationen ausführt (der
+ * Start eines Threads lohnt sich sonst nicht). Eine explizite Vorgabe
+ * wird nur durch die Anzahl der Teilaufgaben begrenzt.
+ *
+ * @param nthreads gewünschte Anzahl der Threads (0: automatisch)
+ * @param work Gesamtaufwand (z.B. Anzahl der Multiplikationen)
+ * @param min_work minimaler Aufwand je Thread (nur bei nthreads==0)
+ * @param nparts Anzahl unabhängiger Teilaufgaben
+ * @return Anzahl der Threads, mindestens 1
+ */
+inline unsigned int num_threads(
+	unsigned int nthreads,
+	size_t work,
+	size_t min_work,
+	size_t nparts
+	)
+{
+	if (nthreads == 0)
+	{
+		size_t maxt = min_work ? work / min_work : work;
+		nthreads = std::thread::hardware_concurrency();
+		if (nthreads > maxt)
+			nthreads = maxt;
+	}
+	if (nthreads > nparts)
+		nthreads = nparts;
+	return nthreads ? nthreads : 1;
+}
+
+/**
+ * Führt f(t) für t=0,...,nt-1 parallel aus. f(0) läuft im aufrufenden
+ * Thread, für alle anderen wird ein Thread gestartet; die Funktion
+ * kehrt zurück, sobald alle beendet sind. f darf keine Exceptions
+ * werfen.
+ *
+ * @param nt Anzahl der Threads
+ * @param f Funktion des Thread-Index
+ */
+template< typename F > inline void run_threads(unsigned int nt, F const & f)
+{
+	unsigned int t;
+	std::vector< std::thread > pool;
+	for (t=1; t<nt; t++)
+		pool.push_back(std::thread(f, t));
+	f(0u);
+	for (t=0; t<pool.size(); t++)
+		pool[t].join();
+}
+
+/**
+ * Verteilt den Bereich [0,n) in nt gleich große, zusammenhängende
+ * Teilbereiche auf nt Threads und führt f(i0,i1) für jeden Teilbereich
+ * aus (siehe run_threads).
+ *
+ * @param n Länge des Bereichs
+ * @param nt Anzahl der Threads
+ * @param f Funktion eines Teilbereichs [i0,i1)
+ */
+template< typename F > inline void run_ranges(size_t n, unsigned int nt, F const & f)
+{
+	run_threads(nt, [n,nt,&f](unsigned int t) {
+		f(n*t/nt, n*(t+1)/nt);
+	});
+}
+
+} // namespace flux
+
+#endif
+
@@ -0,0 +1,54 @@
+#ifndef ALIGNEDSTORAGE_H
+#define ALIGNEDSTORAGE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/** Ausrichtung (Bytes) des Elementspeichers arithmetischer Vektoren/Matrizen */
+#define FLUX_STORAGE_ALIGN	64
+
+namespace flux {
+namespace la {
+
+/**
+ * Allokiert den Elementspeicher für GVector/GMatrix. Für arithmetische
+ * Elementtypen wird der Speicher an einer Cache-Line (64 Bytes, eine
+ * AVX-512-Registerbreite) ausgerichtet und nicht initialisiert; alle
+ * anderen Typen werden wie bisher über new[] konstruiert. Für n==0
+ * wird kein Speicher allokiert.
+ *
+ * @param n Anzahl der Elemente
+ * @return Zeiger auf den Speicher (0 für n==0)
+ */
+template< typename T > inline T * storage_alloc(size_t n)
+{
+	if (n == 0)
+		return 0;
+	if constexpr (std::is_arithmetic< T >::value)
+		return static_cast< T * >(::operator new[](
+			n * sizeof(T), std::align_val_t(FLUX_STORAGE_ALIGN)));
+	else
+		return new T[n];
+}
+
+/**
+ * Gibt einen mit storage_alloc allokierten Speicher frei.
+ *
+ * @param p Zeiger auf den Speicher (darf 0 sein)
+ */
+template< typename T > inline void storage_free(T * p)
+{
+	if (p == 0)
+		return;
+	if constexpr (std::is_arithmetic< T >::value)
+		::operator delete[](p, std::align_val_t(FLUX_STORAGE_ALIGN));
+	else
+		delete[] p;
+}
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
@@ -0,0 +1,406 @@
+#include <cstring>
+#include <vector>
+
+#include "fluxml_config.h"
+#include "Error.h"
+#include "BLASWrap.h"
+#include "SIMDKernels.h"
+
+// Fortran-Prototypen
+#define DGEMM_F77	F77_FUNC(dgemm,DGEMM)
+#define DGEMV_F77	F77_FUNC(dgemv,DGEMV)
+#define DAXPY_F77	F77_FUNC(daxpy,DAXPY)
+#define DDOT_F77	F77_FUNC(ddot,DDOT)
+
+extern "C" {
+// DGEMM  performs one of the matrix-matrix operations
+//    C := alpha*op( A )*op( B ) + beta*C,
+// where  op( X ) is one of op( X ) = X   or   op( X ) = X**T,
+// alpha and beta are scalars, and A, B and C are matrices, with op( A )
+// an m by k matrix,  op( B )  a  k by n matrix and  C an m by n matrix.
+void DGEMM_F77(
+	char const * TRANSA,	// CHARACTER*1
+	char const * TRANSB,	// CHARACTER*1
+	int const * M,		// INTEGER
+	int const * N,		// INTEGER
+	int const * K,		// INTEGER
+	double const * ALPHA,	// DOUBLE PRECISION
+	double const * A,	// DOUBLE PRECISION A(LDA,*)
+	int const * LDA,	// INTEGER
+	double const * B,	// DOUBLE PRECISION B(LDB,*)
+	int const * LDB,	// INTEGER
+	double const * BETA,	// DOUBLE PRECISION
+	double * C,		// DOUBLE PRECISION C(LDC,*)
+	int const * LDC		// INTEGER
+	);
+
+// DGEMV  performs one of the matrix-vector operations
+//    y := alpha*A*x + beta*y,   or   y := alpha*A**T*x + beta*y,
+// where alpha and beta are scalars, x and y are vectors and A is an
+// m by n matrix.
+void DGEMV_F77(
+	char const * TRANS,	// CHARACTER*1
+	int const * M,		// INTEGER
+	int const * N,		// INTEGER
+	double const * ALPHA,	// DOUBLE PRECISION
+	double const * A,	// DOUBLE PRECISION A(LDA,*)
+	int const * LDA,	// INTEGER
+	double const * X,	// DOUBLE PRECISION X(*)
+	int const * INCX,	// INTEGER
+	double const * BETA,	// DOUBLE PRECISION
+	double * Y,		// DOUBLE PRECISION Y(*)
+	int const * INCY	// INTEGER
+	);
+
+// DAXPY constant times a vector plus a vector.
+void DAXPY_F77(
+	int const * N,		// INTEGER
+	double const * DA,	// DOUBLE PRECISION
+	double const * DX,	// DOUBLE PRECISION DX(*)
+	int const * INCX,	// INTEGER
+	double * DY,		// DOUBLE PRECISION DY(*)
+	int const * INCY	// INTEGER
+	);
+
+// DDOT forms the dot product of two vectors.
+double DDOT_F77(
+	int const * N,		// INTEGER
+	double const * DX,	// DOUBLE PRECISION DX(*)
+	int const * INCX,	// INTEGER
+	double const * DY,	// DOUBLE PRECISION DY(*)
+	int const * INCY	// INTEGER
+	);
+
+} // extern "C"
+
+namespace flux {
+namespace la {
+namespace blas {
+
+// Mindestgrößen (Anzahl Multiplikationen), ab denen im Modus be_auto
+// BLAS aufgerufen wird; darunter überwiegt der Aufruf-Overhead.
+// (gemessen mit blasbench, OpenBLAS)
+#define BLAS_MIN_GEMM	(8*8*8)
+#define BLAS_MIN_GEMV	(32*32)
+#define BLAS_MIN_VEC	64
+
+// Blockgrößen der in-tree GEMM: Register-Kachel MRxNR, Cache-Blöcke
+// MCxKC (Panel von A, L2) und KCxNC (Panel von B, L3)
+#define GEMM_MR		8
+#define GEMM_NR		4
+#define GEMM_MC		128
+#define GEMM_KC		256
+#define GEMM_NC		2048
+
+static Backend backend_ = be_auto;
+
+void setBackend(Backend be) { backend_ = be; }
+
+Backend getBackend() { return backend_; }
+
+static inline bool use_blas(size_t work, size_t min_work)
+{
+	return backend_ == be_blas
+		or (backend_ == be_auto and work >= min_work);
+}
+
+// Vektor-Kernel der in-tree Implementierung (AVX2/AVX-512 oder skalar)
+static inline double intree_dot(size_t n, double const * x, double const * y)
+{
+	return simd::dot(n, x, y);
+}
+
+static inline void intree_axpy(size_t n, double alpha, double const * x, double * y)
+{
+	simd::axpy(n, alpha, x, y);
+}
+
+/**
+ * Skaliert eine mxn-Matrix mit beta (beta==0: Nullsetzen ohne Lesen).
+ */
+static void scale_matrix(size_t m, size_t n, double beta, double * C, size_t ldc)
+{
+	size_t i, j;
+	if (beta == 1.)
+		return;
+	for (j=0; j<n; j++)
+	{
+		double * c = C + j*ldc;
+		if (beta == 0.)
+			memset(c, 0, m*sizeof(double));
+		else
+			for (i=0; i<m; i++)
+				c[i] *= beta;
+	}
+}
+
+/**
+ * Packt einen mcxkc-Block von op(A) in Panels von MR Zeilen; innerhalb
+ * eines Panels liegen die MR Werte einer Spalte hintereinander.
+ * Fehlende Zeilen des letzten Panels werden mit 0 aufgefüllt.
+ */
+static void pack_A(
+	char transA, double const * A, size_t lda,
+	size_t i0, size_t p0, size_t mc, size_t kc,
+	double * Ap
+	)
+{
+	size_t ip, r, p;
+	for (ip=0; ip<mc; ip+=GEMM_MR)
+	{
+		size_t mr = mc-ip < GEMM_MR ? mc-ip : GEMM_MR;
+		for (p=0; p<kc; p++, Ap+=GEMM_MR)
+		{
+			for (r=0; r<mr; r++)
+				Ap[r] = (transA == 'N')
+					? A[(i0+ip+r) + (p0+p)*lda]
+					: A[(p0+p) + (i0+ip+r)*lda];
+			for (; r<GEMM_MR; r++)
+				Ap[r] = 0.;
+		}
+	}
+}
+
+/**
+ * Packt einen kcxnc-Block von alpha*op(B) in Panels von NR Spalten;
+ * innerhalb eines Panels liegen die NR Werte einer Zeile hintereinander.
+ */
+static void pack_B(
+	char transB, double alpha, double const * B, size_t ldb,
+	size_t p0, size_t j0, size_t kc, size_t nc,
+	double * Bp
+	)
+{
+	size_t jp, c, p;
+	for (jp=0; jp<nc; jp+=GEMM_NR)
+	{
+		size_t nr = nc-jp < GEMM_NR ? nc-jp : GEMM_NR;
+		for (p=0; p<kc; p++, Bp+=GEMM_NR)
+		{
+			for (c=0; c<nr; c++)
+				Bp[c] = alpha * ((transB == 'N')
+					? B[(p0+p) + (j0+jp+c)*ldb]
+					: B[(j0+jp+c) + (p0+p)*ldb]);
+			for (; c<GEMM_NR; c++)
+				Bp[c] = 0.;
+		}
+	}
+}
+
+/**
+ * Mikro-Kernel: C(MRxNR) += Ap(MRxkc) * Bp(kcxNR). Die Kachel von C
+ * wird in Registern akkumuliert; nur mr x nr Werte werden geschrieben.
+ */
+static inline void micro_kernel(
+	size_t kc,
+	double const * __restrict Ap,
+	double const * __restrict Bp,
+	double * C, size_t ldc,
+	size_t mr, size_t nr
+	)
+{
+	double acc[GEMM_NR][GEMM_MR];
+	size_t p, r, c;
+
+	for (c=0; c<GEMM_NR; c++)
+		for (r=0; r<GEMM_MR; r++)
+			acc[c][r] = 0.;
+	for (p=0; p<kc; p++, Ap+=GEMM_MR, Bp+=GEMM_NR)
+		for (c=0; c<GEMM_NR; c++)
+			for (r=0; r<GEMM_MR; r++)
+				acc[c][r] += Ap[r] * Bp[c];
+	for (c=0; c<nr; c++)
+		for (r=0; r<mr; r++)
+			C[r + c*ldc] += acc[c][r];
+}
+
+/**
+ * In-tree GEMM nach dem Schema von Goto/van de Geijn: Blöcke von
+ * op(B) und op(A) werden gepackt (Cache-Lokalität, Transposition),
+ * der Mikro-Kernel rechnet auf Registerkacheln.
+ */
+static void intree_gemm(
+	char transA, char transB,
+	size_t m, size_t n, size_t k,
+	double alpha,
+	double const * A, size_t lda,
+	double const * B, size_t ldb,
+	double beta,
+	double * C, size_t ldc
+	)
+{
+	size_t ic, jc, pc, ip, jp;
+
+	scale_matrix(m, n, beta, C, ldc);
+	if (k == 0 or alpha == 0.)
+		return;
+
+	size_t kc_max = k < GEMM_KC ? k : GEMM_KC;
+	size_t mc_max = m < GEMM_MC ? m : GEMM_MC;
+	size_t nc_max = n < GEMM_NC ? n : GEMM_NC;
+	std::vector< double > Abuf(
+		((mc_max+GEMM_MR-1)/GEMM_MR)*GEMM_MR * kc_max);
+	std::vector< double > Bbuf(
+		((nc_max+GEMM_NR-1)/GEMM_NR)*GEMM_NR * kc_max);
+	double * Ap = Abuf.data();
+	double * Bp = Bbuf.data();
+
+	for (jc=0; jc<n; jc+=GEMM_NC)
+	{
+		size_t nc = n-jc < GEMM_NC ? n-jc : GEMM_NC;
+		for (pc=0; pc<k; pc+=GEMM_KC)
+		{
+			size_t kc = k-pc < GEMM_KC ? k-pc : GEMM_KC;
+			pack_B(transB, alpha, B, ldb, pc, jc, kc, nc, Bp);
+			for (ic=0; ic<m; ic+=GEMM_MC)
+			{
+				size_t mc = m-ic < GEMM_MC ? m-ic : GEMM_MC;
+				pack_A(transA, A, lda, ic, pc, mc, kc, Ap);
+				for (jp=0; jp<nc; jp+=GEMM_NR)
+				{
+					size_t nr = nc-jp < GEMM_NR ? nc-jp : GEMM_NR;
+					for (ip=0; ip<mc; ip+=GEMM_MR)
+					{
+						size_t mr = mc-ip < GEMM_MR ? mc-ip : GEMM_MR;
+						micro_kernel(kc,
+							Ap + ip*kc, Bp + jp*kc,
+							C + (ic+ip) + (jc+jp)*ldc, ldc,
+							mr, nr);
+					}
+				}
+			}
+		}
+	}
+}
+
+static void intree_gemv(
+	char trans,
+	size_t m, size_t n,
+	double alpha,
+	double const * A, size_t lda,
+	double const * x,
+	double beta,
+	double * y
+	)
+{
+	size_t i, j;
+
+	if (trans == 'N')
+	{
+		scale_matrix(m, 1, beta, y, m);
+		if (alpha == 0.)
+			return;
+		// spaltenweise, je vier Spalten pro Durchlauf über y
+		for (j=0; j+4<=n; j+=4)
+		{
+			double const * __restrict a0 = A + j*lda;
+			double const * __restrict a1 = a0 + lda;
+			double const * __restrict a2 = a1 + lda;
+			double const * __restrict a3 = a2 + lda;
+			double x0 = alpha * x[j], x1 = alpha * x[j+1];
+			double x2 = alpha * x[j+2], x3 = alpha * x[j+3];
+			double * __restrict yy = y;
+			for (i=0; i<m; i++)
+				yy[i] += a0[i]*x0 + a1[i]*x1 + a2[i]*x2 + a3[i]*x3;
+		}
+		for (; j<n; j++)
+			intree_axpy(m, alpha * x[j], A + j*lda, y);
+	}
+	else
+	{
+		for (j=0; j<n; j++)
+		{
+			double s = alpha * intree_dot(m, A + j*lda, x);
+			y[j] = (beta == 0.) ? s : s + beta * y[j];
+		}
+	}
+}
+
+void gemm(
+	char transA, char transB,
+	size_t m, size_t n, size_t k,
+	double alpha,
+	double const * A, size_t lda,
+	double const * B, size_t ldb,
+	double beta,
+	double * C, size_t ldc
+	)
+{
+	fASSERT((transA == 'N' or transA == 'T')
+		and (transB == 'N' or transB == 'T'));
+	if (m == 0 or n == 0)
+		return;
+
+	if (use_blas(m*n*k, BLAS_MIN_GEMM))
+	{
+		int M = int(m), N = int(n), K = int(k);
+		int LDA = int(lda), LDB = int(ldb), LDC = int(ldc);
+		// BLAS verlangt LDA,LDB >= 1 auch für leere Operanden
+		if (LDA < 1) LDA = 1;
+		if (LDB < 1) LDB = 1;
+		DGEMM_F77(&transA, &transB, &M, &N, &K, &alpha,
+			A, &LDA, B, &LDB, &beta, C, &LDC);
+		return;
+	}
+	intree_gemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void gemv(
+	char trans,
+	size_t m, size_t n,
+	double alpha,
+	double const * A, size_t lda,
+	double const * x,
+	double beta,
+	double * y
+	)
+{
+	fASSERT(trans == 'N' or trans == 'T');
+	if ((trans == 'N' and m == 0) or (trans == 'T' and n == 0))
+		return;
+	if (m == 0 or n == 0)
+	{
+		// leeres Produkt: nur y skalieren
+		scale_matrix(trans == 'N' ? m : n, 1, beta, y, 1);
+		return;
+	}
+
+	if (use_blas(m*n, BLAS_MIN_GEMV))
+	{
+		int M = int(m), N = int(n), LDA = int(lda), INC = 1;
+		DGEMV_F77(&trans, &M, &N, &alpha, A, &LDA, x, &INC,
+			&beta, y, &INC);
+		return;
+	}
+	intree_gemv(trans, m, n, alpha, A, lda, x, beta, y);
+}
+
+void axpy(size_t n, double alpha, double const * x, double * y)
+{
+	if (n == 0 or alpha == 0.)
+		return;
+	if (use_blas(n, BLAS_MIN_VEC))
+	{
+		int N = int(n), INC = 1;
+		DAXPY_F77(&N, &alpha, x, &INC, y, &INC);
+		return;
+	}
+	intree_axpy(n, alpha, x, y);
+}
+
+double dot(size_t n, double const * x, double const * y)
+{
+	if (n == 0)
+		return 0.;
+	if (use_blas(n, BLAS_MIN_VEC))
+	{
+		int N = int(n), INC = 1;
+		return DDOT_F77(&N, x, &INC, y, &INC);
+	}
+	return intree_dot(n, x, y);
+}
+
+} // namespace flux::la::blas
+} // namespace flux::la
+} // namespace flux
+
@@ -0,0 +1,116 @@
+#ifndef BLASWRAP_H
+#define BLASWRAP_H
+
+#include <cstddef>
+
+namespace flux {
+namespace la {
+namespace blas {
+
+/**
+ * Auswahl der Implementierung der dichten Kernel.
+ */
+enum Backend
+{
+	be_auto,	// BLAS ab einer Mindestgröße, sonst in-tree
+	be_blas,	// immer BLAS (DGEMM, DGEMV, DAXPY, DDOT)
+	be_intree	// immer die geblockte in-tree Implementierung
+};
+
+/**
+ * Setzt die Implementierung der dichten Kernel. Die Einstellung gilt
+ * global und sollte nicht umgeschaltet werden, während andere Threads
+ * rechnen (gedacht für Benchmarks und Vergleichstests).
+ *
+ * @param be be_auto, be_blas oder be_intree
+ */
+void setBackend(Backend be);
+
+/**
+ * Gibt die eingestellte Implementierung der dichten Kernel zurück.
+ *
+ * @return be_auto, be_blas oder be_intree
+ */
+Backend getBackend();
+
+/**
+ * Matrix-Matrix-Produkt C = alpha*op(A)*op(B) + beta*C (DGEMM) auf
+ * spaltenweise (Fortran-Ordnung) gespeicherten Matrizen. op(X) ist X
+ * für trans='N' und X^T für trans='T'. Für beta==0 wird C vorher
+ * nicht gelesen.
+ *
+ * @param transA 'N' oder 'T'
+ * @param transB 'N' oder 'T'
+ * @param m Zeilen von op(A) und C
+ * @param n Spalten von op(B) und C
+ * @param k Spalten von op(A) bzw. Zeilen von op(B)
+ * @param alpha Faktor des Produkts
+ * @param A Matrix A
+ * @param lda führende Dimension von A
+ * @param B Matrix B
+ * @param ldb führende Dimension von B
+ * @param beta Faktor von C
+ * @param C Ergebnis-Matrix (in/out)
+ * @param ldc führende Dimension von C
+ */
+void gemm(
+	char transA, char transB,
+	size_t m, size_t n, size_t k,
+	double alpha,
+	double const * A, size_t lda,
+	double const * B, size_t ldb,
+	double beta,
+	double * C, size_t ldc
+	);
+
+/**
+ * Matrix-Vektor-Produkt y = alpha*op(A)*x + beta*y (DGEMV) auf einer
+ * spaltenweise gespeicherten mxn-Matrix A. Für beta==0 wird y vorher
+ * nicht gelesen.
+ *
+ * @param trans 'N' oder 'T'
+ * @param m Zeilen von A
+ * @param n Spalten von A
+ * @param alpha Faktor des Produkts
+ * @param A Matrix A
+ * @param lda führende Dimension von A
+ * @param x Vektor x (Länge n bzw. m für trans='T')
+ * @param beta Faktor von y
+ * @param y Ergebnis-Vektor (Länge m bzw. n für trans='T') (in/out)
+ */
+void gemv(
+	char trans,
+	size_t m, size_t n,
+	double alpha,
+	double const * A, size_t lda,
+	double const * x,
+	double beta,
+	double * y
+	);
+
+/**
+ * Vektor-Update y = alpha*x + y (DAXPY).
+ *
+ * @param n Länge der Vektoren
+ * @param alpha Faktor
+ * @param x Vektor x
+ * @param y Vektor y (in/out)
+ */
+void axpy(size_t n, double alpha, double const * x, double * y);
+
+/**
+ * Skalarprodukt x^T*y (DDOT).
+ *
+ * @param n Länge der Vektoren
+ * @param x Vektor x
+ * @param y Vektor y
+ * @return Skalarprodukt
+ */
+double dot(size_t n, double const * x, double const * y);
+
+} // namespace flux::la::blas
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
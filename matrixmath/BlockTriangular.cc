@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+#include "Error.h"
+#include "MMatrix.h"
+#include "MVector.h"
+#include "CSMatrix.h"
+#include "LAPackWrap.h"
+#include "BlockTriangular.h"
+
+namespace flux {
+namespace la {
+
+// "kein Index"
+#define BT_NONE	size_t(-1)
+
+namespace {
+
+/**
+ * Sucht einen augmentierenden Pfad ab Spalte k (Tiefensuche ohne
+ * Rekursion, vgl. MC21 bzw. CSparse cs_augment).
+ *
+ * @param k Startspalte
+ * @param Ap,Ai Muster von A (CSC)
+ * @param jmatch Spalte je Zeile (BT_NONE: ungematcht)
+ * @param cheap je Spalte: nächste Position für die billige Zuordnung
+ * @param w Markierung der besuchten Spalten
+ * @param js,is,ps Stapel
+ */
+void augment(
+	size_t k,
+	size_t const * Ap,
+	size_t const * Ai,
+	std::vector< size_t > & jmatch,
+	std::vector< size_t > & cheap,
+	std::vector< size_t > & w,
+	std::vector< size_t > & js,
+	std::vector< size_t > & is,
+	std::vector< size_t > & ps
+	)
+{
+	bool found = false;
+	size_t i = BT_NONE, j, p;
+	std::ptrdiff_t head = 0;
+
+	js[0] = k;
+	while (head >= 0)
+	{
+		j = js[head];
+		if (w[j] != k)
+		{
+			// erster Besuch: billige Zuordnung versuchen
+			w[j] = k;
+			for (p=cheap[j]; p<Ap[j+1] and not found; p++)
+			{
+				i = Ai[p];
+				found = (jmatch[i] == BT_NONE);
+			}
+			cheap[j] = p;
+			if (found)
+			{
+				is[head] = i;
+				break;
+			}
+			ps[head] = Ap[j];
+		}
+		// Tiefensuche über gematchte Zeilen
+		for (p=ps[head]; p<Ap[j+1]; p++)
+		{
+			i = Ai[p];
+			if (w[jmatch[i]] == k)
+				continue;
+			ps[head] = p+1;
+			is[head] = i;
+			js[++head] = jmatch[i];
+			break;
+		}
+		if (p == Ap[j+1])
+			head--;
+	}
+	if (found)
+		for (; head >= 0; head--)
+			jmatch[is[head]] = js[head];
+}
+
+} // namespace
+
+BlockTriangular::BlockTriangular(CSMatrix const & A)
+	: n_(A.rows()), srank_(0)
+{
+	fASSERT(A.rows() == A.cols());
+	size_t i, j, k, p, n = n_;
+	CSMatrix C = A.convert(CSMatrix::csc);
+	CSMatrix R = A.convert(CSMatrix::csr);
+
+	// maximales Matching: jmatch[i] = Spalte von Zeile i
+	std::vector< size_t > jmatch(n, BT_NONE), imatch(n, BT_NONE);
+	{
+		std::vector< size_t > cheap(C.ptr(), C.ptr()+n), w(n, BT_NONE);
+		std::vector< size_t > js(n), is(n), ps(n);
+		for (k=0; k<n; k++)
+			augment(k, C.ptr(), C.idx(), jmatch, cheap, w, js, is, ps);
+	}
+	for (i=0; i<n; i++)
+		if (jmatch[i] != BT_NONE)
+		{
+			imatch[jmatch[i]] = i;
+			srank_++;
+		}
+	// strukturell singulär: Rest beliebig zuordnen (Null auf der Diagonale)
+	for (i=0,j=0; j<n; j++)
+		if (imatch[j] == BT_NONE)
+		{
+			while (jmatch[i] != BT_NONE)
+				i++;
+			jmatch[i] = j;
+			imatch[j] = i;
+		}
+
+	// starke Zusammenhangskomponenten (Tarjan, ohne Rekursion) des
+	// Graphen j -> k für A(imatch[j],k) != 0
+	size_t const * Rp = R.ptr();
+	size_t const * Ri = R.idx();
+	std::vector< size_t > index(n, BT_NONE), low(n), pos(n), cstk(n);
+	std::vector< size_t > S, emitted, bnd;
+	std::vector< char > onstack(n, 0);
+	size_t counter = 0, v, u;
+	std::ptrdiff_t head;
+
+	S.reserve(n);
+	emitted.reserve(n);
+	bnd.push_back(0);
+	for (k=0; k<n; k++)
+	{
+		if (index[k] != BT_NONE)
+			continue;
+		head = 0;
+		cstk[0] = k;
+		while (head >= 0)
+		{
+			v = cstk[head];
+			if (index[v] == BT_NONE)
+			{
+				index[v] = low[v] = counter++;
+				S.push_back(v);
+				onstack[v] = 1;
+				pos[v] = Rp[imatch[v]];
+			}
+			bool descend = false;
+			for (p=pos[v]; p<Rp[imatch[v]+1]; p++)
+			{
+				u = Ri[p];
+				if (index[u] == BT_NONE)
+				{
+					pos[v] = p+1;
+					cstk[++head] = u;
+					descend = true;
+					break;
+				}
+				if (onstack[u])
+					low[v] = std::min(low[v], index[u]);
+			}
+			if (descend)
+				continue;
+			pos[v] = p;
+
+			// v fertig: Wurzel einer Komponente?
+			if (low[v] == index[v])
+			{
+				do {
+					u = S.back();
+					S.pop_back();
+					onstack[u] = 0;
+					emitted.push_back(u);
+				} while (u != v);
+				bnd.push_back(emitted.size());
+			}
+			head--;
+			if (head >= 0)
+			{
+				u = cstk[head];
+				low[u] = std::min(low[u], low[v]);
+			}
+		}
+	}
+
+	// Tarjan liefert Komponenten nach ihren Abhängigkeiten; für die
+	// obere Block-Dreiecksform wird die Reihenfolge umgekehrt
+	size_t nb = bnd.size()-1;
+	q_.resize(n);
+	p_.resize(n);
+	r_.resize(nb+1);
+	for (j=0,k=nb; k>0; k--)
+	{
+		r_[nb-k] = j;
+		for (p=bnd[k-1]; p<bnd[k]; p++)
+			q_[j++] = emitted[p];
+	}
+	r_[nb] = n;
+	for (j=0; j<n; j++)
+		p_[j] = imatch[q_[j]];
+}
+
+size_t BlockTriangular::maxBlockSize() const
+{
+	size_t k, m = 0;
+	for (k=0; k<blocks(); k++)
+		m = std::max(m, blockSize(k));
+	return m;
+}
+
+CSMatrix BlockTriangular::permute(CSMatrix const & A) const
+{
+	fASSERT(A.rows() == n_ and A.cols() == n_);
+	size_t i, k, p, n = n_;
+	std::vector< size_t > pinv(n), qinv(n);
+	for (k=0; k<n; k++)
+	{
+		pinv[p_[k]] = k;
+		qinv[q_[k]] = k;
+	}
+
+	// major-Elemente in neuer Reihenfolge, minor-Indizes umbenannt
+	bool csr = A.format() == CSMatrix::csr;
+	std::vector< size_t > const & perm = csr ? p_ : q_;
+	std::vector< size_t > const & minv = csr ? qinv : pinv;
+	GVector< size_t > ptr(n+1), idx(A.nnz());
+	MVector val(A.nnz());
+	std::vector< std::pair< size_t,double > > tmp;
+	ptr(0) = 0;
+	for (i=0,k=0; k<n; k++)
+	{
+		size_t m = perm[k];
+		tmp.clear();
+		for (p=A.ptr()[m]; p<A.ptr()[m+1]; p++)
+			tmp.push_back(std::make_pair(minv[A.idx()[p]], A.val()[p]));
+		std::sort(tmp.begin(), tmp.end());
+		for (p=0; p<tmp.size(); p++,i++)
+		{
+			idx(i) = tmp[p].first;
+			val(i) = tmp[p].second;
+		}
+		ptr(k+1) = i;
+	}
+	return CSMatrix(n, n, A.format(), std::move(ptr), std::move(idx),
+		std::move(val));
+}
+
+bool BlockTriangular::solve(CSMatrix const & A, MVector & b) const
+{
+	fASSERT(A.rows() == n_ and A.cols() == n_ and b.dim() == n_);
+	size_t i, j, k, p, nb = blocks();
+	CSMatrix R = permute(A.convert(CSMatrix::csr));
+	size_t const * Rp = R.ptr();
+	size_t const * Ri = R.idx();
+	double const * Rx = R.val();
+	MVector x(n_);
+
+	// von hinten nach vorne: Block k koppelt nur an Blöcke > k
+	for (k=nb; k>0; k--)
+	{
+		size_t r0 = r_[k-1], r1 = r_[k], m = r1-r0;
+
+		if (m == 1)
+		{
+			double s = b.get(p_[r0]), d = 0.;
+			for (p=Rp[r0]; p<Rp[r0+1]; p++)
+				if (Ri[p] == r0)
+					d = Rx[p];
+				else
+					s -= Rx[p] * x.get(Ri[p]);
+			if (d == 0. or not std::isfinite(s / d))
+				return false;
+			x(r0) = s / d;
+			continue;
+		}
+
+		MMatrix B(m, m);
+		MVector s(m);
+		for (i=r0; i<r1; i++)
+		{
+			s(i-r0) = b.get(p_[i]);
+			for (p=Rp[i]; p<Rp[i+1]; p++)
+			{
+				j = Ri[p];
+				if (j < r1)
+					B(i-r0,j-r0) = Rx[p];
+				else
+					s(i-r0) -= Rx[p] * x.get(j);
+			}
+		}
+		if (not lapack::linsolve(B, s))
+			return false;
+		for (i=r0; i<r1; i++)
+			x(i) = s.get(i-r0);
+	}
+
+	for (j=0; j<n_; j++)
+		b(q_[j]) = x.get(j);
+	return true;
+}
+
+void BlockTriangular::dump(FILE * outf) const
+{
+	size_t k, j;
+	fprintf(outf, "BlockTriangular: dim=%lu, srank=%lu, blocks=%lu, max=%lu\n",
+		(unsigned long)n_, (unsigned long)srank_,
+		(unsigned long)blocks(), (unsigned long)maxBlockSize());
+	for (k=0; k<blocks(); k++)
+	{
+		fprintf(outf, "  block %lu:", (unsigned long)k);
+		for (j=r_[k]; j<r_[k+1]; j++)
+			fprintf(outf, " (%lu,%lu)", (unsigned long)p_[j],
+				(unsigned long)q_[j]);
+		fprintf(outf, "\n");
+	}
+}
+
+} // namespace flux::la
+} // namespace flux
+
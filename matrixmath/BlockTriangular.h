@@ -0,0 +1,110 @@
+#ifndef BLOCKTRIANGULAR_H
+#define BLOCKTRIANGULAR_H
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "CSMatrix.h"
+
+namespace flux {
+namespace la {
+
+class MVector;
+
+/**
+ * Klasse BlockTriangular -- Block-Dreieckszerlegung einer quadratischen,
+ * dünn besetzten Matrix (feine Dulmage-Mendelsohn-Zerlegung).
+ *
+ * Zunächst wird über ein maximales Matching (Transversale, vgl. MC21)
+ * eine Zeilenpermutation mit nullfreier Diagonale bestimmt; danach
+ * liefern die starken Zusammenhangskomponenten (Tarjan) des Graphen
+ * "Variable j hängt von Variable k ab, falls A(match(j),k) != 0" die
+ * Diagonalblöcke. A(P,Q) ist dann block-obere-Dreiecksmatrix:
+ *
+ *  Zeilen/Spalten von Block k: r(k) .. r(k+1)-1,
+ *  Block k koppelt nur an Variablen der Blöcke >= k.
+ *
+ * Ein Gleichungssystem zerfällt damit in eine Folge kleiner Systeme,
+ * die von hinten nach vorne gelöst werden. Bei Stoffwechselnetzwerken
+ * sind die meisten Blöcke 1x1.
+ */
+class BlockTriangular
+{
+private:
+	/** Dimension */
+	size_t n_;
+	/** Zeilenpermutation: neue Zeile k ist Zeile p_[k] von A */
+	std::vector< size_t > p_;
+	/** Spaltenpermutation: neue Spalte k ist Spalte q_[k] von A */
+	std::vector< size_t > q_;
+	/** Blockgrenzen (Anzahl Blöcke + 1) */
+	std::vector< size_t > r_;
+	/** strukturelle Rang (Größe des maximalen Matchings) */
+	size_t srank_;
+
+public:
+	/**
+	 * Constructor. Berechnet die Zerlegung aus dem Muster von A; die
+	 * Werte werden nicht verwendet.
+	 *
+	 * @param A quadratische Matrix
+	 */
+	BlockTriangular(CSMatrix const & A);
+
+	/** @return Dimension */
+	inline size_t dim() const { return n_; }
+
+	/** @return Anzahl der Diagonalblöcke */
+	inline size_t blocks() const { return r_.size()-1; }
+
+	/** @return erste Zeile/Spalte von Block k in A(P,Q) */
+	inline size_t blockStart(size_t k) const { return r_[k]; }
+
+	/** @return Größe von Block k */
+	inline size_t blockSize(size_t k) const { return r_[k+1]-r_[k]; }
+
+	/** @return Größe des größten Blocks */
+	size_t maxBlockSize() const;
+
+	/** @return struktureller Rang von A */
+	inline size_t structuralRank() const { return srank_; }
+
+	/** @return true, falls A strukturell singulär ist */
+	inline bool isStructurallySingular() const { return srank_ < n_; }
+
+	/** @return Zeilenpermutation (neue Zeile -> Zeile von A) */
+	inline std::vector< size_t > const & getRowPerm() const { return p_; }
+
+	/** @return Spaltenpermutation (neue Spalte -> Spalte von A) */
+	inline std::vector< size_t > const & getColPerm() const { return q_; }
+
+	/**
+	 * Permutiert eine Matrix mit dem Muster von A.
+	 *
+	 * @param A Matrix
+	 * @return A(P,Q) im Format von A
+	 */
+	CSMatrix permute(CSMatrix const & A) const;
+
+	/**
+	 * Löst A*x = b blockweise (Rückwärtseinsetzen über die Blöcke;
+	 * 1x1-Blöcke direkt, größere Blöcke dicht per LU).
+	 *
+	 * @param A Matrix mit dem Muster der Zerlegung
+	 * @param b rechte Seite; wird mit der Lösung überschrieben
+	 * @return false, falls ein Diagonalblock singulär ist
+	 */
+	bool solve(CSMatrix const & A, MVector & b) const;
+
+	/**
+	 * Debugging: Blockstruktur ausgeben.
+	 */
+	void dump(FILE * outf = stdout) const;
+
+}; // class BlockTriangular
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
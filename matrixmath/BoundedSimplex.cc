@@ -0,0 +1,362 @@
+#include <cmath>
+#include <limits>
+#include "BoundedSimplex.h"
+
+namespace flux {
+namespace la {
+
+BoundedSimplex::BoundedSimplex(
+	MatrixInterface< double > const & A,
+	MVector const & b,
+	MVector const & lo,
+	MVector const & up
+	) : m_(A.rows()), n_(A.cols()), N_(A.cols()+2*A.rows()),
+	    A_(A.rows(),A.cols()), b_(b), T_(A.rows(),A.cols()+2*A.rows()),
+	    lo_(N_), up_(N_), x_(N_), c_(N_), d_(N_), obj_sign_(1.),
+	    basis_(A.rows()), row_of_(N_,-1l),
+	    phase1_done_(false), phase1_status_(lp_infeasible),
+	    max_iter_(0), tol_(1e-9)
+{
+	size_t i,j;
+	double const inf = std::numeric_limits< double >::infinity();
+
+	fASSERT(b.dim() == m_ and lo.dim() == n_ and up.dim() == n_);
+
+	for (j=0; j<n_; j++)
+		for (i=0; i<m_; i++)
+			A_(i,j) = A.get(i,j);
+
+	// Strukturelle Variablen: Start auf einer endlichen Schranke
+	for (j=0; j<n_; j++)
+	{
+		lo_(j) = lo.get(j);
+		up_(j) = up.get(j);
+		fASSERT(lo_(j) <= up_(j));
+		if (not std::isinf(lo_(j)))
+			x_(j) = lo_(j);
+		else if (not std::isinf(up_(j)))
+			x_(j) = up_(j);
+		else
+			x_(j) = 0.;
+	}
+
+	// Schlupf- und künstliche Variablen
+	for (i=0; i<m_; i++)
+	{
+		size_t s = n_+i, a = n_+m_+i;
+		double si = b_(i);
+		for (j=0; j<n_; j++)
+			si -= A_(i,j) * x_(j);
+
+		lo_(s) = 0.;
+		up_(s) = inf;
+		lo_(a) = 0.;
+
+		if (si >= 0.)
+		{
+			// Schlupfvariable ist zulässige Basisvariable
+			for (j=0; j<n_; j++)
+				T_(i,j) = A_(i,j);
+			T_(i,s) = 1.;
+			T_(i,a) = -1.;
+			x_(s) = si;
+			x_(a) = 0.;
+			up_(a) = 0.;
+			basis_(i) = s;
+			row_of_(s) = i;
+		}
+		else
+		{
+			// künstliche Variable übernimmt die Zeile
+			for (j=0; j<n_; j++)
+				T_(i,j) = -A_(i,j);
+			T_(i,s) = -1.;
+			T_(i,a) = 1.;
+			x_(s) = 0.;
+			x_(a) = -si;
+			up_(a) = inf;
+			basis_(i) = a;
+			row_of_(a) = i;
+		}
+	}
+	max_iter_ = 50 * (m_ + N_) + 1000;
+}
+
+void BoundedSimplex::price()
+{
+	size_t i,j;
+	for (j=0; j<N_; j++)
+	{
+		if (row_of_(j) >= 0)
+		{
+			d_(j) = 0.;
+			continue;
+		}
+		double dj = c_(j);
+		for (i=0; i<m_; i++)
+			dj -= c_(basis_(i)) * T_(i,j);
+		d_(j) = dj;
+	}
+}
+
+void BoundedSimplex::refresh()
+{
+	size_t i,j,k;
+	MVector rhs(b_);
+
+	// rhs = b - [A I -I]_N*x_N
+	for (j=0; j<N_; j++)
+	{
+		if (row_of_(j) >= 0 or x_(j) == 0.)
+			continue;
+		if (j < n_)
+			for (i=0; i<m_; i++)
+				rhs(i) -= A_(i,j) * x_(j);
+		else if (j < n_+m_)
+			rhs(j-n_) -= x_(j);
+		else
+			rhs(j-n_-m_) += x_(j);
+	}
+
+	// x_B = B^-1*rhs; B^-1 steht in den Spalten der Schlupfvariablen
+	for (i=0; i<m_; i++)
+	{
+		double v = 0.;
+		for (k=0; k<m_; k++)
+			v += T_(i,n_+k) * rhs(k);
+		x_(basis_(i)) = v;
+	}
+}
+
+void BoundedSimplex::pivot(size_t r, size_t q)
+{
+	size_t i,j;
+	double * T = T_;
+	double piv = T_(r,q);
+	double dq = d_(q);
+
+	fASSERT(piv != 0.);
+
+	// Multiplikatoren der Spalte q sichern
+	MVector f(m_);
+	for (i=0; i<m_; i++)
+		f(i) = T_(i,q) / piv;
+
+	// Zeilenoperationen spaltenweise (Fortran-Ordnung)
+	for (j=0; j<N_; j++)
+	{
+		double * tj = T + j*m_;
+		double trj = tj[r];
+		if (trj == 0.)
+			continue;
+		for (i=0; i<m_; i++)
+			if (i != r)
+				tj[i] -= f(i) * trj;
+		tj[r] = trj / piv;
+		d_(j) -= dq * tj[r];
+	}
+	// numerisch saubere Pivot-Spalte
+	for (i=0; i<m_; i++)
+		T_(i,q) = (i == r) ? 1. : 0.;
+	d_(q) = 0.;
+
+	row_of_(basis_(r)) = -1;
+	basis_(r) = q;
+	row_of_(q) = r;
+}
+
+BoundedSimplex::Status BoundedSimplex::iterate()
+{
+	size_t i,j,iter,q,r;
+	int dir;
+	long degenerate = 0;
+	double const inf = std::numeric_limits< double >::infinity();
+	double const piv_tol = 1e-11;
+
+	for (iter=0; iter<max_iter_; iter++)
+	{
+		// eintretende Variable: Dantzig, bei anhaltender
+		// Degeneriertheit Bland (kleinster Index)
+		bool bland = degenerate > long(m_ + 10);
+		double best = 0.;
+		q = N_;
+		dir = 0;
+		for (j=0; j<N_; j++)
+		{
+			if (row_of_(j) >= 0 or lo_(j) == up_(j))
+				continue;
+			double dj = d_(j);
+			int dj_dir = 0;
+			if (dj > tol_ and x_(j) < up_(j))
+				dj_dir = 1;
+			else if (dj < -tol_ and x_(j) > lo_(j))
+				dj_dir = -1;
+			if (dj_dir == 0)
+				continue;
+			if (fabs(dj) > best)
+			{
+				best = fabs(dj);
+				q = j;
+				dir = dj_dir;
+				if (bland)
+					break;
+			}
+		}
+		if (q == N_)
+			return lp_optimal;
+
+		// Quotiententest; Schranken-Tausch der eintretenden Variable
+		double theta = up_(q) - lo_(q);
+		double best_piv = 0.;
+		bool to_lower = false;
+		r = m_;
+		for (i=0; i<m_; i++)
+		{
+			double alpha = -dir * T_(i,q);
+			if (fabs(alpha) <= piv_tol)
+				continue;
+			size_t bi = basis_(i);
+			double ti;
+			bool tl;
+			if (alpha < 0.)
+			{
+				if (std::isinf(lo_(bi))) continue;
+				ti = (x_(bi) - lo_(bi)) / -alpha;
+				tl = true;
+			}
+			else
+			{
+				if (std::isinf(up_(bi))) continue;
+				ti = (up_(bi) - x_(bi)) / alpha;
+				tl = false;
+			}
+			if (ti < 0.)
+				ti = 0.;
+			if (ti < theta or (ti == theta and r < m_
+				and fabs(alpha) > best_piv))
+			{
+				theta = ti;
+				r = i;
+				best_piv = fabs(alpha);
+				to_lower = tl;
+			}
+		}
+
+		if (theta == inf)
+			return lp_unbounded;
+
+		degenerate = (theta == 0.) ? degenerate+1 : 0;
+
+		// Werte aktualisieren
+		x_(q) += dir * theta;
+		for (i=0; i<m_; i++)
+			x_(basis_(i)) -= dir * theta * T_(i,q);
+
+		if (r == m_)
+		{
+			// nur Schranken-Tausch; die Basis bleibt
+			x_(q) = (dir > 0) ? up_(q) : lo_(q);
+			continue;
+		}
+
+		size_t leaving = basis_(r);
+		pivot(r,q);
+		x_(leaving) = to_lower ? lo_(leaving) : up_(leaving);
+	}
+	fWARNING("simplex iteration limit (%d) reached", int(max_iter_));
+	return lp_iterlimit;
+}
+
+BoundedSimplex::Status BoundedSimplex::phase1()
+{
+	size_t i,j;
+	double infeas, bmax = 1.;
+
+	if (phase1_done_)
+		return phase1_status_;
+
+	// Zielfunktion: max -sum(künstliche Variablen)
+	for (j=0; j<N_; j++)
+		c_(j) = (j >= n_+m_) ? -1. : 0.;
+	price();
+	Status st = iterate();
+	refresh();
+
+	for (infeas=0.,i=0; i<m_; i++)
+	{
+		infeas += x_(n_+m_+i);
+		if (fabs(b_(i)) > bmax)
+			bmax = fabs(b_(i));
+	}
+
+	phase1_done_ = true;
+	if (st == lp_iterlimit)
+		phase1_status_ = lp_iterlimit;
+	else if (infeas > 1e3 * tol_ * bmax)
+		phase1_status_ = lp_infeasible;
+	else
+		phase1_status_ = lp_optimal;
+
+	// künstliche Variablen ab jetzt auf 0 fixieren
+	for (i=0; i<m_; i++)
+	{
+		size_t a = n_+m_+i;
+		up_(a) = 0.;
+		if (row_of_(a) < 0)
+			x_(a) = 0.;
+	}
+	return phase1_status_;
+}
+
+BoundedSimplex::Status BoundedSimplex::findFeasible()
+{
+	return phase1();
+}
+
+BoundedSimplex::Status BoundedSimplex::maximize(MVector const & c)
+{
+	size_t j;
+	fASSERT(c.dim() == n_);
+
+	Status st = phase1();
+	if (st != lp_optimal)
+		return st;
+
+	for (j=0; j<N_; j++)
+		c_(j) = (j < n_) ? c.get(j) : 0.;
+	obj_sign_ = 1.;
+	price();
+	st = iterate();
+	refresh();
+	return st;
+}
+
+BoundedSimplex::Status BoundedSimplex::minimize(MVector const & c)
+{
+	MVector mc(c);
+	for (size_t j=0; j<mc.dim(); j++)
+		mc(j) = -mc(j);
+	Status st = maximize(mc);
+	obj_sign_ = -1.;
+	return st;
+}
+
+MVector BoundedSimplex::getSolution() const
+{
+	MVector x(n_);
+	for (size_t j=0; j<n_; j++)
+		x(j) = x_.get(j);
+	return x;
+}
+
+double BoundedSimplex::getObjective() const
+{
+	double obj = 0.;
+	for (size_t j=0; j<n_; j++)
+		obj += c_.get(j) * x_.get(j);
+	return obj_sign_ * obj;
+}
+
+} // namespace flux::la
+} // namespace flux
+
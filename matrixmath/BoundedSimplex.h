@@ -0,0 +1,218 @@
+#ifndef BOUNDEDSIMPLEX_H
+#define BOUNDEDSIMPLEX_H
+
+#include <cstddef>
+#include "Error.h"
+#include "MatrixInterface.h"
+#include "GVector.h"
+#include "MMatrix.h"
+#include "MVector.h"
+
+namespace flux {
+namespace la {
+
+/**
+ * Primaler Simplex-Algorithmus für beschränkte Variablen.
+ * Gelöst wird das lineare Programm
+ *
+ *   max c^T*x  u.d.N.  A*x <= b,  lo <= x <= up,
+ *
+ * wobei die Schranken lo, up unendlich sein dürfen (freie Variablen).
+ * Zu jeder Zeile von A wird eine Schlupfvariable eingeführt; eine
+ * unzulässige Startbasis wird in Phase 1 über künstliche Variablen
+ * repariert. Nach dem ersten Lösen bleibt die (zulässige) Basis
+ * erhalten, so dass weitere Zielfunktionen ohne Phase 1 und ausgehend
+ * von der letzten optimalen Basis gelöst werden (warm start).
+ *
+ * Die Implementierung arbeitet auf einem dichten Tableau und ist für
+ * die kleinen bis mittelgroßen Systeme aus den Ungleichungen der freien
+ * Flüsse gedacht. Bei m Zeilen und n Variablen belegen Tableau und
+ * Constraint-Matrix m*(2n+2m) doubles; Aufrufer prüfen die Größe vorab
+ * mit fitsTableau.
+ */
+class BoundedSimplex
+{
+public:
+	/** Ergebnis eines Simplex-Laufs */
+	enum Status
+	{
+		lp_optimal,	// optimale Lösung gefunden
+		lp_infeasible,	// das System A*x<=b, lo<=x<=up ist leer
+		lp_unbounded,	// die Zielfunktion ist unbeschränkt
+		lp_iterlimit	// Iterationslimit erreicht
+	};
+
+	/** Maximale Anzahl von doubles in Tableau und Constraint-Matrix (1 GiB) */
+	static size_t const max_tableau_size = size_t(1) << 27;
+
+private:
+	/** Anzahl der Zeilen (Ungleichungen) */
+	size_t m_;
+	/** Anzahl der strukturellen Variablen */
+	size_t n_;
+	/** Gesamtzahl der Variablen: n_ + m_ Schlupf + m_ künstliche */
+	size_t N_;
+	/** Constraint-Matrix A (dicht, für die Neuberechnung von x_B) */
+	MMatrix A_;
+	/** Rechte Seite b */
+	MVector b_;
+	/** Tableau B^-1*[A I -I] */
+	MMatrix T_;
+	/** Untere Schranken aller Variablen */
+	MVector lo_;
+	/** Obere Schranken aller Variablen */
+	MVector up_;
+	/** Werte aller Variablen */
+	MVector x_;
+	/** Kostenvektor der aktuellen Phase */
+	MVector c_;
+	/** Reduzierte Kosten */
+	MVector d_;
+	/** Vorzeichen der Zielfunktion (-1 bei Minimierung) */
+	double obj_sign_;
+	/** Basisvariable der Zeile i */
+	GVector< size_t > basis_;
+	/** Zeile einer Basisvariable oder -1 */
+	GVector< long > row_of_;
+	/** Wurde Phase 1 bereits durchlaufen? */
+	bool phase1_done_;
+	/** Ergebnis von Phase 1 */
+	Status phase1_status_;
+	/** Maximale Anzahl von Iterationen pro Lauf */
+	size_t max_iter_;
+	/** Toleranz für Zulässigkeit und reduzierte Kosten */
+	double tol_;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param A Constraint-Matrix (dicht oder dünnbesetzt)
+	 * @param b rechte Seite
+	 * @param lo untere Schranken der Variablen (-inf erlaubt)
+	 * @param up obere Schranken der Variablen (+inf erlaubt)
+	 */
+	BoundedSimplex(
+		MatrixInterface< double > const & A,
+		MVector const & b,
+		MVector const & lo,
+		MVector const & up
+		);
+
+	/**
+	 * Prüft, ob das dichte Tableau eines LPs mit m Zeilen und n
+	 * Variablen die Obergrenze max_tableau_size nicht überschreitet.
+	 *
+	 * @param m Anzahl der Zeilen (Ungleichungen)
+	 * @param n Anzahl der strukturellen Variablen
+	 * @return true, falls das LP mit dichtem Tableau gelöst werden kann
+	 */
+	static inline bool fitsTableau(size_t m, size_t n)
+	{
+		return m == 0 or (n+m) <= max_tableau_size / (2*m);
+	}
+
+	/**
+	 * Maximiert c^T*x.
+	 *
+	 * @param c Kostenvektor (Länge: Anzahl der Variablen)
+	 * @return Status des Simplex-Laufs
+	 */
+	Status maximize(MVector const & c);
+
+	/**
+	 * Minimiert c^T*x.
+	 *
+	 * @param c Kostenvektor (Länge: Anzahl der Variablen)
+	 * @return Status des Simplex-Laufs
+	 */
+	Status minimize(MVector const & c);
+
+	/**
+	 * Sucht lediglich einen zulässigen Punkt (Phase 1).
+	 *
+	 * @return lp_optimal, falls ein zulässiger Punkt existiert
+	 */
+	Status findFeasible();
+
+	/**
+	 * Gibt die (strukturellen) Variablenwerte der letzten Lösung zurück.
+	 *
+	 * @return Variablenwerte
+	 */
+	MVector getSolution() const;
+
+	/**
+	 * Gibt den Wert einer strukturellen Variablen zurück.
+	 *
+	 * @param j Variablenindex
+	 * @return Variablenwert
+	 */
+	inline double getValue(size_t j) const
+	{
+		fASSERT(j < n_);
+		return x_.get(j);
+	}
+
+	/**
+	 * Gibt den Wert der Zielfunktion c^T*x der letzten Lösung zurück
+	 * (bezogen auf den an maximize bzw. minimize übergebenen Vektor c).
+	 *
+	 * @return Zielfunktionswert
+	 */
+	double getObjective() const;
+
+	/**
+	 * Setzt die maximale Anzahl von Iterationen pro Lauf.
+	 *
+	 * @param max_iter maximale Anzahl von Iterationen
+	 */
+	inline void setMaxIterations(size_t max_iter) { max_iter_ = max_iter; }
+
+	/**
+	 * Setzt die Toleranz für Zulässigkeit und Optimalität.
+	 *
+	 * @param tol Toleranz (default: 1e-9)
+	 */
+	inline void setTolerance(double tol) { tol_ = tol; }
+
+private:
+	/**
+	 * Berechnet die reduzierten Kosten d = c - c_B^T*T.
+	 */
+	void price();
+
+	/**
+	 * Berechnet die Werte der Basisvariablen neu.
+	 */
+	void refresh();
+
+	/**
+	 * Pivotisiert das Tableau an Element (r,q).
+	 *
+	 * @param r Zeile (Index der Basisvariable)
+	 * @param q Spalte (eintretende Variable)
+	 */
+	void pivot(size_t r, size_t q);
+
+	/**
+	 * Simplex-Iteration mit der aktuellen Kostenfunktion.
+	 *
+	 * @return Status des Simplex-Laufs
+	 */
+	Status iterate();
+
+	/**
+	 * Phase 1: Minimierung der Summe der künstlichen Variablen.
+	 *
+	 * @return lp_optimal oder lp_infeasible
+	 */
+	Status phase1();
+
+}; // class BoundedSimplex
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
@@ -0,0 +1,526 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "cstringtools.h"
+#include "Threads.h"
+#include "MMatrix.h"
+#include "MVector.h"
+#include "SMatrix.h"
+#include "StoichMatrixInteger.h"
+#include "CSMatrix.h"
+
+namespace flux {
+namespace la {
+
+// Mindestanzahl Multiplikationen pro Thread; darunter überwiegt der
+// Aufwand für das Starten der Threads
+#define CSM_MIN_WORK_PER_THREAD	(1 << 16)
+
+CSMatrix::CSMatrix()
+	: format_(csr), rows_(0), cols_(0), ptr_(1), idx_(0), val_(0) { }
+
+CSMatrix::CSMatrix(size_t rows, size_t cols, Format format)
+	: format_(format), rows_(rows), cols_(cols),
+	  ptr_((format == csr ? rows : cols) + 1), idx_(0), val_(0) { }
+
+CSMatrix::CSMatrix(
+	size_t rows,
+	size_t cols,
+	Format format,
+	GVector< size_t > && ptr,
+	GVector< size_t > && idx,
+	MVector && val
+	) : format_(format), rows_(rows), cols_(cols),
+	    ptr_(std::move(ptr)), idx_(std::move(idx)), val_(std::move(val))
+{
+	fASSERT(ptr_.dim() == majorDim()+1);
+	fASSERT(idx_.dim() == val_.dim());
+	fASSERT(ptr_.get(majorDim()) == idx_.dim());
+}
+
+CSMatrix::CSMatrix(MMatrix const & A, Format format)
+	: format_(format), rows_(A.rows()), cols_(A.cols())
+{
+	size_t i, j, k, nz;
+	double const * a = A;
+
+	for (nz=0,k=0; k<rows_*cols_; k++)
+		if (a[k] != 0.)
+			nz++;
+
+	ptr_ = GVector< size_t >(majorDim()+1);
+	idx_ = GVector< size_t >(nz);
+	val_ = MVector(nz);
+
+	k = 0;
+	if (format_ == csc)
+	{
+		// Speicherordnung von MMatrix: direkt spaltenweise
+		for (j=0; j<cols_; j++)
+		{
+			ptr_(j) = k;
+			for (i=0; i<rows_; i++)
+				if (a[j*rows_+i] != 0.)
+				{
+					idx_(k) = i;
+					val_(k++) = a[j*rows_+i];
+				}
+		}
+	}
+	else
+	{
+		for (i=0; i<rows_; i++)
+		{
+			ptr_(i) = k;
+			for (j=0; j<cols_; j++)
+				if (a[j*rows_+i] != 0.)
+				{
+					idx_(k) = j;
+					val_(k++) = a[j*rows_+i];
+				}
+		}
+	}
+	ptr_(majorDim()) = k;
+}
+
+CSMatrix::CSMatrix(SMatrix const & A, Format format)
+	: format_(format), rows_(A.rows()), cols_(A.cols())
+{
+	std::vector< size_t > I, J;
+	std::vector< double > V;
+	I.reserve(A.nnz()); J.reserve(A.nnz()); V.reserve(A.nnz());
+	SMatrix::const_iterator a_ij;
+	for (a_ij=A.begin(); a_ij!=A.end(); a_ij++)
+	{
+		I.push_back(a_ij->row);
+		J.push_back(a_ij->col);
+		V.push_back(a_ij->value);
+	}
+	assemble(I,J,V);
+}
+
+CSMatrix::CSMatrix(StoichMatrixInteger const & S, Format format)
+{
+	// StoichMatrixInteger hält die CSR-Form bereits vor
+	if (format == csr)
+		*this = S.getCSR();
+	else
+		*this = S.getCSR().convert(csc);
+}
+
+void CSMatrix::assemble(
+	std::vector< size_t > const & I,
+	std::vector< size_t > const & J,
+	std::vector< double > const & V
+	)
+{
+	size_t k, p, q, n = majorDim(), nz = V.size();
+	std::vector< size_t > const & M = (format_ == csr) ? I : J;
+	std::vector< size_t > const & m = (format_ == csr) ? J : I;
+	std::vector< size_t > next(n+1, 0);
+	std::vector< std::pair< size_t,double > > e(nz);
+
+	// Bucket-Sort nach major, danach je major nach minor sortieren
+	for (k=0; k<nz; k++)
+	{
+		fASSERT(I[k] < rows_ and J[k] < cols_);
+		next[M[k]+1]++;
+	}
+	for (k=0; k<n; k++)
+		next[k+1] += next[k];
+	std::vector< size_t > start(next);
+	for (k=0; k<nz; k++)
+		e[next[M[k]]++] = std::make_pair(m[k], V[k]);
+
+	ptr_ = GVector< size_t >(n+1);
+	std::vector< size_t > tidx;
+	std::vector< double > tval;
+	tidx.reserve(nz);
+	tval.reserve(nz);
+	for (k=0; k<n; k++)
+	{
+		ptr_(k) = tidx.size();
+		std::sort(e.begin()+start[k], e.begin()+start[k+1]);
+		for (p=start[k]; p<start[k+1]; p=q)
+		{
+			// doppelte Einträge zusammenfassen
+			double v = e[p].second;
+			for (q=p+1; q<start[k+1] and e[q].first == e[p].first; q++)
+				v += e[q].second;
+			tidx.push_back(e[p].first);
+			tval.push_back(v);
+		}
+	}
+	ptr_(n) = tidx.size();
+	idx_ = GVector< size_t >(tidx.data(), tidx.size());
+	val_ = MVector(tval.size());
+	val_.copy(tval.data());
+}
+
+double CSMatrix::get(size_t i, size_t j) const
+{
+	fASSERT(i < rows_ and j < cols_);
+	size_t M = (format_ == csr) ? i : j;
+	size_t m = (format_ == csr) ? j : i;
+	size_t const * first = (size_t const *)ptr_ + 0;
+	size_t const * b = (size_t const *)idx_ + first[M];
+	size_t const * e = (size_t const *)idx_ + first[M+1];
+	size_t const * f = std::lower_bound(b, e, m);
+	if (f == e or *f != m)
+		return 0.;
+	return val_.get(f - (size_t const *)idx_);
+}
+
+double * CSMatrix::find(size_t i, size_t j)
+{
+	fASSERT(i < rows_ and j < cols_);
+	size_t M = (format_ == csr) ? i : j;
+	size_t m = (format_ == csr) ? j : i;
+	size_t const * b = (size_t const *)idx_ + ptr_(M);
+	size_t const * e = (size_t const *)idx_ + ptr_(M+1);
+	size_t const * f = std::lower_bound(b, e, m);
+	if (f == e or *f != m)
+		return 0;
+	return (double *)val_ + (f - (size_t const *)idx_);
+}
+
+CSMatrix CSMatrix::getTranspose() const
+{
+	CSMatrix T(*this);
+	T.format_ = (format_ == csr) ? csc : csr;
+	T.rows_ = cols_;
+	T.cols_ = rows_;
+	return T;
+}
+
+CSMatrix CSMatrix::convert(Format format) const
+{
+	if (format == format_)
+		return *this;
+
+	// Transposition der Speicherung (Counting-Sort nach minor); die
+	// minor-Indizes ergeben sich dabei bereits aufsteigend sortiert
+	size_t k, p, n = majorDim(), nm = (format_ == csr) ? cols_ : rows_;
+	size_t nz = nnz();
+	GVector< size_t > ptr(nm+1), idx(nz);
+	MVector val(nz);
+
+	for (p=0; p<nz; p++)
+		ptr(idx_.get(p)+1)++;
+	for (k=0; k<nm; k++)
+		ptr(k+1) += ptr(k);
+	GVector< size_t > next(ptr);
+	for (k=0; k<n; k++)
+		for (p=ptr_.get(k); p<ptr_.get(k+1); p++)
+		{
+			size_t q = next(idx_.get(p))++;
+			idx(q) = k;
+			val(q) = val_.get(p);
+		}
+	return CSMatrix(rows_, cols_, format, std::move(ptr), std::move(idx),
+		std::move(val));
+}
+
+CSMatrix CSMatrix::getRows(size_t i1, size_t i2) const
+{
+	fASSERT(i1 <= i2 and i2 < rows_);
+	if (format_ == csc)
+		return getTranspose().getCols(i1,i2).getTranspose();
+
+	// CSR: zusammenhängender Block
+	size_t k, n = i2-i1+1, p0 = ptr_.get(i1), nz = ptr_.get(i2+1) - p0;
+	GVector< size_t > ptr(n+1);
+	for (k=0; k<=n; k++)
+		ptr(k) = ptr_.get(i1+k) - p0;
+	GVector< size_t > idx((size_t const *)idx_ + p0, nz);
+	MVector val(nz);
+	val.copy((double const *)val_ + p0);
+	return CSMatrix(n, cols_, csr, std::move(ptr), std::move(idx),
+		std::move(val));
+}
+
+CSMatrix CSMatrix::getCols(size_t j1, size_t j2) const
+{
+	fASSERT(j1 <= j2 and j2 < cols_);
+	if (format_ == csc)
+		return getTranspose().getRows(j1,j2).getTranspose();
+
+	// CSR: je Zeile den Indexbereich [j1,j2] per binärer Suche bestimmen
+	size_t k, p, nz, n = rows_;
+	size_t const * idx = idx_;
+	GVector< size_t > lo(n), hi(n), ptr(n+1);
+	for (nz=0,k=0; k<n; k++)
+	{
+		lo(k) = std::lower_bound(idx + ptr_.get(k), idx + ptr_.get(k+1), j1) - idx;
+		hi(k) = std::upper_bound(idx + lo(k), idx + ptr_.get(k+1), j2) - idx;
+		ptr(k) = nz;
+		nz += hi(k) - lo(k);
+	}
+	ptr(n) = nz;
+	GVector< size_t > sidx(nz);
+	MVector sval(nz);
+	for (k=0; k<n; k++)
+		for (p=lo(k); p<hi(k); p++)
+		{
+			sidx(ptr(k) + p-lo(k)) = idx[p] - j1;
+			sval(ptr(k) + p-lo(k)) = val_.get(p);
+		}
+	return CSMatrix(rows_, j2-j1+1, csr, std::move(ptr), std::move(sidx),
+		std::move(sval));
+}
+
+CSMatrix::operator MMatrix () const
+{
+	size_t k, p;
+	MMatrix A(rows_,cols_);
+	for (k=0; k<majorDim(); k++)
+		for (p=ptr_.get(k); p<ptr_.get(k+1); p++)
+			if (format_ == csr)
+				A(k, idx_.get(p)) = val_.get(p);
+			else
+				A(idx_.get(p), k) = val_.get(p);
+	return A;
+}
+
+SMatrix CSMatrix::toSMatrix() const
+{
+	size_t k, p;
+	double fill = (rows_ and cols_) ? double(nnz())/(double(rows_)*cols_) : 0.;
+	SMatrix A(rows_, cols_, fill > 0.05 ? fill : 0.05);
+	for (k=0; k<majorDim(); k++)
+		for (p=ptr_.get(k); p<ptr_.get(k+1); p++)
+			if (format_ == csr)
+				A.set(k, idx_.get(p), val_.get(p));
+			else
+				A.set(idx_.get(p), k, val_.get(p));
+	return A;
+}
+
+/**
+ * Verteilt die majors [0,n) so auf nt Threads, dass jeder Thread etwa
+ * gleich viele Elemente bearbeitet; liefert Grenzen bnd[0..nt].
+ */
+static std::vector< size_t > partition(
+	size_t const * ptr,
+	size_t n,
+	unsigned int nt
+	)
+{
+	std::vector< size_t > bnd(nt+1);
+	size_t nz = ptr[n];
+	bnd[0] = 0;
+	for (unsigned int t=1; t<nt; t++)
+		bnd[t] = std::upper_bound(ptr, ptr+n+1, nz*t/nt) - ptr - 1;
+	bnd[nt] = n;
+	for (unsigned int t=1; t<=nt; t++)
+		if (bnd[t] < bnd[t-1]) bnd[t] = bnd[t-1];
+	return bnd;
+}
+
+/**
+ * "Gather"-Kern (CSR mit A, CSC mit A^T): y(k) = alpha*<major k,x> + beta*y(k)
+ * für die majors k0..k1-1.
+ */
+static void mv_gather(
+	size_t k0, size_t k1,
+	size_t const * ptr, size_t const * idx, double const * val,
+	double alpha, double const * x, double beta, double * y
+	)
+{
+	for (size_t k=k0; k<k1; k++)
+	{
+		double s = 0.;
+		for (size_t p=ptr[k]; p<ptr[k+1]; p++)
+			s += val[p] * x[idx[p]];
+		y[k] = (beta == 0.) ? alpha*s : alpha*s + beta*y[k];
+	}
+}
+
+/**
+ * "Scatter"-Kern (CSR mit A^T, CSC mit A): y(idx) += alpha*x(k)*major k
+ * für die majors k0..k1-1.
+ */
+static void mv_scatter(
+	size_t k0, size_t k1,
+	size_t const * ptr, size_t const * idx, double const * val,
+	double alpha, double const * x, double * y
+	)
+{
+	for (size_t k=k0; k<k1; k++)
+	{
+		double xk = alpha * x[k];
+		if (xk == 0.)
+			continue;
+		for (size_t p=ptr[k]; p<ptr[k+1]; p++)
+			y[idx[p]] += val[p] * xk;
+	}
+}
+
+/**
+ * Serielles y = alpha*op(A)*x + beta*y auf den rohen Arrays.
+ */
+static void mv_serial(
+	bool gather, size_t n, size_t ny,
+	size_t const * ptr, size_t const * idx, double const * val,
+	double alpha, double const * x, double beta, double * y
+	)
+{
+	if (gather)
+		mv_gather(0, n, ptr, idx, val, alpha, x, beta, y);
+	else
+	{
+		for (size_t i=0; i<ny; i++)
+			y[i] = (beta == 0.) ? 0. : beta*y[i];
+		mv_scatter(0, n, ptr, idx, val, alpha, x, y);
+	}
+}
+
+void CSMatrix::spmv(
+	double alpha,
+	MVector const & x,
+	double beta,
+	MVector & y,
+	bool trans,
+	unsigned int nthreads
+	) const
+{
+	size_t nx = trans ? rows_ : cols_, ny = trans ? cols_ : rows_;
+	size_t n = majorDim();
+	fASSERT(x.dim() == nx);
+	if (beta == 0. and y.dim() != ny)
+		y = MVector(ny);
+	fASSERT(y.dim() == ny);
+
+	// CSR*x und CSC^T*x lesen je major ein Skalarprodukt (gather),
+	// CSR^T*x und CSC*x addieren je major in y (scatter)
+	bool gather = (format_ == csr) != trans;
+	size_t const * ptr = ptr_;
+	size_t const * idx = idx_;
+	double const * val = val_;
+	double const * px = x;
+	double * py = y;
+
+	unsigned int t, nt = num_threads(nthreads, nnz(),
+		CSM_MIN_WORK_PER_THREAD, n);
+	if (nt == 1)
+	{
+		mv_serial(gather, n, ny, ptr, idx, val, alpha, px, beta, py);
+		return;
+	}
+
+	std::vector< size_t > bnd = partition(ptr, n, nt);
+	if (gather)
+	{
+		// disjunkte Bereiche von y: keine Synchronisation nötig
+		run_threads(nt, [&](unsigned int t) {
+			mv_gather(bnd[t], bnd[t+1], ptr, idx, val, alpha, px, beta, py);
+		});
+		return;
+	}
+
+	// scatter: private Teilergebnisse je Thread, anschließend Summe
+	std::vector< MVector > part(nt-1, MVector(ny));
+	for (size_t i=0; i<ny; i++)
+		py[i] = (beta == 0.) ? 0. : beta*py[i];
+	run_threads(nt, [&](unsigned int t) {
+		mv_scatter(bnd[t], bnd[t+1], ptr, idx, val, alpha, px,
+			t == 0 ? py : (double *)part[t-1]);
+	});
+	for (t=0; t<nt-1; t++)
+		y += part[t];
+}
+
+void CSMatrix::spmm(
+	double alpha,
+	MMatrix const & B,
+	double beta,
+	MMatrix & C,
+	bool trans,
+	unsigned int nthreads
+	) const
+{
+	size_t nx = trans ? rows_ : cols_, ny = trans ? cols_ : rows_;
+	size_t n = majorDim(), nc = B.cols();
+	fASSERT(B.rows() == nx);
+	if (beta == 0. and (C.rows() != ny or C.cols() != nc))
+		C = MMatrix(ny, nc);
+	fASSERT(C.rows() == ny and C.cols() == nc);
+
+	bool gather = (format_ == csr) != trans;
+	size_t const * ptr = ptr_;
+	size_t const * idx = idx_;
+	double const * val = val_;
+	double const * pB = B;
+	double * pC = C;
+
+	// Spalten von B/C unabhängig: Aufteilung der Spalten auf die Threads
+	auto cols = [&](size_t c0, size_t c1)
+	{
+		for (size_t c=c0; c<c1; c++)
+			mv_serial(gather, n, ny, ptr, idx, val,
+				alpha, pB + c*nx, beta, pC + c*ny);
+	};
+
+	unsigned int nt = num_threads(nthreads, nnz()*nc,
+		CSM_MIN_WORK_PER_THREAD, nc);
+	run_ranges(nc, nt, cols);
+}
+
+MVector CSMatrix::operator* (MVector const & x) const
+{
+	MVector y(rows_);
+	spmv(1., x, 0., y);
+	return y;
+}
+
+MMatrix CSMatrix::operator* (MMatrix const & B) const
+{
+	MMatrix C(rows_, B.cols());
+	spmm(1., B, 0., C);
+	return C;
+}
+
+MVector CSMatrix::transMul(MVector const & x) const
+{
+	MVector y(cols_);
+	spmv(1., x, 0., y, true);
+	return y;
+}
+
+void CSMatrix::dump(FILE * outf, dump_t dt) const
+{
+	char dbl[32];
+	size_t k, p, i, j;
+
+	switch (dt)
+	{
+	case dump_full:
+		MMatrix(*this).dump(outf,dump_default);
+		break;
+	case dump_matlab:
+		MMatrix(*this).dump(outf,dump_matlab);
+		break;
+	case dump_default:
+	case dump_triplet:
+	case dump_matlab_sparse:
+		if (dt == dump_matlab_sparse)
+			fprintf(outf, "S = zeros(%d,%d);\n", int(rows_), int(cols_));
+		for (k=0; k<majorDim(); k++)
+			for (p=ptr_.get(k); p<ptr_.get(k+1); p++)
+			{
+				i = (format_ == csr) ? k : idx_.get(p);
+				j = (format_ == csr) ? idx_.get(p) : k;
+				dbl2str(dbl, val_.get(p), sizeof(dbl));
+				if (dt == dump_matlab_sparse)
+					fprintf(outf, "S(%d,%d) = %s;\n",
+						int(i)+1, int(j)+1, dbl);
+				else
+					fprintf(outf, "%d %d %s\n", int(i), int(j), dbl);
+			}
+		break;
+	}
+}
+
+} // namespace flux::la
+} // namespace flux
+
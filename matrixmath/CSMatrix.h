@@ -0,0 +1,328 @@
+#ifndef CSMATRIX_H
+#define CSMATRIX_H
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "Error.h"
+#include "GVector.h"
+#include "MVector.h"
+#include "MatrixInterface.h"
+
+namespace flux {
+namespace la {
+	class MMatrix;
+	class SMatrix;
+	class StoichMatrixInteger;
+	template< typename T > class GSMatrix;
+}}
+
+namespace flux {
+namespace la {
+
+/**
+ * Klasse CSMatrix -- dünn besetzte Matrix im komprimierten Format
+ * (Compressed Sparse Row bzw. Compressed Sparse Column).
+ *
+ * Im Gegensatz zu SMatrix/GSMatrix (Hash, geeignet für den schrittweisen
+ * Aufbau) ist die Besetzungsstruktur nach der Konstruktion fest; nur die
+ * Werte sind änderbar. Dafür liegen die Nicht-Null-Elemente einer Zeile
+ * (CSR) bzw. Spalte (CSC) sortiert und zusammenhängend im Speicher, was
+ * schnelle Matrix-Vektor- und Matrix-Matrix-Produkte erlaubt.
+ *
+ * Speicherung ("major" = Zeilen bei CSR, Spalten bei CSC):
+ *  - ptr(k) .. ptr(k+1)-1: Positionen der Elemente von major k
+ *  - idx(p): "minor"-Index (Spalte bei CSR, Zeile bei CSC) von Element p
+ *  - val(p): Wert von Element p
+ */
+class CSMatrix
+{
+public:
+	/** Speicherformat */
+	enum Format { csr, csc };
+
+private:
+	/** Speicherformat (CSR oder CSC) */
+	Format format_;
+	/** Anzahl der Zeilen */
+	size_t rows_;
+	/** Anzahl der Spalten */
+	size_t cols_;
+	/** Beginn der Zeilen (CSR) bzw. Spalten (CSC); Länge major+1 */
+	GVector< size_t > ptr_;
+	/** Spalten- (CSR) bzw. Zeilenindizes (CSC), je major aufsteigend */
+	GVector< size_t > idx_;
+	/** Werte der Nicht-Null-Elemente */
+	MVector val_;
+
+public:
+	/**
+	 * Constructor. Erzeugt eine leere 0x0-Matrix (CSR).
+	 */
+	CSMatrix();
+
+	/**
+	 * Constructor. Erzeugt eine Null-Matrix (ohne Elemente).
+	 *
+	 * @param rows Anzahl der Zeilen
+	 * @param cols Anzahl der Spalten
+	 * @param format Speicherformat
+	 */
+	CSMatrix(size_t rows, size_t cols, Format format = csr);
+
+	/**
+	 * Constructor. Übernimmt fertig aufgebaute Arrays (ohne Kopie).
+	 * Die Indizes je major müssen aufsteigend sortiert und eindeutig sein.
+	 *
+	 * @param rows Anzahl der Zeilen
+	 * @param cols Anzahl der Spalten
+	 * @param format Speicherformat
+	 * @param ptr Beginn der Zeilen bzw. Spalten (major+1)
+	 * @param idx Spalten- bzw. Zeilenindizes (nnz)
+	 * @param val Werte (nnz)
+	 */
+	CSMatrix(
+		size_t rows,
+		size_t cols,
+		Format format,
+		GVector< size_t > && ptr,
+		GVector< size_t > && idx,
+		MVector && val
+		);
+
+	/**
+	 * Konvertierung einer dichten Matrix; exakte Nullen werden nicht
+	 * gespeichert.
+	 *
+	 * @param A dichte Matrix
+	 * @param format Speicherformat
+	 */
+	explicit CSMatrix(MMatrix const & A, Format format = csr);
+
+	/**
+	 * Konvertierung einer Hash-basierten dünn besetzten Matrix.
+	 *
+	 * @param A dünn besetzte Matrix
+	 * @param format Speicherformat
+	 */
+	explicit CSMatrix(SMatrix const & A, Format format = csr);
+
+	/**
+	 * Konvertierung einer generischen Hash-basierten dünn besetzten
+	 * Matrix. Die Werte werden nach double konvertiert.
+	 *
+	 * @param A dünn besetzte Matrix
+	 * @param format Speicherformat
+	 */
+	template< typename T > explicit CSMatrix(
+		GSMatrix< T > const & A,
+		Format format = csr
+		) : format_(format), rows_(A.rows()), cols_(A.cols())
+	{
+		std::vector< size_t > I, J;
+		std::vector< double > V;
+		I.reserve(A.nnz()); J.reserve(A.nnz()); V.reserve(A.nnz());
+		typename GSMatrix< T >::const_iterator a_ij;
+		for (a_ij=A.begin(); a_ij!=A.end(); a_ij++)
+		{
+			I.push_back(a_ij->row);
+			J.push_back(a_ij->col);
+			V.push_back(double(a_ij->value));
+		}
+		assemble(I,J,V);
+	}
+
+	/**
+	 * Konvertierung einer (ganzzahligen) stöchiometrischen Matrix.
+	 *
+	 * @param S stöchiometrische Matrix
+	 * @param format Speicherformat
+	 */
+	explicit CSMatrix(StoichMatrixInteger const & S, Format format = csr);
+
+public:
+	/** @return Anzahl der Zeilen */
+	inline size_t rows() const { return rows_; }
+
+	/** @return Anzahl der Spalten */
+	inline size_t cols() const { return cols_; }
+
+	/** @return Anzahl der gespeicherten Elemente */
+	inline size_t nnz() const { return idx_.dim(); }
+
+	/** @return Speicherformat */
+	inline Format format() const { return format_; }
+
+	/** @return Anzahl der Zeilen (CSR) bzw. Spalten (CSC) */
+	inline size_t majorDim() const { return format_ == csr ? rows_ : cols_; }
+
+	/** @return Beginn der Zeilen bzw. Spalten (majorDim()+1) */
+	inline size_t const * ptr() const { return ptr_; }
+
+	/** @return Spalten- bzw. Zeilenindizes (nnz()) */
+	inline size_t const * idx() const { return idx_; }
+
+	/** @return Werte (nnz()) */
+	inline double const * val() const { return val_; }
+
+	/** @return Werte (nnz()), änderbar */
+	inline double * val() { return val_; }
+
+	/**
+	 * Auslesen eines Elements (binäre Suche).
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Wert des Elements (0, falls nicht gespeichert)
+	 */
+	double get(size_t i, size_t j) const;
+
+	/**
+	 * Sucht ein gespeichertes Element.
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Zeiger auf den Wert oder 0, falls nicht gespeichert
+	 */
+	double * find(size_t i, size_t j);
+
+	/**
+	 * Konvertierung in das angegebene Speicherformat.
+	 *
+	 * @param format Speicherformat
+	 * @return Matrix im Speicherformat format
+	 */
+	CSMatrix convert(Format format) const;
+
+	/**
+	 * Transponierte Matrix. Die CSR-Form von A ist die CSC-Form von A^T;
+	 * es werden nur die Arrays kopiert, das Format wechselt.
+	 *
+	 * @return transponierte Matrix
+	 */
+	CSMatrix getTranspose() const;
+
+	/**
+	 * Ausschnitt der Zeilen i1..i2 (inklusive); Format bleibt erhalten.
+	 *
+	 * @param i1 erste Zeile
+	 * @param i2 letzte Zeile
+	 * @return Ausschnitt
+	 */
+	CSMatrix getRows(size_t i1, size_t i2) const;
+
+	/**
+	 * Ausschnitt der Spalten j1..j2 (inklusive); Format bleibt erhalten.
+	 *
+	 * @param j1 erste Spalte
+	 * @param j2 letzte Spalte
+	 * @return Ausschnitt
+	 */
+	CSMatrix getCols(size_t j1, size_t j2) const;
+
+	/**
+	 * Cast-Operator nach MMatrix.
+	 *
+	 * @return dichte Matrix
+	 */
+	operator MMatrix () const;
+
+	/**
+	 * Konvertierung in eine Hash-basierte SMatrix.
+	 *
+	 * @return dünn besetzte Matrix
+	 */
+	SMatrix toSMatrix() const;
+
+	/**
+	 * Sparse Matrix-Vektor-Produkt y = alpha*op(A)*x + beta*y mit
+	 * op(A) = A bzw. A^T. Für beta==0 wird y vorher nicht gelesen
+	 * (und ggf. in der Dimension angepasst). Große Matrizen werden auf
+	 * mehrere Threads verteilt.
+	 *
+	 * @param alpha Faktor des Produkts
+	 * @param x Vektor
+	 * @param beta Faktor von y
+	 * @param y Ergebnis-Vektor (in/out)
+	 * @param trans true, falls op(A) = A^T
+	 * @param nthreads Anzahl der Threads (0: automatisch)
+	 */
+	void spmv(
+		double alpha,
+		MVector const & x,
+		double beta,
+		MVector & y,
+		bool trans = false,
+		unsigned int nthreads = 0
+		) const;
+
+	/**
+	 * Sparse Matrix-Matrix-Produkt C = alpha*op(A)*B + beta*C mit einer
+	 * dichten Matrix B. Für beta==0 wird C vorher nicht gelesen (und ggf.
+	 * in der Dimension angepasst). Die Spalten von B werden auf mehrere
+	 * Threads verteilt.
+	 *
+	 * @param alpha Faktor des Produkts
+	 * @param B dichte Matrix
+	 * @param beta Faktor von C
+	 * @param C Ergebnis-Matrix (in/out)
+	 * @param trans true, falls op(A) = A^T
+	 * @param nthreads Anzahl der Threads (0: automatisch)
+	 */
+	void spmm(
+		double alpha,
+		MMatrix const & B,
+		double beta,
+		MMatrix & C,
+		bool trans = false,
+		unsigned int nthreads = 0
+		) const;
+
+	/**
+	 * Matrix-Vektor-Produkt A*x.
+	 *
+	 * @param x Vektor
+	 * @return Produkt
+	 */
+	MVector operator* (MVector const & x) const;
+
+	/**
+	 * Matrix-Matrix-Produkt A*B mit einer dichten Matrix.
+	 *
+	 * @param B dichte Matrix
+	 * @return Produkt
+	 */
+	MMatrix operator* (MMatrix const & B) const;
+
+	/**
+	 * Produkt mit der Transponierten A^T*x.
+	 *
+	 * @param x Vektor
+	 * @return Produkt
+	 */
+	MVector transMul(MVector const & x) const;
+
+	/**
+	 * Debugging.
+	 */
+	void dump(FILE * outf = stdout, dump_t dt = dump_default) const;
+
+private:
+	/**
+	 * Baut die komprimierte Form aus Tripeln (Zeile,Spalte,Wert) auf
+	 * (format_, rows_, cols_ müssen gesetzt sein). Doppelte Einträge
+	 * werden addiert.
+	 */
+	void assemble(
+		std::vector< size_t > const & I,
+		std::vector< size_t > const & J,
+		std::vector< double > const & V
+		);
+
+}; // class CSMatrix
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
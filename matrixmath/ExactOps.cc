@@ -0,0 +1,867 @@
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <gmpxx.h>
+extern "C"
+{
+#include <stdint.h>
+}
+#include "fluxml_config.h" // MACHEPS
+#include "Error.h"
+#include "IntegerMath.h"
+#include "GMatrix.h"
+#include "GVector.h"
+#include "GMatrixOps.h"
+#include "ExactOps.h"
+
+// maximale Anzahl von Residuen im multi-modularen Verfahren (128 MB)
+#define EXACT_MAX_RESIDUES	(size_t(1) << 25)
+
+namespace flux {
+namespace la {
+namespace ExactOps {
+
+namespace {
+
+/**
+ * Zerlegt eine double-Zahl in v = m*2^e mit ungeradem m.
+ *
+ * @param v double-Zahl
+ * @param m ganzzahlige Mantisse (out)
+ * @param e Exponent (out)
+ * @return false, falls v nicht endlich ist
+ */
+bool split_double(double v, int64_t & m, int & e)
+{
+	int ex;
+	m = 0;
+	e = 0;
+	if (v == 0.)
+		return true;
+	if (not std::isfinite(v))
+		return false;
+	m = int64_t(ldexp(frexp(v,&ex),53));
+	e = ex-53;
+	while ((m & 1) == 0)
+	{
+		m /= 2;
+		e++;
+	}
+	return true;
+}
+
+/**
+ * Bestimmt den kleinsten Exponenten E>=0, so dass alle Einträge von
+ * A und b nach Multiplikation mit 2^E ganzzahlig sind.
+ *
+ * @param A Matrix
+ * @param b Vektor
+ * @param E Skalierungs-Exponent (out)
+ * @return false, falls A oder b nicht-endliche Einträge enthalten
+ */
+bool scale_exponent(MMatrix const & A, MVector const & b, int & E)
+{
+	size_t i,j;
+	int64_t m;
+	int e;
+
+	E = 0;
+	for (j=0; j<=A.cols(); j++)
+		for (i=0; i<A.rows(); i++)
+		{
+			if (not split_double(j<A.cols() ? A.get(i,j) : b.get(i),m,e))
+				return false;
+			if (m != 0 and -e > E)
+				E = -e;
+		}
+	return true;
+}
+
+/**
+ * Konvertiert eine int64-Zahl in eine GMP-Ganzzahl (unabhängig von der
+ * Breite von long).
+ */
+mpz_class int64_to_mpz(int64_t v)
+{
+	mpz_class z(long(v >> 32));
+	z <<= 32;
+	z += (unsigned long)(uint32_t(v));
+	return z;
+}
+
+/**
+ * Bareiss-Elimination über int64 mit Überlauf-Erkennung.
+ */
+class BareissInt64
+{
+private:
+	int R_, C_;
+	/** [A|b] spaltenweise, R x (C+1) */
+	std::vector< int64_t > a_;
+	/** Pivot des vorherigen Schritts */
+	int64_t prev_;
+	/** Betrag des bislang besten Pivot-Kandidaten */
+	int64_t best_;
+	/** Determinante des Pivot-Blocks (Nenner der Lösung) */
+	int64_t det_;
+
+	inline int64_t & at(int i, int j) { return a_[size_t(j)*R_+i]; }
+
+	static inline int64_t absI(int64_t v)
+	{
+		if (v == minimum< int64_t >())
+			throw IntegerOverflow();
+		return v < 0 ? -v : v;
+	}
+
+public:
+	BareissInt64(int R, int C)
+		: R_(R), C_(C), a_(size_t(R)*(C+1),0), prev_(1), best_(0), det_(1) { }
+
+	bool init(MMatrix const & A, MVector const & b)
+	{
+		int i,j,e,E;
+		int64_t m;
+
+		if (not scale_exponent(A,b,E))
+			return false;
+		for (j=0; j<=C_; j++)
+			for (i=0; i<R_; i++)
+			{
+				split_double(j<C_ ? A.get(i,j) : b.get(i),m,e);
+				if (m == 0)
+					continue;
+				e += E;
+				// |m*2^e| < 2^62
+				if (e >= 62 or (absI(m) >> (62-e)) != 0)
+					return false;
+				at(i,j) = m * (int64_t(1) << e);
+			}
+		return true;
+	}
+
+	inline bool isZero(int i, int j) { return at(i,j) == 0; }
+
+	inline void swapRows(int i1, int i2)
+	{
+		for (int j=0; j<=C_; j++)
+			std::swap(at(i1,j),at(i2,j));
+	}
+
+	inline void swapColumns(int j1, int j2)
+	{
+		std::swap_ranges(&at(0,j1),&at(0,j1)+R_,&at(0,j2));
+	}
+
+	inline void beginStep(int) { }
+
+	inline void resetBest(int i, int j) { best_ = absI(at(i,j)); }
+
+	inline bool improves(int i, int j)
+	{
+		int64_t v = absI(at(i,j));
+		if (v <= best_)
+			return false;
+		best_ = v;
+		return true;
+	}
+
+	bool eliminate(int k)
+	{
+		int i,j;
+		int64_t p = at(k,k);
+
+		// a(i,j) = (p*a(i,j) - a(i,k)*a(k,j)) / prev; Division exakt
+		for (j=k+1; j<=C_; j++)
+		{
+			int64_t akj = at(k,j);
+			for (i=k+1; i<R_; i++)
+			{
+				int64_t aij = at(i,j), aik = at(i,k);
+				if (aij == 0 and (aik == 0 or akj == 0))
+					continue;
+				at(i,j) = divI(subI(mulI(p,aij),mulI(aik,akj)),prev_);
+			}
+		}
+		for (i=k+1; i<R_; i++)
+			at(i,k) = 0;
+		prev_ = p;
+		return true;
+	}
+
+	bool solve(int rank)
+	{
+		int c,j,k;
+
+		// Rückwärts-Substitution; y = det*x ist ganzzahlig
+		// (Cramersche Regel) und ersetzt a(k,c)
+		det_ = rank > 0 ? at(rank-1,rank-1) : 1;
+		for (c=rank; c<=C_; c++)
+			for (k=rank-1; k>=0; k--)
+			{
+				int64_t s = mulI(det_,at(k,c));
+				for (j=k+1; j<rank; j++)
+					s = subI(s,mulI(at(k,j),at(j,c)));
+				fASSERT(s % at(k,k) == 0);
+				at(k,c) = divI(s,at(k,k));
+			}
+		return true;
+	}
+
+	void value(int k, int c, mpq_class & q)
+	{
+		q = mpq_class(int64_to_mpz(at(k,c)),int64_to_mpz(det_));
+		q.canonicalize();
+	}
+};
+
+inline uint32_t mulmod(uint32_t a, uint32_t b, uint32_t p)
+{
+	return uint32_t((uint64_t(a) * b) % p);
+}
+
+uint32_t powmod(uint32_t a, uint64_t n, uint32_t p)
+{
+	uint32_t r = 1 % p;
+	while (n)
+	{
+		if (n & 1) r = mulmod(r,a,p);
+		a = mulmod(a,a,p);
+		n >>= 1;
+	}
+	return r;
+}
+
+/**
+ * Deterministischer Miller-Rabin-Test für 32-Bit-Zahlen
+ * (Basen 2, 7, 61).
+ */
+bool is_prime32(uint32_t n)
+{
+	static uint32_t const bases[3] = { 2, 7, 61 };
+	uint32_t d = n-1;
+	int s = 0, r, i;
+
+	if (n < 2 or n % 2 == 0)
+		return n == 2;
+	while (d % 2 == 0) { d /= 2; s++; }
+	for (i=0; i<3; i++)
+	{
+		if (bases[i] % n == 0)
+			continue;
+		uint32_t x = powmod(bases[i],d,n);
+		if (x == 1 or x == n-1)
+			continue;
+		for (r=1; r<s; r++)
+		{
+			x = mulmod(x,x,n);
+			if (x == n-1)
+				break;
+		}
+		if (r == s)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Bareiss-Elimination simultan modulo L Primzahlen.
+ */
+class BareissModular
+{
+private:
+	int R_, C_;
+	/** Anzahl der Primzahlen */
+	size_t L_;
+	/** Anzahl der für den Pivot-Vergleich nötigen Primzahlen */
+	size_t Lk_;
+	/** Primzahlen für Minoren der Größe k+1 */
+	std::vector< size_t > Lstep_;
+	/** Primzahlen (2^30 < p < 2^31) */
+	std::vector< uint32_t > p_;
+	/** Kehrwerte 1/p_i */
+	std::vector< double > pinv_;
+	/** Garner-Koeffizienten p_j^-1 mod p_i an [i*L+j] */
+	std::vector< uint32_t > ginv_;
+	/** Residuen von [A|b]; Eintrag (i,j) an [(j*R+i)*L] */
+	std::vector< uint32_t > a_;
+	/** Residuen des vorherigen Pivots, Inverse, Determinante */
+	std::vector< uint32_t > prev_, inv_, det_;
+	/** CRT-Koeffizienten (M/p_i)^-1 mod p_i für die ersten Lk_ Primzahlen */
+	std::vector< uint32_t > crt_;
+	/** Fehlerschranke der Näherung |x|/M (siehe approx) */
+	double tau_;
+	/** Mixed-Radix-Ziffern des besten / aktuellen Kandidaten */
+	std::vector< uint32_t > best_, cur_, tmp_;
+	/** Position und Näherung |x|/M des besten Kandidaten */
+	int bi_, bj_;
+	double fbest_;
+	/** Ist der beste Kandidat 0? Sind seine Ziffern in best_ gültig? */
+	bool best_zero_, best_valid_;
+	/** Determinante als GMP-Zahl */
+	mpz_class det_z_;
+
+	inline uint32_t * at(int i, int j) { return &a_[(size_t(j)*R_+i)*L_]; }
+
+	/**
+	 * Mixed-Radix-Ziffern v von |x| zu den Residuen r (Garner) bzgl.
+	 * der ersten n Primzahlen. Vorausgesetzt wird |x| < p_0*...*p_n-1/2.
+	 *
+	 * @return true, falls x negativ ist
+	 */
+	bool mixed_radix(uint32_t const * r, uint32_t * v, size_t n)
+	{
+		size_t i,j;
+		bool neg = false;
+
+		for (;;)
+		{
+			for (i=0; i<n; i++)
+			{
+				uint32_t p = p_[i];
+				uint32_t t = r[i];
+				for (j=0; j<i; j++)
+				{
+					uint32_t vj = v[j] % p;
+					t = (t >= vj) ? t - vj : t + p - vj;
+					t = mulmod(t,ginv_[i*L_+j],p);
+				}
+				v[i] = t;
+			}
+			if (neg)
+				return true;
+			// x > (M-1)/2 <=> v > ((p_i-1)/2)_i (lexikographisch)
+			for (i=n; i-->0; )
+				if (v[i] != (p_[i]-1)/2)
+					break;
+			if (i == size_t(-1) or v[i] < (p_[i]-1)/2)
+				return false;
+			// negativ: Residuen von -x
+			for (i=0; i<n; i++)
+				tmp_[i] = r[i] ? p_[i] - r[i] : 0;
+			r = &tmp_[0];
+			neg = true;
+		}
+	}
+
+	/**
+	 * Näherung für |x|/M mit M = p_0*...*p_Lk-1 über den chinesischen
+	 * Restsatz: x/M = frac(sum_i (r_i*c_i mod p_i)/p_i). Der absolute
+	 * Fehler ist kleiner als tau_/2.
+	 */
+	inline double approx(uint32_t const * r)
+	{
+		double s = 0.;
+		for (size_t i=0; i<Lk_; i++)
+			s += mulmod(r[i],crt_[i],p_[i]) * pinv_[i];
+		s -= floor(s);
+		return s > .5 ? 1. - s : s;
+	}
+
+	static int cmp_digits(uint32_t const * u, uint32_t const * v, size_t L)
+	{
+		for (size_t i=L; i-->0; )
+			if (u[i] != v[i])
+				return u[i] < v[i] ? -1 : 1;
+		return 0;
+	}
+
+	mpz_class to_mpz(uint32_t const * r)
+	{
+		bool neg = mixed_radix(r,&cur_[0],L_);
+		mpz_class z(cur_[L_-1]);
+		for (size_t i=L_-1; i-->0; )
+		{
+			z *= (unsigned long)p_[i];
+			z += (unsigned long)cur_[i];
+		}
+		return neg ? mpz_class(-z) : z;
+	}
+
+public:
+	BareissModular(int R, int C)
+		: R_(R), C_(C), L_(0), Lk_(0), tau_(0.), bi_(0), bj_(0), fbest_(0.),
+		  best_zero_(true), best_valid_(false) { }
+
+	bool init(MMatrix const & A, MVector const & b)
+	{
+		int i,j,e,E;
+		size_t l,k;
+		int64_t m;
+		double bits = 0.;
+		std::vector< double > rbits(R_,0.);
+
+		if (not scale_exponent(A,b,E))
+			return false;
+
+		// Hadamard-Schranke aller Minoren von [A|b]*2^E:
+		// |det| <= prod_i max(1,||Zeile i||)
+		for (i=0; i<R_; i++)
+		{
+			double s = 0.;
+			for (j=0; j<=C_; j++)
+			{
+				double v = j<C_ ? A.get(i,j) : b.get(i);
+				s += v*v;
+			}
+			if (not std::isfinite(s))
+				return false;
+			if (s > 0. and E + 0.5*log2(s) > 0.)
+				rbits[i] = E + 0.5*log2(s);
+		}
+		// Minoren der Größe k+1: Produkt der k+1 größten Zeilennormen.
+		// M > 2*H; jede Primzahl trägt mehr als 30 Bit bei
+		std::sort(rbits.begin(),rbits.end(),std::greater< double >());
+		Lstep_.resize(R_);
+		for (i=0; i<R_; i++)
+		{
+			bits += rbits[i];
+			Lstep_[i] = size_t(ceil((bits + 4.) / 30.));
+		}
+		L_ = R_ > 0 ? Lstep_[R_-1] : 1;
+		if (L_ * R_ * size_t(C_+1) > EXACT_MAX_RESIDUES)
+			return false;
+
+		for (uint32_t p=0x7fffffffu; p_.size()<L_; p-=2)
+			if (is_prime32(p))
+			{
+				p_.push_back(p);
+				pinv_.push_back(1. / p);
+			}
+
+		ginv_.assign(L_*L_,0);
+		for (l=0; l<L_; l++)
+			for (k=0; k<l; k++)
+				ginv_[l*L_+k] = powmod(p_[k] % p_[l],p_[l]-2,p_[l]);
+
+		a_.assign(L_*R_*size_t(C_+1),0);
+		for (j=0; j<=C_; j++)
+			for (i=0; i<R_; i++)
+			{
+				split_double(j<C_ ? A.get(i,j) : b.get(i),m,e);
+				if (m == 0)
+					continue;
+				uint32_t * r = at(i,j);
+				uint64_t am = m < 0 ? uint64_t(-m) : uint64_t(m);
+				for (l=0; l<L_; l++)
+				{
+					uint32_t p = p_[l];
+					uint32_t v = mulmod(uint32_t(am % p),powmod(2,e+E,p),p);
+					r[l] = (m < 0 and v != 0) ? p - v : v;
+				}
+			}
+
+		prev_.assign(L_,1);
+		inv_.assign(L_,1);
+		det_.assign(L_,1);
+		best_.assign(L_,0);
+		cur_.assign(L_,0);
+		tmp_.assign(L_,0);
+		return true;
+	}
+
+	inline bool isZero(int i, int j)
+	{
+		uint32_t const * r = at(i,j);
+		for (size_t l=0; l<L_; l++)
+			if (r[l] != 0)
+				return false;
+		return true;
+	}
+
+	inline void swapRows(int i1, int i2)
+	{
+		for (int j=0; j<=C_; j++)
+			std::swap_ranges(at(i1,j),at(i1,j)+L_,at(i2,j));
+	}
+
+	inline void swapColumns(int j1, int j2)
+	{
+		std::swap_ranges(at(0,j1),at(0,j1)+L_*R_,at(0,j2));
+	}
+
+	void beginStep(int k)
+	{
+		size_t i,j;
+		if (Lstep_[k] == Lk_)
+			return;
+		Lk_ = Lstep_[k];
+		crt_.resize(Lk_);
+		for (i=0; i<Lk_; i++)
+		{
+			uint32_t Mi = 1;
+			for (j=0; j<Lk_; j++)
+				if (j != i)
+					Mi = mulmod(Mi,p_[j] % p_[i],p_[i]);
+			crt_[i] = powmod(Mi,p_[i]-2,p_[i]);
+		}
+		tau_ = ldexp(double(Lk_*Lk_+Lk_),-50);
+	}
+
+	inline void resetBest(int i, int j)
+	{
+		bi_ = i;
+		bj_ = j;
+		best_zero_ = isZero(i,j);
+		best_valid_ = false;
+		fbest_ = best_zero_ ? 0. : approx(at(i,j));
+	}
+
+	inline bool improves(int i, int j)
+	{
+		if (isZero(i,j))
+			return false;
+		double f = approx(at(i,j));
+		if (not best_zero_)
+		{
+			if (f < fbest_ - tau_)
+				return false;
+			if (f <= fbest_ + tau_)
+			{
+				// Näherung nicht eindeutig: exakter Vergleich
+				if (not best_valid_)
+					mixed_radix(at(bi_,bj_),&best_[0],Lk_);
+				best_valid_ = true;
+				mixed_radix(at(i,j),&cur_[0],Lk_);
+				if (cmp_digits(&cur_[0],&best_[0],Lk_) <= 0)
+					return false;
+				best_.swap(cur_);
+			}
+			else
+				best_valid_ = false;
+		}
+		bi_ = i;
+		bj_ = j;
+		fbest_ = f;
+		best_zero_ = false;
+		return true;
+	}
+
+	bool eliminate(int k)
+	{
+		int i,j;
+		size_t l;
+		uint32_t const * pk = at(k,k);
+		std::vector< char > kzero(R_,0);
+		std::vector< uint32_t > f(L_);
+
+		// Division durch den vorherigen Pivot: Inverse modulo p
+		for (l=0; l<L_; l++)
+		{
+			if (prev_[l] == 0)
+				return false;
+			inv_[l] = powmod(prev_[l],p_[l]-2,p_[l]);
+			f[l] = mulmod(pk[l],inv_[l],p_[l]);
+		}
+		for (i=k+1; i<R_; i++)
+			kzero[i] = isZero(i,k);
+
+		for (j=k+1; j<=C_; j++)
+		{
+			uint32_t const * akj = at(k,j);
+			bool jzero = isZero(k,j);
+			for (i=k+1; i<R_; i++)
+			{
+				uint32_t * aij = at(i,j);
+				uint32_t const * aik = at(i,k);
+				if (kzero[i] or jzero)
+				{
+					// a(i,j) = p*a(i,j)/prev
+					for (l=0; l<L_; l++)
+						if (aij[l])
+							aij[l] = mulmod(aij[l],f[l],p_[l]);
+					continue;
+				}
+				for (l=0; l<L_; l++)
+				{
+					// p*a(i,j) + (p-a(i,k))*a(k,j) < 2^63
+					uint32_t p = p_[l];
+					uint64_t t = uint64_t(pk[l])*aij[l]
+						+ uint64_t(aik[l] ? p - aik[l] : 0)*akj[l];
+					aij[l] = mulmod(uint32_t(t % p),inv_[l],p);
+				}
+			}
+		}
+		for (i=k+1; i<R_; i++)
+			std::fill(at(i,k),at(i,k)+L_,0u);
+		std::copy(pk,pk+L_,prev_.begin());
+		return true;
+	}
+
+	bool solve(int rank)
+	{
+		int c,j,k;
+		size_t l;
+		std::vector< uint32_t > dinv(size_t(rank)*L_);
+		std::vector< uint64_t > acc(L_);
+
+		if (rank > 0)
+			std::copy(at(rank-1,rank-1),at(rank-1,rank-1)+L_,det_.begin());
+		for (k=0; k<rank; k++)
+			for (l=0; l<L_; l++)
+			{
+				uint32_t akk = at(k,k)[l];
+				if (akk == 0)
+					return false;
+				dinv[k*L_+l] = powmod(akk,p_[l]-2,p_[l]);
+			}
+
+		// Rückwärts-Substitution; y = det*x ersetzt a(k,c). Die Summe
+		// wird in 64 Bit akkumuliert und nur bei Bedarf reduziert.
+		for (c=rank; c<=C_; c++)
+			for (k=rank-1; k>=0; k--)
+			{
+				uint32_t * akc = at(k,c);
+				for (l=0; l<L_; l++)
+					acc[l] = uint64_t(det_[l])*akc[l];
+				for (j=k+1; j<rank; j++)
+				{
+					uint32_t const * akj = at(k,j);
+					uint32_t const * ajc = at(j,c);
+					for (l=0; l<L_; l++)
+					{
+						if (acc[l] >= (uint64_t(1) << 63))
+							acc[l] %= p_[l];
+						acc[l] += uint64_t(akj[l] ? p_[l] - akj[l] : 0)*ajc[l];
+					}
+				}
+				for (l=0; l<L_; l++)
+					akc[l] = mulmod(uint32_t(acc[l] % p_[l]),dinv[k*L_+l],p_[l]);
+			}
+		det_z_ = to_mpz(&det_[0]);
+		return true;
+	}
+
+	void value(int k, int c, mpq_class & q)
+	{
+		q = mpq_class(to_mpz(at(k,c)),det_z_);
+		q.canonicalize();
+	}
+};
+
+/**
+ * Gemeinsamer Ablauf der exakten Gauss-Jordan-Varianten; entspricht
+ * Schritt für Schritt GMatrixOps::gaussJordan.
+ */
+template< typename E > Result gauss_jordan_exact(
+	E & eng,
+	int R,
+	int C,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	)
+{
+	int i,j,k,pr,pc,pk,pj,free,user_free;
+	bool zero;
+	PMatrix Pc(C);
+	PMatrix Pf(Pcf);
+	mpq_class q;
+
+	fASSERT(R <= C);
+
+	// Anzahl der vom Benutzer als frei deklarierten Variablen zählen
+	for (i=0,user_free=0; i<C; i++)
+		if (Pf(i) == 0) user_free++;
+
+	// Spalten freier Variablen in den rechten Teil der Matrix tauschen
+	Pc.initIdent();
+	i=-1;
+	j=C;
+	for (;;)
+	{
+		do j--; while (j>i and Pf(j) == 0);
+		do i++; while (i<j and Pf(i) != 0);
+
+		if (i<j)
+		{
+			Pc.swap(i,j);
+			Pf.swap(i,j);
+			eng.swapColumns(i,j);
+		}
+		else break;
+	}
+
+	for (k=0; k<R; k++)
+	{
+		pr = k;
+		pc = k;
+		eng.beginStep(k);
+		eng.resetBest(pr,pc);
+
+		// betragsgrößtes Element der Restmatrix
+		for (j=k; j<C-user_free; j++)
+			for (i=k; i<R; i++)
+				if (eng.improves(i,j))
+				{
+					pr = i;
+					pc = j;
+				}
+
+		if (eng.isZero(pr,pc))
+			break;
+
+		if (pr != k)
+			eng.swapRows(k,pr);
+		if (pc != k)
+		{
+			eng.swapColumns(k,pc);
+			Pc.swap(k,pc);
+		}
+
+		if (not eng.eliminate(k))
+			return ex_overflow;
+	}
+
+	// Fehlerfälle wie in GMatrixOps::gaussJordan
+	rank = k;
+	if (rank < R)
+	{
+		for (j=C-user_free,zero=true; j<C and zero; j++)
+			for (i=rank; i<R and zero; i++)
+				if (not eng.isZero(i,j))
+					zero = false;
+		if (not zero)
+		{
+			rank = -3;
+			return ex_failed;
+		}
+	}
+	for (i=rank; i<R; i++)
+		if (not eng.isZero(i,C))
+		{
+			rank = -4;
+			return ex_failed;
+		}
+	if (user_free > C-rank)
+	{
+		rank = -2;
+		return ex_failed;
+	}
+
+	if (not eng.solve(rank))
+		return ex_overflow;
+
+	free = C-rank;
+	K = MMatrix(C,free+1);
+	PMatrix Psfree = Pc.sortPerm(rank, C-1).inverse();
+
+	for (k=0; k<rank; k++)
+	{
+		pk = Pc(k);
+		eng.value(k,C,q);
+		if (abs(q)>=MACHEPS)
+			K(pk,0) = q.get_d();
+
+		for (j=rank; j<C; j++)
+		{
+			pj = Psfree(j-rank)+1;
+			eng.value(k,j,q);
+			if (abs(q)>=MACHEPS)
+				K(pk,pj) = mpq_class(-q).get_d();
+		}
+	}
+	for (k=0; k<free; k++)
+	{
+		pj = Psfree(k)+1;
+		K(Pc(k+rank),pj) = 1.;
+	}
+
+	Pc.sort(0,rank-1);
+	Pc.sort(rank,C-1);
+	Pcf = Pc;
+	return ex_ok;
+}
+
+} // namespace
+
+Result gaussJordanBareiss(
+	MMatrix const & A,
+	MVector const & b,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	)
+{
+	fASSERT(Pcf.dim() == A.cols());
+	fASSERT(b.dim() == A.rows());
+
+	try
+	{
+		BareissInt64 eng(A.rows(),A.cols());
+		if (not eng.init(A,b))
+			return ex_overflow;
+		return gauss_jordan_exact(eng,A.rows(),A.cols(),K,Pcf,rank);
+	}
+	catch (IntegerOverflow &)
+	{
+		return ex_overflow;
+	}
+}
+
+Result gaussJordanModular(
+	MMatrix const & A,
+	MVector const & b,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	)
+{
+	fASSERT(Pcf.dim() == A.cols());
+	fASSERT(b.dim() == A.rows());
+
+	BareissModular eng(A.rows(),A.cols());
+	if (not eng.init(A,b))
+		return ex_overflow;
+	return gauss_jordan_exact(eng,A.rows(),A.cols(),K,Pcf,rank);
+}
+
+bool gaussJordan(
+	MMatrix const & A,
+	MVector const & b,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	)
+{
+	size_t j,k;
+	bool result;
+
+	switch (gaussJordanBareiss(A,b,K,Pcf,rank))
+	{
+	case ex_ok:
+		return true;
+	case ex_overflow:
+		fDEBUG(0,"integer overflow in Bareiss elimination; trying multi-modular solver");
+		if (gaussJordanModular(A,b,K,Pcf,rank) == ex_ok)
+			return true;
+		break;
+	case ex_failed:
+		break;
+	}
+
+	// Arbitrary-Precision-Alternative ...
+	GMatrix< mpq_class > qN(A.rows(),A.cols());
+	GVector< mpq_class > qb(b.dim());
+	GMatrix< mpq_class > qV;
+	for (j=0; j<qN.rows(); ++j)
+		for (k=0; k<qN.cols(); ++k)
+			qN(j,k) = A.get(j,k);
+	for (k=0; k<qb.dim(); ++k)
+		qb(k) = b.get(k);
+
+	if (not (result = GMatrixOps::gaussJordan(qN,qb,qV,Pcf,rank)))
+		return false;
+
+	// double-Matrix K aus qV aufbauen:
+	K = MMatrix(qV.rows(),qV.cols());
+	for (j=0; j<qV.rows(); j++)
+		for (k=0; k<qV.cols(); k++)
+			K(j,k) = qV.get(j,k).get_d();
+	return true;
+}
+
+} // namespace flux::la::ExactOps
+} // namespace flux::la
+} // namespace flux
+
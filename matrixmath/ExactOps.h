@@ -0,0 +1,107 @@
+#ifndef EXACTOPS_H
+#define EXACTOPS_H
+
+#include "MMatrix.h"
+#include "MVector.h"
+#include "PMatrix.h"
+
+namespace flux {
+namespace la {
+namespace ExactOps {
+
+/** Ergebnis eines exakten Lösungsversuchs */
+enum Result
+{
+	ex_ok,		// Lösung berechnet
+	ex_failed,	// System nicht lösbar (Fehlercode in rank)
+	ex_overflow	// Verfahren nicht anwendbar (Überlauf, Speicher, ...)
+};
+
+/**
+ * Exakte Gauss-Jordan-Elimination per bruchfreiem Bareiss-Verfahren
+ * über int64. Die Einträge von A und b werden mit einer gemeinsamen
+ * Zweierpotenz auf ganze Zahlen skaliert; jeder Überlauf (erkannt über
+ * mulI/subI aus IntegerMath.h) führt zu ex_overflow.
+ *
+ * Die Pivot-Wahl entspricht exakt der von GMatrixOps::gaussJordan über
+ * mpq_class (betragsgrößtes Element der Restmatrix; die Einträge der
+ * Bareiss-Restmatrix sind ein gemeinsames Vielfaches der rationalen
+ * Einträge). Die Lösung wird als Bruch y/det berechnet und über
+ * mpq_class::get_d konvertiert -- K ist damit bitweise identisch zum
+ * Ergebnis der mpq-Version.
+ *
+ * Bei ex_failed enthält rank den Fehlercode (siehe
+ * MMatrixOps::gaussJordan); Pcf bleibt jedoch unverändert, d.h. für
+ * einen Vorschlag freier Variablen muss die mpq-Version aufgerufen
+ * werden.
+ *
+ * @param A eine quadratische oder "liegende" Matrix (Spalten>=Zeilen)
+ * @param b ein Konstantenvektor
+ * @param K Matrix mit spezieller und homogener Lösung (out)
+ * @param Pcf Spalten-Permutationsmatrix (in/out)
+ * @param rank Rang der Matrix A bzw. Fehlercode (out)
+ * @return ex_ok, ex_failed oder ex_overflow
+ */
+Result gaussJordanBareiss(
+	MMatrix const & A,
+	MVector const & b,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	);
+
+/**
+ * Multi-modulare Variante von gaussJordanBareiss. Die Bareiss-Elimination
+ * läuft simultan modulo mehrerer 31-Bit-Primzahlen, deren Produkt
+ * größer als die doppelte Hadamard-Schranke aller Minoren von [A|b] ist.
+ * Damit ist jeder Eintrag der Restmatrix über seine Residuen eindeutig
+ * bestimmt; Beträge werden für die Pivot-Wahl per Mixed-Radix-Darstellung
+ * (Garner) verglichen. Die Lösung ergibt sich per chinesischem Restsatz
+ * aus den Residuen von Zähler und Nenner (Determinante, Cramersche Regel).
+ *
+ * ex_overflow wird zurückgegeben, falls eine Primzahl einen Pivot teilt
+ * oder der Speicherbedarf der Residuen zu groß wird.
+ *
+ * @param A eine quadratische oder "liegende" Matrix (Spalten>=Zeilen)
+ * @param b ein Konstantenvektor
+ * @param K Matrix mit spezieller und homogener Lösung (out)
+ * @param Pcf Spalten-Permutationsmatrix (in/out)
+ * @param rank Rang der Matrix A bzw. Fehlercode (out)
+ * @return ex_ok, ex_failed oder ex_overflow
+ */
+Result gaussJordanModular(
+	MMatrix const & A,
+	MVector const & b,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	);
+
+/**
+ * Exakte Lösung von A*x=b (siehe MMatrixOps::gaussJordan). Versucht
+ * nacheinander gaussJordanBareiss, gaussJordanModular und zuletzt
+ * GMatrixOps::gaussJordan über mpq_class. Die mpq-Version wird außerdem
+ * verwendet, wenn das System nicht lösbar ist, damit Fehlercode und
+ * Vorschlag freier Variablen in Pcf wie gewohnt zur Verfügung stehen.
+ *
+ * @param A eine quadratische oder "liegende" Matrix (Spalten>=Zeilen)
+ * @param b ein Konstantenvektor
+ * @param K Matrix mit spezieller und homogener Lösung (out)
+ * @param Pcf Spalten-Permutationsmatrix (in/out)
+ * @param rank Rang der Matrix A bzw. Fehlercode (out)
+ * @return true, bei Erfolg, false bei einem Fehler (siehe rank)
+ */
+bool gaussJordan(
+	MMatrix const & A,
+	MVector const & b,
+	MMatrix & K,
+	PMatrix & Pcf,
+	int & rank
+	);
+
+} // namespace flux::la::ExactOps
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
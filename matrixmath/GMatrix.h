@@ -5,7 +5,9 @@
 #include <cstring>
 #include "Error.h"
 #include "MatrixInterface.h"
+#include "AlignedStorage.h"
 #include "GVector.h"
+#include "MatrixView.h"
 
 namespace flux {
 namespace la {
@@ -25,7 +27,7 @@ protected:
 	size_t rows_;
 	/** Anzahl der Spalten */
 	size_t cols_;
-	/** Speicher für Matrixelemente */
+	/** Speicher für Matrixelemente (siehe storage_alloc) */
 	T * matrix_storage_;
 
 public:
@@ -45,7 +47,7 @@ public:
 		: rows_(r), cols_(c)
 	{
 		size_t i = rows_*cols_;
-		matrix_storage_ = new T[i];
+		matrix_storage_ = storage_alloc< T >(i);
 		while (i) matrix_storage_[--i] = T();
 	}
 	
@@ -60,7 +62,7 @@ public:
 		: rows_(r), cols_(c)
 	{
 		size_t i = rows_*cols_;
-		matrix_storage_ = new T[i];
+		matrix_storage_ = storage_alloc< T >(i);
 		while (i) matrix_storage_[--i] = T(init);
 	}
 
@@ -73,7 +75,7 @@ public:
 		: rows_(copy.rows_), cols_(copy.cols_)
 	{
 		size_t i = rows_*cols_;
-		matrix_storage_ = new T[i];
+		matrix_storage_ = storage_alloc< T >(i);
 		while (i)
 		{
 			i--;
@@ -81,10 +83,24 @@ public:
 		}
 	}
 
+	/**
+	 * Move-Constructor. Übernimmt den Speicher von move; move ist
+	 * anschließend eine leere 0x0-Matrix.
+	 *
+	 * @param move zu übernehmendes Objekt
+	 */
+	inline GMatrix(GMatrix && move) noexcept
+		: rows_(move.rows_), cols_(move.cols_),
+		  matrix_storage_(move.matrix_storage_)
+	{
+		move.rows_ = move.cols_ = 0;
+		move.matrix_storage_ = 0;
+	}
+
 	/**
 	 * Destructor.
 	 */
-	virtual inline ~GMatrix() { delete[] matrix_storage_; }
+	virtual inline ~GMatrix() { storage_free(matrix_storage_); }
 
 public:
 	/**
@@ -101,8 +117,8 @@ public:
 		if (i != rows_*cols_)
 		{
 			if (matrix_storage_)
-				delete[] matrix_storage_;
-			matrix_storage_ = new T[i];
+				storage_free(matrix_storage_);
+			matrix_storage_ = storage_alloc< T >(i);
 		}
 		rows_ = copy.rows_;
 		cols_ = copy.cols_;
@@ -114,6 +130,26 @@ public:
 		return *this;
 	}
 
+	/**
+	 * Move-Zuweisung. Übernimmt den Speicher von move (ohne Kopie der
+	 * Elemente); move ist anschließend eine leere 0x0-Matrix.
+	 *
+	 * @param move zu übernehmendes Objekt
+	 */
+	inline GMatrix & operator= (GMatrix && move) noexcept
+	{
+		if (this != &move)
+		{
+			storage_free(matrix_storage_);
+			rows_ = move.rows_;
+			cols_ = move.cols_;
+			matrix_storage_ = move.matrix_storage_;
+			move.rows_ = move.cols_ = 0;
+			move.matrix_storage_ = 0;
+		}
+		return *this;
+	}
+
 	/**
 	 * Elementzugriff (Lesen/Schreiben).
 	 *
@@ -185,6 +221,27 @@ public:
 	 */
 	inline virtual operator T * () const { return matrix_storage_; }
 
+	/**
+	 * Statisch gebundene Sicht auf die Matrix (ohne virtuelle Aufrufe
+	 * und Bereichsprüfung) für numerische Kernel.
+	 *
+	 * @return schreibbare Sicht
+	 */
+	inline MatrixView< T > view()
+	{
+		return MatrixView< T >(matrix_storage_, rows_, cols_, rows_);
+	}
+
+	/**
+	 * Statisch gebundene Nur-Lese-Sicht auf die Matrix.
+	 *
+	 * @return Nur-Lese-Sicht
+	 */
+	inline MatrixView< T const > view() const
+	{
+		return MatrixView< T const >(matrix_storage_, rows_, cols_, rows_);
+	}
+
 	/**
 	 * Spaltenvertauschung
 	 *
@@ -4,6 +4,8 @@
 #include <cstddef>
 #include "Error.h"
 #include "VectorInterface.h"
+#include "AlignedStorage.h"
+#include "MatrixView.h"
 
 namespace flux {
 namespace la {
@@ -18,7 +20,7 @@ template< typename T > class GVector : public VectorInterface<T>
 protected:
 	/** Dimension des Vektors */
 	size_t dim_;
-	/** Speicher der Vektorelemente */
+	/** Speicher der Vektorelemente (siehe storage_alloc) */
 	T * vector_storage_;
 public:
 	/**
@@ -34,7 +36,7 @@ public:
 	 */
 	inline GVector(size_t dim) : dim_(dim)
 	{
-		vector_storage_ = new T[dim_];
+		vector_storage_ = storage_alloc< T >(dim_);
 		for (size_t i=0; i<dim_; ++i)
 			vector_storage_[i] = T();
 	}
@@ -48,7 +50,7 @@ public:
 	 */
 	inline GVector(size_t dim, T const & init) : dim_(dim)
 	{
-		vector_storage_ = new T[dim_];
+		vector_storage_ = storage_alloc< T >(dim_);
 		while (dim) vector_storage_[--dim] = T(init);
 	}
 
@@ -60,7 +62,7 @@ public:
 	inline GVector(GVector const & copy)
 		: dim_(copy.dim_)
 	{
-		vector_storage_ = new T[dim_];
+		vector_storage_ = storage_alloc< T >(dim_);
 		for (size_t i=0; i<dim_; i++)
 			vector_storage_[i] = T(copy.vector_storage_[i]);
 	}
@@ -74,15 +76,28 @@ public:
 	inline GVector(T const * copy, size_t dim)
 		: dim_(dim)
 	{
-		vector_storage_ = new T[dim_];
+		vector_storage_ = storage_alloc< T >(dim_);
 		for (size_t i=0; i<dim_; i++)
 			vector_storage_[i] = T(copy[i]);
 	}
 
+	/**
+	 * Move-Constructor. Übernimmt den Speicher von move; move ist
+	 * anschließend ein leerer Vektor.
+	 *
+	 * @param move zu übernehmender Vektor
+	 */
+	inline GVector(GVector && move) noexcept
+		: dim_(move.dim_), vector_storage_(move.vector_storage_)
+	{
+		move.dim_ = 0;
+		move.vector_storage_ = 0;
+	}
+
 	/**
 	 * Destructor.
 	 */
-	virtual ~GVector() { delete[] vector_storage_; }
+	virtual ~GVector() { storage_free(vector_storage_); }
 
 public:
 	/**
@@ -97,15 +112,35 @@ public:
 		if (dim_ != copy.dim_)
 		{
 			if (vector_storage_)
-				delete[] vector_storage_;
+				storage_free(vector_storage_);
 			dim_ = copy.dim_;
-			vector_storage_ = new T[dim_];
+			vector_storage_ = storage_alloc< T >(dim_);
 		}
 		for (size_t i=0; i<dim_; i++)
 			vector_storage_[i] = copy.vector_storage_[i];
 		return *this;
 	}
 
+	/**
+	 * Move-Zuweisung. Übernimmt den Speicher von move (ohne Kopie der
+	 * Elemente); move ist anschließend ein leerer Vektor.
+	 *
+	 * @param move zu übernehmender Vektor
+	 * @return Referenz auf *this
+	 */
+	inline GVector< T > & operator= (GVector && move) noexcept
+	{
+		if (this != &move)
+		{
+			storage_free(vector_storage_);
+			dim_ = move.dim_;
+			vector_storage_ = move.vector_storage_;
+			move.dim_ = 0;
+			move.vector_storage_ = 0;
+		}
+		return *this;
+	}
+
 	/**
 	 * Elementzugriff (Lesen/Schreiben)
 	 *
@@ -153,9 +188,9 @@ public:
 	{
 		if (dim != dim_)
 		{
-			delete[] vector_storage_;
+			storage_free(vector_storage_);
 			dim_ = dim;
-			vector_storage_ = new T[dim_];
+			vector_storage_ = storage_alloc< T >(dim_);
 		}
 		for (size_t i=0; i<dim_; i++)
 			vector_storage_[i] = T(cpy[i]);
@@ -221,6 +256,27 @@ public:
 	 */
 	inline virtual operator T * () const { return vector_storage_; }
 
+	/**
+	 * Statisch gebundene Sicht auf den Vektor (ohne virtuelle Aufrufe
+	 * und Bereichsprüfung) für numerische Kernel.
+	 *
+	 * @return schreibbare Sicht
+	 */
+	inline VectorView< T > view()
+	{
+		return VectorView< T >(vector_storage_, dim_);
+	}
+
+	/**
+	 * Statisch gebundene Nur-Lese-Sicht auf den Vektor.
+	 *
+	 * @return Nur-Lese-Sicht
+	 */
+	inline VectorView< T const > view() const
+	{
+		return VectorView< T const >(vector_storage_, dim_);
+	}
+
 	/**
 	 * Skalarprodukt-Operator.
 	 */
@@ -0,0 +1,216 @@
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include "Philox.h"
+#include "Threads.h"
+#include "HitAndRunSampler.h"
+
+namespace flux {
+namespace la {
+
+HitAndRunSampler::HitAndRunSampler(StandardForm const & SF)
+	: n_(SF.getNumVars()), m_(SF.getNumInequalities()),
+	  A_(SF.getNumInequalities(),SF.getNumVars()), b_(SF.getRHS()),
+	  have_start_(false), mode_(har_uniform),
+	  burn_in_(1000), thinning_(10), seed_(0)
+{
+	SMatrix::const_iterator a_ij;
+	SMatrix const & A = SF.getLHS();
+	for (a_ij=A.begin(); a_ij!=A.end(); a_ij++)
+		A_(a_ij->row,a_ij->col) = a_ij->value;
+	SF.getBounds(lo_,up_);
+
+	double radius;
+	if (SF.findInteriorPoint(x0_,radius) and radius > 0.)
+		have_start_ = true;
+	else
+		fWARNING("hit-and-run: polytope has no interior point");
+}
+
+bool HitAndRunSampler::setStart(MVector const & x0)
+{
+	size_t i,j;
+	fASSERT(x0.dim() == n_);
+
+	for (j=0; j<n_; j++)
+		if (x0.get(j) < lo_(j) or x0.get(j) > up_(j))
+			return false;
+	for (i=0; i<m_; i++)
+	{
+		double s = 0.;
+		for (j=0; j<n_; j++)
+			s += A_(i,j) * x0.get(j);
+		if (s > b_(i))
+			return false;
+	}
+	x0_ = x0;
+	have_start_ = true;
+	return true;
+}
+
+bool HitAndRunSampler::run_chain(uint64_t chain, size_t N, double * out) const
+{
+	size_t i, j, k, step, nsteps;
+	double const inf = std::numeric_limits< double >::infinity();
+	double const eps = 1e-14;
+	double const * A = A_;
+	Philox4x32 rng(seed_,chain);
+
+	MVector x(x0_);
+	MVector s(m_);	// Schlupf b - A*x
+	MVector d(n_);	// Richtung
+	MVector Ad(m_);	// A*d
+
+	// Die Sehne wird hier direkt aus dem mitgeführten Schlupf b-A*x
+	// bestimmt; StandardForm::distToConstraints und closestIntersection
+	// arbeiten auf der dünnbesetzten A_ und berechnen A*x in jedem
+	// Schritt neu.
+
+	nsteps = burn_in_ + N * thinning_;
+	for (step=0; step<nsteps; step++)
+	{
+		// Schlupf regelmäßig neu berechnen (Rundungsfehler)
+		if (step % 128 == 0)
+		{
+			for (i=0; i<m_; i++)
+				s(i) = b_.get(i);
+			for (j=0; j<n_; j++)
+			{
+				double xj = x(j);
+				double const * aj = A + j*m_;
+				for (i=0; i<m_; i++)
+					s(i) -= aj[i] * xj;
+			}
+		}
+
+		double tmin = -inf, tmax = inf;
+		size_t jc = 0;
+
+		if (mode_ == har_coordinate)
+		{
+			jc = size_t(rng.uniform() * n_);
+			if (jc >= n_) jc = n_-1;
+			double const * aj = A + jc*m_;
+			for (i=0; i<m_; i++)
+				Ad(i) = aj[i];
+			if (not std::isinf(up_.get(jc))) tmax = up_.get(jc) - x(jc);
+			if (not std::isinf(lo_.get(jc))) tmin = lo_.get(jc) - x(jc);
+		}
+		else
+		{
+			double nrm = 0.;
+			for (j=0; j<n_; j++)
+			{
+				d(j) = rng.gauss();
+				nrm += d(j) * d(j);
+			}
+			nrm = sqrt(nrm);
+			for (j=0; j<n_; j++)
+				d(j) /= nrm;
+
+			Ad.fill(0.);
+			for (j=0; j<n_; j++)
+			{
+				double dj = d(j);
+				double const * aj = A + j*m_;
+				for (i=0; i<m_; i++)
+					Ad(i) += aj[i] * dj;
+
+				// Schranken
+				if (dj > eps)
+				{
+					tmax = std::min(tmax, (up_.get(j) - x(j)) / dj);
+					tmin = std::max(tmin, (lo_.get(j) - x(j)) / dj);
+				}
+				else if (dj < -eps)
+				{
+					tmax = std::min(tmax, (lo_.get(j) - x(j)) / dj);
+					tmin = std::max(tmin, (up_.get(j) - x(j)) / dj);
+				}
+			}
+		}
+
+		// Ungleichungen
+		for (i=0; i<m_; i++)
+		{
+			double a = Ad(i);
+			if (a > eps)
+				tmax = std::min(tmax, s(i) / a);
+			else if (a < -eps)
+				tmin = std::max(tmin, s(i) / a);
+		}
+
+		if (std::isinf(tmin) or std::isinf(tmax))
+		{
+			fWARNING("hit-and-run: polytope is unbounded");
+			return false;
+		}
+		// numerisch aus dem Polytop gedriftet: stehen bleiben
+		if (tmax < tmin)
+			tmin = tmax = 0.;
+
+		double t = tmin + rng.uniform() * (tmax - tmin);
+
+		if (mode_ == har_coordinate)
+			x(jc) += t;
+		else
+			for (j=0; j<n_; j++)
+				x(j) += t * d(j);
+		for (i=0; i<m_; i++)
+			s(i) -= t * Ad(i);
+
+		// Ausgabe nach burn-in alle thinning_ Schritte
+		if (step >= burn_in_ and (step - burn_in_ + 1) % thinning_ == 0)
+		{
+			k = (step - burn_in_ + 1) / thinning_ - 1;
+			double * o = out + k*n_;
+			for (j=0; j<n_; j++)
+				o[j] = x(j);
+		}
+	}
+	return true;
+}
+
+bool HitAndRunSampler::sample(
+	size_t N,
+	double * out,
+	unsigned int nchains,
+	unsigned int nthreads
+	) const
+{
+	if (not have_start_)
+	{
+		fWARNING("hit-and-run: no interior starting point");
+		return false;
+	}
+	if (N == 0)
+		return true;
+	if (n_ == 0)
+		return true;
+
+	if (nchains == 0)
+		nchains = default_chains;
+	if (nchains > N)
+		nchains = N;
+	nthreads = num_threads(nthreads, nchains, 1, nchains);
+
+	// Kette c erzeugt die Punkte [N*c/nchains, N*(c+1)/nchains); die
+	// Ketten werden in zusammenhängenden Blöcken auf die Threads verteilt
+	std::atomic< bool > ok(true);
+	run_ranges(nchains, nthreads, [&](size_t c0, size_t c1)
+	{
+		for (size_t ci=c0; ci<c1 and ok; ci++)
+		{
+			size_t first = N * ci / nchains;
+			size_t last = N * (ci+1) / nchains;
+			if (not run_chain(ci, last-first, out + first*n_))
+				ok = false;
+		}
+	});
+	return ok;
+}
+
+} // namespace flux::la
+} // namespace flux
+
@@ -0,0 +1,174 @@
+#ifndef HITANDRUNSAMPLER_H
+#define HITANDRUNSAMPLER_H
+
+#include <cstddef>
+extern "C"
+{
+#include <stdint.h>
+}
+#include "Error.h"
+#include "MMatrix.h"
+#include "MVector.h"
+#include "StandardForm.h"
+
+namespace flux {
+namespace la {
+
+/**
+ * Hit-and-Run-Sampler für das durch eine StandardForm beschriebene
+ * (beschränkte) Polytop A*x<=b, lo<=x<=up. Ausgehend von einem inneren
+ * Punkt wird in jedem Schritt eine Richtung gewählt (gleichverteilt auf
+ * der Einheitssphäre bzw. eine Koordinatenrichtung), die Sehne durch
+ * das Polytop bestimmt und ein gleichverteilter Punkt auf der Sehne
+ * angesprungen. Die Markov-Kette konvergiert gegen die Gleichverteilung
+ * auf dem Polytop.
+ *
+ * Pro Thread läuft eine unabhängige Kette. Die Zufallszahlen stammen
+ * aus einem zähler-basierten Generator (Philox), dessen Strom durch
+ * seed und Kettennummer festgelegt ist; bei gleichem seed und gleicher
+ * Anzahl von Ketten sind die Ergebnisse reproduzierbar.
+ *
+ * Mit einer über ConstraintSystem::fillStandardForm gefüllten
+ * StandardForm werden so zulässige Vektoren freier Flüsse erzeugt.
+ */
+class HitAndRunSampler
+{
+public:
+	/** Wahl der Richtungen */
+	enum Mode
+	{
+		har_uniform,	// Richtung gleichverteilt auf der Einheitssphäre
+		har_coordinate	// zufällige Koordinatenrichtung
+	};
+
+	/** Voreingestellte Anzahl der Ketten (unabhängig vom Rechner) */
+	static unsigned int const default_chains = 8;
+
+private:
+	/** Anzahl der Variablen */
+	size_t n_;
+	/** Anzahl der Ungleichungen */
+	size_t m_;
+	/** Ungleichungs-Matrix A (dicht) */
+	MMatrix A_;
+	/** rechte Seite b */
+	MVector b_;
+	/** untere Schranken */
+	MVector lo_;
+	/** obere Schranken */
+	MVector up_;
+	/** Startpunkt (innerer Punkt) */
+	MVector x0_;
+	/** Ist x0_ ein gültiger, innerer Startpunkt? */
+	bool have_start_;
+	/** Richtungswahl */
+	Mode mode_;
+	/** Anzahl der verworfenen Schritte zu Beginn jeder Kette */
+	size_t burn_in_;
+	/** Anzahl der Schritte zwischen zwei ausgegebenen Punkten */
+	size_t thinning_;
+	/** Schlüssel des Zufallszahlengenerators */
+	uint64_t seed_;
+
+public:
+	/**
+	 * Constructor. Als Startpunkt wird per LP ein innerer Punkt
+	 * bestimmt (StandardForm::findInteriorPoint).
+	 *
+	 * @param SF StandardForm mit Ungleichungen und Schranken
+	 */
+	HitAndRunSampler(StandardForm const & SF);
+
+	/**
+	 * Setzt einen Startpunkt. Der Punkt sollte strikt im Inneren
+	 * des Polytops liegen.
+	 *
+	 * @param x0 Startpunkt
+	 * @return true, falls x0 zulässig ist
+	 */
+	bool setStart(MVector const & x0);
+
+	/**
+	 * Gibt den Startpunkt zurück.
+	 *
+	 * @return Startpunkt
+	 */
+	inline MVector const & getStart() const { return x0_; }
+
+	/**
+	 * Setzt die Richtungswahl.
+	 *
+	 * @param mode har_uniform oder har_coordinate
+	 */
+	inline void setMode(Mode mode) { mode_ = mode; }
+
+	/**
+	 * Setzt die Anzahl der verworfenen Schritte zu Beginn jeder Kette.
+	 *
+	 * @param burn_in Anzahl der Schritte
+	 */
+	inline void setBurnIn(size_t burn_in) { burn_in_ = burn_in; }
+
+	/**
+	 * Setzt die Anzahl der Schritte pro ausgegebenem Punkt.
+	 *
+	 * @param thinning Anzahl der Schritte (>= 1)
+	 */
+	inline void setThinning(size_t thinning)
+	{
+		thinning_ = thinning ? thinning : 1;
+	}
+
+	/**
+	 * Setzt den Schlüssel des Zufallszahlengenerators.
+	 *
+	 * @param seed Schlüssel
+	 */
+	inline void setSeed(uint64_t seed) { seed_ = seed; }
+
+	/**
+	 * Gibt die Anzahl der Variablen (Länge eines Punkts) zurück.
+	 *
+	 * @return Anzahl der Variablen
+	 */
+	inline size_t getNumVars() const { return n_; }
+
+	/**
+	 * Erzeugt N Punkte und schreibt sie spaltenweise (Fortran-Ordnung,
+	 * ein Punkt pro Spalte) nach out. Kette c schreibt den c-ten von
+	 * nchains zusammenhängenden Abschnitten von out. Das Ergebnis hängt
+	 * nur von Schlüssel, N und nchains ab, nicht von der Anzahl der
+	 * Threads, auf die die Ketten verteilt werden.
+	 *
+	 * @param N Anzahl der Punkte
+	 * @param out Puffer für n*N Werte (out)
+	 * @param nchains Anzahl der Ketten (0: default_chains)
+	 * @param nthreads Anzahl der Threads (0: Anzahl der Prozessoren)
+	 * @return false, falls kein innerer Startpunkt existiert oder das
+	 * 	Polytop unbeschränkt ist
+	 */
+	bool sample(
+		size_t N,
+		double * out,
+		unsigned int nchains = 0,
+		unsigned int nthreads = 0
+		) const;
+
+private:
+	/**
+	 * Lässt eine einzelne Kette laufen.
+	 *
+	 * @param chain Nummer der Kette
+	 * @param N Anzahl der Punkte
+	 * @param out Puffer für n*N Werte (out)
+	 * @return false, falls eine unbeschränkte Sehne gefunden wurde
+	 */
+	bool run_chain(uint64_t chain, size_t N, double * out) const;
+
+}; // class HitAndRunSampler
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
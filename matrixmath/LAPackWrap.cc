@@ -1880,53 +1880,123 @@ namespace lapack {
 #define MIN2(a,b)	((a)<=(b)?(a):(b))
 #define MAX2(a,b)	((a)>=(b)?(a):(b))
 
-void svd(MMatrix & A, MMatrix & U, MVector & s, MMatrix & VT)
+// Kennungen der Routinen für die gespeicherten Workspace-Queries
+enum {
+	r_dgesvd, r_dgetri, r_dgeqrf, r_dormqr,
+	r_dgeqp3, r_dgels, r_zgees, r_dsytrd
+};
+
+double * Workspace::dwork(DSlot slot, size_t n)
 {
-	double * WORK;
-	int LWORK = -1;
-	double ws_query;
+	if (dbuf_[slot].size() < n)
+		dbuf_[slot].resize(n);
+	return dbuf_[slot].data();
+}
 
-	dgesvd_opt_t o;
-	o.JOBU = 'A';
-	o.JOBVT = 'A';
-	o.M = A.rows();
-	o.N = A.cols();
-	o.A = A;
-	o.LDA = o.M;
-	o.S = s;
-	o.U = U;
-	o.LDU = o.M;
-	o.VT = VT;
-	o.LDVT = o.N;
+int * Workspace::iwork(ISlot slot, size_t n)
+{
+	if (ibuf_[slot].size() < n)
+		ibuf_[slot].resize(n);
+	return ibuf_[slot].data();
+}
 
-	// Fehlbedienung?
-	fASSERT( VT.rows()==size_t(o.N) && VT.cols()==size_t(o.N) );
-	fASSERT( U.rows()==size_t(o.M) && U.cols()==size_t(o.M) );
-	fASSERT( s.dim()==size_t(MIN2(o.M,o.N)) );
+COMPLEX16 * Workspace::zwork(size_t n)
+{
+	if (zbuf_.size() < 2*n)
+		zbuf_.resize(2*n);
+	return reinterpret_cast< COMPLEX16 * >(zbuf_.data());
+}
 
-	// optimale größe von WORK bestimmen (LWORK==-1)
-	DGESVD_F77(&o.JOBU,
-		&o.JOBVT,
-		&o.M,
-		&o.N,
-		 o.A,
-		&o.LDA,
-		 o.S,
-		 o.U,
-		&o.LDU,
-		 o.VT,
-		&o.LDVT,
-		&ws_query,
-		&LWORK,
-		&o.INFO
-		);
+bool Workspace::lookup(int routine, int a, int b, int c, int & lwork) const
+{
+	Key k = { routine, a, b, c };
+	std::map< Key,int >::const_iterator i = lwork_.find(k);
+	if (i == lwork_.end())
+		return false;
+	lwork = i->second;
+	return true;
+}
+
+void Workspace::store(int routine, int a, int b, int c, int lwork)
+{
+	Key k = { routine, a, b, c };
+	lwork_[k] = lwork;
+}
+
+void Workspace::clear()
+{
+	for (int i=0; i<ws_nd; i++)
+		std::vector< double >().swap(dbuf_[i]);
+	for (int i=0; i<ws_ni; i++)
+		std::vector< int >().swap(ibuf_[i]);
+	std::vector< double >().swap(zbuf_);
+	lwork_.clear();
+}
+
+Workspace & Workspace::local()
+{
+	thread_local Workspace ws;
+	return ws;
+}
+
+/**
+ * Optimales LWORK einer Routine: aus dem Workspace oder, beim ersten
+ * Aufruf mit diesen Dimensionen, per Workspace-Query (LWORK=-1).
+ *
+ * @param ws Workspace
+ * @param routine Kennung der Routine
+ * @param a,b,c Dimensionen
+ * @param LWORK optimales LWORK (out)
+ * @param query führt die Query aus: query(&ws_query, &LWORK, &INFO)
+ * @return false, falls die Query fehlschlägt
+ */
+template< typename Query > static bool ws_lwork(
+	Workspace & ws,
+	int routine,
+	int a,
+	int b,
+	int c,
+	int & LWORK,
+	Query query
+	)
+{
+	double ws_query = 0.;
+	int INFO = 0;
 
-	if (o.INFO != 0)
+	if (ws.lookup(routine, a, b, c, LWORK))
+		return true;
+	LWORK = -1;
+	query(&ws_query, &LWORK, &INFO);
+	if (INFO != 0)
+		return false;
+	LWORK = MAX2(1, int(ws_query));
+	ws.store(routine, a, b, c, LWORK);
+	return true;
+}
+
+/**
+ * Ruft DGESVD mit WORK aus dem Workspace auf. Die optimale Größe von
+ * WORK hängt von JOBU/JOBVT ab und wird daher getrennt abgelegt.
+ *
+ * @param o Parameter von DGESVD (in/out)
+ * @param w Workspace
+ */
+static void dgesvd_ws(dgesvd_opt_t & o, Workspace & w)
+{
+	double * WORK;
+	int LWORK;
+	int job = (o.JOBU == 'N' and o.JOBVT == 'N') ? 1 : 0;
+
+	// optimale größe von WORK bestimmen (LWORK==-1)
+	if (not ws_lwork(w, r_dgesvd, o.M, o.N, job, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGESVD_F77(&o.JOBU, &o.JOBVT, &o.M, &o.N, o.A, &o.LDA,
+				o.S, o.U, &o.LDU, o.VT, &o.LDVT, q, lw, info);
+		}))
 		return;
 
-	// WORK allokieren und SVD berechnen
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	// WORK bereitstellen und SVD berechnen
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 	DGESVD_F77(&o.JOBU,
 		&o.JOBVT,
 		&o.M,
@@ -1942,18 +2012,56 @@ void svd(MMatrix & A, MMatrix & U, MVector & s, MMatrix & VT)
 		&LWORK,
 		&o.INFO
 		);
-	delete[] WORK;
 }
 
-void svd(MMatrix & A, MVector & s)
+void svd(MMatrix & A, MMatrix & U, MVector & s, MMatrix & VT, Workspace * ws)
 {
-	// FORTRAN-KACK!
-	// JOBU='N', JOBVT='N' führt nur zu Segfaults :-(
-	// Angeblich werden U und VT dann nicht verwendet -- das ist aber
-	// nicht so!
-	MMatrix U(A.rows(),A.rows());
-	MMatrix VT(A.cols(),A.cols());
-	svd(A,U,s,VT);
+	dgesvd_opt_t o;
+	o.JOBU = 'A';
+	o.JOBVT = 'A';
+	o.M = A.rows();
+	o.N = A.cols();
+	o.A = A;
+	o.LDA = o.M;
+	o.S = s;
+	o.U = U;
+	o.LDU = o.M;
+	o.VT = VT;
+	o.LDVT = o.N;
+	o.INFO = 0;
+
+	// Fehlbedienung?
+	fASSERT( VT.rows()==size_t(o.N) && VT.cols()==size_t(o.N) );
+	fASSERT( U.rows()==size_t(o.M) && U.cols()==size_t(o.M) );
+	fASSERT( s.dim()==size_t(MIN2(o.M,o.N)) );
+
+	dgesvd_ws(o, ws ? *ws : Workspace::local());
+}
+
+void svd(MMatrix & A, MVector & s, Workspace * ws)
+{
+	// nur Singulärwerte: U und VT werden bei JOBU=JOBVT='N' nicht
+	// referenziert, LDU und LDVT müssen aber >= 1 sein. Ein gültiger
+	// (1-elementiger) Speicher schützt vor Implementierungen, die die
+	// Zeiger dennoch prüfen.
+	double dummy = 0.;
+	dgesvd_opt_t o;
+	o.JOBU = 'N';
+	o.JOBVT = 'N';
+	o.M = A.rows();
+	o.N = A.cols();
+	o.A = A;
+	o.LDA = o.M;
+	o.S = s;
+	o.U = &dummy;
+	o.LDU = 1;
+	o.VT = &dummy;
+	o.LDVT = 1;
+	o.INFO = 0;
+
+	fASSERT( s.dim()==size_t(MIN2(o.M,o.N)) );
+
+	dgesvd_ws(o, ws ? *ws : Workspace::local());
 }
 
 bool LUfactor(MMatrix & A, PMatrix & P)
@@ -2001,40 +2109,43 @@ bool LUsolve(MMatrix & LU, PMatrix & P, MMatrix & B)
 	return INFO == 0;
 }
 
-bool invert(MMatrix & A)
+bool invert(MMatrix & A, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int M = A.rows();
 	int N = A.cols();
 	int INFO = 0;
 	int LWORK;
-	double * WORK, ws_query;
-	PMatrix P(N);
+	double * WORK;
+	unsigned int * IPIV = reinterpret_cast< unsigned int * >(
+		w.iwork(Workspace::ws_ipiv, N));
 	
 	fASSERT(M == N);
-	DGETRF_F77(&M,&N,A,&M,P,&INFO);
+	DGETRF_F77(&M,&N,A,&M,IPIV,&INFO);
 	fASSERT(INFO >= 0); // ansonsten illegal argument
 	if (INFO != 0)
 		return false;
 
 	// workspace query
-	LWORK = -1;
-	DGETRI_F77(&N,A,&N,P,&ws_query,&LWORK,&INFO);
-	if (INFO != 0)
+	if (not ws_lwork(w, r_dgetri, N, 0, 0, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGETRI_F77(&N,A,&N,IPIV,q,lw,info);
+		}))
 		return false;
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 
-	DGETRI_F77(&N,A,&N,P,WORK,&LWORK,&INFO);
-	delete[] WORK;
+	DGETRI_F77(&N,A,&N,IPIV,WORK,&LWORK,&INFO);
 	return INFO == 0;
 }
 
-bool linsolve(MMatrix & A, MMatrix & XB)
+bool linsolve(MMatrix & A, MMatrix & XB, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int N = A.rows();
 	int NRHS = XB.cols();
 	int INFO = 0;
-	PMatrix IPIV(N);
+	unsigned int * IPIV = reinterpret_cast< unsigned int * >(
+		w.iwork(Workspace::ws_ipiv, N));
 
 	fASSERT(XB.rows() == size_t(N));
 	DGESV_F77(&N,&NRHS,A,&N,IPIV,XB,&N,&INFO);
@@ -2042,12 +2153,14 @@ bool linsolve(MMatrix & A, MMatrix & XB)
 	return INFO == 0;
 }
 
-bool linsolve(MMatrix & A, MVector & xb)
+bool linsolve(MMatrix & A, MVector & xb, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int N = A.rows();
 	int NRHS = 1;
 	int INFO = 0;
-	PMatrix IPIV(N);
+	unsigned int * IPIV = reinterpret_cast< unsigned int * >(
+		w.iwork(Workspace::ws_ipiv, N));
 
 	fASSERT(xb.dim() == size_t(N));
 	DGESV_F77(&N,&NRHS,A,&N,IPIV,xb,&N,&INFO);
@@ -2055,8 +2168,9 @@ bool linsolve(MMatrix & A, MVector & xb)
 	return INFO == 0;
 }
 
-bool qr(MMatrix & A, MMatrix * Q, MMatrix * R)
+bool qr(MMatrix & A, MMatrix * Q, MMatrix * R, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int i,j;
 	int K;
 	int M = A.rows();
@@ -2064,9 +2178,8 @@ bool qr(MMatrix & A, MMatrix * Q, MMatrix * R)
 	int LDA = M;
 	double * TAU;
 	int INFO;
-	int LWORK = -1; // workspace query
+	int LWORK;
 	double * WORK;
-	double ws_query;
 
 	if ((Q==0) != (R==0))
 		return false;
@@ -2080,28 +2193,21 @@ bool qr(MMatrix & A, MMatrix * Q, MMatrix * R)
 		return false;
 	
 	// Zur Rekonstruktion von Q
-	TAU = new double[MIN2(M,N)];
+	TAU = w.dwork(Workspace::ws_tau, MIN2(M,N));
 
 	// Workspace query:
-	DGEQRF_F77(&M,&N,A,&LDA,TAU,&ws_query,&LWORK,&INFO);
-
-	if (INFO != 0)
-	{
-		delete[] TAU;
+	if (not ws_lwork(w, r_dgeqrf, M, N, 0, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGEQRF_F77(&M,&N,A,&LDA,TAU,q,lw,info);
+		}))
 		return false;
-	}
 
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 	
 	DGEQRF_F77(&M,&N,A,&LDA,TAU,WORK,&LWORK,&INFO);
 
 	if (INFO != 0)
-	{
-		delete[] TAU;
-		delete[] WORK;
 		return false;
-	}
 
 	if (R != 0)
 	{
@@ -2129,55 +2235,47 @@ bool qr(MMatrix & A, MMatrix * Q, MMatrix * R)
 			for (j=0; j<M; j++)
 				Q->set(i,j,i==j ? 1. : 0.);
 
-		delete[] WORK;
-		LWORK = -1; // workspace query
 		K = M;
-		DORMQR_F77(&SIDE,&TRANS,&M,&M,&K,A,&LDA,TAU,(*Q),&LDC,&ws_query,&LWORK,&INFO);
-		if (INFO != 0)
-		{
-			delete[] TAU;
+		if (not ws_lwork(w, r_dormqr, M, M, K, LWORK,
+			[&](double * q, int * lw, int * info) {
+				DORMQR_F77(&SIDE,&TRANS,&M,&M,&K,A,&LDA,TAU,(*Q),&LDC,q,lw,info);
+			}))
 			return false;
-		}
-		LWORK = (int)ws_query;
-		WORK = new double[LWORK];
+		WORK = w.dwork(Workspace::ws_work, LWORK);
 		// berechne C = Q*I = Q
 		DORMQR_F77(&SIDE,&TRANS,&M,&M,&K,A,&LDA,TAU,(*Q),&LDC,WORK,&LWORK,&INFO);
 	}
 
-	delete[] TAU;
-	delete[] WORK;
 	return INFO == 0;
 }
 
-int qr_rank(MMatrix A)
+int qr_rank(MMatrix A, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int M = A.rows();
 	int N = A.cols();
 	int LDA = M;
-	PMatrix P(N);
-	int * JPVT = reinterpret_cast< int * >((unsigned int *)P);
+	int * JPVT = w.iwork(Workspace::ws_iwork, N);
 	double * TAU;
 	int INFO;
-	int LWORK = -1; // workspace query
+	int LWORK;
 	double * WORK;
-	double ws_query;
 	double tol = MAX2(M,N) * 10 * MACHEPS;
 	
-	TAU = new double[MIN2(M,N)];
+	// freie Spalten (DGEQP3 liest JPVT)
+	for (int j=0; j<N; j++)
+		JPVT[j] = 0;
+	TAU = w.dwork(Workspace::ws_tau, MIN2(M,N));
 	// Workspace query:
-	DGEQP3_F77(&M,&N,A,&LDA,JPVT,TAU,&ws_query,&LWORK,&INFO);
-	if (INFO != 0)
-	{
-		delete[] TAU;
+	if (not ws_lwork(w, r_dgeqp3, M, N, 0, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGEQP3_F77(&M,&N,A,&LDA,JPVT,TAU,q,lw,info);
+		}))
 		return -1;
-	}
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 	
 	DGEQP3_F77(&M,&N,A,&LDA,JPVT,TAU,WORK,&LWORK,&INFO);
 
-	delete[] TAU;
-	delete[] WORK;
 	if (INFO != 0)
 		return -1;
 
@@ -2191,8 +2289,9 @@ int qr_rank(MMatrix A)
 	return 0;
 }
 
-bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P)
+bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int i,j;
 	int K;
 	int M = A.rows();
@@ -2201,9 +2300,8 @@ bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P)
 	int * JPVT = reinterpret_cast< int * >((unsigned int *)P);
 	double * TAU;
 	int INFO;
-	int LWORK = -1; // workspace query
+	int LWORK;
 	double * WORK;
-	double ws_query;
 
 	// falsche Dimension von Q?
 	if (Q.rows() != A.rows() or Q.cols() != A.rows())
@@ -2219,28 +2317,21 @@ bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P)
 	
 	// Zur Rekonstruktion von Q
 	K = MIN2(M,N);
-	TAU = new double[K];
+	TAU = w.dwork(Workspace::ws_tau, K);
 
 	// Workspace query:
-	DGEQP3_F77(&M,&N,A,&LDA,JPVT,TAU,&ws_query,&LWORK,&INFO);
-
-	if (INFO != 0)
-	{
-		delete[] TAU;
+	if (not ws_lwork(w, r_dgeqp3, M, N, 0, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGEQP3_F77(&M,&N,A,&LDA,JPVT,TAU,q,lw,info);
+		}))
 		return false;
-	}
 
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 	
 	DGEQP3_F77(&M,&N,A,&LDA,JPVT,TAU,WORK,&LWORK,&INFO);
 
 	if (INFO != 0)
-	{
-		delete[] TAU;
-		delete[] WORK;
 		return false;
-	}
 
 	// R retten
 	for (j=0; j<N; j++)
@@ -2260,16 +2351,12 @@ bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P)
 		for (j=0; j<M; j++)
 			Q(i,j) = (i==j) ? 1. : 0.;
 
-	delete[] WORK;
-	LWORK = -1; // workspace query
-	DORMQR_F77(&SIDE,&TRANS,&M,&M,&K,A,&LDA,TAU,Q,&LDC,&ws_query,&LWORK,&INFO);
-	if (INFO != 0)
-	{
-		delete[] TAU;
+	if (not ws_lwork(w, r_dormqr, M, M, K, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DORMQR_F77(&SIDE,&TRANS,&M,&M,&K,A,&LDA,TAU,Q,&LDC,q,lw,info);
+		}))
 		return false;
-	}
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 	// berechne C = Q*I = Q
 	DORMQR_F77(&SIDE,&TRANS,&M,&M,&K,A,&LDA,TAU,Q,&LDC,WORK,&LWORK,&INFO);
 
@@ -2277,8 +2364,6 @@ bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P)
 	for (i=0; i<N; i++)
 		P(i) -= 1;
 
-	delete[] TAU;
-	delete[] WORK;
 	return INFO == 0;
 }
 
@@ -2372,8 +2457,9 @@ int lssolve(MMatrix & A, MVector const & b, MVector & x, GVector< int > JPVT, do
 }
 #endif
 
-bool lssolve(MMatrix & A, MVector const & b, MVector & x)
+bool lssolve(MMatrix & A, MVector const & b, MVector & x, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int i;
 	char TRANS = 'N';
 	int M = A.rows();
@@ -2381,41 +2467,42 @@ bool lssolve(MMatrix & A, MVector const & b, MVector & x)
 	int NRHS = 1;
 	int LDA = M;
 	int LDB = MAX2(M,N);
-	double * WORK, ws_query;
+	double * WORK, * xb;
 	int LWORK;
 	int INFO;
 
 	if (b.dim() != A.rows() or x.dim() != A.cols())
 		return false;
 
-	MVector xb(MAX2(M,N));
+	xb = w.dwork(Workspace::ws_aux, LDB);
 	for (i=0; i<M; i++)
-		xb(i) = b.get(i);
+		xb[i] = b.get(i);
+	for (; i<LDB; i++)
+		xb[i] = 0.;
 
 	// workspace query
-	LWORK = -1;
-	DGELS_F77(&TRANS,&M,&N,&NRHS,A,&LDA,xb,&LDB,&ws_query,&LWORK,&INFO);
-
-	if (INFO != 0)
+	if (not ws_lwork(w, r_dgels, M, N, NRHS, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGELS_F77(&TRANS,&M,&N,&NRHS,A,&LDA,xb,&LDB,q,lw,info);
+		}))
 		return false;
 
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 
 	DGELS_F77(&TRANS,&M,&N,&NRHS,A,&LDA,xb,&LDB,WORK,&LWORK,&INFO);
-	delete[] WORK;
 
 	if (INFO != 0)
 		return false;
 
 	for (i=0; i<N; i++)
-		x(i) = xb(i);
+		x(i) = xb[i];
 
 	return true;
 }
 
-bool lssolve(MMatrix & A, MMatrix const & B, MMatrix & X)
+bool lssolve(MMatrix & A, MMatrix const & B, MMatrix & X, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	int i,j;
 	char TRANS = 'N';
 	int M = A.rows();
@@ -2423,37 +2510,39 @@ bool lssolve(MMatrix & A, MMatrix const & B, MMatrix & X)
 	int NRHS = B.cols();
 	int LDA = M;
 	int LDB = MAX2(M,N);
-	double * WORK, ws_query;
+	double * WORK, * XB;
 	int LWORK;
 	int INFO;
 
 	if (B.rows() != A.rows() or B.cols() != X.cols() or A.cols() != X.rows())
 		return false;
 
-	MMatrix XB(MAX2(M,N),NRHS);
+	XB = w.dwork(Workspace::ws_aux, size_t(LDB)*NRHS);
 	for (j=0; j<NRHS; j++)
+	{
 		for (i=0; i<M; i++)
-			XB(i,j) = B.get(i,j);
+			XB[j*LDB+i] = B.get(i,j);
+		for (; i<LDB; i++)
+			XB[j*LDB+i] = 0.;
+	}
 
 	// workspace query
-	LWORK = -1;
-	DGELS_F77(&TRANS,&M,&N,&NRHS,A,&LDA,XB,&LDB,&ws_query,&LWORK,&INFO);
-
-	if (INFO != 0)
+	if (not ws_lwork(w, r_dgels, M, N, NRHS, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DGELS_F77(&TRANS,&M,&N,&NRHS,A,&LDA,XB,&LDB,q,lw,info);
+		}))
 		return false;
 
-	LWORK = (int)ws_query;
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, LWORK);
 
 	DGELS_F77(&TRANS,&M,&N,&NRHS,A,&LDA,XB,&LDB,WORK,&LWORK,&INFO);
-	delete[] WORK;
 
 	if (INFO != 0)
 		return false;
 
 	for (j=0; j<NRHS; j++)
 		for (i=0; i<N; i++)
-			X(i,j) = XB(i,j);
+			X(i,j) = XB[j*LDB+i];
 
 	return true;
 }
@@ -2506,8 +2595,9 @@ bool lssolve_svd(MMatrix & A, MVector const & b, MVector & x, int & RANK, double
 
 extern int ZGEES_SELECT(COMPLEX16) { return 1; }
 
-bool schur(GMatrix< COMPLEX16 > & A, GVector< COMPLEX16 > & w, GMatrix< COMPLEX16 > & Z)
+bool schur(GMatrix< COMPLEX16 > & A, GVector< COMPLEX16 > & w, GMatrix< COMPLEX16 > & Z, Workspace * ws)
 {
+	Workspace & wsp = ws ? *ws : Workspace::local();
 	char JOBVS = 'V';
 	char SORT = 'S';
 	int N = A.rows();
@@ -2515,25 +2605,23 @@ bool schur(GMatrix< COMPLEX16 > & A, GVector< COMPLEX16 > & w, GMatrix< COMPLEX1
 	int SDIM;
 	int LDVS = N;
 	COMPLEX16 * WORK;
-	COMPLEX16 wsquery;
-	int LWORK = -1;
-	double * RWORK = new double[N];
-	int * BWORK = new int[N];
+	int LWORK;
+	double * RWORK = wsp.dwork(Workspace::ws_aux, N);
+	int * BWORK = wsp.iwork(Workspace::ws_iwork, N);
 	int INFO;
 
 	// Workspace Query:
-	ZGEES_F77(&JOBVS,&SORT,ZGEES_SELECT,&N,A,&LDA,&SDIM,w,Z,&LDVS,&wsquery,&LWORK,RWORK,BWORK,&INFO);
-
-	if (INFO != 0)
+	if (not ws_lwork(wsp, r_zgees, N, 0, 0, LWORK,
+		[&](double * q, int * lw, int * info) {
+			COMPLEX16 wsquery;
+			ZGEES_F77(&JOBVS,&SORT,ZGEES_SELECT,&N,A,&LDA,&SDIM,w,Z,&LDVS,&wsquery,lw,RWORK,BWORK,info);
+			*q = wsquery.real();
+		}))
 		return false;
-	LWORK = int(wsquery.real());
-	WORK = new COMPLEX16[LWORK];
+	WORK = wsp.zwork(LWORK);
 	
 	ZGEES_F77(&JOBVS,&SORT,ZGEES_SELECT,&N,A,&LDA,&SDIM,w,Z,&LDVS,WORK,&LWORK,RWORK,BWORK,&INFO);
 
-	delete[] WORK;
-	delete[] BWORK;
-	delete[] RWORK;
 	return INFO == 0;
 }
 
@@ -2552,33 +2640,32 @@ bool cholesky(MMatrix & A)
 	return INFO == 0;
 }
 
-bool symmeig(MMatrix & A, MVector & W)
+bool symmeig(MMatrix & A, MVector & W, Workspace * ws)
 {
+	Workspace & w = ws ? *ws : Workspace::local();
 	char UPLO = 'U';
 	int N = A.rows();
 	int LDA = N;
-	MVector D(N);
-	MVector E(N-1);
-	MVector TAU(N-1);
-	int LWORK = -1; // workspace query
-	double wsquery;
+	double * D = w.dwork(Workspace::ws_aux, N);
+	double * E = w.dwork(Workspace::ws_aux2, MAX2(N-1,1));
+	double * TAU = w.dwork(Workspace::ws_tau, MAX2(N-1,1));
+	int LWORK;
 	double * WORK;
 	int INFO;
 
 	// workspace query
-	DSYTRD_F77(&UPLO,&N,A,&LDA,D,E,TAU,&wsquery,&LWORK,&INFO);
-	if (INFO != 0)
-	{
-		fINFO("DSYTRD workspace query returned with INFO=%i", INFO);
+	if (not ws_lwork(w, r_dsytrd, N, 0, 0, LWORK,
+		[&](double * q, int * lw, int * info) {
+			DSYTRD_F77(&UPLO,&N,A,&LDA,D,E,TAU,q,lw,info);
+			if (*info != 0)
+				fINFO("DSYTRD workspace query returned with INFO=%i", *info);
+		}))
 		return false;
-	}
-	LWORK = int(wsquery);
-	WORK = new double[LWORK];
+	WORK = w.dwork(Workspace::ws_work, MAX2(LWORK,4*N));
 	DSYTRD_F77(&UPLO,&N,A,&LDA,D,E,TAU,WORK,&LWORK,&INFO);
 	if (INFO != 0)
 	{
 		fINFO("DSYTRD returned with INFO=%i", INFO);
-		delete[] WORK;
 		return false;
 	}
 
@@ -2587,17 +2674,13 @@ bool symmeig(MMatrix & A, MVector & W)
 	double ABSTOL = 0.;
 	int M;
 	int NSPLIT;
-	W = MVector(N);
-	int * IBLOCK = new int[N];
-	int * ISPLIT = new int[N];
-	delete[] WORK; WORK = new double[4*N];
-	int * IWORK = new int[3*N];
+	if (W.dim() != size_t(N))
+		W = MVector(N);
+	int * IBLOCK = w.iwork(Workspace::ws_iaux, N);
+	int * ISPLIT = w.iwork(Workspace::ws_iaux2, N);
+	int * IWORK = w.iwork(Workspace::ws_iwork, 3*N);
 	DSTEBZ_F77(&RANGE,&ORDER,&N,0,0,0,0,&ABSTOL,D,E,&M,&NSPLIT,W,IBLOCK,ISPLIT,WORK,IWORK,&INFO);
 
-	delete[] IBLOCK;
-	delete[] ISPLIT;
-	delete[] WORK;
-	delete[] IWORK;
 	if (INFO != 0)
 		fWARNING("DSTEBZ returned INFO=%i", INFO);
 	return INFO == 0;
@@ -1,6 +1,9 @@
 #ifndef LAPACKWRAP_H
 #define LAPACKWRAP_H
 
+#include <cstddef>
+#include <map>
+#include <vector>
 #include "MMatrix.h"
 #include "MVector.h"
 #include "PMatrix.h"
@@ -23,13 +26,131 @@ namespace flux {
 namespace la {
 namespace lapack {
 
+/**
+ * Wiederverwendbarer Arbeitsspeicher für die LAPACK-Wrapper.
+ *
+ * Statt bei jedem Aufruf eine Workspace-Query auszuführen und WORK, TAU,
+ * IWORK, ... mit new[] zu allokieren, verwenden die Wrapper die Puffer
+ * eines Workspace-Objekts. Die Puffer wachsen nur; die Ergebnisse der
+ * Workspace-Queries werden je Routine und Dimension gespeichert. Nach dem
+ * ersten Aufruf mit gegebenen Dimensionen wird der Allokator nicht mehr
+ * verwendet.
+ *
+ * Ein Workspace darf nicht gleichzeitig von mehreren Threads verwendet
+ * werden. Wird kein Workspace übergeben, verwenden die Wrapper den
+ * thread-lokalen Workspace local(). Ein eigener Workspace kann z.B. über
+ * die Iterationen einer Optimierung gehalten werden.
+ */
+class Workspace
+{
+public:
+	/** Puffer für double-Arrays */
+	enum DSlot { ws_work, ws_tau, ws_aux, ws_aux2, ws_nd };
+	/** Puffer für int-Arrays */
+	enum ISlot { ws_iwork, ws_ipiv, ws_iaux, ws_iaux2, ws_ni };
+
+private:
+	/** Schlüssel einer Workspace-Query: Routine und Dimensionen */
+	struct Key
+	{
+		int r, a, b, c;
+		bool operator< (Key const & k) const
+		{
+			if (r != k.r) return r < k.r;
+			if (a != k.a) return a < k.a;
+			if (b != k.b) return b < k.b;
+			return c < k.c;
+		}
+	};
+
+	/** double-Puffer */
+	std::vector< double > dbuf_[ws_nd];
+	/** int-Puffer */
+	std::vector< int > ibuf_[ws_ni];
+	/** COMPLEX16-Puffer (als Paare von double) */
+	std::vector< double > zbuf_;
+	/** Ergebnisse der Workspace-Queries (optimales LWORK) */
+	std::map< Key,int > lwork_;
+
+public:
+	/** Constructor */
+	Workspace() { }
+
+private:
+	Workspace(Workspace const &);
+	Workspace & operator= (Workspace const &);
+
+public:
+	/**
+	 * Liefert einen double-Puffer mit mindestens n Elementen. Der Inhalt
+	 * ist undefiniert; der Zeiger bleibt bis zum nächsten Aufruf für
+	 * denselben Puffer gültig.
+	 *
+	 * @param slot Puffer
+	 * @param n Anzahl der Elemente
+	 * @return Zeiger auf den Puffer
+	 */
+	double * dwork(DSlot slot, size_t n);
+
+	/**
+	 * Liefert einen int-Puffer mit mindestens n Elementen.
+	 *
+	 * @param slot Puffer
+	 * @param n Anzahl der Elemente
+	 * @return Zeiger auf den Puffer
+	 */
+	int * iwork(ISlot slot, size_t n);
+
+	/**
+	 * Liefert einen COMPLEX16-Puffer mit mindestens n Elementen.
+	 *
+	 * @param n Anzahl der Elemente
+	 * @return Zeiger auf den Puffer
+	 */
+	COMPLEX16 * zwork(size_t n);
+
+	/**
+	 * Sucht das Ergebnis einer früheren Workspace-Query.
+	 *
+	 * @param routine Kennung der LAPACK-Routine (und Variante)
+	 * @param a,b,c Dimensionen
+	 * @param lwork optimales LWORK (out)
+	 * @return true, falls vorhanden
+	 */
+	bool lookup(int routine, int a, int b, int c, int & lwork) const;
+
+	/**
+	 * Speichert das Ergebnis einer Workspace-Query.
+	 *
+	 * @param routine Kennung der LAPACK-Routine (und Variante)
+	 * @param a,b,c Dimensionen
+	 * @param lwork optimales LWORK
+	 */
+	void store(int routine, int a, int b, int c, int lwork);
+
+	/**
+	 * Gibt alle Puffer frei.
+	 */
+	void clear();
+
+	/**
+	 * Thread-lokaler Workspace, den die Wrapper ohne expliziten
+	 * Workspace verwenden.
+	 *
+	 * @return Referenz auf den Workspace des aufrufenden Threads
+	 */
+	static Workspace & local();
+
+}; // class Workspace
+
 /**
  * Singulärwertzerlegung.
  *
  * @param A MxN-Matrix (nach dem Aufruf zerstört) (in/out)
  * @param s Vektor mit berechneten Singulärwerten (Dimension min(M,N)) (out)
+ * @param ws Workspace (0: thread-lokaler Workspace)
  */
-void svd(MMatrix & A, MVector & s);
+void svd(MMatrix & A, MVector & s, Workspace * ws = 0);
 
 /**
  * Singulärwertzerlegung. A=U . diag(s) . VT
@@ -41,8 +162,9 @@ void svd(MMatrix & A, MVector & s);
  * @param U MxM-Matrix
  * @param s Vektor mit berechneten Singulärwerten (Dimension min(M,N))
  * @param VT NxN-Matrix
+ * @param ws Workspace (0: thread-lokaler Workspace)
  */
-void svd(MMatrix & A, MMatrix & U, MVector & s, MMatrix & VT);
+void svd(MMatrix & A, MMatrix & U, MVector & s, MMatrix & VT, Workspace * ws = 0);
 
 /**
  * LU-Faktorisierung. Die übergebene Matrix wird LU(P)-zerlegt.
@@ -79,9 +201,10 @@ bool LUsolve(MMatrix & LU, PMatrix & P, MMatrix & B);
  * Matrix-Inversion über LU(P)-Zerlegung mit DGETRF+DGETRI.
  *
  * @param A Matrix
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return false bei singulärer Matrix A, sonst true
  */
-bool invert(MMatrix & A);
+bool invert(MMatrix & A, Workspace * ws = 0);
 
 /**
  * Multi-RHS-Gleichungssystemlöser (LU, Blackbox).
@@ -89,9 +212,10 @@ bool invert(MMatrix & A);
  *
  * @param A NxN-Matrix (in/out)
  * @param XB rechte Seite (in) / Lösung (out)
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return false bei singulärer Matrix A, sonst true
  */
-bool linsolve(MMatrix & A, MMatrix & XB);
+bool linsolve(MMatrix & A, MMatrix & XB, Workspace * ws = 0);
 
 /**
  * Gleichungssystemlöser (LU, Blackbox).
@@ -99,9 +223,10 @@ bool linsolve(MMatrix & A, MMatrix & XB);
  *
  * @param A NxN-Matrix (in/out)
  * @param xb rechte Seite (in) / Lösung (out)
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return false bei singulärer Matrix A, sonst true
  */
-bool linsolve(MMatrix & A, MVector & xb);
+bool linsolve(MMatrix & A, MVector & xb, Workspace * ws = 0);
 
 /**
  * QR-Faktorisierung. A = Q.R
@@ -111,9 +236,10 @@ bool linsolve(MMatrix & A, MVector & xb);
  * @param A MxN-Matrix
  * @param Q Zeiger auf orthogonale MxM-Matrix
  * @param R Zeiger auf MxN-Matrix
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return false im Fehlerfall
  */
-bool qr(MMatrix & A, MMatrix * Q = 0, MMatrix * R = 0);
+bool qr(MMatrix & A, MMatrix * Q = 0, MMatrix * R = 0, Workspace * ws = 0);
 
 /**
  * QR-Faktorisierung. A = Q.R
@@ -122,16 +248,18 @@ bool qr(MMatrix & A, MMatrix * Q = 0, MMatrix * R = 0);
  * @param A MxN-Matrix
  * @param Q Orthogonale MxM-Matrix
  * @param R MxN-Matrix
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return false im Fehlerfall
  */
-inline bool qr(MMatrix & A, MMatrix & Q, MMatrix & R) { return qr(A,&Q,&R); }
+inline bool qr(MMatrix & A, MMatrix & Q, MMatrix & R, Workspace * ws = 0) { return qr(A,&Q,&R,ws); }
 
 /**
  * Rangbestimmung mit QR(P)-Faktorisierung.
  *
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return rang(A) oder -1 bei Fehler
  */
-int qr_rank(MMatrix A);
+int qr_rank(MMatrix A, Workspace * ws = 0);
 
 /**
  * QR(P)-Faktorisierung (QR-Faktorisierung mit Spalten-Pivotisierung). A.P=Q.R
@@ -140,9 +268,10 @@ int qr_rank(MMatrix A);
  * @param Q Orthogonale MxM-Matrix
  * @param R MxN-Matrix
  * @param P NxN-Permutationsmatrix der Spaltenpermutation
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return false im Fehlerfall
  */
-bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P);
+bool qrp(MMatrix & A, MMatrix & Q, MMatrix & R, PMatrix & P, Workspace * ws = 0);
 
 #if 0
 /**
@@ -179,9 +308,10 @@ int lssolve(MMatrix & A, MVector const & b, MVector & x, GVector< int > JPVT, do
  * @param A MxN-Matrix
  * @param b M-Konstantenvektor
  * @param x N-Lösungsvektor
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return true, falls alles ok
  */
-bool lssolve(MMatrix & A, MVector const & b, MVector & x);
+bool lssolve(MMatrix & A, MVector const & b, MVector & x, Workspace * ws = 0);
 
 /**
  * QR-Least-Squares-Solver für beliebige Systeme (DGELS).
@@ -190,9 +320,10 @@ bool lssolve(MMatrix & A, MVector const & b, MVector & x);
  * @param A MxN-Matrix
  * @param B MxL-Konstantenmatrix
  * @param X NxL-Lösungsmatrix
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return true, falls alles ok
  */
-bool lssolve(MMatrix & A, MMatrix const & B, MMatrix & X);
+bool lssolve(MMatrix & A, MMatrix const & B, MMatrix & X, Workspace * ws = 0);
 
 #if 0
 // NICHT FERTIG?!
@@ -219,9 +350,10 @@ bool lssolve_svd(MMatrix & A, MVector const & b, MVector & x, int & RANK, double
  * @param A komplexe Matrix; wird mit T überschrieben (in/out)
  * @param w komplexer Vektor mit Eigenwerten (out)
  * @param Z Unitäre Matrix Z
+ * @param ws Workspace (0: thread-lokaler Workspace)
  * @return true, falls alles ok
  */
-bool schur(GMatrix< COMPLEX16 > & A, GVector< COMPLEX16 > & w, GMatrix< COMPLEX16 > & Z);
+bool schur(GMatrix< COMPLEX16 > & A, GVector< COMPLEX16 > & w, GMatrix< COMPLEX16 > & Z, Workspace * ws = 0);
 
 /**
  * Cholesky-Zerlegung A = U^T.U einer symmetrischen, positiv
@@ -237,8 +369,9 @@ bool cholesky(MMatrix & A);
  *
  * @param A symmetrische Matrix (in)
  * @param W aufsteigend sortierte Eigenwerte (out)
+ * @param ws Workspace (0: thread-lokaler Workspace)
  */
-bool symmeig(MMatrix & A, MVector & W);
+bool symmeig(MMatrix & A, MVector & W, Workspace * ws = 0);
 
 } // namespace flux::la::lapack
 } // namespace flux::la
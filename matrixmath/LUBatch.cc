@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Error.h"
+#include "Threads.h"
+#include "MMatrix.h"
+#include "MVector.h"
+#include "LUBatch.h"
+
+namespace flux {
+namespace la {
+
+// Mindestanzahl Multiplikationen pro Thread; darunter überwiegt der
+// Aufwand für das Starten der Threads
+#define LUB_MIN_WORK_PER_THREAD	(1 << 16)
+
+// Element (i,j) in Lane l eines Blocks a
+#define LUB(a,i,j,l)	(a)[((j)*n+(i))*LUB_LANES+(l)]
+
+namespace {
+
+/**
+ * LU-Zerlegung eines Blocks (LUB_LANES Matrizen) mit partieller
+ * Pivotsuche. Die Schleifen über l haben feste Länge und werden
+ * vektorisiert; nur der Zeilentausch erfolgt je Lane.
+ */
+void factor_block(size_t n, double * a, size_t * piv, size_t * info)
+{
+	size_t i, j, k, l;
+	double amax[LUB_LANES], rinv[LUB_LANES], v;
+	size_t ip[LUB_LANES];
+
+	for (l=0; l<LUB_LANES; l++)
+		info[l] = 0;
+
+	for (k=0; k<n; k++)
+	{
+		// Pivotsuche in Spalte k
+		for (l=0; l<LUB_LANES; l++)
+		{
+			amax[l] = ::fabs(LUB(a,k,k,l));
+			ip[l] = k;
+		}
+		for (i=k+1; i<n; i++)
+			for (l=0; l<LUB_LANES; l++)
+			{
+				v = ::fabs(LUB(a,i,k,l));
+				ip[l] = v > amax[l] ? i : ip[l];
+				amax[l] = v > amax[l] ? v : amax[l];
+			}
+
+		// Zeilentausch (je Lane verschieden)
+		for (l=0; l<LUB_LANES; l++)
+		{
+			piv[k*LUB_LANES+l] = ip[l];
+			if (ip[l] != k)
+				for (j=0; j<n; j++)
+				{
+					v = LUB(a,k,j,l);
+					LUB(a,k,j,l) = LUB(a,ip[l],j,l);
+					LUB(a,ip[l],j,l) = v;
+				}
+			if (amax[l] == 0. and info[l] == 0)
+				info[l] = k+1;
+		}
+
+		// Elimination; bei Null-Pivot (singulär) wie dgetrf ohne Skalierung
+		for (l=0; l<LUB_LANES; l++)
+			rinv[l] = LUB(a,k,k,l) != 0. ? 1./LUB(a,k,k,l) : 0.;
+		for (i=k+1; i<n; i++)
+			for (l=0; l<LUB_LANES; l++)
+				LUB(a,i,k,l) *= rinv[l];
+		for (j=k+1; j<n; j++)
+			for (i=k+1; i<n; i++)
+				for (l=0; l<LUB_LANES; l++)
+					LUB(a,i,j,l) -= LUB(a,i,k,l) * LUB(a,k,j,l);
+	}
+}
+
+/**
+ * Vorwärts-/Rückwärtseinsetzen für einen Block; x[i*LUB_LANES+l] ist die
+ * rechte Seite von Lane l.
+ */
+void solve_block(size_t n, double const * a, size_t const * piv, double * x)
+{
+	size_t i, k, l;
+	double v;
+
+	for (k=0; k<n; k++)
+		for (l=0; l<LUB_LANES; l++)
+		{
+			i = piv[k*LUB_LANES+l];
+			v = x[k*LUB_LANES+l];
+			x[k*LUB_LANES+l] = x[i*LUB_LANES+l];
+			x[i*LUB_LANES+l] = v;
+		}
+	for (k=0; k<n; k++)
+		for (i=k+1; i<n; i++)
+			for (l=0; l<LUB_LANES; l++)
+				x[i*LUB_LANES+l] -= LUB(a,i,k,l) * x[k*LUB_LANES+l];
+	for (k=n; k>0; k--)
+	{
+		for (l=0; l<LUB_LANES; l++)
+			x[(k-1)*LUB_LANES+l] /= LUB(a,k-1,k-1,l);
+		for (i=0; i<k-1; i++)
+			for (l=0; l<LUB_LANES; l++)
+				x[i*LUB_LANES+l] -= LUB(a,i,k-1,l) * x[(k-1)*LUB_LANES+l];
+	}
+}
+
+} // namespace
+
+LUBatch::LUBatch(size_t n, size_t count)
+	: n_(n), count_(count),
+	  nblocks_((count + LUB_LANES - 1) / LUB_LANES),
+	  data_(nblocks_*n*n*LUB_LANES),
+	  piv_(nblocks_*n*LUB_LANES),
+	  info_(nblocks_*LUB_LANES),
+	  factored_(false)
+{
+	size_t b, i, l;
+	double * a = data_;
+	data_.fill(0.);
+	// auch die Lanes hinter count: reguläre Dummy-Matrizen
+	for (b=0; b<nblocks_; b++)
+		for (i=0; i<n; i++)
+			for (l=0; l<LUB_LANES; l++)
+				LUB(a + b*n*n*LUB_LANES,i,i,l) = 1.;
+	for (i=0; i<piv_.dim(); i++)
+		piv_(i) = 0;
+	for (i=0; i<info_.dim(); i++)
+		info_(i) = 0;
+}
+
+void LUBatch::setMatrix(size_t b, MMatrix const & A)
+{
+	fASSERT(b < count_ and A.rows() == n_ and A.cols() == n_);
+	size_t i, j, n = n_, l = b % LUB_LANES;
+	double * a = (double*)data_ + (b/LUB_LANES)*n*n*LUB_LANES;
+	double const * s = A;
+	for (j=0; j<n; j++)
+		for (i=0; i<n; i++)
+			LUB(a,i,j,l) = s[j*n+i];
+	factored_ = false;
+}
+
+MMatrix LUBatch::getMatrix(size_t b) const
+{
+	fASSERT(b < count_);
+	size_t i, j, n = n_, l = b % LUB_LANES;
+	double const * a = (double const*)data_ + (b/LUB_LANES)*n*n*LUB_LANES;
+	MMatrix A(n, n);
+	double * d = A;
+	for (j=0; j<n; j++)
+		for (i=0; i<n; i++)
+			d[j*n+i] = LUB(a,i,j,l);
+	return A;
+}
+
+size_t LUBatch::factor(unsigned int nthreads)
+{
+	size_t n = n_, b, nsing = 0;
+	double * a = data_;
+	size_t * piv = piv_;
+	size_t * info = info_;
+
+	unsigned int nt = num_threads(nthreads, n*n*n/3*LUB_LANES*nblocks_,
+		LUB_MIN_WORK_PER_THREAD, nblocks_);
+	run_ranges(nblocks_, nt, [=](size_t b0, size_t b1) {
+		for (size_t blk=b0; blk<b1; blk++)
+			factor_block(n, a + blk*n*n*LUB_LANES,
+				piv + blk*n*LUB_LANES, info + blk*LUB_LANES);
+	});
+	factored_ = true;
+
+	for (b=0; b<count_; b++)
+		if (info_.get(b) != 0)
+			nsing++;
+	return nsing;
+}
+
+void LUBatch::solve(MMatrix & B, unsigned int nthreads) const
+{
+	fASSERT(factored_);
+	fASSERT(B.rows() == n_ and B.cols() == count_);
+	size_t n = n_, count = count_;
+	double const * a = data_;
+	size_t const * piv = piv_;
+	double * pB = B;
+
+	unsigned int nt = num_threads(nthreads, n*n*LUB_LANES*nblocks_,
+		LUB_MIN_WORK_PER_THREAD, nblocks_);
+	run_ranges(nblocks_, nt, [=](size_t b0, size_t b1) {
+		size_t blk, i, l, b;
+		std::vector< double > x(n*LUB_LANES);
+		for (blk=b0; blk<b1; blk++)
+		{
+			// rechte Seiten des Blocks verschränken (Padding: 0)
+			std::fill(x.begin(), x.end(), 0.);
+			for (l=0; l<LUB_LANES; l++)
+			{
+				b = blk*LUB_LANES + l;
+				if (b < count)
+					for (i=0; i<n; i++)
+						x[i*LUB_LANES+l] = pB[b*n+i];
+			}
+			solve_block(n, a + blk*n*n*LUB_LANES,
+				piv + blk*n*LUB_LANES, x.data());
+			for (l=0; l<LUB_LANES; l++)
+			{
+				b = blk*LUB_LANES + l;
+				if (b < count)
+					for (i=0; i<n; i++)
+						pB[b*n+i] = x[i*LUB_LANES+l];
+			}
+		}
+	});
+}
+
+} // namespace flux::la
+} // namespace flux
+
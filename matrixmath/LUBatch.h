@@ -0,0 +1,163 @@
+#ifndef LUBATCH_H
+#define LUBATCH_H
+
+#include <cstddef>
+#include "Error.h"
+#include "GVector.h"
+#include "MVector.h"
+
+/** Anzahl der verschränkt gespeicherten Matrizen je Block (Lanes) */
+#define LUB_LANES	8
+
+namespace flux {
+namespace la {
+
+class MMatrix;
+
+/**
+ * Klasse LUBatch -- LU-Zerlegung (mit partieller Pivotsuche) vieler kleiner
+ * dichter Matrizen gleicher Dimension in einem Aufruf.
+ *
+ * Die Matrizen werden blockweise verschränkt gespeichert ("AoSoA"): je
+ * LUB_LANES Matrizen bilden einen Block, in dem das Element (i,j) aller
+ * Matrizen des Blocks nebeneinander liegt. Die innersten Schleifen laufen
+ * damit über die Matrizen eines Blocks (SIMD-Breite, eine Cache-Line) und
+ * nicht über die kleine Dimension n. Blöcke sind unabhängig und werden auf
+ * mehrere Threads verteilt. Es entfallen die LAPACK-Aufrufe, Workspace-
+ * Allokationen und PMatrix-Objekte je Matrix.
+ */
+class LUBatch
+{
+private:
+	/** Dimension der Matrizen */
+	size_t n_;
+	/** Anzahl der Matrizen */
+	size_t count_;
+	/** Anzahl der Blöcke (count_ aufgerundet auf LUB_LANES) */
+	size_t nblocks_;
+	/** Elemente, verschränkt: ((blk*n+j)*n+i)*LUB_LANES+lane */
+	MVector data_;
+	/** Pivot-Zeilen, verschränkt: (blk*n+k)*LUB_LANES+lane */
+	GVector< size_t > piv_;
+	/** je Matrix: 0 oder k+1, falls U(k,k) der erste Null-Pivot */
+	GVector< size_t > info_;
+	/** Flag: Matrizen sind zerlegt */
+	bool factored_;
+
+public:
+	/**
+	 * Constructor. Alle Matrizen werden mit der Einheitsmatrix
+	 * initialisiert.
+	 *
+	 * @param n Dimension der Matrizen
+	 * @param count Anzahl der Matrizen
+	 */
+	LUBatch(size_t n, size_t count);
+
+	/** @return Dimension der Matrizen */
+	inline size_t dim() const { return n_; }
+
+	/** @return Anzahl der Matrizen */
+	inline size_t count() const { return count_; }
+
+	/** @return true, falls factor() aufgerufen wurde */
+	inline bool isFactored() const { return factored_; }
+
+	/**
+	 * Zugriff auf ein Element; vor factor() ein Element von A, danach ein
+	 * Element von L bzw. U (L mit Einheitsdiagonale).
+	 *
+	 * @param b Index der Matrix
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Referenz auf das Element
+	 */
+	inline double & operator() (size_t b, size_t i, size_t j)
+	{
+		fASSERT(b < count_ and i < n_ and j < n_);
+		factored_ = false;
+		return data_((((b/LUB_LANES)*n_+j)*n_+i)*LUB_LANES + b%LUB_LANES);
+	}
+
+	/**
+	 * Lesender Zugriff auf ein Element.
+	 *
+	 * @param b Index der Matrix
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Wert des Elements
+	 */
+	inline double get(size_t b, size_t i, size_t j) const
+	{
+		fASSERT(b < count_ and i < n_ and j < n_);
+		return data_.get((((b/LUB_LANES)*n_+j)*n_+i)*LUB_LANES + b%LUB_LANES);
+	}
+
+	/**
+	 * Setzt Matrix b.
+	 *
+	 * @param b Index der Matrix
+	 * @param A n x n-Matrix
+	 */
+	void setMatrix(size_t b, MMatrix const & A);
+
+	/**
+	 * Liefert Matrix b (vor factor() A, danach L und U in einer Matrix
+	 * wie bei LAPACK dgetrf).
+	 *
+	 * @param b Index der Matrix
+	 * @return n x n-Matrix
+	 */
+	MMatrix getMatrix(size_t b) const;
+
+	/**
+	 * LU-Zerlegung aller Matrizen. Singuläre Matrizen werden (wie bei
+	 * LAPACK dgetrf) vollständig zerlegt und über info() gemeldet.
+	 *
+	 * @param nthreads Anzahl der Threads (0: automatisch)
+	 * @return Anzahl der singulären Matrizen
+	 */
+	size_t factor(unsigned int nthreads = 0);
+
+	/**
+	 * Löst A_b*x_b = b_b für alle Matrizen b. Setzt factor() voraus.
+	 *
+	 * @param B n x count-Matrix; Spalte b ist die rechte Seite zu Matrix
+	 *	b und wird mit der Lösung überschrieben
+	 * @param nthreads Anzahl der Threads (0: automatisch)
+	 */
+	void solve(MMatrix & B, unsigned int nthreads = 0) const;
+
+	/**
+	 * Status der Zerlegung von Matrix b.
+	 *
+	 * @param b Index der Matrix
+	 * @return 0 oder k+1, falls U(k,k) der erste Null-Pivot ist
+	 */
+	inline size_t info(size_t b) const
+	{
+		fASSERT(b < count_);
+		return info_.get(b);
+	}
+
+	/**
+	 * Pivot-Zeile von Matrix b in Schritt k (Zeile k wurde mit der
+	 * gelieferten Zeile vertauscht; 0-basiert).
+	 *
+	 * @param b Index der Matrix
+	 * @param k Schritt
+	 * @return Pivot-Zeile
+	 */
+	inline size_t pivot(size_t b, size_t k) const
+	{
+		fASSERT(factored_ and b < count_ and k < n_);
+		return piv_.get(((b/LUB_LANES)*n_+k)*LUB_LANES + b%LUB_LANES);
+	}
+
+}; // class LUBatch
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
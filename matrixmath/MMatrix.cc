@@ -8,6 +8,8 @@
 #include "MVector.h"
 #include "MMatrixOps.h"
 #include "LAPackWrap.h"
+#include "BLASWrap.h"
+#include "SIMDKernels.h"
 #include "cstringtools.h"
 
 namespace flux {
@@ -106,11 +108,12 @@ double MMatrix::normInf() const
 {
 	double n=0., n1_row;
 	size_t i, j;
+	MatrixView< double const > A = view();
 
 	for (i=0; i<rows_; i++)
 	{
 		for (j=0,n1_row=0.; j<cols_; j++)
-			n1_row += fabs(get(i,j));
+			n1_row += fabs(A(i,j));
 		if (n1_row > n) n = n1_row;
 	}
 	return n;
@@ -120,12 +123,11 @@ double MMatrix::normInf() const
 double MMatrix::normInfCwise() const
 {
 	double n=0., n1_col;
-	size_t i, j;
+	size_t j;
 
 	for (j=0; j<cols_; j++)
 	{
-		for (i=0,n1_col=0.; i<rows_; i++)
-			n1_col += fabs(get(i,j));
+		n1_col = simd::norm1(rows_, matrix_storage_ + j*rows_);
 		if (n1_col > n) n = n1_col;
 	}
 	return n;
@@ -134,14 +136,13 @@ double MMatrix::normInfCwise() const
 double MMatrix::norm1() const
 {
 	double n=0., n1_col;
-	size_t i, j;
+	size_t j;
 
-        for (j=0; j<cols_; j++)
-        {
-            for (i=0,n1_col=0.; i<rows_; i++)
-                n1_col += fabs(get(i,j));
-            if (n1_col > n) n = n1_col;
-        }
+	for (j=0; j<cols_; j++)
+	{
+		n1_col = simd::norm1(rows_, matrix_storage_ + j*rows_);
+		if (n1_col > n) n = n1_col;
+	}
 	return n;
 }
 
@@ -165,131 +166,127 @@ double MMatrix::conditionKappaInf() const
 	return normInf()*I.normInf();
 }
 
-MMatrix MMatrix::operator+ (MMatrix const & Rval) const
+MMatrix MMatrix::operator+ (MMatrix const & Rval) const &
 {
-	size_t i,j;
-	MMatrix C(rows(), cols());
-
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			C.set(i,j,get(i,j) + Rval.get(i,j));
+	MMatrix C(*this);
+	C += Rval;
 	return C;
 }
 
-MMatrix & MMatrix::operator+= (MMatrix const & Rval)
+MMatrix MMatrix::operator+ (MMatrix const & Rval) &&
 {
-	size_t i,j;
+	*this += Rval;
+	return std::move(*this);
+}
 
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			set(i,j,get(i,j) + Rval.get(i,j));
+MMatrix & MMatrix::operator+= (MMatrix const & Rval)
+{
+	fASSERT(rows_ == Rval.rows_ and cols_ == Rval.cols_);
+	// Speicher ist zusammenhängend: ein AXPY über rows*cols Werte
+	blas::axpy(rows_*cols_, 1., Rval, *this);
 	return *this;
 }
 
-MMatrix MMatrix::operator- (MMatrix const & Rval) const
+MMatrix MMatrix::operator- (MMatrix const & Rval) const &
 {
-	size_t i,j;
-	MMatrix C(rows(), cols());
-
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols(); j++)
-			C.set(i,j,get(i,j) - Rval.get(i,j));
+	MMatrix C(*this);
+	C -= Rval;
 	return C;
 }
 
-MMatrix & MMatrix::operator-= (MMatrix const & Rval)
+MMatrix MMatrix::operator- (MMatrix const & Rval) &&
 {
-	size_t i,j;
+	*this -= Rval;
+	return std::move(*this);
+}
 
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			set(i,j,get(i,j) - Rval.get(i,j));
+MMatrix & MMatrix::operator-= (MMatrix const & Rval)
+{
+	fASSERT(rows_ == Rval.rows_ and cols_ == Rval.cols_);
+	blas::axpy(rows_*cols_, -1., Rval, *this);
 	return *this;
 }
 
 MMatrix MMatrix::operator* (MMatrix const & Rval) const
 {
-	size_t i,j,k;
-	double sum;
+	fASSERT(cols_ == Rval.rows_);
 	MMatrix C(rows_,Rval.cols_);
 
-	for (i=0; i<C.rows_; i++)
-		for (j=0; j<C.cols_; j++)
-		{
-			for (sum=0.,k=0; k<cols_; k++)
-				sum += get(i,k) * Rval.get(k,j);
-			C.set(i,j,sum);
-		}
+	blas::gemm('N', 'N', rows_, Rval.cols_, cols_,
+		1., *this, rows_, Rval, Rval.rows_, 0., C, C.rows_);
 	return C;
 }
 
 MVector MMatrix::operator* (MVector const & rval) const
 {
-	size_t i,k;
-	double sum;
-
+	fASSERT(cols_ == rval.dim());
 	MVector c(rows_);
 
-	for (i=0; i<rows_; i++)
-	{
-		for (sum=0.,k=0; k<cols_; k++)
-			sum += get(i,k) * rval.get(k);
-		c.set(i,sum);
-        }
+	blas::gemv('N', rows_, cols_, 1., *this, rows_, rval, 0., c);
 	return c;
 }
 
 MMatrix & MMatrix::operator*= (double rval)
 {
-	size_t i,j;
-
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			set(i,j,get(i,j) * rval);
+	// Speicher ist zusammenhängend
+	simd::scale(rows_*cols_, rval, matrix_storage_);
 	return *this;
 }
 
-MMatrix MMatrix::operator* (double rval) const
+MMatrix MMatrix::operator* (double rval) const &
 {
-	size_t i,j;
-	MMatrix M(rows_,cols_);
-
-	for (i=0; i<rows_; i++)
-		for (j=0; j < cols(); j++)
-			M.set(i, j, get(i, j) * rval);
+	MMatrix M(*this);
+	M *= rval;
 	return M;
 }
 
+MMatrix MMatrix::operator* (double rval) &&
+{
+	*this *= rval;
+	return std::move(*this);
+}
+
 MMatrix & MMatrix::operator/= (double rval)
 {
 	size_t i,j;
 	fASSERT(rval != 0.);
+	MatrixView< double > A = view();
 
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols(); j++)
-			set(i,j,get(i,j) / rval);
+	for (j=0; j<cols_; j++)
+		for (i=0; i<rows_; i++)
+			A(i,j) /= rval;
 	return *this;
 }
 
-MMatrix MMatrix::operator/ (double rval) const
+MMatrix MMatrix::operator/ (double rval) const &
 {
 	size_t i,j;
 	MMatrix M(rows(), cols());
 	fASSERT(rval != 0.);
+	MatrixView< double const > A = view();
+	MatrixView< double > Mv = M.view();
 	
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			M.set(i,j,get(i,j) / rval);
+	for (j=0; j<cols_; j++)
+		for (i=0; i<rows_; i++)
+			Mv(i,j) = A(i,j) / rval;
 	return M;
 }
 
+MMatrix MMatrix::operator/ (double rval) &&
+{
+	*this /= rval;
+	return std::move(*this);
+}
+
 MMatrix MMatrix::getTranspose() const
 {
 	size_t i,j;
 	MMatrix X(cols_,rows_);
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			X.set(j,i,get(i,j));
+	MatrixView< double const > A = view();
+	MatrixView< double > Xv = X.view();
+	for (j=0; j<cols_; j++)
+		for (i=0; i<rows_; i++)
+			Xv(j,i) = A(i,j);
 	return X;
 }
 
@@ -298,9 +295,11 @@ MMatrix MMatrix::getSlice(size_t i1, size_t j1, size_t i2, size_t j2) const
 	size_t i,j;
 	fASSERT(i2<rows_ and j2<cols_ and i1<=i2 and j1<=j2);
 	MMatrix S(i2-i1+1,j2-j1+1);
-	for (i=0; i<i2-i1+1; i++)
-		for (j=0; j<j2-j1+1; j++)
-			S(i,j) = get(i1+i,j1+j);
+	MatrixView< double const > A = view().block(i1,j1,S.rows_,S.cols_);
+	MatrixView< double > Sv = S.view();
+	for (j=0; j<S.cols_; j++)
+		for (i=0; i<S.rows_; i++)
+			Sv(i,j) = A(i,j);
 	return S;
 }
 
@@ -308,9 +307,11 @@ bool MMatrix::setSlice(size_t i1, size_t j1, size_t i2, size_t j2, MMatrix S)
 {
 	size_t i,j;
 	fASSERT(i2<rows_ and j2<cols_ and i1<=i2 and j1<=j2);
-	for (i=0; i<S.rows_; i++)
-            for (j=0; j<S.cols_; j++)
-                    set(i1+i,j1+j,S.get(i,j));        
+	MatrixView< double > A = view().block(i1,j1,S.rows_,S.cols_);
+	MatrixView< double const > Sv = S.view();
+	for (j=0; j<S.cols_; j++)
+		for (i=0; i<S.rows_; i++)
+			A(i,j) = Sv(i,j);
 	return true;
 }
 
@@ -318,9 +319,10 @@ MMatrix & MMatrix::diag(MVector & d)
 {
 	fASSERT(d.dim() == (rows_<cols_?rows_:cols_));
 	size_t i,j;
-	for (i=0; i<rows_; i++)
-		for (j=0; j<cols_; j++)
-			set(i,j,i==j?d(i):0.);
+	MatrixView< double > A = view();
+	for (j=0; j<cols_; j++)
+		for (i=0; i<rows_; i++)
+			A(i,j) = i==j ? d(i) : 0.;
 	return *this;
 }
 
@@ -336,6 +338,49 @@ MVector MMatrix::diag() const
 	return d;
 }
 
+void gemv(
+	double alpha,
+	MMatrix const & A,
+	MVector const & x,
+	double beta,
+	MVector & y,
+	bool trans
+	)
+{
+	size_t m = trans ? A.cols() : A.rows();
+	fASSERT(x.dim() == (trans ? A.rows() : A.cols()));
+	fASSERT((double const*)x != (double const*)y or x.dim() == 0);
+	if (beta == 0. and y.dim() != m)
+		y = MVector(m);
+	fASSERT(y.dim() == m);
+
+	blas::gemv(trans ? 'T' : 'N', A.rows(), A.cols(),
+		alpha, A, A.rows(), x, beta, y);
+}
+
+void gemm(
+	double alpha,
+	MMatrix const & A,
+	MMatrix const & B,
+	double beta,
+	MMatrix & C,
+	bool transA,
+	bool transB
+	)
+{
+	size_t m = transA ? A.cols() : A.rows();
+	size_t k = transA ? A.rows() : A.cols();
+	size_t n = transB ? B.rows() : B.cols();
+	fASSERT(k == (transB ? B.cols() : B.rows()));
+	fASSERT(&C != &A and &C != &B);
+	if (beta == 0. and (C.rows() != m or C.cols() != n))
+		C = MMatrix(m,n);
+	fASSERT(C.rows() == m and C.cols() == n);
+
+	blas::gemm(transA ? 'T' : 'N', transB ? 'T' : 'N', m, n, k,
+		alpha, A, A.rows(), B, B.rows(), beta, C, C.rows());
+}
+
 } // namespace flux::la
 } // namespace flux
 
@@ -1,6 +1,7 @@
 #ifndef MMATRIX_H
 #define MMATRIX_H
 
+#include <utility>
 #include "GMatrix.h"
 
 namespace flux {
@@ -49,12 +50,51 @@ public:
 	 */
 	MMatrix(GMatrix< double > const & copy) : GMatrix< double >(copy) { }
 
+	/**
+	 * Move-Constructor.
+	 *
+	 * @param move zu übernehmendes Objekt
+	 */
+	MMatrix(MMatrix && move) noexcept
+		: GMatrix< double >(std::move(move)) { }
+
+	/**
+	 * Move-Constructor (GMatrix).
+	 *
+	 * @param move zu übernehmendes Objekt
+	 */
+	MMatrix(GMatrix< double > && move) noexcept
+		: GMatrix< double >(std::move(move)) { }
+
 	/**
 	 * Destructor.
 	 */
 	virtual ~MMatrix() { }
 
 public:
+	/**
+	 * Zuweisungsoperator.
+	 *
+	 * @param copy zu kopierendes Objekt
+	 * @return Referenz auf *this
+	 */
+	MMatrix & operator= (MMatrix const & copy)
+	{
+		GMatrix< double >::operator=(copy);
+		return *this;
+	}
+
+	/**
+	 * Move-Zuweisung (ohne Kopie der Elemente).
+	 *
+	 * @param move zu übernehmendes Objekt
+	 * @return Referenz auf *this
+	 */
+	MMatrix & operator= (MMatrix && move) noexcept
+	{
+		GMatrix< double >::operator=(std::move(move));
+		return *this;
+	}
 
 	/**
 	 * Formatiert eine Matrix à la Matlab/Octave.
@@ -148,7 +188,16 @@ public:
 	 * @param Rval rechtes Argument
 	 * @return Summen-Matrix
 	 */
-	MMatrix operator+ (MMatrix const & Rval) const;
+	MMatrix operator+ (MMatrix const & Rval) const &;
+
+	/**
+	 * Matrix-Matrix-Addition auf einem temporären linken Argument;
+	 * dessen Speicher wird für das Ergebnis wiederverwendet.
+	 *
+	 * @param Rval rechtes Argument
+	 * @return Summen-Matrix
+	 */
+	MMatrix operator+ (MMatrix const & Rval) &&;
 
 	/**
 	 * Matrix-Matrix-Addition.
@@ -164,7 +213,16 @@ public:
 	 * @param Rval rechtes Argument
 	 * @return Differenz-Matrix
 	 */
-	MMatrix operator- (MMatrix const & Rval) const;
+	MMatrix operator- (MMatrix const & Rval) const &;
+
+	/**
+	 * Matrix-Matrix-Subtraktion auf einem temporären linken Argument
+	 * (ohne neuen Speicher).
+	 *
+	 * @param Rval rechtes Argument
+	 * @return Differenz-Matrix
+	 */
+	MMatrix operator- (MMatrix const & Rval) &&;
 	
 	/**
 	 * Matrix-Matrix-Subtraktion.
@@ -204,7 +262,16 @@ public:
 	 * @param rval Skalar
 	 * @return Produktmatrix
 	 */
-	MMatrix operator* (double rval) const;
+	MMatrix operator* (double rval) const &;
+
+	/**
+	 * Matrix-Skalar Multiplikation auf einer temporären Matrix
+	 * (ohne neuen Speicher).
+	 *
+	 * @param rval Skalar
+	 * @return Produktmatrix
+	 */
+	MMatrix operator* (double rval) &&;
 
 	/**
 	 * Matrix-Skalar-Division.
@@ -220,7 +287,16 @@ public:
 	 * @param rval Skalar
 	 * @return Produktmatrix
 	 */
-	MMatrix operator/ (double rval) const;
+	MMatrix operator/ (double rval) const &;
+
+	/**
+	 * Matrix-Skalar-Division auf einer temporären Matrix
+	 * (ohne neuen Speicher).
+	 *
+	 * @param rval Skalar
+	 * @return Produktmatrix
+	 */
+	MMatrix operator/ (double rval) &&;
 
 	/**
 	 * Gibt eine transponierte Kopie der Matrix zurück
@@ -267,6 +343,52 @@ public:
 
 };
 
+/**
+ * Fusioniertes Matrix-Vektor-Produkt y = alpha*op(A)*x + beta*y ohne
+ * temporäre Objekte (siehe blas::gemv). Für beta==0 wird y bei Bedarf
+ * auf die passende Länge gebracht und vorher nicht gelesen. x und y
+ * dürfen nicht denselben Speicher verwenden.
+ *
+ * @param alpha Faktor des Produkts
+ * @param A Matrix
+ * @param x Vektor
+ * @param beta Faktor von y
+ * @param y Ergebnis-Vektor (in/out)
+ * @param trans A transponiert verwenden (op(A)=A^T)
+ */
+void gemv(
+	double alpha,
+	MMatrix const & A,
+	MVector const & x,
+	double beta,
+	MVector & y,
+	bool trans = false
+	);
+
+/**
+ * Fusioniertes Matrix-Matrix-Produkt C = alpha*op(A)*op(B) + beta*C
+ * ohne temporäre Objekte (siehe blas::gemm). Für beta==0 wird C bei
+ * Bedarf auf die passende Größe gebracht und vorher nicht gelesen.
+ * C darf nicht denselben Speicher wie A oder B verwenden.
+ *
+ * @param alpha Faktor des Produkts
+ * @param A linke Matrix
+ * @param B rechte Matrix
+ * @param beta Faktor von C
+ * @param C Ergebnis-Matrix (in/out)
+ * @param transA A transponiert verwenden
+ * @param transB B transponiert verwenden
+ */
+void gemm(
+	double alpha,
+	MMatrix const & A,
+	MMatrix const & B,
+	double beta,
+	MMatrix & C,
+	bool transA = false,
+	bool transB = false
+	);
+
 } // namespace flux::la
 } // namespace flux
 
@@ -32,6 +32,8 @@ bool _LUfactor(
 {
 	int i,j,k,n,pk,tmp_i;
 	double pivot, tmp;
+	MatrixView< double > Av = A.view();
+	VectorView< unsigned int > Pv = P.view();
 	
 	n = A.rows();
 	
@@ -45,7 +47,7 @@ bool _LUfactor(
 	{
 		for (j=0,abs_max=0.; j<n; j++)
 		{
-			abs = fabs(A.get(k,j));
+			abs = fabs(Av(k,j));
 			if (abs > abs_max) abs_max = abs;
 		}
 		scale(k) = abs_max;
@@ -57,10 +59,10 @@ bool _LUfactor(
 	{
 #ifdef SCALED_PP
 		// Pivot-Suche (Scaled-Partial-Pivoting)
-		pk=k; pivot=fabs(A(k,k))/scale(k);
+		pk=k; pivot=fabs(Av(k,k))/scale(k);
 		for (i=k+1; i<n; i++)
 		{
-			tmp = fabs(A(i,k));
+			tmp = fabs(Av(i,k));
 			if (scale(i) >= TINY*tmp)
 			{
 				tmp /= scale(i);
@@ -69,10 +71,10 @@ bool _LUfactor(
 		}
 #else
 		// "normale" Pivot-Suche (Partial Pivoting)
-		pk=k; pivot=fabs(A(k,k));
+		pk=k; pivot=fabs(Av(k,k));
 		for (i=k+1; i<n; i++)
 		{
-			tmp = fabs(A(i,k));
+			tmp = fabs(Av(i,k));
 			if (tmp>pivot) { pivot=tmp; pk=i; }
 		}
 #endif
@@ -85,21 +87,25 @@ bool _LUfactor(
 		{
 			for (i=0; i<n; i++)
 			{
-				tmp = A(pk,i);
-				A(pk,i) = A(k,i);
-				A(k,i) = tmp;
+				tmp = Av(pk,i);
+				Av(pk,i) = Av(k,i);
+				Av(k,i) = tmp;
 			}
-			tmp_i = P(pk);
-			P(pk) = P(k);
-			P(k) = tmp_i;
+			tmp_i = Pv(pk);
+			Pv(pk) = Pv(k);
+			Pv(k) = tmp_i;
 		}
 
-		// Elimination
+		// Elimination (spaltenweise, passend zur Speicherordnung)
 		for (i=k+1; i<n; i++)
+			Av(i,k) /= Av(k,k);
+		for (j=k+1; j<n; j++)
 		{
-			A(i,k) /= A(k,k);
-			for (j=k+1; j<n; j++)
-				A(i,j) -= A(i,k)*A(k,j);
+			double akj = Av(k,j);
+			double * aj = &Av(0,j);
+			double const * ak = &Av(0,k);
+			for (i=k+1; i<n; i++)
+				aj[i] -= ak[i]*akj;
 		}
 	}
 	return true;
@@ -110,16 +116,21 @@ void _LUfactor_nopivot(
 	)
 {
 	int i,j,k,n = A.rows();
+	MatrixView< double > Av = A.view();
 	
 	// LU-Zerlegung: A=L.U
 	for (k=0; k<=n-2; k++)
 	{
-		// Elimination
+		// Elimination (spaltenweise, passend zur Speicherordnung)
 		for (i=k+1; i<n; i++)
+			Av(i,k) /= Av(k,k);
+		for (j=k+1; j<n; j++)
 		{
-			A(i,k) /= A(k,k);
-			for (j=k+1; j<n; j++)
-				A(i,j) -= A(i,k)*A(k,j);
+			double akj = Av(k,j);
+			double * aj = &Av(0,j);
+			double const * ak = &Av(0,k);
+			for (i=k+1; i<n; i++)
+				aj[i] -= ak[i]*akj;
 		}
 	}
 }
@@ -136,19 +147,21 @@ double _LUestimateCondition(
 	MVector p(n), y(n), r(n), w(n), z(n);
 	MVector pk_plus(n);
 	MVector pk_minus(n);
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
 
 	// 2.1.: Löse U^T.y=d (wie estimate_condition; zu Beginn p(0:n-1)=0)
 	//       und berechne norm_inf(y):
 	for (k=0,norm_inf_y=0.; k<n; k++)
 	{
-		yk_plus  = (1. - p(k)) / LU.get(k,k);
-		yk_minus = (-1. - p(k)) / LU.get(k,k);
+		yk_plus  = (1. - p(k)) / LUv(k,k);
+		yk_minus = (-1. - p(k)) / LUv(k,k);
 		
 		for (j=k; j<n; j++)
 		{
 			// Durch transponierten Zugriff wird hier U^T.y=d gelöst:
 			// (es wird auf LU(k,j) zugegr. statt auf LU(j,k) !)
-			double LU_kj = LU.get(k,j);
+			double LU_kj = LUv(k,j);
 			pk_plus(j) = p(j) + LU_kj * yk_plus;
 			pk_minus(j) = p(j) + LU_kj * yk_minus;
 		}
@@ -191,23 +204,23 @@ double _LUestimateCondition(
 	for (k=1; k<n; k++)
 	{
 		for (r(k)=y(k),j=0; j<k; j++)
-			r(k) -= LU.get(k,j)*r(j);
+			r(k) -= LUv(k,j)*r(j);
 		abs = fabs(r(k));
 		if (abs > norm_inf_r) norm_inf_r = abs;
 	}
 
 	// 2.2.2.: Löse L.w=P.r
-	w(0) = r(P.get(0));
+	w(0) = r(Pv(0));
 	for (k=1; k<n; k++)
-		for (w(k)=r(P.get(k)),j=0; j<k; j++)
-			w(k) -= LU.get(k,j)*w(j);
+		for (w(k)=r(Pv(k)),j=0; j<k; j++)
+			w(k) -= LUv(k,j)*w(j);
 	
 	// 2.2.3.: Löse U.z=w
 	for (k=n-1,norm_inf_z=0.; k>=0; k--)
 	{
 		for (z(k)=w(k),j=n-1; j>k; j--)
-			z(k) -= LU.get(k,j)*z(j);
-		z(k) /= LU.get(k,k);
+			z(k) -= LUv(k,j)*z(j);
+		z(k) /= LUv(k,k);
 		abs = fabs(z(k));
 		if (abs > norm_inf_z) norm_inf_z = abs;
 	}
@@ -226,20 +239,24 @@ void _LUsolve(
 {
 	int j,k,n = x.dim();
 	MVector r(n);
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
+	VectorView< double const > bv = b.view();
+	VectorView< double > xv = x.view();
 
 	// Berechne L.r = P.b
 	for (k=0; k<n; k++)
-		for (r(k)=b.get(P.get(k)),j=0; j<k; j++)
-			r(k) -= LU.get(k,j)*r(j);
+		for (r(k)=bv(Pv(k)),j=0; j<k; j++)
+			r(k) -= LUv(k,j)*r(j);
 
 	// Berechne R.x = r
 	for (k=n-1; k>=0; k--)
 	{
 		// x(k) = r(k) kann entfallen, da r in x gespeichert wird
-		x(k) = r(k);
+		xv(k) = r(k);
 		for (j=n-1; j>k; j--)
-			x(k) -= LU.get(k,j)*x(j);
-		x(k) /= LU.get(k,k);
+			xv(k) -= LUv(k,j)*xv(j);
+		xv(k) /= LUv(k,k);
 	}
 }
 
@@ -260,21 +277,24 @@ void _LUsolve(
 {
 	int i,k,n = b.dim();
 	MVector r(n);
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
+	VectorView< double > bv = b.view();
 
 	// Forward Substitution
-	r(0) = b(P.get(0));
+	r(0) = bv(Pv(0));
 	for (i=1; i<n; i++)
-		for (k=0,r(i)=b(P.get(i)); k<i; k++)
-			r(i) -= LU.get(i,k)*r(k);
+		for (k=0,r(i)=bv(Pv(i)); k<i; k++)
+			r(i) -= LUv(i,k)*r(k);
 
 	// Back Substitution
-	b(n-1) = r(n-1) / LU.get(n-1,n-1);
+	bv(n-1) = r(n-1) / LUv(n-1,n-1);
 	for (i=n-2; i>=0; i--)
 	{
-		b(i) = r(i);
+		bv(i) = r(i);
 		for (k=i+1; k<n; k++)
-			b(i) -= LU.get(i,k)*b(k);
-		b(i) /= LU.get(i,i);
+			bv(i) -= LUv(i,k)*bv(k);
+		bv(i) /= LUv(i,i);
 	}
 }
 
@@ -285,21 +305,23 @@ void _LUsolve_nopivot(
 {
 	int i,k,n = b.dim();
 	MVector r(n);
+	MatrixView< double const > LUv = LU.view();
+	VectorView< double > bv = b.view();
 
 	// Forward Substitution
-	r(0) = b(0);
+	r(0) = bv(0);
 	for (i=1; i<n; i++)
-		for (k=0,r(i)=b(i); k<i; k++)
-			r(i) -= LU.get(i,k)*r(k);
+		for (k=0,r(i)=bv(i); k<i; k++)
+			r(i) -= LUv(i,k)*r(k);
 
 	// Back Substitution
-	b(n-1) = r(n-1) / LU.get(n-1,n-1);
+	bv(n-1) = r(n-1) / LUv(n-1,n-1);
 	for (i=n-2; i>=0; i--)
 	{
-		b(i) = r(i);
+		bv(i) = r(i);
 		for (k=i+1; k<n; k++)
-			b(i) -= LU.get(i,k)*b(k);
-		b(i) /= LU.get(i,i);
+			bv(i) -= LUv(i,k)*bv(k);
+		bv(i) /= LUv(i,i);
 	}
 }
 
@@ -311,23 +333,26 @@ void _LUsolve(
 {
 	int i,j,k,n = B.rows();
 	MVector r(n);
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
+	MatrixView< double > Bv = B.view();
 
 	for (j=0; j<(int)B.cols(); j++)
 	{
 		// Forward Substitution
-		r(0) = B(P.get(0),j);
+		r(0) = Bv(Pv(0),j);
 		for (i=1; i<n; i++)
-			for (k=0,r(i)=B(P.get(i),j); k<i; k++)
-				r(i) -= LU.get(i,k)*r(k);
+			for (k=0,r(i)=Bv(Pv(i),j); k<i; k++)
+				r(i) -= LUv(i,k)*r(k);
 
 		// Back Substitution
-		B(n-1,j) = r(n-1) / LU.get(n-1,n-1);
+		Bv(n-1,j) = r(n-1) / LUv(n-1,n-1);
 		for (i=n-2; i>=0; i--)
 		{
-			B(i,j) = r(i);
+			Bv(i,j) = r(i);
 			for (k=i+1; k<n; k++)
-				B(i,j) -= LU.get(i,k)*B(k,j);
-			B(i,j) /= LU.get(i,i);
+				Bv(i,j) -= LUv(i,k)*Bv(k,j);
+			Bv(i,j) /= LUv(i,i);
 		}
 	}
 }
@@ -341,23 +366,27 @@ void _LUsolve(
 {
 	int i,j,k,n = B.rows();
 	MVector r(n);
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
+	MatrixView< double const > Bv = B.view();
+	MatrixView< double > Xv = X.view();
 
 	for (j=0; j<(int)B.cols(); j++)
 	{
 		// Berechne L.r = P.b (Forward Substitution)
 		for (i=0; i<n; i++)
-			for (r(i)=B.get(P.get(i),j),k=0; k<i; k++)
-				r(i) -= LU.get(i,k)*r(k);
+			for (r(i)=Bv(Pv(i),j),k=0; k<i; k++)
+				r(i) -= LUv(i,k)*r(k);
 	
 		// Berechne R.x = r (Back Substitution)
-		X(n-1,j) = r(n-1) / LU.get(n-1,n-1);
+		Xv(n-1,j) = r(n-1) / LUv(n-1,n-1);
 		for (i=n-2; i>=0; i--)
 		{
 			// x(i) = r(i) kann entfallen, da r in x gespeichert wird
-			X(i,j) = r(i);
+			Xv(i,j) = r(i);
 			for (k=n-1; k>i; k--)
-				X(i,j) -= LU.get(i,k)*X(k,j);
-			X(i,j) /= LU.get(i,i);
+				Xv(i,j) -= LUv(i,k)*Xv(k,j);
+			Xv(i,j) /= LUv(i,i);
 		}
 	}
 }
@@ -394,25 +423,30 @@ void _LUiterativeImprovement(
 	int j,k,n = x.dim();
 	MVector r(n), y(n);
 	MVector & z = r;
+	MatrixView< double const > Av = A.view();
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
+	VectorView< double const > bv = b.view();
+	VectorView< double > xv = x.view();
 	
 	// Berechne Residuum: r = b - A.x (x ist die zuvor berechnete Näherung)
 	for (k=0; k<n; k++)
-		for (r(k)=b.get(k),j=0; j<n; j++)
-			r(k) -= A.get(k,j)*x.get(j);
+		for (r(k)=bv(k),j=0; j<n; j++)
+			r(k) -= Av(k,j)*xv(j);
 
 	// Berechne L.y = P.r
-	y(0) = r(P.get(0));
+	y(0) = r(Pv(0));
 	for (k=1; k<n; k++)
-		for (y(k)=r(P.get(k)),j=0; j<k; j++)
-			y(k) -= LU.get(k,j)*y(j);
+		for (y(k)=r(Pv(k)),j=0; j<k; j++)
+			y(k) -= LUv(k,j)*y(j);
 	
 	// Berechne U.z = y; x := x+z
 	for (k=n-1; k>=0; k--)
 	{
 		for (z(k)=y(k),j=n-1; j>k; j--)
-			z(k) -= LU.get(k,j)*z(j);
-		z(k) /= LU.get(k,k);
-		x(k) += z(k);
+			z(k) -= LUv(k,j)*z(j);
+		z(k) /= LUv(k,k);
+		xv(k) += z(k);
 	}
 }
 
@@ -429,20 +463,25 @@ void _LUiterativeImprovement(
 	int nu = X.cols();
 	MMatrix R(n,nu), Y(n,nu);
 	MMatrix & Z = R;
+	MatrixView< double const > Av = A.view();
+	MatrixView< double const > LUv = LU.view();
+	VectorView< unsigned int const > Pv = P.view();
+	MatrixView< double const > Bv = B.view();
+	MatrixView< double > Xv = X.view();
 	
 	// Berechne Residuum: R = B - A.X (X ist die zuvor berechnete Näherung)
 	for (l=0; l<nu; l++)
 		for (k=0; k<n; k++)
-			for (R(k,l)=B.get(k,l),j=0; j<n; j++)
-				R(k,l) -= A.get(k,j)*X.get(j,l);
+			for (R(k,l)=Bv(k,l),j=0; j<n; j++)
+				R(k,l) -= Av(k,j)*Xv(j,l);
 
 	// Berechne L.Y = P.R
 	for (l=0; l<nu; l++)
 	{
-		Y(0,l) = R(P.get(0),l);
+		Y(0,l) = R(Pv(0),l);
 		for (k=1; k<n; k++)
-			for (Y(k,l)=R(P.get(k),l),j=0; j<k; j++)
-				Y(k,l) -= LU.get(k,j)*Y(j,l);
+			for (Y(k,l)=R(Pv(k),l),j=0; j<k; j++)
+				Y(k,l) -= LUv(k,j)*Y(j,l);
 	}
 	
 	// Berechne U.Z = Y; X := X+Z
@@ -450,9 +489,9 @@ void _LUiterativeImprovement(
 		for (k=n-1; k>=0; k--)
 		{
 			for (Z(k,l)=Y(k,l),j=n-1; j>k; j--)
-				Z(k,l) -= LU.get(k,j)*Z(j,l);
-			Z(k,l) /= LU.get(k,k);
-			X(k,l) += Z(k,l);
+				Z(k,l) -= LUv(k,j)*Z(j,l);
+			Z(k,l) /= LUv(k,k);
+			Xv(k,l) += Z(k,l);
 		}
 }
 
@@ -560,6 +599,8 @@ bool gaussJordan(
 	double pivot, abs, mult, tolerance;
 	bool zero;
 	PMatrix Pc(C);
+	MatrixView< double > Av = A.view();
+	VectorView< double > bv = b.view();
 
 	fASSERT(Pcf.dim() == A.cols());
 	fASSERT(b.dim() == A.rows());
@@ -601,7 +642,7 @@ bool gaussJordan(
 		// Initialisierung der Pivot-Zeilen / -Spalten
 		pr = k;
 		pc = k;
-		pivot = fabs(A(pr,pc));
+		pivot = fabs(Av(pr,pc));
 
 		// Pivot in der Restmatrix suchen.
 		// Abbruch, sobald Index j die Spalten der freizuhaltenden
@@ -610,7 +651,7 @@ bool gaussJordan(
 		{
 			for (i=k; i<R; i++)
 			{
-				abs = fabs(A(i,j));
+				abs = fabs(Av(i,j));
 				if (abs > pivot)
 				{
 					pivot = abs;
@@ -646,13 +687,13 @@ bool gaussJordan(
 		// Eliminationsschritt
 		for (i=k+1; i<R; i++)
 		{
-			mult = - A(i,k) / A(k,k);
-			b(i) += mult * b(k);
+			mult = - Av(i,k) / Av(k,k);
+			bv(i) += mult * bv(k);
 			
 			// multipliziere Zeile k mit mult und addiere
 			// auf Zeile i
 			for (j=k; j<C; j++)
-				A(i,j) += mult * A(k,j);
+				Av(i,j) += mult * Av(k,j);
 		}
 	}
 
@@ -673,11 +714,11 @@ bool gaussJordan(
 		// ist A(k:R-1,C-user_free:C-1) ist eine Nullmatrix?
 		for (j=C-user_free,zero=true; j<C and zero; j++)
 			for (i=rank; i<R and zero; i++)
-				if (fabs(A(i,j)) > tolerance)
+				if (fabs(Av(i,j)) > tolerance)
 					zero = false;
 				else
 					// klare Verhältnisse schaffen
-					A(i,j) = 0.;
+					Av(i,j) = 0.;
 
 		// Fall 2:
 		if (not zero)
@@ -695,7 +736,7 @@ bool gaussJordan(
 			for (; j<C; j++)
 			{
 				for (i=rank,zero=true; i<R and zero; i++)
-					if (fabs(A(i,j)) > tolerance)
+					if (fabs(Av(i,j)) > tolerance)
 						zero = false;
 				if (not zero)
 					// möglicher Pivot-Kandidat gefunden
@@ -712,7 +753,7 @@ bool gaussJordan(
 	// keine Lösung:
 	for (i=rank; i<R; i++)
 	{
-		if (fabs(b(i)) > tolerance)
+		if (fabs(bv(i)) > tolerance)
 		{
 			K = MMatrix();
 			rank = -4;
@@ -720,7 +761,7 @@ bool gaussJordan(
 		}
 		else
 			// klare Verhältnisse herstellen:
-			b(i) = 0.;
+			bv(i) = 0.;
 	}
 
 	// Der Benutzer will möglicherweise mehr Variablen freihalten als
@@ -740,21 +781,21 @@ bool gaussJordan(
 		// Eliminationsschritt
 		for (i=k-1; i>=0; i--)
 		{
-			mult = - A(i,k) / A(k,k);
-			b(i) += mult * b(k);
+			mult = - Av(i,k) / Av(k,k);
+			bv(i) += mult * bv(k);
 			
 			// multipliziere Zeile k mit mult und addiere
 			// auf Zeile i
 			for (j=k; j<C; j++)
-				A(i,j) += mult * A(k,j);
+				Av(i,j) += mult * Av(k,j);
 		}
 		// Teile die Zeile durch A(k,k), damit eine 1 auf der
 		// Diagonalen steht
-		mult = 1. / A(k,k);
-		A(k,k) = 1.;
+		mult = 1. / Av(k,k);
+		Av(k,k) = 1.;
 		for (j=rank; j<C; j++)
-			A(k,j) *= mult;
-		b(k) *= mult;
+			Av(k,j) *= mult;
+		bv(k) *= mult;
 	}
 
 	free = C-rank;
@@ -778,13 +819,13 @@ bool gaussJordan(
 		// konstanter Teil der Lösung; beim Zugriff auf b muß nicht
 		// permutiert werden, da Zeilenvertauschungen auch auf b
 		// durchgeführt wurden.
-		if (fabs(b(k))>=MACHEPS)
-			K(pk,0) = b(k);
+		if (fabs(bv(k))>=MACHEPS)
+			K(pk,0) = bv(k);
 		
 		for (j=rank; j<C; j++)
 		{
 			pj = Psfree(j-rank)+1;
-			if (fabs(A(k,j))>=MACHEPS) K(pk,pj) = - A(k,j);
+			if (fabs(Av(k,j))>=MACHEPS) K(pk,pj) = - Av(k,j);
 		}
 	}
 
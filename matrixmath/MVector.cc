@@ -1,6 +1,8 @@
 #include <cmath>
 #include "MVector.h"
 #include "MMatrix.h"
+#include "BLASWrap.h"
+#include "SIMDKernels.h"
 #include "cstringtools.h"
 
 namespace flux {
@@ -8,49 +10,40 @@ namespace la {
 
 double MVector::max() const
 {
-	double max=get(0);
+	VectorView< double const > x = view();
+	double max=x(0);
 	for (size_t i=1; i<dim_; i++)
-            if(max<get(i))
-		max= get(i);
+            if(max<x(i))
+		max= x(i);
 	return max;
 }
     
 double MVector::norm1(size_t lo, size_t hi) const
 {
-	double n=0.;
 	if (hi==0) hi=dim_-1;
-	for (size_t k=lo; k<=hi; k++)
-		n += fabs(get(k));
-	return n;
+	return simd::norm1(hi+1-lo, vector_storage_+lo);
 }
 
 double MVector::norm2(size_t lo, size_t hi) const
 {
-	double n=0.;
 	if (hi==0) hi=dim_-1;
-	for (size_t k=lo; k<=hi; k++)
-		n += get(k)*get(k);
-	return sqrt(n);
+	return simd::norm2(hi+1-lo, vector_storage_+lo);
 }
 
 double MVector::normInf(size_t lo, size_t hi) const
 {
-	double n=0., abs;
 	if (hi==0) hi=dim_-1;
-	for (size_t k=lo; k<=hi; k++)
-	{
-		abs = fabs(get(k));
-		if (abs>n) n = abs;
-	}
-	return n;
+	return simd::normInf(hi+1-lo, vector_storage_+lo);
 }
 
 double MVector::euklid(MVector const & L, MVector const & R)
 {
 	double d=0.,v;
+	VectorView< double const > l = L.view();
+	VectorView< double const > r = R.view();
 	for (size_t i=0; i<L.dim_; i++)
 	{
-		v = L.get(i)-R.get(i);
+		v = l(i)-r(i);
 		d += v*v;
 	}
 	return sqrt(d);
@@ -60,8 +53,10 @@ MVector MVector::getSlice(size_t i, size_t j) const
 {
 	fASSERT(j<dim_ and i<=j);
 	MVector s(j-i+1);
+	VectorView< double const > x = view();
+	VectorView< double > sv = s.view();
 	for (size_t k=0; k<j-i+1; k++)
-		s(k) = get(k+i);
+		sv(k) = x(k+i);
 	return s;
 }
 
@@ -116,121 +111,148 @@ MMatrix MVector::diag(size_t r, size_t c)
 
 MVector MVector::operator*(MMatrix const & Rval) const
 {
-	size_t i,j;
-	double sum;
 	fASSERT(Rval.rows() == dim_);
 	MVector p(Rval.cols());
-	for (j=0; j<Rval.cols(); j++)
-	{
-		sum = 0.;
-		for (i=0; i<dim_; i++)
-			sum += get(i) * Rval.get(i,j);
-		p(j) = sum;
-	}
+	// x^T*A = (A^T*x)^T
+	blas::gemv('T', Rval.rows(), Rval.cols(), 1., Rval, Rval.rows(),
+		*this, 0., p);
 	return p;
 }
 	
 double MVector::operator*(MVector const & rval) const
 {
-	size_t i;
-	double sp;
 	fASSERT(rval.dim_ == dim_);
-	for (sp=0.,i=0; i<dim_; i++)
-		sp += get(i) * rval.get(i);
-	return sp;
+	return blas::dot(dim_, *this, rval);
 }
 
-MVector MVector::operator*(double rval) const
+MVector MVector::operator*(double rval) const &
 {
-	size_t i;
-	MVector p(dim_);
-	for (i=0; i<dim_; i++)
-		p(i) = get(i) * rval;
+	MVector p(*this);
+	p *= rval;
 	return p;
 }
 
+MVector MVector::operator*(double rval) &&
+{
+	*this *= rval;
+	return std::move(*this);
+}
+
 MVector & MVector::operator*=(double rval)
 {
-	size_t i;
-	for (i=0; i<dim_; i++)
-		set(i,get(i)*rval);
+	simd::scale(dim_, rval, vector_storage_);
 	return *this;
 }
 
-MVector MVector::operator/(double rval) const
+MVector MVector::operator/(double rval) const &
 {
 	fASSERT(rval != 0.);
 	size_t i;
 	MVector p(dim_);
+	VectorView< double const > x = view();
+	VectorView< double > pv = p.view();
 	for (i=0; i<dim_; i++)
-		p(i) = get(i) / rval;
+		pv(i) = x(i) / rval;
 	return p;
 }
 
+MVector MVector::operator/(double rval) &&
+{
+	*this /= rval;
+	return std::move(*this);
+}
+
 MVector & MVector::operator/=(double rval)
 {
 	fASSERT(rval != 0.);
 	size_t i;
+	VectorView< double > x = view();
 	for (i=0; i<dim_; i++)
-		set(i, get(i) / rval);
+		x(i) /= rval;
 	return *this;
 }
  
-MVector MVector::operator+(MVector const & rval) const
+MVector MVector::operator+(MVector const & rval) const &
 {
 	size_t i;
 	fASSERT(rval.dim_ == dim_);
 	MVector s(dim_);
+	VectorView< double const > x = view();
+	VectorView< double const > y = rval.view();
+	VectorView< double > sv = s.view();
 	for (i=0; i<dim_; i++)
-		s(i) = get(i) + rval.get(i);
+		sv(i) = x(i) + y(i);
 	return s;
 }
 
+MVector MVector::operator+(MVector const & rval) &&
+{
+	*this += rval;
+	return std::move(*this);
+}
+
 MVector & MVector::operator+=(MVector const & rval)
 {
-	size_t i;
 	fASSERT(rval.dim_ == dim_);
-	for (i=0; i<dim_; i++)
-		set(i,get(i) + rval.get(i));
+	blas::axpy(dim_, 1., rval, *this);
 	return *this;
 }
 
-MVector MVector::operator-(MVector const & rval) const
+MVector MVector::operator-(MVector const & rval) const &
 {
 	size_t i;
 	fASSERT(rval.dim_ == dim_);
 	MVector d(dim_);
+	VectorView< double const > x = view();
+	VectorView< double const > y = rval.view();
+	VectorView< double > dv = d.view();
 	for (i=0; i<dim_; i++)
-		d(i) = get(i) - rval.get(i);
+		dv(i) = x(i) - y(i);
 	return d;
 }
 
+MVector MVector::operator-(MVector const & rval) &&
+{
+	*this -= rval;
+	return std::move(*this);
+}
+
 MVector & MVector::operator-=(MVector const & rval)
 {
-	size_t i;
 	fASSERT(rval.dim_ == dim_);
-	for (i=0; i<dim_; i++)
-		set(i,get(i) - rval.get(i));
+	blas::axpy(dim_, -1., rval, *this);
 	return *this;
 }
 
 MVector MVector::operator-() const
 {
 	MVector neg(dim_);
+	VectorView< double const > x = view();
+	VectorView< double > nv = neg.view();
 	for (size_t i=0; i<dim_; ++i)
-		neg(i) = -get(i);
+		nv(i) = -x(i);
 	return neg;
 }
 
 MVector operator*(double lval, MVector const & rval)
 {
-	size_t i;
-	MVector p(rval.dim());
-	for (i=0; i<rval.dim(); i++)
-		p(i) = lval * rval.get(i);
+	MVector p(rval);
+	p *= lval;
 	return p;
 }
 
+MVector operator*(double lval, MVector && rval)
+{
+	rval *= lval;
+	return std::move(rval);
+}
+
+void axpy(double alpha, MVector const & x, MVector & y)
+{
+	fASSERT(x.dim() == y.dim());
+	blas::axpy(x.dim(), alpha, x, y);
+}
+
 } // namespace flux::la
 } // namespace flux
 
@@ -2,7 +2,9 @@
 #define MVECTOR_H
 
 #include <cmath>
+#include <utility>
 #include "GVector.h"
+#include "SIMDKernels.h"
 #include "MatrixInterface.h"
 
 namespace flux {
@@ -38,6 +40,14 @@ public:
 	MVector(MVector const & copy)
 		: GVector< double >(copy) { }
 
+	/**
+	 * Move-Constructor.
+	 *
+	 * @param move zu übernehmender Vektor
+	 */
+	MVector(MVector && move) noexcept
+		: GVector< double >(std::move(move)) { }
+
 	/**
 	 * Constructor mit Initialisierung über Array.
 	 *
@@ -53,6 +63,40 @@ public:
 	virtual ~MVector() { }
 
 public:
+	/**
+	 * Zuweisung.
+	 *
+	 * @param copy zu kopierender Vektor
+	 * @return Referenz auf *this
+	 */
+	MVector & operator=(MVector const & copy)
+	{
+		GVector< double >::operator=(copy);
+		return *this;
+	}
+
+	/**
+	 * Move-Zuweisung (ohne Kopie der Elemente).
+	 *
+	 * @param move zu übernehmender Vektor
+	 * @return Referenz auf *this
+	 */
+	MVector & operator=(MVector && move) noexcept
+	{
+		GVector< double >::operator=(std::move(move));
+		return *this;
+	}
+
+	/**
+	 * Füllt den Vektor mit einem Wert.
+	 *
+	 * @param val Wert
+	 */
+	inline void fill(double const & val)
+	{
+		simd::fill(dim_, val, vector_storage_);
+	}
+
 	/**
 	 * 1-Norm (Summe der Beträge)
 	 *
@@ -153,7 +197,15 @@ public:
 	 * @param rval Skalar, rechter Operand
 	 * @return Produkt
 	 */
-	MVector operator*(double rval) const;
+	MVector operator*(double rval) const &;
+
+	/**
+	 * Produkt aus temporärem Vektor und Skalar (ohne neuen Speicher).
+	 *
+	 * @param rval Skalar, rechter Operand
+	 * @return Produkt
+	 */
+	MVector operator*(double rval) &&;
 	
 	/**
 	 * Produkt aus Vektor und Skalar.
@@ -169,7 +221,16 @@ public:
 	 * @param rval Skalar
 	 * @return neuer Vektor
 	 */
-	MVector operator/(double rval) const;
+	MVector operator/(double rval) const &;
+
+	/**
+	 * Elementweise Division eines temporären Vektors durch einen
+	 * Skalar (ohne neuen Speicher).
+	 *
+	 * @param rval Skalar
+	 * @return Vektor
+	 */
+	MVector operator/(double rval) &&;
 
 	/**
 	 * Elementweise Division durch einen Skalar.
@@ -185,7 +246,17 @@ public:
 	 * @param rval Vektor, rechter Operand
 	 * @return Vektor
 	 */
-	MVector operator+(MVector const & rval) const;
+	MVector operator+(MVector const & rval) const &;
+
+	/**
+	 * Vektor-Addition auf einem temporären linken Operanden; dessen
+	 * Speicher wird für das Ergebnis wiederverwendet, so dass z.B.
+	 * a+b+c nur einen neuen Vektor anlegt.
+	 *
+	 * @param rval Vektor, rechter Operand
+	 * @return Vektor
+	 */
+	MVector operator+(MVector const & rval) &&;
 
 	/**
 	 * Vektor-Addition.
@@ -201,7 +272,16 @@ public:
 	 * @param rval Vektor, rechter Operand
 	 * @return Vektor
 	 */
-	MVector operator-(MVector const & rval) const;
+	MVector operator-(MVector const & rval) const &;
+
+	/**
+	 * Vektor-Subtraktion auf einem temporären linken Operanden
+	 * (ohne neuen Speicher).
+	 *
+	 * @param rval Vektor, rechter Operand
+	 * @return Vektor
+	 */
+	MVector operator-(MVector const & rval) &&;
 	
 	/**
 	 * Vektor-Subtraktion.
@@ -222,6 +302,25 @@ public:
 
 MVector operator*(double lval, MVector const & rval);
 
+/**
+ * Produkt aus Skalar und temporärem Vektor (ohne neuen Speicher).
+ *
+ * @param lval Skalar
+ * @param rval temporärer Vektor
+ * @return Produkt
+ */
+MVector operator*(double lval, MVector && rval);
+
+/**
+ * Fusioniertes Vektor-Update y = alpha*x + y ohne temporäre Objekte
+ * (siehe blas::axpy).
+ *
+ * @param alpha Faktor
+ * @param x Vektor
+ * @param y Vektor (in/out)
+ */
+void axpy(double alpha, MVector const & x, MVector & y);
+
 } // namespace flux::la
 } // namespace flux
 
@@ -0,0 +1,434 @@
+#ifndef MATRIXEXPONENTIAL__H
+#define MATRIXEXPONENTIAL__H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Error.h"
+#include "MMatrix.h"
+#include "MVector.h"
+#include "CSMatrix.h"
+#include "LAPackWrap.h"
+#include "StemFunction_.h"
+
+/**
+ * Matrix-Exponential exp(A) (dicht, Scaling-and-Squaring mit Padé-
+ * Approximation nach Higham 2005) und dessen Wirkung exp(t*A)*v auf
+ * Vektoren bzw. Blöcke von Vektoren (abgeschnittene Taylor-Reihe mit
+ * Shift und Skalierung nach Al-Mohy/Higham 2011), ohne exp(t*A) zu
+ * bilden. expmv arbeitet auf dichten (MMatrix) und dünn besetzten
+ * (CSMatrix) Matrizen; benötigt werden nur Produkte A*v.
+ */
+
+namespace flux {
+namespace la {
+namespace expm_detail {
+
+/** Maximaler Grad der Taylor-Polynome in expmv */
+#define EXPMV_MMAX	55
+
+/** 1-Norm von A-mu*I (dicht) */
+inline double norm1_shifted(MMatrix const & A, double mu)
+{
+	size_t i, j, n = A.rows();
+	double s, nrm = 0.;
+	double const * a = A;
+	for (j=0; j<A.cols(); j++)
+	{
+		for (s=0.,i=0; i<n; i++)
+			s += (i == j) ? ::fabs(a[j*n+i]-mu) : ::fabs(a[j*n+i]);
+		nrm = std::max(nrm, s);
+	}
+	return nrm;
+}
+
+/** 1-Norm von A-mu*I (dünn besetzt; fehlende Diagonale zählt |mu|) */
+inline double norm1_shifted(CSMatrix const & A, double mu)
+{
+	size_t k, j, i;
+	std::vector< double > s(A.cols(), 0.);
+	std::vector< char > d(A.cols(), 0);
+	for (k=0; k<A.majorDim(); k++)
+		for (size_t p=A.ptr()[k]; p<A.ptr()[k+1]; p++)
+		{
+			i = A.format() == CSMatrix::csr ? k : A.idx()[p];
+			j = A.format() == CSMatrix::csr ? A.idx()[p] : k;
+			if (i == j)
+			{
+				s[j] += ::fabs(A.val()[p]-mu);
+				d[j] = 1;
+			}
+			else
+				s[j] += ::fabs(A.val()[p]);
+		}
+	double nrm = 0.;
+	for (j=0; j<A.cols(); j++)
+		nrm = std::max(nrm, d[j] ? s[j] : s[j]+::fabs(mu));
+	return nrm;
+}
+
+/** Spur (dicht) */
+inline double trace(MMatrix const & A)
+{
+	double t = 0.;
+	for (size_t i=0; i<A.rows(); i++)
+		t += A.get(i,i);
+	return t;
+}
+
+/** Spur (dünn besetzt) */
+inline double trace(CSMatrix const & A)
+{
+	double t = 0.;
+	for (size_t k=0; k<A.majorDim(); k++)
+		for (size_t p=A.ptr()[k]; p<A.ptr()[k+1]; p++)
+			if (A.idx()[p] == k)
+				t += A.val()[p];
+	return t;
+}
+
+/** Y = A*X */
+inline void apply(MMatrix const & A, MVector const & X, MVector & Y)
+{
+	gemv(1., A, X, 0., Y);
+}
+
+/** Y = A*X */
+inline void apply(MMatrix const & A, MMatrix const & X, MMatrix & Y)
+{
+	gemm(1., A, X, 0., Y);
+}
+
+/** Y = A*X */
+inline void apply(CSMatrix const & A, MVector const & X, MVector & Y)
+{
+	A.spmv(1., X, 0., Y);
+}
+
+/** Y = A*X */
+inline void apply(CSMatrix const & A, MMatrix const & X, MMatrix & Y)
+{
+	A.spmm(1., X, 0., Y);
+}
+
+/** Anzahl der Elemente eines Vektors */
+inline size_t numel(MVector const & v) { return v.dim(); }
+
+/** Anzahl der Elemente eines Vektor-Blocks */
+inline size_t numel(MMatrix const & V) { return V.rows()*V.cols(); }
+
+/** Maximum-Norm über alle Elemente */
+inline double norm_inf(double const * v, size_t N)
+{
+	double m = 0.;
+	for (size_t i=0; i<N; i++)
+		m = std::max(m, ::fabs(v[i]));
+	return m;
+}
+
+/**
+ * theta_m: größtes rho = ||X||_1 mit Restglied der nach Grad m
+ * abgeschnittenen Taylor-Reihe von exp(X) unterhalb der
+ * Maschinengenauigkeit, über die Vorwärtsschranke
+ * rho^(m+1)/(m+1)! * exp(rho) <= 2^-53 (Bisektion; einmalig berechnet).
+ *
+ * @param m Grad (1..EXPMV_MMAX)
+ * @return theta_m
+ */
+inline double taylor_theta(int m)
+{
+	static struct Table
+	{
+		double theta[EXPMV_MMAX+1];
+		Table()
+		{
+			double const lu = ::log(::ldexp(1.,-53));
+			theta[0] = 0.;
+			for (int k=1; k<=EXPMV_MMAX; k++)
+			{
+				double lo = 0., hi = 64., mid;
+				for (int it=0; it<200; it++)
+				{
+					mid = .5*(lo+hi);
+					if ((k+1)*::log(mid) - ::lgamma(k+2.) + mid <= lu)
+						lo = mid;
+					else
+						hi = mid;
+				}
+				theta[k] = lo;
+			}
+		}
+	} table;
+	return table.theta[m];
+}
+
+/**
+ * exp(t*A)*F für einen Vektor bzw. Vektor-Block F (in-place).
+ * Mit mu = trace(A)/n gilt exp(t*A) = exp(t*mu)*exp(t*(A-mu*I)); der
+ * Shift wird verwendet, falls er die Norm verkleinert. Grad m und Zahl
+ * der Teilschritte s minimieren die Anzahl der Produkte m*s unter
+ * ||t*(A-mu*I)||_1/s <= theta_m. Innerhalb eines Teilschritts bricht
+ * die Reihe ab, sobald zwei Terme vernachlässigbar sind.
+ */
+template< typename Op, typename V > void expmv_inplace(
+	Op const & A,
+	double t,
+	V & F
+	)
+{
+	fASSERT(A.rows() == A.cols());
+	size_t n = A.rows(), N = numel(F), i;
+	int j, m, mbest = 0;
+	size_t k, s, sbest = 1;
+	double mu, nrm, eta, c1, c2, nf, fac;
+
+	if (n == 0 or N == 0 or t == 0.)
+		return;
+
+	mu = trace(A) / double(n);
+	nrm = norm1_shifted(A, mu);
+	if (norm1_shifted(A, 0.) <= nrm)
+	{
+		mu = 0.;
+		nrm = norm1_shifted(A, 0.);
+	}
+	nrm *= ::fabs(t);
+
+	// Grad und Teilschritte
+	if (nrm > 0.)
+	{
+		sbest = size_t(-1);
+		for (m=1; m<=EXPMV_MMAX; m++)
+		{
+			s = std::max(size_t(1), size_t(::ceil(nrm / taylor_theta(m))));
+			if (mbest == 0 or m*s < mbest*sbest)
+			{
+				mbest = m;
+				sbest = s;
+			}
+		}
+	}
+
+	eta = ::exp(t*mu/double(sbest));
+	V B(F), Z(F);
+	double * f = F;
+	for (k=0; k<sbest; k++)
+	{
+		double * b = B;
+		c1 = norm_inf(b, N);
+		for (j=1; j<=mbest; j++)
+		{
+			// B = t/(s*j) * (A-mu*I)*B
+			apply(A, B, Z);
+			std::swap(B, Z);
+			b = B;
+			double const * z = Z;
+			fac = t / (double(sbest)*j);
+			for (i=0; i<N; i++)
+				b[i] = fac * (b[i] - mu*z[i]);
+			for (i=0; i<N; i++)
+				f[i] += b[i];
+			c2 = norm_inf(b, N);
+			nf = norm_inf(f, N);
+			if (c1 + c2 <= ::ldexp(1.,-53) * nf)
+				break;
+			c1 = c2;
+		}
+		for (i=0; i<N; i++)
+			f[i] *= eta;
+		B = F;
+	}
+}
+
+/**
+ * Padé-Approximant [m/m] von exp(A): U (ungerader Teil) und V
+ * (gerader Teil), exp(A) ~ (V-U)^-1*(V+U).
+ */
+inline void pade(MMatrix const & A, int m, MMatrix & U, MMatrix & V)
+{
+	static double const b3[] = { 120., 60., 12., 1. };
+	static double const b5[] = { 30240., 15120., 3360., 420., 30., 1. };
+	static double const b7[] = { 17297280., 8648640., 1995840., 277200.,
+		25200., 1512., 56., 1. };
+	static double const b9[] = { 17643225600., 8821612800., 2075673600.,
+		302702400., 30270240., 2162160., 110880., 3960., 90., 1. };
+	static double const b13[] = { 64764752532480000., 32382376266240000.,
+		7771770303897600., 1187353796428800., 129060195264000.,
+		10559470521600., 670442572800., 33522128640., 1323241920.,
+		40840800., 960960., 16380., 182., 1. };
+
+	size_t n = A.rows(), i, l;
+	int k;
+	double const * b = m == 3 ? b3 : m == 5 ? b5 : m == 7 ? b7 : m == 9 ? b9 : b13;
+
+	// Potenzen A^0, A^2, A^4, ...
+	std::vector< MMatrix > P;
+	P.push_back(MMatrix(n, n));
+	for (i=0; i<n; i++)
+		P[0](i,i) = 1.;
+	P.push_back(A*A);
+	for (k=2; k<=(m == 13 ? 3 : m/2); k++)
+		P.push_back(P[k-1]*P[1]);
+
+	// Linearkombination sum_l c[l]*P[l]
+	auto lincomb = [&](double const * c, int cnt) -> MMatrix {
+		MMatrix C(n, n);
+		double * pc = C;
+		for (int q=0; q<cnt; q++)
+		{
+			double const * pp = P[q];
+			for (l=0; l<n*n; l++)
+				pc[l] += c[q] * pp[l];
+		}
+		return C;
+	};
+
+	double ce[7], co[7];
+	if (m != 13)
+	{
+		for (k=0; k<=m/2; k++)
+		{
+			ce[k] = b[2*k];
+			co[k] = b[2*k+1];
+		}
+		V = lincomb(ce, m/2+1);
+		U = A * lincomb(co, m/2+1);
+		return;
+	}
+
+	// m=13: A^6*(...) + ... mit nur drei Potenzen
+	double h1[] = { 0., b[9], b[11], b[13] };
+	double h0[] = { b[1], b[3], b[5], b[7] };
+	double g1[] = { 0., b[8], b[10], b[12] };
+	double g0[] = { b[0], b[2], b[4], b[6] };
+	U = P[3] * lincomb(h1, 4);
+	U += lincomb(h0, 4);
+	U = A * U;
+	V = P[3] * lincomb(g1, 4);
+	V += lincomb(g0, 4);
+}
+
+} // namespace flux::la::expm_detail
+
+/**
+ * Matrix-Exponential exp(A) einer dichten Matrix (Scaling-and-Squaring,
+ * Padé-Grad 3, 5, 7, 9 oder 13 nach ||A||_1; Higham 2005).
+ *
+ * @param A quadratische Matrix
+ * @return exp(A)
+ */
+inline MMatrix expm(MMatrix const & A)
+{
+	static double const theta[] = { 1.495585217958292e-2,
+		2.539398330063230e-1, 9.504178996162932e-1,
+		2.097847961257068e0, 5.371920351148152e0 };
+	static int const deg[] = { 3, 5, 7, 9, 13 };
+
+	fASSERT(A.rows() == A.cols());
+	size_t n = A.rows();
+	int k, s = 0;
+	double nrm = A.norm1();
+	MMatrix U, V;
+
+	if (n == 0)
+		return MMatrix(0, 0);
+	if (n == 1)
+	{
+		MMatrix E(1, 1);
+		E(0,0) = stem::exp(A.get(0,0), 0);
+		return E;
+	}
+
+	for (k=0; k<4 and nrm > theta[k]; k++)
+		;
+	if (k < 4)
+		expm_detail::pade(A, deg[k], U, V);
+	else
+	{
+		s = std::max(0, int(::ceil(::log2(nrm / theta[4]))));
+		expm_detail::pade(A * ::ldexp(1.,-s), 13, U, V);
+	}
+
+	// (V-U)*E = V+U
+	MMatrix Q(V), E(V);
+	Q -= U;
+	E += U;
+	if (not lapack::linsolve(Q, E))
+		fWARNING("expm: singular Pade denominator");
+
+	// Quadrieren
+	for (k=0; k<s; k++)
+		E = E * E;
+	return E;
+}
+
+/**
+ * Wirkung des Matrix-Exponentials: v := exp(t*A)*v.
+ *
+ * @param A quadratische Matrix (MMatrix oder CSMatrix)
+ * @param t Zeit
+ * @param v Vektor (in/out)
+ */
+template< typename Op > void expmv(Op const & A, double t, MVector & v)
+{
+	fASSERT(v.dim() == A.cols());
+	expm_detail::expmv_inplace(A, t, v);
+}
+
+/**
+ * Wirkung des Matrix-Exponentials auf einen Block von Vektoren:
+ * V := exp(t*A)*V.
+ *
+ * @param A quadratische Matrix (MMatrix oder CSMatrix)
+ * @param t Zeit
+ * @param V Block von Vektoren (Spalten; in/out)
+ */
+template< typename Op > void expmv(Op const & A, double t, MMatrix & V)
+{
+	fASSERT(V.rows() == A.cols());
+	expm_detail::expmv_inplace(A, t, V);
+}
+
+/**
+ * Trajektorie x(t_k) = exp((t_k-t0)*A)*x0 auf einem aufsteigenden
+ * Zeitgitter, z.B. zu den Messzeitpunkten eines instationären
+ * Markierungsexperiments. Es wird schrittweise über die Intervalle
+ * t_{k-1}..t_k propagiert.
+ *
+ * @param A quadratische Matrix (MMatrix oder CSMatrix)
+ * @param t0 Anfangszeit
+ * @param t aufsteigende Zeitpunkte (>= t0)
+ * @param x0 Anfangswert
+ * @return Matrix mit x(t_k) in Spalte k
+ */
+template< typename Op > MMatrix expmv(
+	Op const & A,
+	double t0,
+	MVector const & t,
+	MVector const & x0
+	)
+{
+	fASSERT(x0.dim() == A.cols());
+	size_t i, k, n = x0.dim();
+	MMatrix X(n, t.dim());
+	MVector x(x0);
+	double tp = t0;
+
+	for (k=0; k<t.dim(); k++)
+	{
+		fASSERT(t.get(k) >= tp);
+		expmv(A, t.get(k)-tp, x);
+		tp = t.get(k);
+		for (i=0; i<n; i++)
+			X(i,k) = x.get(i);
+	}
+	return X;
+}
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
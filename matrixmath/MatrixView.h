@@ -0,0 +1,229 @@
+#ifndef MATRIXVIEW_H
+#define MATRIXVIEW_H
+
+#include <cstddef>
+#include "Error.h"
+
+namespace flux {
+namespace la {
+
+/**
+ * Nicht-besitzende Sicht auf einen (strided) Vektor: Zeiger auf das
+ * erste Element, Länge und Abstand zweier Elemente. Alle Zugriffe sind
+ * nicht-virtuell, inline und ohne Bereichsprüfung; damit können
+ * numerische Kernel statisch gebunden (und vom Compiler vektorisiert)
+ * auf GVector/GMatrix-Daten arbeiten. Für T = U const ergibt sich eine
+ * Nur-Lese-Sicht.
+ *
+ * Eine Sicht bleibt nur so lange gültig, wie der zugrundeliegende
+ * Speicher nicht neu angelegt wird (Zuweisung, Move, Destructor).
+ */
+template< typename T > class VectorView
+{
+private:
+	/** Zeiger auf das erste Element */
+	T * data_;
+	/** Anzahl der Elemente */
+	size_t dim_;
+	/** Abstand zweier aufeinanderfolgender Elemente */
+	size_t stride_;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param data Zeiger auf das erste Element
+	 * @param dim Anzahl der Elemente
+	 * @param stride Abstand zweier Elemente
+	 */
+	inline VectorView(T * data, size_t dim, size_t stride = 1)
+		: data_(data), dim_(dim), stride_(stride) { }
+
+	/**
+	 * Konvertierung einer schreibbaren in eine Nur-Lese-Sicht.
+	 *
+	 * @param v Sicht
+	 */
+	template< typename U > inline VectorView(VectorView< U > const & v)
+		: data_(v.data()), dim_(v.dim()), stride_(v.stride()) { }
+
+	/**
+	 * Elementzugriff.
+	 *
+	 * @param i Index
+	 * @return Referenz auf das i-te Element
+	 */
+	inline T & operator() (size_t i) const { return data_[i*stride_]; }
+
+	/**
+	 * Elementzugriff (Lesen).
+	 *
+	 * @param i Index
+	 * @return Referenz auf das i-te Element
+	 */
+	inline T & get(size_t i) const { return data_[i*stride_]; }
+
+	/**
+	 * Elementzugriff (Schreiben).
+	 *
+	 * @param i Index
+	 * @param val Wert
+	 */
+	template< typename V > inline void set(size_t i, V const & val) const
+	{
+		data_[i*stride_] = val;
+	}
+
+	/** @return Anzahl der Elemente */
+	inline size_t dim() const { return dim_; }
+
+	/** @return Abstand zweier Elemente */
+	inline size_t stride() const { return stride_; }
+
+	/** @return Zeiger auf das erste Element */
+	inline T * data() const { return data_; }
+
+	/**
+	 * Ausschnitt der Sicht.
+	 *
+	 * @param i erster Index
+	 * @param n Anzahl der Elemente
+	 * @return Sicht auf die Elemente i, ..., i+n-1
+	 */
+	inline VectorView slice(size_t i, size_t n) const
+	{
+		fASSERT(i+n <= dim_);
+		return VectorView(data_ + i*stride_, n, stride_);
+	}
+
+}; // class VectorView
+
+/**
+ * Nicht-besitzende Sicht auf eine spaltenweise (Fortran-Ordnung)
+ * gespeicherte Matrix oder einen Block davon: Element (i,j) liegt an
+ * data[j*ld+i]. Wie VectorView ohne virtuelle Aufrufe und ohne
+ * Bereichsprüfung.
+ */
+template< typename T > class MatrixView
+{
+private:
+	/** Zeiger auf Element (0,0) */
+	T * data_;
+	/** Anzahl der Zeilen */
+	size_t rows_;
+	/** Anzahl der Spalten */
+	size_t cols_;
+	/** führende Dimension (Abstand zweier Spalten) */
+	size_t ld_;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param data Zeiger auf Element (0,0)
+	 * @param rows Anzahl der Zeilen
+	 * @param cols Anzahl der Spalten
+	 * @param ld führende Dimension (>= rows)
+	 */
+	inline MatrixView(T * data, size_t rows, size_t cols, size_t ld)
+		: data_(data), rows_(rows), cols_(cols), ld_(ld) { }
+
+	/**
+	 * Konvertierung einer schreibbaren in eine Nur-Lese-Sicht.
+	 *
+	 * @param A Sicht
+	 */
+	template< typename U > inline MatrixView(MatrixView< U > const & A)
+		: data_(A.data()), rows_(A.rows()), cols_(A.cols()), ld_(A.ld()) { }
+
+	/**
+	 * Elementzugriff.
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Referenz auf Element (i,j)
+	 */
+	inline T & operator() (size_t i, size_t j) const
+	{
+		return data_[j*ld_+i];
+	}
+
+	/**
+	 * Elementzugriff (Lesen).
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Referenz auf Element (i,j)
+	 */
+	inline T & get(size_t i, size_t j) const { return data_[j*ld_+i]; }
+
+	/**
+	 * Elementzugriff (Schreiben).
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @param val Wert
+	 */
+	template< typename V > inline void set(size_t i, size_t j, V const & val) const
+	{
+		data_[j*ld_+i] = val;
+	}
+
+	/** @return Anzahl der Zeilen */
+	inline size_t rows() const { return rows_; }
+
+	/** @return Anzahl der Spalten */
+	inline size_t cols() const { return cols_; }
+
+	/** @return führende Dimension */
+	inline size_t ld() const { return ld_; }
+
+	/** @return Zeiger auf Element (0,0) */
+	inline T * data() const { return data_; }
+
+	/**
+	 * Sicht auf eine Spalte (zusammenhängend).
+	 *
+	 * @param j Spalte
+	 * @return Sicht auf Spalte j
+	 */
+	inline VectorView< T > col(size_t j) const
+	{
+		fASSERT(j < cols_);
+		return VectorView< T >(data_ + j*ld_, rows_, 1);
+	}
+
+	/**
+	 * Sicht auf eine Zeile (Abstand ld).
+	 *
+	 * @param i Zeile
+	 * @return Sicht auf Zeile i
+	 */
+	inline VectorView< T > row(size_t i) const
+	{
+		fASSERT(i < rows_);
+		return VectorView< T >(data_ + i, cols_, ld_);
+	}
+
+	/**
+	 * Sicht auf einen Block der Matrix.
+	 *
+	 * @param i Zeile der oberen linken Ecke
+	 * @param j Spalte der oberen linken Ecke
+	 * @param r Anzahl der Zeilen
+	 * @param c Anzahl der Spalten
+	 * @return Sicht auf den Block
+	 */
+	inline MatrixView block(size_t i, size_t j, size_t r, size_t c) const
+	{
+		fASSERT(i+r <= rows_ and j+c <= cols_);
+		return MatrixView(data_ + j*ld_ + i, r, c, ld_);
+	}
+
+}; // class MatrixView
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
@@ -70,6 +70,17 @@ public:
 	inline PMatrix(PMatrix const & copy)
 		: GVector< unsigned int > (copy) { }
 
+	/**
+	 * Zuweisung.
+	 *
+	 * @param copy zu kopierendes Objekt
+	 * @return Referenz auf *this
+	 */
+	inline PMatrix & operator= (PMatrix const & copy)
+	{
+		GVector< unsigned int >::operator=(copy);
+		return *this;
+	}
 
 public:
 	/**
@@ -0,0 +1,568 @@
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+
+#include "Error.h"
+#include "SIMDKernels.h"
+
+// AVX2/AVX-512 werden über Funktions-Attribute (target) übersetzt, so
+// dass die Bibliothek ohne -mavx2 gebaut und auf jeder x86-64-CPU
+// ausgeführt werden kann; die Auswahl erfolgt zur Laufzeit.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_X86
+#include <immintrin.h>
+#define TARGET_AVX2	__attribute__((target("avx2,fma")))
+#define TARGET_AVX512	__attribute__((target("avx512f")))
+#endif
+
+namespace flux {
+namespace la {
+namespace simd {
+
+/**
+ * Tabelle der Kernel eines Befehlssatzes.
+ */
+struct Kernels
+{
+	ISA isa;
+	/** Ausrichtung (Bytes) für aligned; 0 bei skalaren Kerneln */
+	size_t align;
+	/** Variante mit ausgerichteten Lade-/Speicheroperationen (oder 0) */
+	Kernels const * aligned;
+	void (*fill)(size_t, double, double *);
+	void (*axpy)(size_t, double, double const *, double *);
+	void (*scale)(size_t, double, double *);
+	double (*dot)(size_t, double const *, double const *);
+	double (*asum)(size_t, double const *);
+	double (*sumsq)(size_t, double const *);
+	double (*amax)(size_t, double const *);
+	size_t (*bounds)(size_t, double const *, double const *,
+		double const *, double, double *);
+};
+
+/*
+ * Skalare Referenz-Implementierung
+ */
+
+static void scalar_fill(size_t n, double val, double * x)
+{
+	for (size_t i=0; i<n; i++)
+		x[i] = val;
+}
+
+static void scalar_axpy(size_t n, double alpha, double const * x, double * y)
+{
+	for (size_t i=0; i<n; i++)
+		y[i] += alpha * x[i];
+}
+
+static void scalar_scale(size_t n, double alpha, double * x)
+{
+	for (size_t i=0; i<n; i++)
+		x[i] *= alpha;
+}
+
+static double scalar_dot(size_t n, double const * x, double const * y)
+{
+	// vier unabhängige Summen (Latenz der Addition)
+	double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+	size_t i;
+	for (i=0; i+4<=n; i+=4)
+	{
+		s0 += x[i] * y[i];
+		s1 += x[i+1] * y[i+1];
+		s2 += x[i+2] * y[i+2];
+		s3 += x[i+3] * y[i+3];
+	}
+	for (; i<n; i++)
+		s0 += x[i] * y[i];
+	return (s0 + s1) + (s2 + s3);
+}
+
+static double scalar_asum(size_t n, double const * x)
+{
+	double s = 0.;
+	for (size_t i=0; i<n; i++)
+		s += fabs(x[i]);
+	return s;
+}
+
+static double scalar_sumsq(size_t n, double const * x)
+{
+	return scalar_dot(n, x, x);
+}
+
+static double scalar_amax(size_t n, double const * x)
+{
+	double m = 0., a;
+	for (size_t i=0; i<n; i++)
+	{
+		a = fabs(x[i]);
+		if (a > m) m = a;
+	}
+	return m;
+}
+
+static size_t scalar_bounds(
+	size_t n,
+	double const * x,
+	double const * lo,
+	double const * hi,
+	double tol,
+	double * viol
+	)
+{
+	size_t i, nviol = 0;
+	bool violated;
+	for (i=0; i<n; i++)
+	{
+		violated = not (x[i] >= lo[i]-tol and x[i] <= hi[i]+tol);
+		if (viol)
+			viol[i] = violated ? fabs(x[i]) : -1.;
+		nviol += violated ? 1 : 0;
+	}
+	return nviol;
+}
+
+static Kernels const scalar_kernels = {
+	isa_scalar, 0, 0,
+	scalar_fill, scalar_axpy, scalar_scale, scalar_dot,
+	scalar_asum, scalar_sumsq, scalar_amax, scalar_bounds
+};
+
+#ifdef SIMD_X86
+
+/*
+ * AVX2 + FMA
+ */
+
+/** Laden/Speichern von 4 doubles; A: Adresse ist 32-Byte-ausgerichtet */
+template< bool A > TARGET_AVX2 static inline __m256d avx2_ld(double const * p)
+{
+	return A ? _mm256_load_pd(p) : _mm256_loadu_pd(p);
+}
+
+template< bool A > TARGET_AVX2 static inline void avx2_st(double * p, __m256d v)
+{
+	if (A) _mm256_store_pd(p, v); else _mm256_storeu_pd(p, v);
+}
+
+TARGET_AVX2 static inline __m256d avx2_abs(__m256d v)
+{
+	return _mm256_andnot_pd(_mm256_set1_pd(-0.), v);
+}
+
+TARGET_AVX2 static inline double avx2_hsum(__m256d v)
+{
+	__m128d lo = _mm256_castpd256_pd128(v);
+	__m128d hi = _mm256_extractf128_pd(v, 1);
+	lo = _mm_add_pd(lo, hi);
+	return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+template< bool A > TARGET_AVX2 static void avx2_fill(size_t n, double val, double * x)
+{
+	__m256d v = _mm256_set1_pd(val);
+	size_t i;
+	for (i=0; i+4<=n; i+=4)
+		avx2_st< A >(x+i, v);
+	for (; i<n; i++)
+		x[i] = val;
+}
+
+template< bool A > TARGET_AVX2 static void avx2_axpy(size_t n, double alpha, double const * x, double * y)
+{
+	__m256d a = _mm256_set1_pd(alpha);
+	size_t i;
+	for (i=0; i+8<=n; i+=8)
+	{
+		__m256d y0 = _mm256_fmadd_pd(a, avx2_ld< A >(x+i), avx2_ld< A >(y+i));
+		__m256d y1 = _mm256_fmadd_pd(a, avx2_ld< A >(x+i+4), avx2_ld< A >(y+i+4));
+		avx2_st< A >(y+i, y0);
+		avx2_st< A >(y+i+4, y1);
+	}
+	for (; i<n; i++)
+		y[i] += alpha * x[i];
+}
+
+template< bool A > TARGET_AVX2 static void avx2_scale(size_t n, double alpha, double * x)
+{
+	__m256d a = _mm256_set1_pd(alpha);
+	size_t i;
+	for (i=0; i+4<=n; i+=4)
+		avx2_st< A >(x+i, _mm256_mul_pd(a, avx2_ld< A >(x+i)));
+	for (; i<n; i++)
+		x[i] *= alpha;
+}
+
+template< bool A > TARGET_AVX2 static double avx2_dot(size_t n, double const * x, double const * y)
+{
+	// vier Akkumulatoren verdecken die FMA-Latenz
+	__m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+	size_t i;
+	for (i=0; i+16<=n; i+=16)
+	{
+		s0 = _mm256_fmadd_pd(avx2_ld< A >(x+i), avx2_ld< A >(y+i), s0);
+		s1 = _mm256_fmadd_pd(avx2_ld< A >(x+i+4), avx2_ld< A >(y+i+4), s1);
+		s2 = _mm256_fmadd_pd(avx2_ld< A >(x+i+8), avx2_ld< A >(y+i+8), s2);
+		s3 = _mm256_fmadd_pd(avx2_ld< A >(x+i+12), avx2_ld< A >(y+i+12), s3);
+	}
+	for (; i+4<=n; i+=4)
+		s0 = _mm256_fmadd_pd(avx2_ld< A >(x+i), avx2_ld< A >(y+i), s0);
+	double s = avx2_hsum(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+	for (; i<n; i++)
+		s += x[i] * y[i];
+	return s;
+}
+
+template< bool A > TARGET_AVX2 static double avx2_asum(size_t n, double const * x)
+{
+	__m256d s0 = _mm256_setzero_pd(), s1 = s0;
+	size_t i;
+	for (i=0; i+8<=n; i+=8)
+	{
+		s0 = _mm256_add_pd(s0, avx2_abs(avx2_ld< A >(x+i)));
+		s1 = _mm256_add_pd(s1, avx2_abs(avx2_ld< A >(x+i+4)));
+	}
+	double s = avx2_hsum(_mm256_add_pd(s0, s1));
+	for (; i<n; i++)
+		s += fabs(x[i]);
+	return s;
+}
+
+template< bool A > TARGET_AVX2 static double avx2_sumsq(size_t n, double const * x)
+{
+	return avx2_dot< A >(n, x, x);
+}
+
+template< bool A > TARGET_AVX2 static double avx2_amax(size_t n, double const * x)
+{
+	// max(|x|,m) liefert m, falls |x| NaN ist
+	__m256d m = _mm256_setzero_pd();
+	size_t i;
+	for (i=0; i+4<=n; i+=4)
+		m = _mm256_max_pd(avx2_abs(avx2_ld< A >(x+i)), m);
+	double r[4], a;
+	_mm256_storeu_pd(r, m);
+	for (a=0.; i<n; i++)
+		if (fabs(x[i]) > a) a = fabs(x[i]);
+	for (i=0; i<4; i++)
+		if (r[i] > a) a = r[i];
+	return a;
+}
+
+template< bool A > TARGET_AVX2 static size_t avx2_bounds(
+	size_t n,
+	double const * x,
+	double const * lo,
+	double const * hi,
+	double tol,
+	double * viol
+	)
+{
+	__m256d t = _mm256_set1_pd(tol);
+	__m256d m1 = _mm256_set1_pd(-1.);
+	size_t i, nviol = 0;
+	for (i=0; i+4<=n; i+=4)
+	{
+		__m256d v = avx2_ld< A >(x+i);
+		__m256d l = _mm256_sub_pd(avx2_ld< A >(lo+i), t);
+		__m256d h = _mm256_add_pd(avx2_ld< A >(hi+i), t);
+		// "not greater/less or equal, unordered": NaN ist verletzt
+		__m256d mask = _mm256_or_pd(
+			_mm256_cmp_pd(v, l, _CMP_NGE_UQ),
+			_mm256_cmp_pd(v, h, _CMP_NLE_UQ));
+		if (viol)
+			avx2_st< A >(viol+i, _mm256_blendv_pd(m1, avx2_abs(v), mask));
+		nviol += __builtin_popcount(_mm256_movemask_pd(mask));
+	}
+	if (i < n)
+		nviol += scalar_bounds(n-i, x+i, lo+i, hi+i, tol, viol ? viol+i : 0);
+	return nviol;
+}
+
+static Kernels const avx2_kernels_aligned = {
+	isa_avx2, 32, 0,
+	avx2_fill< true >, avx2_axpy< true >, avx2_scale< true >, avx2_dot< true >,
+	avx2_asum< true >, avx2_sumsq< true >, avx2_amax< true >, avx2_bounds< true >
+};
+
+static Kernels const avx2_kernels = {
+	isa_avx2, 32, &avx2_kernels_aligned,
+	avx2_fill< false >, avx2_axpy< false >, avx2_scale< false >, avx2_dot< false >,
+	avx2_asum< false >, avx2_sumsq< false >, avx2_amax< false >, avx2_bounds< false >
+};
+
+/*
+ * AVX-512F
+ */
+
+/**
+ * Laden/Speichern von 8 doubles (auch maskiert); A: Adresse ist
+ * 64-Byte-ausgerichtet
+ */
+template< bool A > TARGET_AVX512 static inline __m512d avx512_ld(double const * p)
+{
+	return A ? _mm512_load_pd(p) : _mm512_loadu_pd(p);
+}
+
+template< bool A > TARGET_AVX512 static inline void avx512_st(double * p, __m512d v)
+{
+	if (A) _mm512_store_pd(p, v); else _mm512_storeu_pd(p, v);
+}
+
+template< bool A > TARGET_AVX512 static inline __m512d avx512_ldz(__mmask8 k, double const * p)
+{
+	return A ? _mm512_maskz_load_pd(k, p) : _mm512_maskz_loadu_pd(k, p);
+}
+
+template< bool A > TARGET_AVX512 static inline void avx512_stm(double * p, __mmask8 k, __m512d v)
+{
+	if (A) _mm512_mask_store_pd(p, k, v); else _mm512_mask_storeu_pd(p, k, v);
+}
+
+
+template< bool A > TARGET_AVX512 static void avx512_fill(size_t n, double val, double * x)
+{
+	__m512d v = _mm512_set1_pd(val);
+	size_t i;
+	for (i=0; i+8<=n; i+=8)
+		avx512_st< A >(x+i, v);
+	if (i < n)
+		avx512_stm< A >(x+i, __mmask8((1u << (n-i)) - 1), v);
+}
+
+template< bool A > TARGET_AVX512 static void avx512_axpy(size_t n, double alpha, double const * x, double * y)
+{
+	__m512d a = _mm512_set1_pd(alpha);
+	size_t i;
+	for (i=0; i+16<=n; i+=16)
+	{
+		__m512d y0 = _mm512_fmadd_pd(a, avx512_ld< A >(x+i), avx512_ld< A >(y+i));
+		__m512d y1 = _mm512_fmadd_pd(a, avx512_ld< A >(x+i+8), avx512_ld< A >(y+i+8));
+		avx512_st< A >(y+i, y0);
+		avx512_st< A >(y+i+8, y1);
+	}
+	for (; i+8<=n; i+=8)
+		avx512_st< A >(y+i, _mm512_fmadd_pd(a, avx512_ld< A >(x+i), avx512_ld< A >(y+i)));
+	if (i < n)
+	{
+		__mmask8 k = __mmask8((1u << (n-i)) - 1);
+		__m512d xv = avx512_ldz< A >(k, x+i);
+		__m512d yv = avx512_ldz< A >(k, y+i);
+		avx512_stm< A >(y+i, k, _mm512_fmadd_pd(a, xv, yv));
+	}
+}
+
+template< bool A > TARGET_AVX512 static void avx512_scale(size_t n, double alpha, double * x)
+{
+	__m512d a = _mm512_set1_pd(alpha);
+	size_t i;
+	for (i=0; i+8<=n; i+=8)
+		avx512_st< A >(x+i, _mm512_mul_pd(a, avx512_ld< A >(x+i)));
+	if (i < n)
+	{
+		__mmask8 k = __mmask8((1u << (n-i)) - 1);
+		avx512_stm< A >(x+i, k, _mm512_mul_pd(a, avx512_ldz< A >(k, x+i)));
+	}
+}
+
+template< bool A > TARGET_AVX512 static double avx512_dot(size_t n, double const * x, double const * y)
+{
+	__m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+	size_t i;
+	for (i=0; i+32<=n; i+=32)
+	{
+		s0 = _mm512_fmadd_pd(avx512_ld< A >(x+i), avx512_ld< A >(y+i), s0);
+		s1 = _mm512_fmadd_pd(avx512_ld< A >(x+i+8), avx512_ld< A >(y+i+8), s1);
+		s2 = _mm512_fmadd_pd(avx512_ld< A >(x+i+16), avx512_ld< A >(y+i+16), s2);
+		s3 = _mm512_fmadd_pd(avx512_ld< A >(x+i+24), avx512_ld< A >(y+i+24), s3);
+	}
+	for (; i+8<=n; i+=8)
+		s0 = _mm512_fmadd_pd(avx512_ld< A >(x+i), avx512_ld< A >(y+i), s0);
+	if (i < n)
+	{
+		// maskierte Ladeoperationen liefern 0 außerhalb des Vektors
+		__mmask8 k = __mmask8((1u << (n-i)) - 1);
+		s1 = _mm512_fmadd_pd(avx512_ldz< A >(k, x+i),
+			avx512_ldz< A >(k, y+i), s1);
+	}
+	return _mm512_reduce_add_pd(
+		_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+template< bool A > TARGET_AVX512 static double avx512_asum(size_t n, double const * x)
+{
+	__m512d s0 = _mm512_setzero_pd(), s1 = s0;
+	size_t i;
+	for (i=0; i+16<=n; i+=16)
+	{
+		s0 = _mm512_add_pd(s0, _mm512_abs_pd(avx512_ld< A >(x+i)));
+		s1 = _mm512_add_pd(s1, _mm512_abs_pd(avx512_ld< A >(x+i+8)));
+	}
+	for (; i+8<=n; i+=8)
+		s0 = _mm512_add_pd(s0, _mm512_abs_pd(avx512_ld< A >(x+i)));
+	if (i < n)
+	{
+		__mmask8 k = __mmask8((1u << (n-i)) - 1);
+		s1 = _mm512_add_pd(s1, _mm512_abs_pd(avx512_ldz< A >(k, x+i)));
+	}
+	return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+}
+
+template< bool A > TARGET_AVX512 static double avx512_sumsq(size_t n, double const * x)
+{
+	return avx512_dot< A >(n, x, x);
+}
+
+template< bool A > TARGET_AVX512 static double avx512_amax(size_t n, double const * x)
+{
+	// max(|x|,m) liefert m, falls |x| NaN ist
+	__m512d m = _mm512_setzero_pd();
+	size_t i;
+	for (i=0; i+8<=n; i+=8)
+		m = _mm512_max_pd(_mm512_abs_pd(avx512_ld< A >(x+i)), m);
+	if (i < n)
+	{
+		__mmask8 k = __mmask8((1u << (n-i)) - 1);
+		m = _mm512_max_pd(_mm512_abs_pd(avx512_ldz< A >(k, x+i)), m);
+	}
+	return _mm512_reduce_max_pd(m);
+}
+
+template< bool A > TARGET_AVX512 static size_t avx512_bounds(
+	size_t n,
+	double const * x,
+	double const * lo,
+	double const * hi,
+	double tol,
+	double * viol
+	)
+{
+	__m512d t = _mm512_set1_pd(tol);
+	__m512d m1 = _mm512_set1_pd(-1.);
+	size_t i, nviol = 0;
+	for (i=0; i<n; i+=8)
+	{
+		__mmask8 k = (n-i >= 8) ? __mmask8(0xff) : __mmask8((1u << (n-i)) - 1);
+		__m512d v = avx512_ldz< A >(k, x+i);
+		__m512d l = _mm512_sub_pd(avx512_ldz< A >(k, lo+i), t);
+		__m512d h = _mm512_add_pd(avx512_ldz< A >(k, hi+i), t);
+		// "not greater/less or equal, unordered": NaN ist verletzt
+		__mmask8 mask = _mm512_mask_cmp_pd_mask(k, v, l, _CMP_NGE_UQ)
+			| _mm512_mask_cmp_pd_mask(k, v, h, _CMP_NLE_UQ);
+		if (viol)
+			avx512_stm< A >(viol+i, k,
+				_mm512_mask_blend_pd(mask, m1, _mm512_abs_pd(v)));
+		nviol += __builtin_popcount(mask);
+	}
+	return nviol;
+}
+
+static Kernels const avx512_kernels_aligned = {
+	isa_avx512, 64, 0,
+	avx512_fill< true >, avx512_axpy< true >, avx512_scale< true >,
+	avx512_dot< true >, avx512_asum< true >, avx512_sumsq< true >,
+	avx512_amax< true >, avx512_bounds< true >
+};
+
+static Kernels const avx512_kernels = {
+	isa_avx512, 64, &avx512_kernels_aligned,
+	avx512_fill< false >, avx512_axpy< false >, avx512_scale< false >,
+	avx512_dot< false >, avx512_asum< false >, avx512_sumsq< false >,
+	avx512_amax< false >, avx512_bounds< false >
+};
+
+#endif // SIMD_X86
+
+/**
+ * Bestimmt die Kernel-Tabelle für den gewünschten Befehlssatz; nicht
+ * unterstützte Befehlssätze fallen auf den nächstkleineren zurück.
+ */
+static Kernels const * select_kernels(ISA isa)
+{
+#ifdef SIMD_X86
+	__builtin_cpu_init();
+	bool has_avx512 = __builtin_cpu_supports("avx512f");
+	bool has_avx2 = __builtin_cpu_supports("avx2")
+		and __builtin_cpu_supports("fma");
+
+	if ((isa == isa_auto or isa == isa_avx512) and has_avx512)
+		return &avx512_kernels;
+	if ((isa == isa_auto or isa == isa_avx512 or isa == isa_avx2) and has_avx2)
+		return &avx2_kernels;
+#endif
+	if (isa != isa_auto and isa != isa_scalar)
+		fWARNING("requested SIMD instruction set is not supported; using scalar kernels");
+	return &scalar_kernels;
+}
+
+static std::atomic< Kernels const * > kernels_(0);
+
+static inline Kernels const & K()
+{
+	Kernels const * k = kernels_.load(std::memory_order_relaxed);
+	if (k == 0)
+	{
+		// einmalige Auswahl beim ersten Aufruf
+		static Kernels const * const init = select_kernels(isa_auto);
+		kernels_.store(k = init, std::memory_order_relaxed);
+	}
+	return *k;
+}
+
+/**
+ * Kernel-Tabelle für eine Operation auf den gegebenen Vektoren: sind
+ * alle Adressen (bitweise verodert in addr) passend ausgerichtet -- wie
+ * der Elementspeicher von GVector/GMatrix --, werden ausgerichtete
+ * Lade-/Speicheroperationen verwendet.
+ */
+static inline Kernels const & K(uintptr_t addr)
+{
+	Kernels const & k = K();
+	if (k.aligned and addr % k.align == 0)
+		return *k.aligned;
+	return k;
+}
+
+void setISA(ISA isa) { kernels_.store(select_kernels(isa)); }
+
+ISA getISA() { return K().isa; }
+
+void fill(size_t n, double val, double * x) { K(uintptr_t(x)).fill(n, val, x); }
+
+void axpy(size_t n, double alpha, double const * x, double * y)
+{
+	K(uintptr_t(x) | uintptr_t(y)).axpy(n, alpha, x, y);
+}
+
+void scale(size_t n, double alpha, double * x) { K(uintptr_t(x)).scale(n, alpha, x); }
+
+double dot(size_t n, double const * x, double const * y)
+{
+	return K(uintptr_t(x) | uintptr_t(y)).dot(n, x, y);
+}
+
+double norm1(size_t n, double const * x) { return K(uintptr_t(x)).asum(n, x); }
+
+double norm2(size_t n, double const * x) { return sqrt(K(uintptr_t(x)).sumsq(n, x)); }
+
+double normInf(size_t n, double const * x) { return K(uintptr_t(x)).amax(n, x); }
+
+size_t checkBounds(
+	size_t n,
+	double const * x,
+	double const * lo,
+	double const * hi,
+	double tol,
+	double * viol
+	)
+{
+	return K(uintptr_t(x) | uintptr_t(lo) | uintptr_t(hi)
+		| uintptr_t(viol)).bounds(n, x, lo, hi, tol, viol);
+}
+
+} // namespace flux::la::simd
+} // namespace flux::la
+} // namespace flux
+
@@ -0,0 +1,135 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+
+namespace flux {
+namespace la {
+namespace simd {
+
+/**
+ * Befehlssatz der elementweisen Vektor-Kernel. Die Auswahl erfolgt
+ * beim ersten Aufruf anhand der CPU (isa_auto); ohne x86-Unterstützung
+ * wird immer die skalare Implementierung verwendet.
+ */
+enum ISA
+{
+	isa_auto,	// beste von der CPU unterstützte Variante
+	isa_scalar,	// skalare Schleifen (Referenz)
+	isa_avx2,	// AVX2 + FMA, 4 doubles pro Register
+	isa_avx512	// AVX-512F, 8 doubles pro Register
+};
+
+/**
+ * Setzt den Befehlssatz der Vektor-Kernel. Nicht unterstützte
+ * Befehlssätze werden auf die beste verfügbare Variante abgebildet.
+ * Die Einstellung gilt global und sollte nicht umgeschaltet werden,
+ * während andere Threads rechnen (gedacht für Benchmarks und
+ * Vergleichstests).
+ *
+ * @param isa gewünschter Befehlssatz
+ */
+void setISA(ISA isa);
+
+/**
+ * Gibt den tatsächlich verwendeten Befehlssatz zurück.
+ *
+ * @return isa_scalar, isa_avx2 oder isa_avx512
+ */
+ISA getISA();
+
+/**
+ * Füllt einen Vektor mit einem Wert: x(i) = val.
+ *
+ * @param n Länge des Vektors
+ * @param val Wert
+ * @param x Vektor (out)
+ */
+void fill(size_t n, double val, double * x);
+
+/**
+ * Vektor-Update y = alpha*x + y. x und y dürfen identisch sein.
+ *
+ * @param n Länge der Vektoren
+ * @param alpha Faktor
+ * @param x Vektor x
+ * @param y Vektor y (in/out)
+ */
+void axpy(size_t n, double alpha, double const * x, double * y);
+
+/**
+ * Skalierung x = alpha*x.
+ *
+ * @param n Länge des Vektors
+ * @param alpha Faktor
+ * @param x Vektor (in/out)
+ */
+void scale(size_t n, double alpha, double * x);
+
+/**
+ * Skalarprodukt x^T*y. Die Summationsreihenfolge hängt vom Befehlssatz
+ * ab; die Ergebnisse können daher in den letzten Bits abweichen.
+ *
+ * @param n Länge der Vektoren
+ * @param x Vektor x
+ * @param y Vektor y
+ * @return Skalarprodukt
+ */
+double dot(size_t n, double const * x, double const * y);
+
+/**
+ * 1-Norm \sum_i |x(i)|.
+ *
+ * @param n Länge des Vektors
+ * @param x Vektor
+ * @return 1-Norm
+ */
+double norm1(size_t n, double const * x);
+
+/**
+ * Euklidische Norm sqrt(\sum_i x(i)^2) (ohne Skalierung gegen
+ * Über-/Unterlauf).
+ *
+ * @param n Länge des Vektors
+ * @param x Vektor
+ * @return 2-Norm
+ */
+double norm2(size_t n, double const * x);
+
+/**
+ * Maximum-Norm max_i |x(i)|. NaN-Elemente werden ignoriert.
+ *
+ * @param n Länge des Vektors
+ * @param x Vektor
+ * @return Inf-Norm
+ */
+double normInf(size_t n, double const * x);
+
+/**
+ * Vergleich mit Schranken: x(i) gilt als verletzt, falls nicht
+ * lo(i)-tol <= x(i) <= hi(i)+tol (NaN ist immer verletzt). Unbeschränkte
+ * Seiten werden durch -inf bzw. +inf ausgedrückt.
+ *
+ * @param n Länge der Vektoren
+ * @param x Vektor
+ * @param lo untere Schranken
+ * @param hi obere Schranken
+ * @param tol Toleranz
+ * @param viol falls !=0: |x(i)| bei Verletzung, sonst -1 (out)
+ * @return Anzahl der verletzten Schranken
+ */
+size_t checkBounds(
+	size_t n,
+	double const * x,
+	double const * lo,
+	double const * hi,
+	double tol,
+	double * viol = 0
+	);
+
+} // namespace flux::la::simd
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
@@ -0,0 +1,527 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+#include "Error.h"
+#include "MMatrix.h"
+#include "MVector.h"
+#include "CSMatrix.h"
+#include "SparseLU.h"
+
+namespace flux {
+namespace la {
+
+// "kein Index"
+#define SLU_NONE	size_t(-1)
+
+namespace {
+
+/**
+ * Minimum-Degree-Ordnung auf einem Quotientengraphen (vgl. AMD): bei der
+ * Elimination eines Knotens p werden p und seine Nachbarn zu einem neuen
+ * "Element" zusammengefasst, statt die Clique explizit zu bilden. Der Grad
+ * eines Knotens wird (wie bei AMD) nach oben durch die Summe der Größen
+ * seiner Elemente abgeschätzt. Supervariablen werden nicht erkannt.
+ *
+ * @param n Anzahl der Knoten
+ * @param Av Nachbarknoten je Knoten (ohne Schleifen); wird verbraucht
+ * @param Le Anfangselemente (Knotenmengen); wird verbraucht
+ * @param dense Knoten, die nicht eliminiert, sondern angehängt werden
+ * @param order Eliminationsreihenfolge (Ausgabe)
+ */
+void mindeg_order(
+	size_t n,
+	std::vector< std::vector< size_t > > & Av,
+	std::vector< std::vector< size_t > > & Le,
+	std::vector< char > const & dense,
+	std::vector< size_t > & order
+	)
+{
+	size_t i, p, e, d, tag = 0;
+	std::vector< std::vector< size_t > > Ev(n);
+	std::vector< char > elim(dense), elive(Le.size(), 1);
+	std::vector< size_t > deg(n), mark(n, SLU_NONE);
+	std::set< std::pair< size_t,size_t > > Q;
+
+	for (e=0; e<Le.size(); e++)
+		for (i=0; i<Le[e].size(); i++)
+			Ev[Le[e][i]].push_back(e);
+
+	auto degree = [&](size_t v) -> size_t {
+		size_t k, dv = Av[v].size();
+		for (k=0; k<Ev[v].size(); k++)
+			dv += Le[Ev[v][k]].size() - 1;
+		return std::min(dv, n-1);
+	};
+
+	order.clear();
+	order.reserve(n);
+	for (i=0; i<n; i++)
+	{
+		if (dense[i])
+			continue;
+		deg[i] = degree(i);
+		Q.insert(std::make_pair(deg[i],i));
+	}
+
+	while (not Q.empty())
+	{
+		p = Q.begin()->second;
+		Q.erase(Q.begin());
+		elim[p] = 1;
+		order.push_back(p);
+
+		// neues Element Lp = (Av[p] u Vereinigung der Elemente von p) \ {p};
+		// die Elemente von p werden absorbiert
+		std::vector< size_t > Lp;
+		mark[p] = ++tag;
+		for (i=0; i<Av[p].size(); i++)
+			if (not elim[Av[p][i]] and mark[Av[p][i]] != tag)
+			{
+				mark[Av[p][i]] = tag;
+				Lp.push_back(Av[p][i]);
+			}
+		for (i=0; i<Ev[p].size(); i++)
+		{
+			e = Ev[p][i];
+			if (not elive[e])
+				continue;
+			for (d=0; d<Le[e].size(); d++)
+				if (not elim[Le[e][d]] and mark[Le[e][d]] != tag)
+				{
+					mark[Le[e][d]] = tag;
+					Lp.push_back(Le[e][d]);
+				}
+			elive[e] = 0;
+			std::vector< size_t >().swap(Le[e]);
+		}
+		std::vector< size_t >().swap(Av[p]);
+		std::vector< size_t >().swap(Ev[p]);
+
+		e = Le.size();
+		elive.push_back(1);
+		Le.push_back(Lp);
+
+		// Nachbarn aktualisieren: Kanten innerhalb von Lp sind durch das
+		// neue Element abgedeckt
+		for (i=0; i<Lp.size(); i++)
+		{
+			size_t v = Lp[i];
+			std::vector< size_t > & av = Av[v];
+			std::vector< size_t > & ev = Ev[v];
+			av.erase(std::remove_if(av.begin(), av.end(),
+				[&](size_t w) { return elim[w] or mark[w] == tag; }),
+				av.end());
+			ev.erase(std::remove_if(ev.begin(), ev.end(),
+				[&](size_t f) { return not elive[f]; }),
+				ev.end());
+			ev.push_back(e);
+			if (dense[v])
+				continue;
+			Q.erase(std::make_pair(deg[v],v));
+			deg[v] = degree(v);
+			Q.insert(std::make_pair(deg[v],v));
+		}
+	}
+
+	for (i=0; i<n; i++)
+		if (dense[i])
+			order.push_back(i);
+}
+
+/**
+ * Schwelle für dichte Zeilen/Spalten (wie bei AMD/COLAMD), die bei der
+ * Ordnung ignoriert werden.
+ */
+inline size_t dense_threshold(size_t n)
+{
+	return std::max(size_t(16), size_t(10. * ::sqrt(double(n))));
+}
+
+/**
+ * Liefert A im CSC-Format (ggf. konvertiert).
+ */
+inline CSMatrix const & as_csc(CSMatrix const & A, CSMatrix & tmp)
+{
+	if (A.format() == CSMatrix::csc)
+		return A;
+	tmp = A.convert(CSMatrix::csc);
+	return tmp;
+}
+
+} // namespace
+
+SparseLU::SparseLU(Ordering ordering, double pivtol)
+	: ordering_(ordering), pivtol_(pivtol), n_(0),
+	  analyzed_(false), factored_(false)
+{
+	fASSERT(pivtol_ >= 0. and pivtol_ <= 1.);
+}
+
+void SparseLU::orderAMD(CSMatrix const & A, std::vector< size_t > & q)
+{
+	fASSERT(A.rows() == A.cols());
+	size_t i, j, k, n = A.rows();
+	CSMatrix tmp;
+	CSMatrix const & C = as_csc(A, tmp);
+	std::vector< std::vector< size_t > > Av(n), Le;
+	std::vector< char > dense(n, 0);
+
+	// Muster von A+A^T ohne Diagonale
+	for (j=0; j<n; j++)
+		for (k=C.ptr()[j]; k<C.ptr()[j+1]; k++)
+		{
+			i = C.idx()[k];
+			if (i == j)
+				continue;
+			Av[i].push_back(j);
+			Av[j].push_back(i);
+		}
+	for (i=0; i<n; i++)
+	{
+		std::sort(Av[i].begin(), Av[i].end());
+		Av[i].erase(std::unique(Av[i].begin(), Av[i].end()), Av[i].end());
+		if (Av[i].size() > dense_threshold(n))
+			dense[i] = 1;
+	}
+	for (i=0; i<n; i++)
+		Av[i].erase(std::remove_if(Av[i].begin(), Av[i].end(),
+			[&](size_t v) { return dense[v] != 0; }), Av[i].end());
+	mindeg_order(n, Av, Le, dense, q);
+}
+
+void SparseLU::orderCOLAMD(CSMatrix const & A, std::vector< size_t > & q)
+{
+	size_t i, j, k, n = A.cols();
+	CSMatrix tmp;
+	CSMatrix const & C = as_csc(A, tmp);
+	std::vector< std::vector< size_t > > Av(n), Le(A.rows());
+	std::vector< char > dense(n, 0);
+
+	// Zeile i von A verbindet alle ihre Spalten in A^T*A: als Element
+	for (j=0; j<n; j++)
+		for (k=C.ptr()[j]; k<C.ptr()[j+1]; k++)
+			Le[C.idx()[k]].push_back(j);
+	// dichte Zeilen würden A^T*A voll besetzen
+	for (i=0; i<Le.size(); i++)
+		if (Le[i].size() > dense_threshold(n))
+			std::vector< size_t >().swap(Le[i]);
+	mindeg_order(n, Av, Le, dense, q);
+}
+
+bool SparseLU::samePattern(CSMatrix const & A) const
+{
+	if (A.rows() != n_ or A.cols() != n_ or A.format() != CSMatrix::csc
+		or A.nnz() != Ai_.size())
+		return false;
+	return std::equal(Ap_.begin(), Ap_.end(), A.ptr())
+		and std::equal(Ai_.begin(), Ai_.end(), A.idx());
+}
+
+void SparseLU::analyze(CSMatrix const & A)
+{
+	fASSERT(A.rows() == A.cols());
+	CSMatrix tmp;
+	CSMatrix const & C = as_csc(A, tmp);
+	size_t k;
+
+	n_ = C.rows();
+	Ap_.assign(C.ptr(), C.ptr()+n_+1);
+	Ai_.assign(C.idx(), C.idx()+C.nnz());
+
+	switch (ordering_)
+	{
+	case ord_amd:
+		orderAMD(C, q_);
+		break;
+	case ord_colamd:
+		orderCOLAMD(C, q_);
+		break;
+	default:
+		q_.resize(n_);
+		for (k=0; k<n_; k++)
+			q_[k] = k;
+	}
+	fASSERT(q_.size() == n_);
+	analyzed_ = true;
+	factored_ = false;
+}
+
+bool SparseLU::factor(CSMatrix const & A)
+{
+	CSMatrix tmp;
+	CSMatrix const & C = as_csc(A, tmp);
+	if (not analyzed_ or not samePattern(C))
+		analyze(C);
+
+	size_t n = n_, j, k, s, r, t, top, ipiv;
+	std::ptrdiff_t head;
+	double amax, pivot;
+	size_t const * Cp = C.ptr();
+	size_t const * Ci = C.idx();
+	double const * Cx = C.val();
+	std::vector< double > x(n, 0.);
+	std::vector< size_t > xi(n), stk(n), pos(n), flag(n, SLU_NONE);
+	std::vector< std::pair< size_t,double > > ucol;
+
+	factored_ = false;
+	p_.assign(n, SLU_NONE);
+	pinv_.assign(n, SLU_NONE);
+	Lp_.assign(1, 0); Li_.clear(); Lx_.clear();
+	Up_.assign(1, 0); Ui_.clear(); Ux_.clear();
+	Ud_.assign(n, 0.);
+	Li_.reserve(C.nnz()); Lx_.reserve(C.nnz());
+	Ui_.reserve(C.nnz()); Ux_.reserve(C.nnz());
+
+	for (k=0; k<n; k++)
+	{
+		j = q_[k];
+
+		// Muster von L\A(:,j): Tiefensuche von den Zeilen von A(:,j)
+		// über die bereits pivotisierten Spalten von L; xi[top..n-1]
+		// enthält das Ergebnis in topologischer Ordnung
+		top = n;
+		for (t=Cp[j]; t<Cp[j+1]; t++)
+		{
+			if (flag[Ci[t]] == k)
+				continue;
+			head = 0;
+			stk[0] = Ci[t];
+			while (head >= 0)
+			{
+				r = stk[head];
+				s = pinv_[r];
+				if (flag[r] != k)
+				{
+					flag[r] = k;
+					pos[head] = (s == SLU_NONE) ? 0 : Lp_[s];
+				}
+				bool done = true;
+				if (s != SLU_NONE)
+					for (size_t q=pos[head]; q<Lp_[s+1]; q++)
+					{
+						if (flag[Li_[q]] == k)
+							continue;
+						pos[head] = q+1;
+						stk[++head] = Li_[q];
+						done = false;
+						break;
+					}
+				if (done)
+				{
+					head--;
+					xi[--top] = r;
+				}
+			}
+		}
+
+		// numerisch: x = L\A(:,j)
+		for (t=Cp[j]; t<Cp[j+1]; t++)
+			x[Ci[t]] = Cx[t];
+		for (t=top; t<n; t++)
+		{
+			r = xi[t];
+			s = pinv_[r];
+			if (s == SLU_NONE)
+				continue;
+			double xr = x[r];
+			for (size_t q=Lp_[s]; q<Lp_[s+1]; q++)
+				x[Li_[q]] -= Lx_[q] * xr;
+		}
+
+		// U(:,k) und Pivotsuche unter den nicht pivotisierten Zeilen
+		ucol.clear();
+		amax = 0.;
+		ipiv = SLU_NONE;
+		for (t=top; t<n; t++)
+		{
+			r = xi[t];
+			s = pinv_[r];
+			if (s != SLU_NONE)
+				ucol.push_back(std::make_pair(s, x[r]));
+			else if (ipiv == SLU_NONE or ::fabs(x[r]) > amax)
+			{
+				amax = ::fabs(x[r]);
+				ipiv = r;
+			}
+		}
+		if (ipiv == SLU_NONE or amax == 0. or not std::isfinite(amax))
+		{
+			// (strukturell oder numerisch) singulär
+			for (t=top; t<n; t++)
+				x[xi[t]] = 0.;
+			return false;
+		}
+		// Diagonale bevorzugen, falls ausreichend groß
+		if (pinv_[j] == SLU_NONE and flag[j] == k
+			and ::fabs(x[j]) >= pivtol_ * amax)
+			ipiv = j;
+
+		pivot = x[ipiv];
+		Ud_[k] = pivot;
+		p_[k] = ipiv;
+		pinv_[ipiv] = k;
+
+		// U-Spalte mit aufsteigenden Schrittindizes (topologische Ordnung
+		// für refactor)
+		std::sort(ucol.begin(), ucol.end());
+		for (t=0; t<ucol.size(); t++)
+		{
+			Ui_.push_back(ucol[t].first);
+			Ux_.push_back(ucol[t].second);
+		}
+		Up_.push_back(Ui_.size());
+
+		for (t=top; t<n; t++)
+		{
+			r = xi[t];
+			if (pinv_[r] == SLU_NONE)
+			{
+				Li_.push_back(r);
+				Lx_.push_back(x[r] / pivot);
+			}
+			x[r] = 0.;
+		}
+		Lp_.push_back(Li_.size());
+	}
+	factored_ = true;
+	return true;
+}
+
+bool SparseLU::refactor(CSMatrix const & A)
+{
+	CSMatrix tmp;
+	CSMatrix const & C = as_csc(A, tmp);
+	if (not factored_ or not samePattern(C))
+		return false;
+
+	size_t n = n_, j, k, s, r, t, q;
+	double amax, d, xr;
+	size_t const * Cp = C.ptr();
+	size_t const * Ci = C.idx();
+	double const * Cx = C.val();
+	std::vector< double > x(n, 0.);
+
+	for (k=0; k<n; k++)
+	{
+		j = q_[k];
+		for (t=Cp[j]; t<Cp[j+1]; t++)
+			x[Ci[t]] = Cx[t];
+
+		// Muster von U(:,k) ist bekannt und aufsteigend sortiert
+		for (t=Up_[k]; t<Up_[k+1]; t++)
+		{
+			s = Ui_[t];
+			r = p_[s];
+			xr = x[r];
+			x[r] = 0.;
+			Ux_[t] = xr;
+			for (q=Lp_[s]; q<Lp_[s+1]; q++)
+				x[Li_[q]] -= Lx_[q] * xr;
+		}
+
+		d = x[p_[k]];
+		x[p_[k]] = 0.;
+		amax = ::fabs(d);
+		for (q=Lp_[k]; q<Lp_[k+1]; q++)
+			amax = std::max(amax, ::fabs(x[Li_[q]]));
+		if (d == 0. or not std::isfinite(amax) or ::fabs(d) < pivtol_ * amax)
+		{
+			// Pivotfolge hier nicht mehr stabil
+			for (q=Lp_[k]; q<Lp_[k+1]; q++)
+				x[Li_[q]] = 0.;
+			factored_ = false;
+			return false;
+		}
+
+		Ud_[k] = d;
+		for (q=Lp_[k]; q<Lp_[k+1]; q++)
+		{
+			Lx_[q] = x[Li_[q]] / d;
+			x[Li_[q]] = 0.;
+		}
+	}
+	return true;
+}
+
+bool SparseLU::update(CSMatrix const & A)
+{
+	CSMatrix tmp;
+	CSMatrix const & C = as_csc(A, tmp);
+	if (refactor(C))
+		return true;
+	return factor(C);
+}
+
+void SparseLU::solve(double * b, std::vector< double > & z) const
+{
+	size_t k, q, n = n_;
+	double zk;
+
+	// L*y = P*b; b ist nach Zeilen von A indiziert
+	for (k=0; k<n; k++)
+	{
+		zk = b[p_[k]];
+		for (q=Lp_[k]; q<Lp_[k+1]; q++)
+			b[Li_[q]] -= Lx_[q] * zk;
+		z[k] = zk;
+	}
+	// U*w = y
+	for (k=n; k>0; k--)
+	{
+		zk = (z[k-1] /= Ud_[k-1]);
+		for (q=Up_[k-1]; q<Up_[k]; q++)
+			z[Ui_[q]] -= Ux_[q] * zk;
+	}
+	// x = Q*w
+	for (k=0; k<n; k++)
+		b[q_[k]] = z[k];
+}
+
+void SparseLU::solve(MVector & b) const
+{
+	fASSERT(factored_ and b.dim() == n_);
+	std::vector< double > z(n_);
+	solve((double*)b, z);
+}
+
+void SparseLU::solve(MMatrix & B) const
+{
+	fASSERT(factored_ and B.rows() == n_);
+	std::vector< double > z(n_);
+	double * Bv = B;
+	for (size_t j=0; j<B.cols(); j++)
+		solve(Bv + j*n_, z);
+}
+
+void SparseLU::solveTrans(MVector & b) const
+{
+	fASSERT(factored_ and b.dim() == n_);
+	size_t k, q, n = n_;
+	double * bv = b;
+	double zk;
+	std::vector< double > z(n);
+
+	// (P*A*Q)^T = U^T*L^T; U^T*w = Q^T*b
+	for (k=0; k<n; k++)
+	{
+		zk = bv[q_[k]];
+		for (q=Up_[k]; q<Up_[k+1]; q++)
+			zk -= Ux_[q] * z[Ui_[q]];
+		z[k] = zk / Ud_[k];
+	}
+	// L^T*v = w; Zeilen von L sind Zeilen von A
+	for (k=n; k>0; k--)
+	{
+		zk = z[k-1];
+		for (q=Lp_[k-1]; q<Lp_[k]; q++)
+			zk -= Lx_[q] * bv[Li_[q]];
+		bv[p_[k-1]] = zk;
+	}
+}
+
+} // namespace flux::la
+} // namespace flux
+
@@ -0,0 +1,192 @@
+#ifndef SPARSELU_H
+#define SPARSELU_H
+
+#include <cstddef>
+#include <vector>
+#include "CSMatrix.h"
+
+namespace flux {
+namespace la {
+
+class MVector;
+class MMatrix;
+
+/**
+ * Klasse SparseLU -- LU-Zerlegung dünn besetzter, quadratischer Matrizen
+ * (left-looking, Gilbert/Peierls) mit füllreduzierender Spaltenordnung.
+ *
+ * Zerlegt wird P*A*Q = L*U mit Spaltenpermutation Q (AMD auf dem Muster
+ * von A+A^T bzw. COLAMD-artig auf dem Muster von A^T*A) und
+ * Zeilenpermutation P aus einer Schwellwert-Pivotsuche, die das
+ * Diagonalelement bevorzugt.
+ *
+ * Die Berechnung ist in drei Stufen getrennt, damit Matrizen mit gleichem
+ * Muster, aber neuen Werten (z.B. neue Flusswerte), billig neu zerlegt
+ * werden können:
+ *  - analyze():  Spaltenordnung (symbolisch, nur vom Muster abhängig)
+ *  - factor():   numerische Zerlegung mit Pivotsuche
+ *  - refactor(): numerische Zerlegung mit Pivotfolge und Muster von L, U
+ *                aus dem letzten factor()
+ * update() kombiniert die Stufen: refactor(), falls möglich und stabil,
+ * sonst factor().
+ */
+class SparseLU
+{
+public:
+	/** Füllreduzierende Spaltenordnung */
+	enum Ordering {
+		ord_natural,	// keine Umordnung
+		ord_amd,	// minimaler Grad auf A+A^T (symmetrisches Muster)
+		ord_colamd	// minimaler Grad auf A^T*A (unsymmetrisches Muster)
+	};
+
+private:
+	/** Spaltenordnung */
+	Ordering ordering_;
+	/** Schwellwert der Pivotsuche (0: Diagonale immer, 1: partielles Pivoting) */
+	double pivtol_;
+	/** Dimension */
+	size_t n_;
+	/** Muster (CSC) der analysierten Matrix */
+	std::vector< size_t > Ap_, Ai_;
+	/** Spaltenpermutation: Schritt k eliminiert Spalte q_[k] */
+	std::vector< size_t > q_;
+	/** Zeilenpermutation: Schritt k pivotisiert Zeile p_[k] */
+	std::vector< size_t > p_;
+	/** Inverse Zeilenpermutation */
+	std::vector< size_t > pinv_;
+	/** L (CSC, Einheitsdiagonale nicht gespeichert, Zeilen von A) */
+	std::vector< size_t > Lp_, Li_;
+	std::vector< double > Lx_;
+	/** U (CSC, Diagonale in Ud_, Zeilen als Schrittindex aufsteigend) */
+	std::vector< size_t > Up_, Ui_;
+	std::vector< double > Ux_, Ud_;
+	/** Flag: Spaltenordnung berechnet */
+	bool analyzed_;
+	/** Flag: numerische Zerlegung vorhanden */
+	bool factored_;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param ordering füllreduzierende Spaltenordnung
+	 * @param pivtol Schwellwert der Pivotsuche; das Diagonalelement wird
+	 *	verwendet, falls |a_jj| >= pivtol * max_i |a_ij|
+	 */
+	SparseLU(Ordering ordering = ord_colamd, double pivtol = 0.1);
+
+	/**
+	 * Symbolische Analyse: berechnet die Spaltenordnung für das Muster
+	 * von A. Die Werte von A werden nicht verwendet.
+	 *
+	 * @param A quadratische Matrix
+	 */
+	void analyze(CSMatrix const & A);
+
+	/**
+	 * Numerische Zerlegung mit Pivotsuche. Falls das Muster von A nicht
+	 * dem der letzten Analyse entspricht, wird analyze() aufgerufen.
+	 *
+	 * @param A quadratische Matrix
+	 * @return true, falls A regulär
+	 */
+	bool factor(CSMatrix const & A);
+
+	/**
+	 * Numerische Zerlegung unter Wiederverwendung von Pivotfolge und
+	 * Muster von L und U aus dem letzten factor(). Schlägt fehl, falls
+	 * das Muster von A abweicht oder ein Pivotelement den Schwellwert
+	 * verletzt; die Zerlegung ist dann ungültig.
+	 *
+	 * @param A quadratische Matrix mit unverändertem Muster
+	 * @return true bei Erfolg
+	 */
+	bool refactor(CSMatrix const & A);
+
+	/**
+	 * Zerlegung einer Matrix, deren Muster sich i.d.R. nicht ändert:
+	 * versucht refactor() und fällt auf factor() zurück.
+	 *
+	 * @param A quadratische Matrix
+	 * @return true, falls A regulär
+	 */
+	bool update(CSMatrix const & A);
+
+	/**
+	 * Löst A*x = b.
+	 *
+	 * @param b rechte Seite; wird mit der Lösung überschrieben
+	 */
+	void solve(MVector & b) const;
+
+	/**
+	 * Löst A*X = B.
+	 *
+	 * @param B rechte Seiten; werden mit der Lösung überschrieben
+	 */
+	void solve(MMatrix & B) const;
+
+	/**
+	 * Löst A^T*x = b.
+	 *
+	 * @param b rechte Seite; wird mit der Lösung überschrieben
+	 */
+	void solveTrans(MVector & b) const;
+
+	/** @return Dimension */
+	inline size_t dim() const { return n_; }
+
+	/** @return true, falls die Spaltenordnung berechnet ist */
+	inline bool isAnalyzed() const { return analyzed_; }
+
+	/** @return true, falls eine gültige Zerlegung vorhanden ist */
+	inline bool isFactored() const { return factored_; }
+
+	/** @return Anzahl der Elemente von L (ohne Diagonale) */
+	inline size_t nnzL() const { return Li_.size(); }
+
+	/** @return Anzahl der Elemente von U (mit Diagonale) */
+	inline size_t nnzU() const { return Ui_.size() + Ud_.size(); }
+
+	/** @return Spaltenpermutation (Schritt k -> Spalte) */
+	inline std::vector< size_t > const & getColPerm() const { return q_; }
+
+	/** @return Zeilenpermutation (Schritt k -> Zeile) */
+	inline std::vector< size_t > const & getRowPerm() const { return p_; }
+
+	/**
+	 * Minimum-Degree-Ordnung auf dem Muster von A+A^T.
+	 *
+	 * @param A quadratische Matrix
+	 * @param q Ordnung (Ausgabe)
+	 */
+	static void orderAMD(CSMatrix const & A, std::vector< size_t > & q);
+
+	/**
+	 * Minimum-Degree-Ordnung der Spalten auf dem Muster von A^T*A,
+	 * ohne A^T*A zu bilden (Zeilen von A als Anfangselemente).
+	 *
+	 * @param A Matrix
+	 * @param q Ordnung der Spalten (Ausgabe)
+	 */
+	static void orderCOLAMD(CSMatrix const & A, std::vector< size_t > & q);
+
+private:
+	/**
+	 * Vergleicht das Muster von A (CSC) mit dem analysierten Muster.
+	 */
+	bool samePattern(CSMatrix const & A) const;
+
+	/**
+	 * Vorwärts-/Rückwärtseinsetzen für eine rechte Seite.
+	 */
+	void solve(double * b, std::vector< double > & z) const;
+
+}; // class SparseLU
+
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
@@ -2,6 +2,7 @@
 #include "charptr_array.h"
 #include "StandardForm.h"
 #include "MMatrix.h"
+#include "BoundedSimplex.h"
 #include "LinearExpression.h"
 #include <sstream>
 
@@ -216,6 +217,7 @@ void StandardForm::build() const
 	}
 
 	A_ = A;
+	Acsr_ = CSMatrix(A_);
 	b_ = b;
 
 	dirty_ = false;
@@ -352,11 +354,15 @@ bool StandardForm::isFeasible(double const * x, double tol, bool verbose) const
 			return false;
 		}
 
+	// Zeilen von A in CSR-Form (aufsteigende Spalten wie zuvor)
+	size_t const * ptr = Acsr_.ptr();
+	size_t const * idx = Acsr_.idx();
+	double const * val = Acsr_.val();
 	for (i=0; i<A_.rows(); i++)
 	{
 		s = 0.;
-		for (j=0; j<A_.cols(); j++)
-			s += A_.get(i,j) * x[j];
+		for (size_t k=ptr[i]; k<ptr[i+1]; k++)
+			s += val[k] * x[idx[k]];
 		if (s - tol > b_.get(i))
 		{
 			if (verbose)
@@ -401,14 +407,113 @@ bool StandardForm::isFeasible(double const * x, double tol, bool verbose) const
 }
 
 bool StandardForm::isFeasible() const
+{
+	MVector x;
+	double radius;
+	return findInteriorPoint(x,radius);
+}
+
+void StandardForm::getBounds(MVector & lo, MVector & up) const
+{
+	build();
+	double const inf = std::numeric_limits< double >::infinity();
+	charptr_map< double >::const_iterator bnd;
+
+	lo = MVector(A_.cols(),-inf);
+	up = MVector(A_.cols(),inf);
+	for (bnd=lvbound_.begin(); bnd!=lvbound_.end(); bnd++)
+		lo(*(var_indices_.findPtr(bnd->key))) = bnd->value;
+	for (bnd=uvbound_.begin(); bnd!=uvbound_.end(); bnd++)
+		up(*(var_indices_.findPtr(bnd->key))) = bnd->value;
+}
+
+bool StandardForm::findInteriorPoint(MVector & x, double & radius) const
 {
 	build();
-//	LPProblem LPP;
-//	LPP.importConstraints(*this);
-//	LPP.maximize(getVars()[0]);
-//	LPSolver LPS(LPP);
-//	return LPS.solve() != LPSolver::lps_infeasible;
-	//XXX how should we check this
+	size_t i,j,k,nb;
+	size_t n = A_.cols(), m = A_.rows();
+	double const inf = std::numeric_limits< double >::infinity();
+	MVector lo, up;
+
+	getBounds(lo,up);
+	x = MVector(n);
+
+	// Anzahl der endlichen Schranken
+	for (nb=0,j=0; j<n; j++)
+		nb += (std::isinf(lo(j)) ? 0 : 1) + (std::isinf(up(j)) ? 0 : 1);
+
+	// das LP wird dicht gelöst; zu große Systeme bleiben unentschieden
+	if (not BoundedSimplex::fitsTableau(m+nb,n+1))
+	{
+		fWARNING("LP feasibility check: system too large for dense "
+			"simplex (%lu rows, %lu variables)",
+			(unsigned long)(m+nb), (unsigned long)(n+1));
+		radius = std::numeric_limits< double >::quiet_NaN();
+		return false;
+	}
+
+	// Variablen (x,r); Zeilen: Ungleichungen, dann Schranken
+	MMatrix L(m+nb,n+1);
+	MVector lb(m+nb);
+	MVector llo(n+1,-inf), lup(n+1,inf);
+	MVector c(n+1);
+
+	SMatrix::const_iterator a_ij;
+	for (a_ij=A_.begin(); a_ij!=A_.end(); a_ij++)
+		L(a_ij->row,a_ij->col) = a_ij->value;
+	for (i=0; i<m; i++)
+	{
+		double nrm = 0.;
+		for (j=0; j<n; j++)
+			nrm += L(i,j) * L(i,j);
+		L(i,n) = sqrt(nrm);
+		lb(i) = b_.get(i);
+	}
+	for (k=m,j=0; j<n; j++)
+	{
+		// -x_j + r <= -lo_j
+		if (not std::isinf(lo(j)))
+		{
+			L(k,j) = -1.;
+			L(k,n) = 1.;
+			lb(k++) = -lo(j);
+		}
+		// x_j + r <= up_j
+		if (not std::isinf(up(j)))
+		{
+			L(k,j) = 1.;
+			L(k,n) = 1.;
+			lb(k++) = up(j);
+		}
+	}
+	lup(n) = 1.;
+	c(n) = 1.;
+
+	BoundedSimplex LP(L,lb,llo,lup);
+	switch (LP.maximize(c))
+	{
+	case BoundedSimplex::lp_optimal:
+		break;
+	case BoundedSimplex::lp_iterlimit:
+		fWARNING("LP feasibility check did not converge");
+		radius = std::numeric_limits< double >::quiet_NaN();
+		return false;
+	default:
+		// da r nach unten unbeschränkt ist, ist das LP immer lösbar
+		fASSERT_NONREACHABLE();
+		radius = -inf;
+		return false;
+	}
+
+	for (j=0; j<n; j++)
+		x(j) = LP.getValue(j);
+	radius = LP.getValue(n);
+	if (radius < -1e-9)
+		return false;
+
+	// Kontrolle mit der Test-Funktion für Punkte
+	if (not isFeasible(x, 1e-7))
+		fWARNING("LP feasibility check: computed point violates constraints");
 	return true;
 }
 
@@ -764,14 +869,15 @@ bool StandardFormPenalty::intersectConstraint(
 	// lege Gerade durch P1 und P2 und bestimme das Schnittverhältnis u
 	//
 	// in 3d: u = (Ax1+By1+Cz1+D)/(A(x1-x2)+B(y1-y2)+C(z1-z2))
-	size_t j;
-	SMatrix const & A = SF_.getLHS();
+	size_t j, k;
+	CSMatrix const & A = SF_.getLHSCompressed();
 	MVector const & b = SF_.getRHS();
 	double N = -b.get(i), D = 0., u;
-	for (j=0; j<A.cols(); j++)
+	for (k=A.ptr()[i]; k<A.ptr()[i+1]; k++)
 	{
-		N += A.get(i,j)*P1.get(j);
-		D += A.get(i,j)*(P1.get(j)-P2.get(j));
+		j = A.idx()[k];
+		N += A.val()[k]*P1.get(j);
+		D += A.val()[k]*(P1.get(j)-P2.get(j));
 	}
 	// Schnittverhältnis u (Mischungsverhältnis von P1 und P2)
 	// es sind nur Schnittpunkt zwischen P1 und P2 gesucht
@@ -5,6 +5,7 @@
 #include "charptr_array.h"
 #include "charptr_map.h"
 #include "SMatrix.h"
+#include "CSMatrix.h"
 #include "MVector.h"
 #include "ExprTree.h"
 
@@ -34,6 +35,8 @@ protected:
 	charptr_map< double > uvbound_;
 	/** Constraint-Matrix A */
 	mutable SMatrix A_;
+	/** Constraint-Matrix A in CSR-Form (wird mit A_ aufgebaut) */
+	mutable CSMatrix Acsr_;
 	/** Rechte Seite des Constraint-Systems */
 	mutable MVector b_;
 	/** Muss build() aufgerufen werden? */
@@ -181,6 +184,17 @@ public:
 	 */
 	inline SMatrix const & getLHS() const { return A_; }
 
+	/**
+	 * Gibt die linke Seite des Constraint-Systems in CSR-Form zurück.
+	 *
+	 * @return Matrix A (CSR)
+	 */
+	inline CSMatrix const & getLHSCompressed() const
+	{
+		if (dirty_) build();
+		return Acsr_;
+	}
+
 	/**
 	 * Gibt die rechte Seite des Constraint-Systems zurück.
 	 *
@@ -214,12 +228,40 @@ public:
 
 	/**
 	 * Gibt true zurück, falls das System von Ungleichungen feasible ist,
-	 * d.h. die beschriebene Region nicht leer ist.
+	 * d.h. die beschriebene Region nicht leer ist. Kann dies nicht
+	 * entschieden werden (siehe findInteriorPoint), wird false
+	 * zurückgegeben.
 	 *
 	 * @return true, falls das System von Ungleichungen feasible ist
 	 */
 	bool isFeasible() const;
 
+	/**
+	 * Sucht per LP einen Punkt x, der alle Ungleichungen und Schranken
+	 * mit möglichst großem (euklidischen) Abstand r erfüllt:
+	 * max r u.d.N. A_i*x + ||A_i||*r <= b_i, lo+r <= x <= up-r, r <= 1.
+	 * Ist r > 0, so liegt x strikt im Inneren der Region; ist r = 0, so
+	 * ist die Region nicht leer, hat aber kein Inneres (z.B. durch
+	 * Gleichungen); ist r < 0, so ist die Region leer. Konvergiert das
+	 * LP nicht oder ist das System zu groß für das dichte Tableau
+	 * (BoundedSimplex::fitsTableau), so ist r NaN und die Frage bleibt
+	 * unentschieden.
+	 *
+	 * @param x gefundener Punkt (out)
+	 * @param radius Abstand r von x zum Rand der Region (out)
+	 * @return true, falls die Region nachweislich nicht leer ist
+	 */
+	bool findInteriorPoint(MVector & x, double & radius) const;
+
+	/**
+	 * Gibt die Variablenschranken als Vektoren zurück (in der
+	 * Reihenfolge der Spalten). Fehlende Schranken sind -inf bzw. +inf.
+	 *
+	 * @param lo untere Schranken (out)
+	 * @param up obere Schranken (out)
+	 */
+	void getBounds(MVector & lo, MVector & up) const;
+
 	/**
 	 * Distanz-Funktion.
 	 * Mißt den minimalen Abstand D des Punktes x0 zur Hyperfläche, die
@@ -0,0 +1,137 @@
+#ifndef STEMFUNCTION__H
+#define STEMFUNCTION__H
+
+#include <cmath>
+
+namespace flux {
+namespace la {
+namespace stem {
+
+/**
+ * Stammfunktionen für Matrixfunktionen: f(x) und ihre n-te Ableitung
+ * (n >= 0) für skalare Argumente.
+ */
+
+/**
+ * n-te Ableitung der Exponentialfunktion.
+ *
+ * @param x Argument
+ * @param n Ordnung der Ableitung
+ * @return exp^(n)(x)
+ */
+inline double exp(double x, int n)
+{
+	(void)n;
+	return ::exp(x);
+}
+
+/**
+ * n-te Ableitung von cos.
+ *
+ * @param x Argument
+ * @param n Ordnung der Ableitung
+ * @return cos^(n)(x)
+ */
+inline double cos(double x, int n)
+{
+	switch (n % 4)
+	{
+	case 0: return ::cos(x);
+	case 1: return -::sin(x);
+	case 2: return -::cos(x);
+	default: return ::sin(x);
+	}
+}
+
+/**
+ * n-te Ableitung von sin.
+ *
+ * @param x Argument
+ * @param n Ordnung der Ableitung
+ * @return sin^(n)(x)
+ */
+inline double sin(double x, int n)
+{
+	switch (n % 4)
+	{
+	case 0: return ::sin(x);
+	case 1: return ::cos(x);
+	case 2: return -::sin(x);
+	default: return -::cos(x);
+	}
+}
+
+/**
+ * n-te Ableitung von cosh.
+ *
+ * @param x Argument
+ * @param n Ordnung der Ableitung
+ * @return cosh^(n)(x)
+ */
+inline double cosh(double x, int n)
+{
+	return (n % 2) ? ::sinh(x) : ::cosh(x);
+}
+
+/**
+ * n-te Ableitung von sinh.
+ *
+ * @param x Argument
+ * @param n Ordnung der Ableitung
+ * @return sinh^(n)(x)
+ */
+inline double sinh(double x, int n)
+{
+	return (n % 2) ? ::cosh(x) : ::sinh(x);
+}
+
+/**
+ * phi-Funktionen der exponentiellen Integratoren:
+ * phi_0(x) = exp(x), phi_{k+1}(x) = (phi_k(x) - 1/k!) / x,
+ * d.h. phi_k(x) = sum_{j>=0} x^j/(j+k)!. Mit phi_1 ist die Lösung von
+ * y' = a*y + b (konstantes b) y(t) = exp(t*a)*y(0) + t*phi_1(t*a)*b.
+ * Für kleine |x| wird die Reihe summiert (die Rekursion löscht aus).
+ *
+ * @param x Argument
+ * @param k Index (k >= 0)
+ * @return phi_k(x)
+ */
+inline double phi(double x, int k)
+{
+	int j;
+	double f, t;
+
+	if (k == 0)
+		return ::exp(x);
+
+	if (::fabs(x) < 1.)
+	{
+		// Reihe: t_j = x^j/(j+k)!
+		for (t=1.,j=1; j<=k; j++)
+			t /= j;
+		for (f=t,j=1; j<64 and ::fabs(t) > 1e-17 * ::fabs(f); j++)
+		{
+			t *= x / (j+k);
+			f += t;
+		}
+		return f;
+	}
+
+	// Rekursion; für |x| >= 1 und kleine k ausreichend genau
+	double fact = 1.;
+	f = ::exp(x);
+	for (j=0; j<k; j++)
+	{
+		if (j > 0)
+			fact *= j;
+		f = (f - 1./fact) / x;
+	}
+	return f;
+}
+
+} // namespace flux::la::stem
+} // namespace flux::la
+} // namespace flux
+
+#endif
+
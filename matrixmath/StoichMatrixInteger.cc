@@ -1,6 +1,7 @@
 #include <list>
 #include <cstring>
 #include <cstdio>
+#include <cmath>
 #include "cstringtools.h"
 #include "Combinations.h"
 #include "GVector.h"
@@ -75,6 +76,96 @@ StoichMatrixInteger::operator MMatrix () const
 	return N;
 }
 
+void StoichMatrixInteger::compress() const
+{
+	size_t i,j,k,nz;
+
+	if (csr_valid_)
+		return;
+
+	// Nicht-Null-Elemente zählen
+	for (nz=0,k=0; k<rows_*cols_; k++)
+		if (matrix_storage_[k] != 0)
+			nz++;
+
+	GVector< size_t > ptr(rows_+1), idx(nz);
+	MVector val(nz);
+
+	for (k=0,i=0; i<rows_; i++)
+	{
+		ptr(i) = k;
+		for (j=0; j<cols_; j++)
+		{
+			int64_t s = matrix_storage_[j*rows_+i];
+			if (s == 0)
+				continue;
+			idx(k) = j;
+			val(k) = double(s);
+			k++;
+		}
+	}
+	ptr(rows_) = k;
+	csr_ = CSMatrix(rows_, cols_, CSMatrix::csr,
+		std::move(ptr), std::move(idx), std::move(val));
+	csr_valid_ = true;
+}
+
+void StoichMatrixInteger::spmv(double const * x, double * y) const
+{
+	size_t i,k;
+	compress();
+	size_t const * ptr = csr_.ptr();
+	size_t const * idx = csr_.idx();
+	double const * val = csr_.val();
+
+	for (i=0; i<rows_; i++)
+	{
+		double s = 0.;
+		for (k=ptr[i]; k<ptr[i+1]; k++)
+			s += val[k] * x[idx[k]];
+		y[i] = s;
+	}
+}
+
+void StoichMatrixInteger::spmvT(double const * y, double * x) const
+{
+	size_t i,j,k;
+	compress();
+	size_t const * ptr = csr_.ptr();
+	size_t const * idx = csr_.idx();
+	double const * val = csr_.val();
+
+	for (j=0; j<cols_; j++)
+		x[j] = 0.;
+	for (i=0; i<rows_; i++)
+	{
+		double yi = y[i];
+		if (yi == 0.)
+			continue;
+		for (k=ptr[i]; k<ptr[i+1]; k++)
+			x[idx[k]] += val[k] * yi;
+	}
+}
+
+double StoichMatrixInteger::residualNorm2(double const * x) const
+{
+	size_t i,k;
+	double r2 = 0.;
+	compress();
+	size_t const * ptr = csr_.ptr();
+	size_t const * idx = csr_.idx();
+	double const * val = csr_.val();
+
+	for (i=0; i<rows_; i++)
+	{
+		double s = 0.;
+		for (k=ptr[i]; k<ptr[i+1]; k++)
+			s += val[k] * x[idx[k]];
+		r2 += s*s;
+	}
+	return sqrt(r2);
+}
+
 } // namespace flux::la
 } // namespace flux
 
@@ -10,6 +10,7 @@ extern "C"
 #include "charptr_array.h"
 #include "GLabelMatrix.h"
 #include "PMatrix.h"
+#include "CSMatrix.h"
 
 namespace flux {
 namespace la {
@@ -18,6 +19,12 @@ class MMatrix;
 
 class StoichMatrixInteger : public GLabelMatrix< int64_t >
 {
+private:
+	/** CSR-Form der Matrix (zwischengespeichert) */
+	mutable CSMatrix csr_;
+	/** true, falls die CSR-Form aktuell ist */
+	mutable bool csr_valid_;
+
 public:
 	/**
 	 * Constructor.
@@ -31,7 +38,7 @@ public:
 		size_t nrows, size_t ncols,
 		char const ** metabolite_names,
 		char const ** reaction_names
-		) : GLabelMatrix< int64_t >(nrows,ncols,0)
+		) : GLabelMatrix< int64_t >(nrows,ncols,0), csr_valid_(false)
 	{
 		size_t k;
 		for (k=0; metabolite_names[k]!=0; ++k)
@@ -46,7 +53,130 @@ public:
 	 * Copy-Constructor
 	 */
 	inline StoichMatrixInteger(StoichMatrixInteger const & copy) :
-		GLabelMatrix< int64_t >(copy) { }
+		GLabelMatrix< int64_t >(copy), csr_valid_(false) { }
+
+	using GLabelMatrix< int64_t >::operator();
+
+	/**
+	 * Elementzugriff (Schreiben); verwirft die CSR-Form.
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @return Referenz auf das Objekt mit Index (i,j)
+	 */
+	inline int64_t & operator() (size_t i, size_t j)
+	{
+		csr_valid_ = false;
+		return GLabelMatrix< int64_t >::operator()(i,j);
+	}
+
+	/**
+	 * Elementzugriff (Schreiben); verwirft die CSR-Form.
+	 *
+	 * @param i Zeile
+	 * @param j Spalte
+	 * @param val Wert
+	 */
+	inline virtual void set(size_t i, size_t j, int64_t const & val)
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::set(i,j,val);
+	}
+
+	/**
+	 * Füllt die Matrix mit einem Wert; verwirft die CSR-Form.
+	 *
+	 * @param val Wert
+	 */
+	inline virtual void fill(int64_t const & val)
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::fill(val);
+	}
+
+	/**
+	 * Setzt eine Zeile; verwirft die CSR-Form.
+	 *
+	 * @param i Zeile
+	 * @param row Zeilenwerte
+	 */
+	inline virtual void setRow(size_t i, int64_t const * row)
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::setRow(i,row);
+	}
+
+	/**
+	 * Setzt eine Spalte; verwirft die CSR-Form.
+	 *
+	 * @param j Spalte
+	 * @param col Spaltenwerte
+	 */
+	inline virtual void setCol(size_t j, int64_t const * col)
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::setCol(j,col);
+	}
+
+	/**
+	 * Zeilenvertauschung; verwirft die CSR-Form.
+	 *
+	 * @param i1 erste Zeile
+	 * @param i2 zweite Zeile
+	 */
+	inline virtual void swapRows(size_t i1, size_t i2)
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::swapRows(i1,i2);
+	}
+
+	/**
+	 * Spaltenvertauschung; verwirft die CSR-Form.
+	 *
+	 * @param j1 erste Spalte
+	 * @param j2 zweite Spalte
+	 */
+	inline virtual void swapColumns(size_t j1, size_t j2)
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::swapColumns(j1,j2);
+	}
+
+	/**
+	 * Transposition; verwirft die CSR-Form.
+	 */
+	inline virtual void transpose()
+	{
+		csr_valid_ = false;
+		GLabelMatrix< int64_t >::transpose();
+	}
+
+	using GLabelMatrix< int64_t >::operator int64_t *;
+
+	/**
+	 * Roher Speicher in Fortran-Ordnung zum Schreiben; verwirft die
+	 * CSR-Form. Über ein const-Objekt darf nicht geschrieben werden.
+	 *
+	 * @return rohe Matrix in Fortran-Ordnung
+	 */
+	inline operator int64_t * ()
+	{
+		csr_valid_ = false;
+		return matrix_storage_;
+	}
+
+	using GLabelMatrix< int64_t >::view;
+
+	/**
+	 * Schreibbare Sicht auf die Matrix; verwirft die CSR-Form.
+	 *
+	 * @return schreibbare Sicht
+	 */
+	inline MatrixView< int64_t > view()
+	{
+		csr_valid_ = false;
+		return GLabelMatrix< int64_t >::view();
+	}
 
 public:
 	/**
@@ -125,6 +255,60 @@ public:
 	 */
 	operator MMatrix () const;
 
+	/**
+	 * Erstellt die (zwischengespeicherte) CSR-Form der Matrix, falls sie
+	 * nicht aktuell ist. Die CSR-Form wird von den SpMV-Kerneln bei Bedarf
+	 * automatisch erstellt; vor einem Zugriff aus mehreren Threads sollte
+	 * compress() einmal explizit aufgerufen werden.
+	 */
+	void compress() const;
+
+	/**
+	 * Gibt die Anzahl der Nicht-Null-Elemente zurück.
+	 *
+	 * @return Anzahl der Nicht-Null-Elemente
+	 */
+	inline size_t nnz() const
+	{
+		compress();
+		return csr_.nnz();
+	}
+
+	/**
+	 * Gibt die (zwischengespeicherte) CSR-Form der Matrix zurück.
+	 *
+	 * @return CSR-Form
+	 */
+	inline CSMatrix const & getCSR() const
+	{
+		compress();
+		return csr_;
+	}
+
+	/**
+	 * Sparse Matrix-Vektor-Produkt y = S*x.
+	 *
+	 * @param x Vektor der Länge cols() (in)
+	 * @param y Vektor der Länge rows() (out)
+	 */
+	void spmv(double const * x, double * y) const;
+
+	/**
+	 * Sparse Matrix-Vektor-Produkt mit der Transponierten x = S^T*y.
+	 *
+	 * @param y Vektor der Länge rows() (in)
+	 * @param x Vektor der Länge cols() (out)
+	 */
+	void spmvT(double const * y, double * x) const;
+
+	/**
+	 * Berechnet das Residuum ||S*x||_2 ohne temporären Vektor.
+	 *
+	 * @param x Vektor der Länge cols()
+	 * @return euklidische Norm von S*x
+	 */
+	double residualNorm2(double const * x) const;
+
 };
 
 } // namespace flux::la
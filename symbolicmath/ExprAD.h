@@ -0,0 +1,113 @@
+#ifndef EXPRAD_H
+#define EXPRAD_H
+
+#include <cmath>
+
+namespace flux {
+namespace symb {
+
+/**
+ * Duale Zahl v + d*eps (eps^2 = 0) für die Vorwärts-Differentiation
+ * (forward mode). Wird ein ExprProgram mit T = Dual ausgewertet und
+ * tragen die Slots ihre Richtungsableitungen in d, so liefert das
+ * Ergebnis in d die Richtungsableitung des Ausdrucks -- ohne Aufbau
+ * eines abgeleiteten Ausdrucksbaums. Den vollständigen Gradienten in
+ * einem Lauf liefert ExprProgram::gradient (reverse mode).
+ *
+ * Vergleiche beziehen sich nur auf den Wert; die Ableitung der
+ * Vergleichsoperatoren ist 0, die von abs/min/max die des aktiven
+ * Zweigs.
+ */
+template< typename T > struct Dual
+{
+	/** Wert */
+	T v;
+	/** Ableitung */
+	T d;
+
+	/** Constructor (Konstante) */
+	inline Dual(T value = T(0.)) : v(value), d(T(0.)) { }
+
+	/** Constructor */
+	inline Dual(T value, T deriv) : v(value), d(deriv) { }
+
+	inline Dual operator-() const { return Dual(-v,-d); }
+	inline Dual & operator+=(Dual const & b) { v += b.v; d += b.d; return *this; }
+	inline Dual & operator-=(Dual const & b) { v -= b.v; d -= b.d; return *this; }
+	inline Dual & operator*=(Dual const & b) { *this = *this * b; return *this; }
+	inline Dual & operator/=(Dual const & b) { *this = *this / b; return *this; }
+
+	friend inline Dual operator+(Dual const & a, Dual const & b)
+	{
+		return Dual(a.v+b.v, a.d+b.d);
+	}
+	friend inline Dual operator-(Dual const & a, Dual const & b)
+	{
+		return Dual(a.v-b.v, a.d-b.d);
+	}
+	friend inline Dual operator*(Dual const & a, Dual const & b)
+	{
+		return Dual(a.v*b.v, a.d*b.v + a.v*b.d);
+	}
+	friend inline Dual operator/(Dual const & a, Dual const & b)
+	{
+		T q = a.v/b.v;
+		return Dual(q, (a.d - q*b.d)/b.v);
+	}
+
+	friend inline bool operator==(Dual const & a, Dual const & b) { return a.v == b.v; }
+	friend inline bool operator!=(Dual const & a, Dual const & b) { return a.v != b.v; }
+	friend inline bool operator<=(Dual const & a, Dual const & b) { return a.v <= b.v; }
+	friend inline bool operator>=(Dual const & a, Dual const & b) { return a.v >= b.v; }
+	friend inline bool operator<(Dual const & a, Dual const & b) { return a.v < b.v; }
+	friend inline bool operator>(Dual const & a, Dual const & b) { return a.v > b.v; }
+
+	friend inline Dual pow(Dual const & a, Dual const & b)
+	{
+		using std::pow; using std::log;
+		T p = pow(a.v,b.v);
+		T d = a.d * b.v * pow(a.v,b.v-T(1.));
+		if (b.d != T(0.) and a.v > T(0.))
+			d += b.d * p * log(a.v);
+		return Dual(p, d);
+	}
+	friend inline Dual sqrt(Dual const & a)
+	{
+		using std::sqrt;
+		T s = sqrt(a.v);
+		return Dual(s, a.d/(T(2.)*s));
+	}
+	friend inline Dual log(Dual const & a)
+	{
+		using std::log;
+		return Dual(log(a.v), a.d/a.v);
+	}
+	friend inline Dual log10(Dual const & a)
+	{
+		using std::log; using std::log10;
+		return Dual(log10(a.v), a.d/(a.v*log(T(10.))));
+	}
+	friend inline Dual exp(Dual const & a)
+	{
+		using std::exp;
+		T e = exp(a.v);
+		return Dual(e, a.d*e);
+	}
+	friend inline Dual sin(Dual const & a)
+	{
+		using std::sin; using std::cos;
+		return Dual(sin(a.v), a.d*cos(a.v));
+	}
+	friend inline Dual cos(Dual const & a)
+	{
+		using std::sin; using std::cos;
+		return Dual(cos(a.v), -a.d*sin(a.v));
+	}
+
+}; // struct Dual
+
+} // namespace flux::symb
+} // namespace flux
+
+#endif
+
@@ -0,0 +1,301 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+extern "C"
+{
+#include <stdint.h>
+}
+#include "Error.h"
+#include "charptr_map.h"
+#include "fhash_map.h"
+#include "hash_functions.h"
+#include "ExprTree.h"
+#include "ExprParser.h"
+#include "ExprProgram.h"
+#include "ExprDAG.h"
+
+namespace flux {
+namespace symb {
+
+ExprDAG::ExprDAG()
+	: ops_(0)
+{
+}
+
+uint32_t ExprDAG::insert(mxkooo const & key, Node const & n)
+{
+	uint32_t * ip = table_.findPtr(key);
+	if (ip)
+		return *ip;
+	uint32_t i = nodes_.size();
+	nodes_.push_back(n);
+	table_.insert(key, i);
+	return i;
+}
+
+uint32_t ExprDAG::literal(double v)
+{
+	uint64_t bits;
+	::memcpy(&bits, &v, sizeof(bits));
+	Node n = { uint8_t(et_literal), NONE, NONE, v };
+	ops_ |= ExprProgram::opMask(et_literal);
+	return insert(mxkooo(et_literal, size_t(bits), size_t(bits >> 32)), n);
+}
+
+uint32_t ExprDAG::slot(ExprTree const * E)
+{
+	// diff-Knoten werden über ihre Textform identifiziert
+	std::string key = E->isVariable() ? E->getVarName() : E->toString();
+	uint32_t * vi = varidx_.findPtr(key.c_str());
+	if (vi == 0)
+	{
+		varidx_.insert(key.c_str(), uint32_t(vars_.size()));
+		vi = varidx_.findPtr(key.c_str());
+		// die Kopie eines diff-Knotens darf nicht in einer Arena liegen
+		ExprTree::Arena::Suspend suspend;
+		vars_.push_back(*E);
+	}
+	Node n = { uint8_t(et_variable), *vi, NONE, 0. };
+	ops_ |= ExprProgram::opMask(et_variable);
+	return insert(mxkooo(et_variable, *vi, 0), n);
+}
+
+uint32_t ExprDAG::variable(char const * name)
+{
+	ExprTree v(name);
+	return slot(&v);
+}
+
+uint32_t ExprDAG::op(ExprType et, uint32_t a, uint32_t b)
+{
+	fASSERT( a < nodes_.size() and (b == NONE or b < nodes_.size()) );
+	// kommutative Operatoren: Operanden in kanonischer Reihenfolge
+	if ((et == et_op_add or et == et_op_mul) and b < a)
+	{
+		uint32_t t = a; a = b; b = t;
+	}
+	Node n = { uint8_t(et), a, b, 0. };
+	ops_ |= ExprProgram::opMask(et);
+	return insert(mxkooo(et, a, b), n);
+}
+
+uint32_t ExprDAG::intern(
+	ExprTree const * E,
+	charptr_map< uint32_t > const * subst
+	)
+{
+	if (E->isLiteral())
+		return literal(E->getDoubleValue());
+	if (E->isVariable())
+	{
+		uint32_t * s = subst ? subst->findPtr(E->getVarName()) : 0;
+		return s ? *s : slot(E);
+	}
+	if (IS_OP_DIFF(E))
+		return slot(E);
+
+	uint32_t a = intern(E->Lval(), subst);
+	uint32_t b = E->Rval() ? intern(E->Rval(), subst) : NONE;
+	return op(E->getNodeType(), a, b);
+}
+
+size_t ExprDAG::add(ExprTree const * E, char const * name)
+{
+	size_t k = roots_.size();
+	roots_.push_back(intern(E, 0));
+	rootnames_.push_back(name ? name : "");
+	if (name and *name)
+		rootidx_[name] = k;
+	return k;
+}
+
+size_t ExprDAG::findRoot(char const * name) const
+{
+	size_t * kp = rootidx_.findPtr(name);
+	return kp ? *kp : roots_.size();
+}
+
+std::vector< uint32_t > ExprDAG::refCounts() const
+{
+	std::vector< uint32_t > refs(nodes_.size(), 0);
+	size_t i;
+	for (i=0; i<nodes_.size(); i++)
+	{
+		Node const & n = nodes_[i];
+		if (n.type == et_literal or n.type == et_variable)
+			continue;
+		refs[n.a]++;
+		if (n.b != NONE)
+			refs[n.b]++;
+	}
+	for (i=0; i<roots_.size(); i++)
+		refs[roots_[i]]++;
+	return refs;
+}
+
+double ExprDAG::treeSize() const
+{
+	// kann exponentiell in der Anzahl der Knoten wachsen -- daher double
+	std::vector< double > sz(nodes_.size());
+	double s = 0.;
+	size_t i;
+	for (i=0; i<nodes_.size(); i++)
+	{
+		Node const & n = nodes_[i];
+		if (n.type == et_literal or n.type == et_variable)
+			sz[i] = 1.;
+		else
+			sz[i] = 1. + sz[n.a] + (n.b != NONE ? sz[n.b] : 0.);
+	}
+	for (i=0; i<roots_.size(); i++)
+		s += sz[roots_[i]];
+	return s;
+}
+
+ExprTree * ExprDAG::toTree(uint32_t i) const
+{
+	return toTree(i, 0, true);
+}
+
+ExprTree * ExprDAG::toTree(
+	uint32_t i,
+	std::vector< uint32_t > const * refs,
+	bool top
+	) const
+{
+	Node const & n = nodes_[i];
+	if (n.type == et_literal)
+		return ExprTree::val(n.lit);
+	if (n.type == et_variable)
+		return ExprTree::clone(&vars_[n.a]);
+	if (refs and not top and (*refs)[i] > 1)
+		return ExprTree::sym("_t%lu", (unsigned long)i);
+
+	ExprTree * L = toTree(n.a, refs, false);
+	ExprTree * R = n.b != NONE ? toTree(n.b, refs, false) : 0;
+	return new ExprTree(ExprType(n.type), L, R);
+}
+
+void ExprDAG::evalRoots(charptr_map< double > const & values, double * y) const
+{
+	evalRoots([&](size_t i) {
+		char const * vn = varName(i);
+		double * v = vn ? values.findPtr(vn) : 0;
+		if (v == 0)
+		{
+			fWARNING("ExprDAG: no value for variable \"%s\"",
+				vars_[i].toString().c_str());
+			fTHROW(ExprTreeException);
+		}
+		return *v;
+	}, y);
+}
+
+std::string ExprDAG::serialize() const
+{
+	std::vector< uint32_t > refs = refCounts();
+	std::string s;
+	char buf[32];
+	size_t i, k;
+
+	// Hilfsvariablen in Postorder, d.h. vor ihrer ersten Verwendung
+	for (i=0; i<nodes_.size(); i++)
+	{
+		Node const & n = nodes_[i];
+		if (n.type == et_literal or n.type == et_variable or refs[i] < 2)
+			continue;
+		ExprTree * E = toTree(uint32_t(i), &refs, true);
+		snprintf(buf, sizeof(buf), "_t%lu = ", (unsigned long)i);
+		s += buf + E->toString() + ";\n";
+		delete E;
+	}
+	for (k=0; k<roots_.size(); k++)
+	{
+		if (rootnames_[k].empty())
+		{
+			snprintf(buf, sizeof(buf), "_r%lu", (unsigned long)k);
+			s += buf;
+		}
+		else
+			s += rootnames_[k];
+		ExprTree * E = toTree(roots_[k], &refs, false);
+		s += " = " + E->toString() + ";\n";
+		delete E;
+	}
+	return s;
+}
+
+bool ExprDAG::read(char const * text)
+{
+	charptr_map< uint32_t > temps;
+	std::string src(text);
+	size_t p = 0, e, q;
+
+	while ((e = src.find(';', p)) != std::string::npos)
+	{
+		std::string stmt = src.substr(p, e-p);
+		p = e+1;
+
+		// "name = Ausdruck": das erste '=' trennt die Bezeichnung ab
+		q = stmt.find('=');
+		if (q == std::string::npos)
+		{
+			if (stmt.find_first_not_of(" \t\r\n") != std::string::npos)
+				return false;
+			continue;
+		}
+		size_t l0 = stmt.find_first_not_of(" \t\r\n");
+		size_t l1 = stmt.find_last_not_of(" \t\r\n", q-1);
+		if (l0 >= q or l1 == std::string::npos or l1 < l0)
+			return false;
+		std::string lhs = stmt.substr(l0, l1-l0+1);
+
+		ExprTree * E = 0;
+		try
+		{
+			E = ExprTree::parse(stmt.c_str()+q+1);
+		}
+		catch (ExprParserException &)
+		{
+			return false;
+		}
+		if (E == 0)
+			return false;
+		uint32_t id = intern(E, &temps);
+		delete E;
+
+		if (lhs.compare(0, 2, "_t") == 0)
+			temps[lhs.c_str()] = id;
+		else
+		{
+			size_t k = roots_.size();
+			roots_.push_back(id);
+			if (lhs.compare(0, 2, "_r") == 0)
+				rootnames_.push_back("");
+			else
+			{
+				rootnames_.push_back(lhs);
+				rootidx_[lhs.c_str()] = k;
+			}
+		}
+	}
+	return src.find_first_not_of(" \t\r\n", p) == std::string::npos;
+}
+
+void ExprDAG::dump(FILE * outf) const
+{
+	std::vector< uint32_t > refs = refCounts();
+	size_t i, shared = 0;
+	for (i=0; i<nodes_.size(); i++)
+		if (refs[i] > 1 and nodes_[i].type != et_literal
+			and nodes_[i].type != et_variable)
+			shared++;
+	fprintf(outf, "ExprDAG: roots=%lu, nodes=%lu (as trees: %.0f), vars=%lu, shared=%lu\n",
+		(unsigned long)roots_.size(), (unsigned long)nodes_.size(),
+		treeSize(), (unsigned long)vars_.size(), (unsigned long)shared);
+}
+
+} // namespace flux::symb
+} // namespace flux
+
@@ -0,0 +1,381 @@
+#ifndef EXPRDAG_H
+#define EXPRDAG_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+extern "C"
+{
+#include <stdint.h>
+}
+#include "Error.h"
+#include "charptr_map.h"
+#include "fhash_map.h"
+#include "hash_functions.h"
+#include "ExprTree.h"
+#include "ExprProgram.h"
+
+namespace flux {
+namespace symb {
+
+/**
+ * Eine Menge von Ausdrücken als gerichteter azyklischer Graph mit
+ * gemeinsamen Teilausdrücken (hash-consing).
+ *
+ * Jeder Knoten wird über eine Interning-Tabelle mit dem Schlüssel
+ * (Knotentyp, Nachfolger-Knoten) bzw. (Literal-Bitmuster) bzw.
+ * (Variablen-Index) eindeutig abgelegt; strukturell gleiche Unterbäume
+ * werden dadurch nur einmal gespeichert. Die Operanden von + und *
+ * werden nach Knotennummer sortiert, so dass auch a+b und b+a
+ * zusammenfallen. Der rekursive hashValue() von ExprTree wird nicht
+ * benötigt: die Nachfolger eines Knotens sind bereits interniert, ein
+ * Knoten kostet daher O(1).
+ *
+ * Knoten werden in Postorder angelegt, die Nachfolger eines Knotens
+ * haben also stets kleinere Nummern. Die Auswertung aller Wurzeln
+ * erfolgt in einem Durchlauf über die Knoten; gemeinsame
+ * Teilausdrücke werden dabei nur einmal berechnet.
+ *
+ * Ableitungsknoten diff(X,v) werden (wie bei ExprProgram) als
+ * Variablen behandelt, die über ihre Textform identifiziert werden.
+ *
+ * Serialisierung (serialize/read): eine Anweisung "name = Ausdruck;"
+ * je Wurzel; mehrfach referenzierte Teilausdrücke werden zuvor an
+ * Hilfsvariablen "_t<k>" gebunden. Wurzeln ohne Namen heißen "_r<k>".
+ * Variablennamen der Form "_t<k>" sind daher reserviert. Literale
+ * werden wie bei ExprTree::toString() formatiert.
+ */
+class ExprDAG
+{
+public:
+	/** Ein Knoten des DAG */
+	struct Node
+	{
+		/** Knotentyp (ExprType) */
+		uint8_t type;
+		/** linker Nachfolger bzw. Variablen-Index */
+		uint32_t a;
+		/** rechter Nachfolger (NONE bei unären Operatoren) */
+		uint32_t b;
+		/** Literalwert */
+		double lit;
+	};
+
+	/** "kein Knoten" */
+	static constexpr uint32_t NONE = uint32_t(-1);
+
+private:
+	/** Knoten in Postorder */
+	std::vector< Node > nodes_;
+	/** Interning-Tabelle: (Typ, a, b) -> Knoten */
+	fhash_map< mxkooo,uint32_t,mxkooo_hashf > table_;
+	/** Variablen (Variablen- oder diff-Knoten) */
+	std::vector< ExprTree > vars_;
+	/** Variablenname bzw. Textform eines diff-Knotens -> Variablen-Index */
+	charptr_map< uint32_t > varidx_;
+	/** Wurzelknoten */
+	std::vector< uint32_t > roots_;
+	/** Bezeichnungen der Wurzeln ("" falls ohne Namen) */
+	std::vector< std::string > rootnames_;
+	/** Bezeichnung -> Index der Wurzel */
+	charptr_map< size_t > rootidx_;
+	/** im DAG vorkommende Knotentypen (Bit i: ExprType i) */
+	uint64_t ops_;
+
+public:
+	/**
+	 * Constructor. Erzeugt einen leeren DAG.
+	 */
+	ExprDAG();
+
+	/**
+	 * Interniert einen Ausdruck (ohne ihn als Wurzel einzutragen).
+	 *
+	 * @param E Ausdruck
+	 * @return Knoten des Ausdrucks
+	 */
+	inline uint32_t intern(ExprTree const * E) { return intern(E, 0); }
+
+	/**
+	 * Interniert einen Ausdruck und trägt ihn als Wurzel ein.
+	 *
+	 * @param E Ausdruck
+	 * @param name Bezeichnung der Wurzel (optional, eindeutig)
+	 * @return Index der Wurzel
+	 */
+	size_t add(ExprTree const * E, char const * name = 0);
+
+	/**
+	 * Interniert einen Literalknoten.
+	 *
+	 * @param v Literalwert
+	 * @return Knoten
+	 */
+	uint32_t literal(double v);
+
+	/**
+	 * Interniert einen Variablenknoten.
+	 *
+	 * @param name Variablenname
+	 * @return Knoten
+	 */
+	uint32_t variable(char const * name);
+
+	/**
+	 * Interniert einen Operatorknoten.
+	 *
+	 * @param et Operator
+	 * @param a linker Nachfolger
+	 * @param b rechter Nachfolger (NONE bei unären Operatoren)
+	 * @return Knoten
+	 */
+	uint32_t op(ExprType et, uint32_t a, uint32_t b = NONE);
+
+	/** @return Anzahl der Knoten */
+	inline size_t size() const { return nodes_.size(); }
+
+	/**
+	 * Zugriff auf einen Knoten.
+	 *
+	 * @param i Knoten
+	 * @return Knoten
+	 */
+	inline Node const & node(uint32_t i) const { return nodes_[i]; }
+
+	/** @return Anzahl der Wurzeln */
+	inline size_t roots() const { return roots_.size(); }
+
+	/**
+	 * Knoten einer Wurzel.
+	 *
+	 * @param k Index der Wurzel
+	 * @return Knoten
+	 */
+	inline uint32_t root(size_t k) const { return roots_[k]; }
+
+	/**
+	 * Bezeichnung einer Wurzel.
+	 *
+	 * @param k Index der Wurzel
+	 * @return Bezeichnung ("" falls ohne Namen)
+	 */
+	inline char const * rootName(size_t k) const { return rootnames_[k].c_str(); }
+
+	/**
+	 * Sucht eine Wurzel über ihre Bezeichnung.
+	 *
+	 * @param name Bezeichnung
+	 * @return Index der Wurzel oder roots(), falls nicht vorhanden
+	 */
+	size_t findRoot(char const * name) const;
+
+	/** @return Anzahl der Variablen */
+	inline size_t vars() const { return vars_.size(); }
+
+	/**
+	 * Name einer Variablen.
+	 *
+	 * @param i Variablen-Index
+	 * @return Variablenname oder 0 bei diff-Knoten
+	 */
+	inline char const * varName(size_t i) const
+	{
+		return vars_[i].isVariable() ? vars_[i].getVarName() : 0;
+	}
+
+	/**
+	 * Ausdruck einer Variablen (Variable oder diff-Knoten).
+	 *
+	 * @param i Variablen-Index
+	 * @return Ausdruck
+	 */
+	inline ExprTree const & varExpr(size_t i) const { return vars_[i]; }
+
+	/**
+	 * Prüft, ob der DAG nur erlaubte Knotentypen enthält.
+	 *
+	 * @param allowed Bitmaske gemäß ExprProgram::opMask
+	 * @return true, falls alle Knotentypen erlaubt sind
+	 */
+	inline bool usesOnly(uint64_t allowed) const
+	{
+		return (ops_ & ~(allowed
+			| ExprProgram::opMask(et_literal)
+			| ExprProgram::opMask(et_variable))) == 0;
+	}
+
+	/**
+	 * Anzahl der Referenzen je Knoten (durch andere Knoten und durch
+	 * Wurzeln).
+	 *
+	 * @return Referenzzähler je Knoten
+	 */
+	std::vector< uint32_t > refCounts() const;
+
+	/**
+	 * Größe aller Wurzeln als (nicht geteilte) Ausdrucksbäume.
+	 *
+	 * @return Gesamtzahl der Baumknoten
+	 */
+	double treeSize() const;
+
+	/**
+	 * Erzeugt den Ausdrucksbaum eines Knotens.
+	 *
+	 * @param i Knoten
+	 * @return neuer Ausdrucksbaum
+	 */
+	ExprTree * toTree(uint32_t i) const;
+
+	/**
+	 * Wertet alle Knoten aus; jeder Knoten wird genau einmal berechnet.
+	 *
+	 * @param load Funktor size_t -> T, liefert den Wert einer Variablen
+	 * @param work Werte je Knoten (Länge size(); out)
+	 */
+	template< typename T, typename Load > void eval(Load load, T * work) const
+	{
+		using std::pow; using std::sqrt; using std::log;
+		using std::log10; using std::exp; using std::sin; using std::cos;
+
+		for (size_t i=0; i<nodes_.size(); i++)
+		{
+			Node const & n = nodes_[i];
+			T & D = work[i];
+			if (n.type == et_literal)
+			{
+				D = T(n.lit);
+				continue;
+			}
+			if (n.type == et_variable)
+			{
+				D = load(size_t(n.a));
+				continue;
+			}
+			T const & L = work[n.a];
+			T const & R = work[n.b == NONE ? n.a : n.b];
+			switch (ExprType(n.type))
+			{
+			case et_op_add: D = L+R; break;
+			case et_op_sub: D = L-R; break;
+			case et_op_uminus: D = -L; break;
+			case et_op_mul: D = L*R; break;
+			case et_op_div: D = L/R; break;
+			case et_op_pow: D = pow(L,R); break;
+			case et_op_eq: D = T(L == R ? 1. : 0.); break;
+			case et_op_neq: D = T(L != R ? 1. : 0.); break;
+			case et_op_leq: D = T(L <= R ? 1. : 0.); break;
+			case et_op_geq: D = T(L >= R ? 1. : 0.); break;
+			case et_op_lt: D = T(L < R ? 1. : 0.); break;
+			case et_op_gt: D = T(L > R ? 1. : 0.); break;
+			case et_op_abs: D = L < T(0.) ? T(-L) : L; break;
+			case et_op_min: D = L <= R ? L : R; break;
+			case et_op_max: D = L >= R ? L : R; break;
+			case et_op_sqr: D = L*L; break;
+			case et_op_sqrt: D = sqrt(L); break;
+			case et_op_log: D = log(L); break;
+			case et_op_log2: D = log(L)/::log(2.); break;
+			case et_op_log10: D = log10(L); break;
+			case et_op_exp: D = exp(L); break;
+			case et_op_sin: D = sin(L); break;
+			case et_op_cos: D = cos(L); break;
+			default:
+				fASSERT_NONREACHABLE();
+			}
+		}
+	}
+
+	/**
+	 * Wertet alle Wurzeln aus.
+	 *
+	 * @param load Funktor size_t -> double, liefert den Wert einer Variablen
+	 * @param y Werte der Wurzeln (Länge roots(); out)
+	 */
+	template< typename Load > void evalRoots(Load load, double * y) const
+	{
+		std::vector< double > work(nodes_.size());
+		eval< double >(load, work.data());
+		for (size_t k=0; k<roots_.size(); k++)
+			y[k] = work[roots_[k]];
+	}
+
+	/**
+	 * Wertet alle Wurzeln aus.
+	 *
+	 * @param values Werte der Variablen
+	 * @param y Werte der Wurzeln (Länge roots(); out)
+	 */
+	void evalRoots(charptr_map< double > const & values, double * y) const;
+
+	/**
+	 * Serialisiert den DAG (Anweisungen "name = Ausdruck;", gemeinsame
+	 * Teilausdrücke als Hilfsvariablen "_t<k>").
+	 *
+	 * @return Textform
+	 */
+	std::string serialize() const;
+
+	/**
+	 * Liest Anweisungen in der Form von serialize() und fügt die
+	 * Wurzeln hinzu.
+	 *
+	 * @param text Textform
+	 * @return true bei Erfolg
+	 */
+	bool read(char const * text);
+
+	/**
+	 * Ausgabe einer Statistik (Knoten, Baumgröße, Wurzeln).
+	 *
+	 * @param outf Ausgabestrom
+	 */
+	void dump(FILE * outf = stdout) const;
+
+private:
+	/**
+	 * Rekursiver Worker für intern; ersetzt Variablen aus subst durch
+	 * bereits internierte Knoten.
+	 *
+	 * @param E Ausdruck
+	 * @param subst Ersetzungen Variablenname -> Knoten (oder 0)
+	 * @return Knoten des Ausdrucks
+	 */
+	uint32_t intern(ExprTree const * E, charptr_map< uint32_t > const * subst);
+
+	/**
+	 * Interniert einen Variablen- oder diff-Knoten.
+	 *
+	 * @param E Variable oder diff-Knoten
+	 * @return Knoten
+	 */
+	uint32_t slot(ExprTree const * E);
+
+	/**
+	 * Trägt einen Knoten ein, falls er noch nicht existiert.
+	 *
+	 * @param key Schlüssel der Interning-Tabelle
+	 * @param n Knoten
+	 * @return Knoten
+	 */
+	uint32_t insert(mxkooo const & key, Node const & n);
+
+	/**
+	 * Erzeugt den Ausdrucksbaum eines Knotens; geteilte Knoten
+	 * (refs > 1, außer dem Knoten selbst) werden durch "_t<k>" ersetzt.
+	 *
+	 * @param i Knoten
+	 * @param refs Referenzzähler (oder 0: vollständig expandieren)
+	 * @param top true für den Knoten selbst
+	 * @return neuer Ausdrucksbaum
+	 */
+	ExprTree * toTree(uint32_t i, std::vector< uint32_t > const * refs,
+		bool top) const;
+
+}; // class ExprDAG
+
+} // namespace flux::symb
+} // namespace flux
+
+#endif
+
@@ -0,0 +1,433 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include "fluxml_config.h"
+extern "C"
+{
+#include <stdint.h>
+#ifndef P_WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+}
+#include "Error.h"
+#include "Combinations.h"
+#include "DynamicLibrary.h"
+#include "ExprTree.h"
+#include "ExprProgram.h"
+#include "ExprJIT.h"
+
+namespace flux {
+namespace symb {
+
+namespace {
+
+/**
+ * Literal als exakte C-Konstante (hexadezimale Gleitkommazahl).
+ */
+std::string c_literal(double v)
+{
+	char buf[64];
+	if (std::isnan(v))
+		return "NAN";
+	if (std::isinf(v))
+		return v > 0 ? "HUGE_VAL" : "(-HUGE_VAL)";
+	snprintf(buf, sizeof(buf), "%a", v);
+	return buf;
+}
+
+/**
+ * C-Ausdruck für eine Instruktion (Operanden als Register rA, rB).
+ */
+std::string c_instr(ExprProgram::Instr const & I)
+{
+	char a[32], b[32];
+	snprintf(a, sizeof(a), "r%lu", (unsigned long)I.a);
+	snprintf(b, sizeof(b), "r%lu", (unsigned long)I.b);
+	std::string A(a), B(b);
+
+	switch (ExprType(I.op))
+	{
+	case et_op_add:    return A + "+" + B;
+	case et_op_sub:    return A + "-" + B;
+	case et_op_uminus: return "-" + A;
+	case et_op_mul:    return A + "*" + B;
+	case et_op_div:    return A + "/" + B;
+	case et_op_pow:    return "pow(" + A + "," + B + ")";
+	case et_op_eq:     return "(double)(" + A + "==" + B + ")";
+	case et_op_neq:    return "(double)(" + A + "!=" + B + ")";
+	case et_op_leq:    return "(double)(" + A + "<=" + B + ")";
+	case et_op_geq:    return "(double)(" + A + ">=" + B + ")";
+	case et_op_lt:     return "(double)(" + A + "<" + B + ")";
+	case et_op_gt:     return "(double)(" + A + ">" + B + ")";
+	case et_op_abs:    return A + "<0.?-" + A + ":" + A;
+	case et_op_min:    return A + "<=" + B + "?" + A + ":" + B;
+	case et_op_max:    return A + ">=" + B + "?" + A + ":" + B;
+	case et_op_sqr:    return A + "*" + A;
+	case et_op_sqrt:   return "sqrt(" + A + ")";
+	case et_op_log:    return "log(" + A + ")";
+	case et_op_log2:   return "log(" + A + ")/log(2.)";
+	case et_op_log10:  return "log10(" + A + ")";
+	case et_op_exp:    return "exp(" + A + ")";
+	case et_op_sin:    return "sin(" + A + ")";
+	case et_op_cos:    return "cos(" + A + ")";
+	default:
+		fASSERT_NONREACHABLE();
+		return "0.";
+	}
+}
+
+#ifndef P_WIN32
+/**
+ * Cache-Verzeichnis gemäß Voreinstellung; ohne FLUXML_JIT_CACHE ein
+ * eigenes Unterverzeichnis je Benutzer in TMPDIR bzw. /tmp.
+ */
+std::string cache_dir_default()
+{
+	char const * d = getenv("FLUXML_JIT_CACHE");
+	if (d and *d)
+		return d;
+	d = getenv("TMPDIR");
+	if (d == 0 or *d == 0)
+		d = "/tmp";
+	char uid[32];
+	snprintf(uid, sizeof(uid), "/fluxjit-%lu", (unsigned long)geteuid());
+	return std::string(d) + uid;
+}
+
+/**
+ * Legt das Cache-Verzeichnis (Modus 0700) an, falls es nicht existiert,
+ * und prüft, dass es ein Verzeichnis (kein symbolischer Link) ist, das
+ * dem Benutzer gehört und für andere weder les- noch schreibbar ist.
+ */
+bool cache_dir_check(std::string const & dir)
+{
+	struct stat st;
+	if (mkdir(dir.c_str(), 0700) != 0 and errno != EEXIST)
+		return false;
+	if (lstat(dir.c_str(), &st) != 0)
+		return false;
+	return S_ISDIR(st.st_mode) and st.st_uid == geteuid()
+		and (st.st_mode & 077) == 0;
+}
+
+/**
+ * Prüft, ob path eine reguläre Datei des Benutzers ist, deren Inhalt
+ * exakt content ist.
+ */
+bool file_matches(std::string const & path, std::string const & content)
+{
+	struct stat st;
+	if (lstat(path.c_str(), &st) != 0 or not S_ISREG(st.st_mode)
+		or st.st_uid != geteuid() or size_t(st.st_size) != content.size())
+		return false;
+	FILE * f = fopen(path.c_str(), "rb");
+	if (f == 0)
+		return false;
+	std::string buf(content.size(), '\0');
+	bool ok = fread(&buf[0], 1, buf.size(), f) == buf.size()
+		and fgetc(f) == EOF;
+	fclose(f);
+	return ok and buf == content;
+}
+
+/**
+ * Startet den Compiler per fork/execvp (ohne Shell) und wartet auf
+ * sein Ende. Die Ausgaben des Compilers werden verworfen.
+ */
+bool run_compiler(std::vector< std::string > const & args)
+{
+	std::vector< char * > argv;
+	for (size_t i=0; i<args.size(); i++)
+		argv.push_back(const_cast< char * >(args[i].c_str()));
+	argv.push_back(0);
+
+	pid_t pid = fork();
+	if (pid < 0)
+		return false;
+	if (pid == 0)
+	{
+		int fd = open("/dev/null", O_WRONLY);
+		if (fd >= 0)
+		{
+			dup2(fd, 1);
+			dup2(fd, 2);
+			close(fd);
+		}
+		execvp(argv[0], &argv[0]);
+		_exit(127);
+	}
+
+	int status;
+	while (waitpid(pid, &status, 0) < 0)
+		if (errno != EINTR)
+			return false;
+	return WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+#endif
+
+} // namespace
+
+ExprJIT::ExprJIT()
+	: lib_(0), all_(0)
+{
+}
+
+ExprJIT::~ExprJIT()
+{
+	unload();
+}
+
+void ExprJIT::unload()
+{
+	fns_.clear();
+	all_ = 0;
+	if (lib_)
+	{
+		delete lib_;
+		lib_ = 0;
+	}
+}
+
+size_t ExprJIT::add(ExprTree const * E)
+{
+	unload();
+	progs_.push_back(ExprProgram(E));
+	ExprProgram const & P = progs_.back();
+	std::vector< size_t > sm(P.slots());
+
+	for (size_t i=0; i<P.slots(); i++)
+	{
+		std::string key = P.slotName(i) ? std::string(P.slotName(i))
+			: P.slotExpr(i).toString();
+		size_t * j = varidx_.findPtr(key.c_str());
+		if (j == 0)
+		{
+			varidx_.insert(key.c_str(), vars_.size());
+			j = varidx_.findPtr(key.c_str());
+			vars_.push_back(key);
+		}
+		sm[i] = *j;
+	}
+	slotmap_.push_back(sm);
+	return progs_.size()-1;
+}
+
+size_t ExprJIT::varIndex(char const * name) const
+{
+	size_t * j = varidx_.findPtr(name);
+	return j ? *j : vars_.size();
+}
+
+std::string ExprJIT::source() const
+{
+	std::string src;
+	char buf[128];
+	size_t k, i;
+
+	src = "/* generated by flux::symb::ExprJIT */\n#include <math.h>\n\n";
+	for (k=0; k<progs_.size(); k++)
+	{
+		ExprProgram const & P = progs_[k];
+		size_t nc = P.consts(), ns = P.slots(), nr = P.workSize();
+
+		// Variablenbezeichnungen als Kommentar (ohne "*/")
+		src += "/*";
+		for (i=0; i<ns; i++)
+		{
+			std::string v = vars_[slotmap_[k][i]];
+			for (size_t p; (p = v.find("*/")) != std::string::npos; )
+				v.replace(p, 2, "* /");
+			src += " " + v;
+		}
+		src += " */\n";
+
+		snprintf(buf, sizeof(buf), "double fluxjit_%lu(double const * x)\n{\n",
+			(unsigned long)k);
+		src += buf;
+		if (nr == 0)
+		{
+			src += "\t(void)x;\n\treturn 0.;\n}\n\n";
+			continue;
+		}
+		for (i=0; i<nc; i++)
+		{
+			snprintf(buf, sizeof(buf), "\tdouble const r%lu = ", (unsigned long)i);
+			src += buf + c_literal(P.constant(i)) + ";\n";
+		}
+		for (i=0; i<ns; i++)
+		{
+			snprintf(buf, sizeof(buf), "\tdouble const r%lu = x[%lu];\n",
+				(unsigned long)(nc+i), (unsigned long)slotmap_[k][i]);
+			src += buf;
+		}
+		for (i=nc+ns; i<nr; i++)
+		{
+			snprintf(buf, sizeof(buf), "\tdouble r%lu;\n", (unsigned long)i);
+			src += buf;
+		}
+		if (ns == 0)
+			src += "\t(void)x;\n";
+		for (i=0; i<P.size(); i++)
+		{
+			snprintf(buf, sizeof(buf), "\tr%lu = ", (unsigned long)P.instr(i).dst);
+			src += buf + c_instr(P.instr(i)) + ";\n";
+		}
+		snprintf(buf, sizeof(buf), "\treturn r%lu;\n}\n\n", (unsigned long)P.result());
+		src += buf;
+	}
+
+	src += "void fluxjit_all(double const * x, double * y)\n{\n";
+	for (k=0; k<progs_.size(); k++)
+	{
+		snprintf(buf, sizeof(buf), "\ty[%lu] = fluxjit_%lu(x);\n",
+			(unsigned long)k, (unsigned long)k);
+		src += buf;
+	}
+	src += "}\n";
+	return src;
+}
+
+bool ExprJIT::compile(char const * cache_dir)
+{
+	unload();
+#ifdef P_WIN32
+	(void)cache_dir;
+	fWARNING("ExprJIT: native compilation not supported; using interpreter");
+	return false;
+#else
+	std::string src = source();
+	std::string dir = cache_dir ? std::string(cache_dir) : cache_dir_default();
+	char const * cc = getenv("CC");
+	if (cc == 0 or *cc == 0)
+		cc = "cc";
+
+	// nur ein privates Verzeichnis des Benutzers wird verwendet; sonst
+	// könnte ein anderer Benutzer eine fremde Bibliothek unterschieben
+	if (not cache_dir_check(dir))
+	{
+		fWARNING("ExprJIT: cache directory \"%s\" is not private; using interpreter",
+			dir.c_str());
+		return false;
+	}
+
+	// Cache-Schlüssel: SHA-256 des Quelltexts
+	uint8_t digest[32];
+	char key[80];
+	sha256(src.data(), src.size(), digest);
+	strcpy(key, "fluxjit_");
+	for (size_t i=0; i<32; i++)
+		snprintf(key + 8 + 2*i, 3, "%02x", digest[i]);
+	std::string so = dir + "/" + key + ".so";
+	std::string csrc = dir + "/" + key + ".c";
+
+	// der neben der Bibliothek abgelegte Quelltext muss übereinstimmen
+	struct stat st;
+	if (not file_matches(csrc, src) or lstat(so.c_str(), &st) != 0
+		or not S_ISREG(st.st_mode) or st.st_uid != geteuid())
+	{
+		// in exklusiv angelegte temporäre Dateien übersetzen, dann
+		// atomar umbenennen
+		std::string tsrc = dir + "/" + key + ".c.XXXXXX";
+		std::string tso = dir + "/" + key + ".so.XXXXXX";
+		int fd = mkstemp(&tsrc[0]);
+		if (fd < 0)
+		{
+			fWARNING("ExprJIT: cannot write to \"%s\"; using interpreter",
+				dir.c_str());
+			return false;
+		}
+		FILE * f = fdopen(fd, "w");
+		bool ok = f != 0;
+		if (f == 0)
+			close(fd);
+		else
+		{
+			ok = fwrite(src.data(), 1, src.size(), f) == src.size();
+			ok = (fclose(f) == 0) and ok;
+		}
+		int fdso = ok ? mkstemp(&tso[0]) : -1;
+		if (fdso >= 0)
+			close(fdso);
+		ok = ok and fdso >= 0;
+
+		// Compiler-Kommando: CC darf Optionen enthalten (z.B. "ccache cc")
+		std::vector< std::string > args;
+		char const * p = cc;
+		while (*p)
+		{
+			while (*p == ' ' or *p == '\t') p++;
+			char const * q = p;
+			while (*q and *q != ' ' and *q != '\t') q++;
+			if (q > p)
+				args.push_back(std::string(p, q-p));
+			p = q;
+		}
+		ok = ok and not args.empty();
+		args.push_back("-O2");
+		args.push_back("-ffp-contract=off");
+		args.push_back("-fPIC");
+		args.push_back("-shared");
+		args.push_back("-o");
+		args.push_back(tso);
+		args.push_back("-x");
+		args.push_back("c");
+		args.push_back(tsrc);
+		args.push_back("-lm");
+
+		ok = ok and run_compiler(args);
+		ok = ok and rename(tsrc.c_str(), csrc.c_str()) == 0;
+		ok = ok and rename(tso.c_str(), so.c_str()) == 0;
+		if (not ok)
+		{
+			remove(tsrc.c_str());
+			if (fdso >= 0)
+				remove(tso.c_str());
+			fWARNING("ExprJIT: compiler \"%s\" not available or failed; using interpreter",
+				cc);
+			return false;
+		}
+	}
+
+	lib_ = new DynamicLibrary(so.c_str());
+	all_ = lib_->loadSymbol< all_fn_t >("fluxjit_all");
+	for (size_t k=0; all_ and k<progs_.size(); k++)
+	{
+		char sym[48];
+		snprintf(sym, sizeof(sym), "fluxjit_%lu", (unsigned long)k);
+		expr_fn_t fn = lib_->loadSymbol< expr_fn_t >(sym);
+		if (fn == 0)
+			break;
+		fns_.push_back(fn);
+	}
+	if (all_ == 0 or fns_.size() != progs_.size())
+	{
+		fWARNING("ExprJIT: cannot load \"%s\"; using interpreter", so.c_str());
+		unload();
+		return false;
+	}
+	return true;
+#endif
+}
+
+void ExprJIT::evalAll(double const * x, double * y) const
+{
+	if (all_)
+	{
+		all_(x, y);
+		return;
+	}
+	for (size_t k=0; k<progs_.size(); k++)
+		y[k] = eval(k, x);
+}
+
+} // namespace flux::symb
+} // namespace flux
+
@@ -0,0 +1,171 @@
+#ifndef EXPRJIT_H
+#define EXPRJIT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "charptr_map.h"
+#include "ExprTree.h"
+#include "ExprProgram.h"
+
+class DynamicLibrary;
+
+namespace flux {
+namespace symb {
+
+/**
+ * Native Übersetzung einer Menge von Ausdrücken (z.B. Constraints,
+ * Messformeln, Fehlermodelle, Input-Profile).
+ *
+ * Alle Ausdrücke teilen sich eine Variablentabelle; ausgewertet wird
+ * mit einem Vektor x der Variablenwerte (Index gemäß var()). Aus den
+ * ExprProgram-Übersetzungen wird eine C-Übersetzungseinheit erzeugt,
+ * mit dem System-Compiler (Umgebungsvariable CC, sonst "cc") zu einem
+ * Shared-Library übersetzt (mit -ffp-contract=off, damit keine FMA-
+ * Kontraktion die Ergebnisse verändert) und per DynamicLibrary geladen.
+ * Das Ergebnis wird im Cache-Verzeichnis (Umgebungsvariable
+ * FLUXML_JIT_CACHE, sonst TMPDIR/fluxjit-<uid> bzw. /tmp/fluxjit-<uid>)
+ * unter der SHA-256-Prüfsumme des Quelltexts abgelegt und bei gleicher
+ * Ausdrucksmenge wiederverwendet. Das Verzeichnis muss dem Benutzer
+ * gehören und darf für andere nicht zugänglich sein (Modus 0700); eine
+ * Bibliothek wird nur geladen, wenn der daneben abgelegte Quelltext mit
+ * dem aktuellen übereinstimmt.
+ *
+ * Steht kein Compiler zur Verfügung (oder schlägt die Übersetzung
+ * fehl), werden die Ausdrücke mit ExprProgram interpretiert; das
+ * Ergebnis ist in beiden Fällen dasselbe.
+ *
+ * Exportierte Symbole: fluxjit_<k>(x) für Ausdruck k,
+ * fluxjit_all(x,y) für alle Ausdrücke.
+ */
+class ExprJIT
+{
+public:
+	/** Funktionszeiger eines übersetzten Ausdrucks */
+	typedef double (*expr_fn_t)(double const *);
+	/** Funktionszeiger für alle Ausdrücke */
+	typedef void (*all_fn_t)(double const *, double *);
+
+private:
+	/** übersetzte Ausdrücke (Interpreter) */
+	std::vector< ExprProgram > progs_;
+	/** je Ausdruck: Slot -> Index in der Variablentabelle */
+	std::vector< std::vector< size_t > > slotmap_;
+	/** Variablentabelle (Variablenname bzw. diff-Ausdruck) */
+	std::vector< std::string > vars_;
+	/** Abbildung Variable -> Index */
+	charptr_map< size_t > varidx_;
+	/** geladenes Shared-Library (0: Interpreter) */
+	DynamicLibrary * lib_;
+	/** native Funktionen je Ausdruck */
+	std::vector< expr_fn_t > fns_;
+	/** native Funktion für alle Ausdrücke */
+	all_fn_t all_;
+
+public:
+	/**
+	 * Constructor. Erzeugt eine leere Ausdrucksmenge.
+	 */
+	ExprJIT();
+
+	/**
+	 * Destructor. Entlädt das Shared-Library.
+	 */
+	~ExprJIT();
+
+	/**
+	 * Fügt einen Ausdruck hinzu. Eine vorherige native Übersetzung wird
+	 * verworfen.
+	 *
+	 * @param E Ausdruck
+	 * @return Index des Ausdrucks
+	 */
+	size_t add(ExprTree const * E);
+
+	/** @return Anzahl der Ausdrücke */
+	inline size_t size() const { return progs_.size(); }
+
+	/** @return Anzahl der Variablen */
+	inline size_t vars() const { return vars_.size(); }
+
+	/**
+	 * Bezeichnung einer Variablen.
+	 *
+	 * @param j Index der Variablen
+	 * @return Variablenname (bzw. Textform eines diff-Knotens)
+	 */
+	inline char const * var(size_t j) const { return vars_[j].c_str(); }
+
+	/**
+	 * Sucht den Index einer Variablen.
+	 *
+	 * @param name Variablenname
+	 * @return Index oder vars(), falls nicht vorhanden
+	 */
+	size_t varIndex(char const * name) const;
+
+	/**
+	 * Interpreter-Programm eines Ausdrucks.
+	 *
+	 * @param k Index des Ausdrucks
+	 * @return ExprProgram
+	 */
+	inline ExprProgram const & program(size_t k) const { return progs_[k]; }
+
+	/**
+	 * Erzeugt die C-Übersetzungseinheit für alle Ausdrücke.
+	 *
+	 * @return C-Quelltext
+	 */
+	std::string source() const;
+
+	/**
+	 * Übersetzt und lädt die Ausdrucksmenge (oder lädt sie aus dem
+	 * Cache).
+	 *
+	 * @param cache_dir Cache-Verzeichnis (0: Voreinstellung)
+	 * @return true, falls native Auswertung verfügbar ist
+	 */
+	bool compile(char const * cache_dir = 0);
+
+	/** @return true, falls die Auswertung nativ erfolgt */
+	inline bool isNative() const { return lib_ != 0; }
+
+	/**
+	 * Wertet einen Ausdruck aus.
+	 *
+	 * @param k Index des Ausdrucks
+	 * @param x Variablenwerte (Länge vars())
+	 * @return Wert des Ausdrucks
+	 */
+	inline double eval(size_t k, double const * x) const
+	{
+		if (lib_)
+			return fns_[k](x);
+		std::vector< size_t > const & sm = slotmap_[k];
+		return progs_[k].run< double >([&sm,x](size_t i) { return x[sm[i]]; });
+	}
+
+	/**
+	 * Wertet alle Ausdrücke aus.
+	 *
+	 * @param x Variablenwerte (Länge vars())
+	 * @param y Ergebnisse (Länge size())
+	 */
+	void evalAll(double const * x, double * y) const;
+
+private:
+	/** Entlädt das Shared-Library */
+	void unload();
+
+	/** nicht kopierbar */
+	ExprJIT(ExprJIT const &);
+	ExprJIT & operator=(ExprJIT const &);
+
+}; // class ExprJIT
+
+} // namespace flux::symb
+} // namespace flux
+
+#endif
+
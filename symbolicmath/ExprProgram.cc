@@ -0,0 +1,240 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+extern "C"
+{
+#include <stdint.h>
+}
+#include "Error.h"
+#include "charptr_map.h"
+#include "ExprTree.h"
+#include "ExprProgram.h"
+
+namespace flux {
+namespace symb {
+
+struct ExprProgram::Context
+{
+	/** Bitmuster eines Literals -> Konstanten-Index */
+	std::map< uint64_t,uint32_t > consts;
+	/** Slot-Schlüssel (Variablenname bzw. diff-Ausdruck) -> Slot-Index */
+	charptr_map< uint32_t > slots;
+	/** Blatt (Literal/Slot) -> Register */
+	std::map< ExprTree const *,uint32_t > leaves;
+	/** freie Zwischenregister */
+	std::vector< uint32_t > freeregs;
+};
+
+ExprProgram::ExprProgram()
+	: nregs_(0), res_(0), ops_(0)
+{
+}
+
+ExprProgram::ExprProgram(ExprTree const * E)
+	: nregs_(0), res_(0), ops_(0)
+{
+	compile(E);
+}
+
+void ExprProgram::compile(ExprTree const * E)
+{
+	Context ctx;
+	code_.clear();
+	ssa_.clear();
+	const_.clear();
+	slots_.clear();
+	nregs_ = res_ = 0;
+	ops_ = 0;
+	if (E == 0)
+		return;
+
+	// 1. Konstanten und Slots; Register der Blätter festlegen
+	collect(E, ctx);
+	uint32_t nc = const_.size();
+	std::map< ExprTree const *,uint32_t >::iterator li;
+	for (li=ctx.leaves.begin(); li!=ctx.leaves.end(); ++li)
+		if (not li->first->isLiteral())
+			li->second += nc;
+	nregs_ = nc + slots_.size();
+
+	// 2. Instruktionen (Postorder)
+	uint32_t vid;
+	res_ = emit(E, ctx, vid);
+}
+
+void ExprProgram::collect(ExprTree const * E, Context & ctx)
+{
+	ops_ |= opMask(E->getNodeType());
+
+	if (E->isLiteral())
+	{
+		double v = E->getDoubleValue();
+		uint64_t bits;
+		::memcpy(&bits, &v, sizeof(bits));
+		std::map< uint64_t,uint32_t >::const_iterator ci = ctx.consts.find(bits);
+		if (ci == ctx.consts.end())
+		{
+			ci = ctx.consts.insert(std::make_pair(bits,
+				uint32_t(const_.size()))).first;
+			const_.push_back(v);
+		}
+		ctx.leaves[E] = ci->second;
+		return;
+	}
+
+	if (E->isVariable() or IS_OP_DIFF(E))
+	{
+		// diff-Knoten werden über ihre Textform identifiziert
+		std::string key = E->isVariable() ? E->getVarName() : E->toString();
+		uint32_t * si = ctx.slots.findPtr(key.c_str());
+		if (si == 0)
+		{
+			ctx.slots.insert(key.c_str(), uint32_t(slots_.size()));
+			si = ctx.slots.findPtr(key.c_str());
+			slots_.push_back(*E);
+		}
+		ctx.leaves[E] = *si;
+		return;
+	}
+
+	collect(E->Lval(), ctx);
+	if (E->Rval())
+		collect(E->Rval(), ctx);
+}
+
+uint32_t ExprProgram::emit(ExprTree const * E, Context & ctx, uint32_t & vid)
+{
+	std::map< ExprTree const *,uint32_t >::const_iterator li = ctx.leaves.find(E);
+	if (li != ctx.leaves.end())
+		return (vid = li->second);
+
+	Instr I, S;
+	I.op = S.op = uint8_t(E->getNodeType());
+	I.a = emit(E->Lval(), ctx, S.a);
+	if (E->Rval())
+		I.b = emit(E->Rval(), ctx, S.b);
+	else
+	{
+		I.b = I.a;
+		S.b = S.a;
+	}
+
+	// Zwischenregister der Operanden freigeben, dann Ziel belegen
+	uint32_t nfixed = const_.size() + slots_.size();
+	if (I.b >= nfixed and I.b != I.a)
+		ctx.freeregs.push_back(I.b);
+	if (I.a >= nfixed)
+		ctx.freeregs.push_back(I.a);
+	if (ctx.freeregs.empty())
+		I.dst = nregs_++;
+	else
+	{
+		I.dst = ctx.freeregs.back();
+		ctx.freeregs.pop_back();
+	}
+	code_.push_back(I);
+
+	S.dst = vid = nfixed + ssa_.size();
+	ssa_.push_back(S);
+	return I.dst;
+}
+
+double ExprProgram::reverse(double * v, double * adj, double * grad) const
+{
+	size_t k, nfixed = const_.size() + slots_.size();
+	size_t nv = nfixed + ssa_.size();
+	uint32_t res = ssa_.empty() ? res_ : uint32_t(nv-1);
+
+	if (nregs_ == 0)
+		return 0.;
+
+	// Vorwärts: alle Zwischenergebnisse bleiben erhalten
+	double f = exec(ssa_.data(), ssa_.data()+ssa_.size(), res, v);
+
+	for (k=0; k<nv; k++)
+		adj[k] = 0.;
+	adj[res] = 1.;
+
+	// Rückwärts: Adjungierte der Operanden akkumulieren
+	for (k=ssa_.size(); k>0; k--)
+	{
+		Instr const & I = ssa_[k-1];
+		double g = adj[I.dst], a = v[I.a], b = v[I.b], d = v[I.dst];
+		if (g == 0.)
+			continue;
+		switch (ExprType(I.op))
+		{
+		case et_op_add: adj[I.a] += g; adj[I.b] += g; break;
+		case et_op_sub: adj[I.a] += g; adj[I.b] -= g; break;
+		case et_op_uminus: adj[I.a] -= g; break;
+		case et_op_mul: adj[I.a] += g*b; adj[I.b] += g*a; break;
+		case et_op_div: adj[I.a] += g/b; adj[I.b] -= g*d/b; break;
+		case et_op_pow:
+			adj[I.a] += g*b*::pow(a,b-1.);
+			if (a > 0.)
+				adj[I.b] += g*d*::log(a);
+			break;
+		case et_op_eq:
+		case et_op_neq:
+		case et_op_leq:
+		case et_op_geq:
+		case et_op_lt:
+		case et_op_gt:
+			break;
+		case et_op_abs: adj[I.a] += a < 0. ? -g : g; break;
+		case et_op_min: adj[a <= b ? I.a : I.b] += g; break;
+		case et_op_max: adj[a >= b ? I.a : I.b] += g; break;
+		case et_op_sqr: adj[I.a] += 2.*a*g; break;
+		case et_op_sqrt: adj[I.a] += g/(2.*d); break;
+		case et_op_log: adj[I.a] += g/a; break;
+		case et_op_log2: adj[I.a] += g/(a*::log(2.)); break;
+		case et_op_log10: adj[I.a] += g/(a*::log(10.)); break;
+		case et_op_exp: adj[I.a] += g*d; break;
+		case et_op_sin: adj[I.a] += g*::cos(a); break;
+		case et_op_cos: adj[I.a] -= g*::sin(a); break;
+		default:
+			fASSERT_NONREACHABLE();
+		}
+	}
+
+	for (k=0; k<slots_.size(); k++)
+		grad[k] = adj[const_.size()+k];
+	return f;
+}
+
+size_t ExprProgram::slotOf(char const * name) const
+{
+	size_t i;
+	for (i=0; i<slots_.size(); i++)
+		if (slots_[i].isVariable() and strcmp(slots_[i].getVarName(),name) == 0)
+			break;
+	return i;
+}
+
+void ExprProgram::dump(FILE * outf) const
+{
+	size_t i, nc = const_.size();
+	fprintf(outf, "ExprProgram: %lu instr, %lu const, %lu slots, %lu regs, result r%lu\n",
+		(unsigned long)code_.size(), (unsigned long)nc,
+		(unsigned long)slots_.size(), (unsigned long)nregs_,
+		(unsigned long)res_);
+	for (i=0; i<nc; i++)
+		fprintf(outf, "  r%lu = %g\n", (unsigned long)i, const_[i]);
+	for (i=0; i<slots_.size(); i++)
+		fprintf(outf, "  r%lu = [%s]\n", (unsigned long)(nc+i),
+			slots_[i].toString().c_str());
+	for (i=0; i<code_.size(); i++)
+	{
+		ExprTree op(ExprType(code_[i].op), ExprTree::val(0.), ExprTree::val(0.));
+		fprintf(outf, "  r%lu = %s(r%lu,r%lu)\n", (unsigned long)code_[i].dst,
+			op.nodeToString().c_str(), (unsigned long)code_[i].a,
+			(unsigned long)code_[i].b);
+	}
+}
+
+} // namespace flux::symb
+} // namespace flux
+
@@ -0,0 +1,396 @@
+#ifndef EXPRPROGRAM_H
+#define EXPRPROGRAM_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+extern "C"
+{
+#include <stdint.h>
+}
+#include "Error.h"
+#include "ExprTree.h"
+
+namespace flux {
+namespace symb {
+
+/**
+ * Ein ExprTree, übersetzt in ein lineares Programm für eine einfache
+ * Register-Maschine. Die Auswertung kommt ohne Rekursion, ohne
+ * Namensauflösung und ohne Allokation aus.
+ *
+ * Registersatz (ein Array vom Typ T):
+ *
+ *  [0, nconst)              Literale (Konstanten-Pool, dedupliziert)
+ *  [nconst, nconst+nslots)  Slots (Variablen, vom Aufrufer belegt)
+ *  [nconst+nslots, size)    Zwischenergebnisse
+ *
+ * Jede Instruktion berechnet dst = op(a,b) mit op aus ExprType; b wird
+ * bei unären Operatoren ignoriert. Die Zwischenregister werden beim
+ * Übersetzen wiederverwendet, ihre Anzahl wächst nur mit der Tiefe
+ * des Baums.
+ *
+ * Slots sind die verschiedenen Variablen des Ausdrucks in der
+ * Reihenfolge ihres ersten Auftretens. Ableitungsknoten diff(X,v) werden
+ * nicht ausgewertet, sondern ebenfalls als Slot behandelt, d.h. ihr
+ * Wert wird vom Aufrufer geliefert.
+ */
+class ExprProgram
+{
+public:
+	/** Eine Instruktion: dst = op(a,b) */
+	struct Instr
+	{
+		/** Operator (ExprType) */
+		uint8_t op;
+		/** Zielregister */
+		uint32_t dst;
+		/** linkes Operandenregister */
+		uint32_t a;
+		/** rechtes Operandenregister (nur bei binären Operatoren) */
+		uint32_t b;
+	};
+
+private:
+	/** Instruktionen in Ausführungsreihenfolge */
+	std::vector< Instr > code_;
+	/**
+	 * dieselben Instruktionen in SSA-Form: Instruktion k schreibt
+	 * Register nconst+nslots+k (für das Rückwärts-Differenzieren)
+	 */
+	std::vector< Instr > ssa_;
+	/** Konstanten-Pool */
+	std::vector< double > const_;
+	/** Slot-Ausdrücke (Variablen oder diff-Knoten) */
+	std::vector< ExprTree > slots_;
+	/** Gesamtzahl der Register */
+	uint32_t nregs_;
+	/** Register mit dem Ergebnis */
+	uint32_t res_;
+	/** im Ausdruck vorkommende Knotentypen (Bit i: ExprType i) */
+	uint64_t ops_;
+
+public:
+	/**
+	 * Default-Constructor; das leere Programm liefert 0.
+	 */
+	ExprProgram();
+
+	/**
+	 * Constructor. Übersetzt einen Ausdruck.
+	 *
+	 * @param E Ausdruck
+	 */
+	ExprProgram(ExprTree const * E);
+
+	/**
+	 * Übersetzt einen Ausdruck (ersetzt das bisherige Programm).
+	 *
+	 * @param E Ausdruck
+	 */
+	void compile(ExprTree const * E);
+
+	/** @return Anzahl der Slots */
+	inline size_t slots() const { return slots_.size(); }
+
+	/**
+	 * Slot-Ausdruck (Variable oder diff-Knoten).
+	 *
+	 * @param i Slot-Index
+	 * @return Ausdruck des Slots
+	 */
+	inline ExprTree const & slotExpr(size_t i) const { return slots_[i]; }
+
+	/**
+	 * Variablenname eines Slots.
+	 *
+	 * @param i Slot-Index
+	 * @return Variablenname oder 0, falls der Slot ein diff-Knoten ist
+	 */
+	inline char const * slotName(size_t i) const
+	{
+		return slots_[i].isVariable() ? slots_[i].getVarName() : 0;
+	}
+
+	/**
+	 * Sucht den Slot einer Variablen.
+	 *
+	 * @param name Variablenname
+	 * @return Slot-Index oder slots(), falls nicht vorhanden
+	 */
+	size_t slotOf(char const * name) const;
+
+	/** @return Anzahl der Instruktionen */
+	inline size_t size() const { return code_.size(); }
+
+	/** @return benötigte Größe des Arbeitsspeichers (Register) */
+	inline size_t workSize() const { return nregs_; }
+
+	/**
+	 * Zugriff auf eine Instruktion (z.B. für Code-Generatoren).
+	 *
+	 * @param i Index der Instruktion
+	 * @return Instruktion
+	 */
+	inline Instr const & instr(size_t i) const { return code_[i]; }
+
+	/** @return Anzahl der Konstanten (Register 0 bis consts()-1) */
+	inline size_t consts() const { return const_.size(); }
+
+	/**
+	 * Wert einer Konstanten.
+	 *
+	 * @param i Index der Konstanten (= Register)
+	 * @return Wert
+	 */
+	inline double constant(size_t i) const { return const_[i]; }
+
+	/** @return Register mit dem Ergebnis */
+	inline size_t result() const { return res_; }
+
+	/**
+	 * Prüft, ob ein Knotentyp im Ausdruck vorkommt.
+	 *
+	 * @param et Knotentyp
+	 * @return true, falls et vorkommt
+	 */
+	inline bool uses(ExprType et) const
+	{
+		return (ops_ >> int(et)) & 1;
+	}
+
+	/**
+	 * Prüft, ob nur die angegebenen Operatoren vorkommen.
+	 *
+	 * @param allowed Bitmaske erlaubter Knotentypen (Bit i: ExprType i)
+	 * @return true, falls keine anderen Operatoren vorkommen
+	 */
+	inline bool usesOnly(uint64_t allowed) const
+	{
+		return (ops_ & ~(allowed | opMask(et_literal) | opMask(et_variable))) == 0;
+	}
+
+	/**
+	 * Bitmaske eines Knotentyps für usesOnly.
+	 *
+	 * @param et Knotentyp
+	 * @return Bitmaske
+	 */
+	static inline uint64_t opMask(ExprType et) { return uint64_t(1) << int(et); }
+
+	/**
+	 * Auswertung mit vom Aufrufer bereitgestelltem Arbeitsspeicher.
+	 * load(i) liefert den Wert von Slot i und wird genau einmal je Slot
+	 * aufgerufen.
+	 *
+	 * @param load Funktor size_t -> T
+	 * @param work Arbeitsspeicher mit mindestens workSize() Elementen
+	 * @return Wert des Ausdrucks
+	 */
+	template< typename T, typename Load > T run(Load load, T * work) const
+	{
+		size_t i, nc = const_.size(), ns = slots_.size();
+		for (i=0; i<nc; i++)
+			work[i] = T(const_[i]);
+		for (i=0; i<ns; i++)
+			work[nc+i] = load(i);
+		return exec(code_.data(), code_.data()+code_.size(), res_, work);
+	}
+
+	/**
+	 * Auswertung mit Thread-lokalem Arbeitsspeicher. Dieser wächst nur
+	 * bei Bedarf; verschachtelte Aufrufe (aus load heraus) erhalten
+	 * jeweils einen eigenen Puffer.
+	 *
+	 * @param load Funktor size_t -> T
+	 * @return Wert des Ausdrucks
+	 */
+	template< typename T, typename Load > T run(Load load) const
+	{
+		Workspace< T > & ws = Workspace< T >::local();
+		WorkspaceGuard< T > guard(ws);
+		std::vector< T > & w = ws.bufs_[guard.level_];
+		if (w.size() < nregs_)
+			w.resize(nregs_);
+		T * work = w.data();
+		return run< T >(load, work);
+	}
+
+	/**
+	 * Auswertung mit Slot-Werten aus einem Array.
+	 *
+	 * @param values Slot-Werte (Länge slots())
+	 * @return Wert des Ausdrucks
+	 */
+	inline double eval(double const * values) const
+	{
+		return run< double >([values](size_t i) { return values[i]; });
+	}
+
+	/**
+	 * Gradient per Rückwärts-Differentiation (reverse mode): ein
+	 * Vorwärtslauf speichert alle Zwischenergebnisse, ein Rückwärtslauf
+	 * akkumuliert die Adjungierten. Der Aufwand ist ein kleines
+	 * Vielfaches einer Auswertung, unabhängig von der Anzahl der Slots.
+	 * diff-Slots werden wie Variablen behandelt.
+	 *
+	 * @param load Funktor size_t -> double (Slot-Werte)
+	 * @param grad Ableitungen nach den Slots (out, Länge slots())
+	 * @return Wert des Ausdrucks
+	 */
+	template< typename Load > double gradient(Load load, double * grad) const
+	{
+		size_t i, nc = const_.size(), ns = slots_.size();
+		size_t nv = nc + ns + ssa_.size();
+		Workspace< double > & ws = Workspace< double >::local();
+		WorkspaceGuard< double > guard(ws);
+		std::vector< double > & w = ws.bufs_[guard.level_];
+		if (w.size() < 2*nv)
+			w.resize(2*nv);
+		double * v = w.data();
+		for (i=0; i<nc; i++)
+			v[i] = const_[i];
+		for (i=0; i<ns; i++)
+			v[nc+i] = load(i);
+		return reverse(v, v+nv, grad);
+	}
+
+	/**
+	 * Debugging: Programm ausgeben.
+	 */
+	void dump(FILE * outf = stdout) const;
+
+private:
+	/**
+	 * Führt Instruktionen auf dem belegten Registersatz aus.
+	 *
+	 * @param c erste Instruktion
+	 * @param e Ende der Instruktionen
+	 * @param res Ergebnisregister
+	 * @param r Registersatz (Konstanten und Slots belegt)
+	 * @return Wert des Ergebnisregisters
+	 */
+	template< typename T > T exec(
+		Instr const * c,
+		Instr const * e,
+		uint32_t res,
+		T * r
+		) const
+	{
+		using std::pow; using std::sqrt; using std::log;
+		using std::log10; using std::exp; using std::sin; using std::cos;
+
+		if (nregs_ == 0)
+			return T(0.);
+
+		for (; c != e; ++c)
+		{
+			T const & L = r[c->a];
+			T const & R = r[c->b];
+			T & D = r[c->dst];
+			switch (ExprType(c->op))
+			{
+			case et_op_add: D = L+R; break;
+			case et_op_sub: D = L-R; break;
+			case et_op_uminus: D = -L; break;
+			case et_op_mul: D = L*R; break;
+			case et_op_div: D = L/R; break;
+			case et_op_pow: D = pow(L,R); break;
+			case et_op_eq: D = T(L == R ? 1. : 0.); break;
+			case et_op_neq: D = T(L != R ? 1. : 0.); break;
+			case et_op_leq: D = T(L <= R ? 1. : 0.); break;
+			case et_op_geq: D = T(L >= R ? 1. : 0.); break;
+			case et_op_lt: D = T(L < R ? 1. : 0.); break;
+			case et_op_gt: D = T(L > R ? 1. : 0.); break;
+			case et_op_abs: D = L < T(0.) ? T(-L) : L; break;
+			case et_op_min: D = L <= R ? L : R; break;
+			case et_op_max: D = L >= R ? L : R; break;
+			case et_op_sqr: D = L*L; break;
+			case et_op_sqrt: D = sqrt(L); break;
+			case et_op_log: D = log(L); break;
+			case et_op_log2: D = log(L)/::log(2.); break;
+			case et_op_log10: D = log10(L); break;
+			case et_op_exp: D = exp(L); break;
+			case et_op_sin: D = sin(L); break;
+			case et_op_cos: D = cos(L); break;
+			default:
+				// diff-Knoten, Literale und Variablen sind Register
+				fASSERT_NONREACHABLE();
+			}
+		}
+		return r[res];
+	}
+
+	/**
+	 * Vorwärts- und Rückwärtslauf über die SSA-Instruktionen.
+	 *
+	 * @param v Werte (Konstanten und Slots belegt; Länge wie adj)
+	 * @param adj Adjungierte (Arbeitsspeicher)
+	 * @param grad Ableitungen nach den Slots (out)
+	 * @return Wert des Ausdrucks
+	 */
+	double reverse(double * v, double * adj, double * grad) const;
+
+	/**
+	 * Thread-lokaler Arbeitsspeicher; ein Puffer je Verschachtelungstiefe.
+	 */
+	template< typename T > struct Workspace
+	{
+		std::vector< std::vector< T > > bufs_;
+		size_t level_;
+
+		Workspace() : level_(0) { }
+
+		static Workspace & local()
+		{
+			static thread_local Workspace ws;
+			return ws;
+		}
+	};
+
+	/**
+	 * Belegt einen Puffer des Arbeitsspeichers für die Dauer eines
+	 * Aufrufs (auch bei Exceptions aus load).
+	 */
+	template< typename T > struct WorkspaceGuard
+	{
+		Workspace< T > & ws_;
+		size_t level_;
+
+		WorkspaceGuard(Workspace< T > & ws) : ws_(ws), level_(ws.level_++)
+		{
+			if (ws_.bufs_.size() <= level_)
+				ws_.bufs_.resize(level_+1);
+		}
+		~WorkspaceGuard() { ws_.level_--; }
+	};
+
+	/** Zustand beim Übersetzen */
+	struct Context;
+
+	/**
+	 * Rekursiver Worker: Sammelt Konstanten, Slots und Knotentypen.
+	 *
+	 * @param E (Unter-)Ausdruck
+	 * @param ctx Übersetzungszustand
+	 */
+	void collect(ExprTree const * E, Context & ctx);
+
+	/**
+	 * Rekursiver Worker: Erzeugt die Instruktionen.
+	 *
+	 * @param E (Unter-)Ausdruck
+	 * @param ctx Übersetzungszustand
+	 * @param vid SSA-Register mit dem Wert von E (out)
+	 * @return Register mit dem Wert von E
+	 */
+	uint32_t emit(ExprTree const * E, Context & ctx, uint32_t & vid);
+
+}; // class ExprProgram
+
+} // namespace flux::symb
+} // namespace flux
+
+#endif
+
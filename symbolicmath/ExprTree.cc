@@ -2,7 +2,13 @@
 #include <list>
 #include <queue>
 #include <cmath>
+#include <algorithm>
 #include <cstdarg>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
 extern "C"
 {
 #include <stdint.h>
@@ -46,7 +52,7 @@ ExprTree::ExprTree(ExprTree const & copy)
 	switch (node_type_)
 	{
 	case et_variable:
-		value_.var_name_ = strdup_alloc(copy.value_.var_name_);
+		value_.var_name_ = copy.value_.var_name_;
 		break;
 	case et_literal:
 		value_.lit_value_ = copy.value_.lit_value_;
@@ -64,17 +70,12 @@ ExprTree::ExprTree(ExprTree const & copy)
 		else
 			value_.childs_.Rval_ = 0;
 	}
-	if (copy.hval_ != 0)
-	{
-		hval_ = new size_t;
-		*hval_ = *(copy.hval_);
-	}
-	else
-		hval_ = 0;
+	hval_valid_ = copy.hval_valid_;
+	hval_ = copy.hval_;
 	mark_ = copy.mark_;
 }
 
-ExprTree::ExprTree(double ltvalue) : hval_(0)
+ExprTree::ExprTree(double ltvalue) : hval_valid_(false), hval_(0)
 {
 	mark_ = 0;
 	if (ltvalue >= 0.)
@@ -93,9 +94,6 @@ ExprTree::ExprTree(double ltvalue) : hval_(0)
 
 ExprTree::~ExprTree()
 {
-	if (hval_ != 0)
-		delete hval_;
-
 	if (isOperator())
 	{
 		if (value_.childs_.Lval_ != 0)
@@ -103,37 +101,162 @@ ExprTree::~ExprTree()
 		if (value_.childs_.Rval_ != 0)
 			delete value_.childs_.Rval_;
 	}
-	else if (isVariable())
-		delete[] value_.var_name_;
 }	
 	
+/*
+ * Internierte Symbolnamen und Arena-Allokation:
+ */
+
+namespace {
+
+/**
+ * Tabelle der internierten Symbolnamen. Die Namen werden nie
+ * freigegeben; die Tabelle selbst wird nie zerstört, damit Knoten in
+ * statischen Objekten auch beim Programmende gültig bleiben.
+ */
+struct SymbolTable
+{
+	std::mutex mtx;
+	charptr_map< bool > names;
+
+	static SymbolTable & get()
+	{
+		static SymbolTable * st = new SymbolTable;
+		return *st;
+	}
+};
+
+/** aktive (innerste) Arena des Threads */
+thread_local ExprTree::Arena * arena_current = 0;
+/** Arena-Allokation ausgesetzt (Arena::Suspend)? */
+thread_local bool arena_suspended = false;
+
+/** Größe des ersten Arena-Blocks; jeder weitere Block ist doppelt so groß */
+size_t const ARENA_BLOCK_MIN = 16*1024;
+/** maximale Größe eines Arena-Blocks */
+size_t const ARENA_BLOCK_MAX = 4*1024*1024;
+
+} // namespace
+
+char const * ExprTree::internSymbol(char const * name)
+{
+	if (name == 0)
+		return 0;
+	SymbolTable & st = SymbolTable::get();
+	std::lock_guard< std::mutex > lock(st.mtx);
+	charptr_map< bool >::iterator i = st.names.find(name);
+	if (i == st.names.end())
+		i = st.names.insert(name, true);
+	return i->key;
+}
+
+ExprTree::Arena::Arena()
+	: prev_(arena_current), prev_suspended_(arena_suspended),
+	  cur_(0), end_(0), nodes_(0)
+{
+	arena_current = this;
+	arena_suspended = false;
+}
+
+ExprTree::Arena::~Arena()
+{
+	// Arenen sind lokale Objekte und daher streng geschachtelt
+	arena_current = prev_;
+	arena_suspended = prev_suspended_;
+	for (size_t k=0; k<blocks_.size(); k++)
+		::operator delete(blocks_[k].first);
+}
+
+void * ExprTree::Arena::allocate(size_t n)
+{
+	size_t const align = alignof(std::max_align_t);
+	n = (n + align - 1) & ~(align - 1);
+	if (size_t(end_ - cur_) < n)
+	{
+		size_t bs = blocks_.empty() ? ARENA_BLOCK_MIN
+			: std::min(2*size_t(blocks_.back().second - blocks_.back().first),
+				ARENA_BLOCK_MAX);
+		if (bs < n)
+			bs = n;
+		cur_ = static_cast< char * >(::operator new(bs));
+		end_ = cur_ + bs;
+		blocks_.push_back(std::make_pair(cur_, end_));
+	}
+	void * p = cur_;
+	cur_ += n;
+	nodes_++;
+	return p;
+}
+
+bool ExprTree::Arena::owns(void const * p) const
+{
+	char const * c = static_cast< char const * >(p);
+	std::less< char const * > lt;
+	// jüngste Blöcke zuerst
+	for (size_t k=blocks_.size(); k>0; k--)
+		if (not lt(c, blocks_[k-1].first) and lt(c, blocks_[k-1].second))
+			return true;
+	return false;
+}
+
+ExprTree * ExprTree::Arena::persist(ExprTree const * E)
+{
+	Suspend s;
+	return E->clone();
+}
+
+ExprTree::Arena::Suspend::Suspend()
+	: prev_(arena_suspended)
+{
+	arena_suspended = true;
+}
+
+ExprTree::Arena::Suspend::~Suspend()
+{
+	arena_suspended = prev_;
+}
+
+// nicht inline: sonst sieht GCC (-Wmismatched-new-delete) in clone()
+// das globale operator new gepaart mit dem Klassen-operator delete
+__attribute__((noinline)) void * ExprTree::operator new(size_t n)
+{
+	if (arena_current and not arena_suspended)
+		return arena_current->allocate(n);
+	return ::operator new(n);
+}
+
+void ExprTree::operator delete(void * p)
+{
+	if (p == 0)
+		return;
+	// Knoten aus einer Arena werden mit der Arena freigegeben
+	for (Arena const * a = arena_current; a; a = a->prev_)
+		if (a->owns(p))
+			return;
+	::operator delete(p);
+}
+
+void ExprTree::operator delete(void * p, size_t)
+{
+	ExprTree::operator delete(p);
+}
+
 ExprTree * ExprTree::replaceBy(ExprTree * & E)
 {
 	fASSERT( E != 0 );
-	if (node_type_ == et_variable)
-		delete[] value_.var_name_;
-	else
+	if (isOperator())
 	{
 		if (value_.childs_.Lval_)
 			delete value_.childs_.Lval_;
 		if (value_.childs_.Rval_)
-			delete value_.childs_.Lval_;
+			delete value_.childs_.Rval_;
 	}
 	value_ = E->value_;
 	mark_ = E->mark_;
-	if (E->hval_)
-	{
-		if (hval_ == 0)
-			hval_ = new size_t;
-		*hval_ = *(E->hval_);
-	}
-	else if (hval_)
-	{
-		delete hval_;
-		hval_ = 0;
-	}
+	hval_valid_ = E->hval_valid_;
+	hval_ = E->hval_;
 	node_type_ = E->node_type_;
-	// beim delete das Löschen des Variablennamens verhindern
+	// beim delete das Löschen der Nachfolger verhindern
 	// und Variablen zu Literalen machen
 	if (node_type_ == et_variable)
 		E->node_type_ = et_literal;
@@ -162,7 +285,8 @@ bool ExprTree::operator== (ExprTree const & E) const
 	case et_literal:
 		return value_.lit_value_ == E.value_.lit_value_;
 	case et_variable:
-		return strcmp(value_.var_name_, E.value_.var_name_) == 0;
+		// internierte Namen: gleicher Name <=> gleicher Zeiger
+		return value_.var_name_ == E.value_.var_name_;
 	default:
 		// rekursiver Vergleich
 		if (not (*(value_.childs_.Lval_) == *(E.value_.childs_.Lval_)))
@@ -1041,7 +1165,7 @@ cMD_abort_loop:
 				delete l;
 				break;
 			case et_variable:
-				value_.var_name_ = strdup_alloc(l->value_.var_name_);
+				value_.var_name_ = l->value_.var_name_;
 				delete l;
 				break;
 			default: // Operator
@@ -1415,7 +1539,7 @@ cAS_abort_loop:
 				delete l;
 				break;
 			case et_variable:
-				value_.var_name_ = strdup_alloc(l->value_.var_name_);
+				value_.var_name_ = l->value_.var_name_;
 				delete l;
 				break;
 			default:
@@ -1724,7 +1848,7 @@ ExprTree * ExprTree::evalNode(
 			// Kopiere rval nach this
 			new_node_type_ = rval->node_type_;
 			if (rval->node_type_ == et_variable)
-				value_.var_name_ = strdup_alloc(rval->value_.var_name_);
+				value_.var_name_ = rval->value_.var_name_;
 			else
 			{
 				// tiefe Kopie der union
@@ -1756,7 +1880,7 @@ ExprTree * ExprTree::evalNode(
 			{
 				new_node_type_ = lval->node_type_;
 				if (lval->node_type_ == et_variable)
-					value_.var_name_ = strdup_alloc(lval->value_.var_name_);
+					value_.var_name_ = lval->value_.var_name_;
 				else
 				{
 					// s.o.
@@ -1865,7 +1989,7 @@ ExprTree * ExprTree::evalNode(
 			// Kopiere rval nach this
 			new_node_type_ = rval->node_type_;
 			if (rval->node_type_ == et_variable)
-				value_.var_name_ = strdup_alloc(rval->value_.var_name_);
+				value_.var_name_ = rval->value_.var_name_;
 			else
 			{
 				// tiefe Kopie der union
@@ -1889,7 +2013,7 @@ ExprTree * ExprTree::evalNode(
 			{
 				new_node_type_ = lval->node_type_;
 				if (lval->node_type_ == et_variable)
-					value_.var_name_ = strdup_alloc(lval->value_.var_name_);
+					value_.var_name_ = lval->value_.var_name_;
 				else
 				{
 					// s.o.
@@ -1925,7 +2049,7 @@ ExprTree * ExprTree::evalNode(
 				// Kopiere lval nach this
 				new_node_type_ = lval->node_type_;
 				if (lval->node_type_ == et_variable)
-					value_.var_name_ = strdup_alloc(lval->value_.var_name_);
+					value_.var_name_ = lval->value_.var_name_;
 				else
 				{
 					// tiefe Kopie der union
@@ -2019,7 +2143,7 @@ ExprTree * ExprTree::evalNode(
 		}
 		else
 		{
-			value_.var_name_ = strdup_alloc(L->getVarName());
+			value_.var_name_ = L->getVarName();
 			node_type_ = et_variable;
 		}
 		if (deleteChilds) { delete L; delete R; }
@@ -2078,7 +2202,7 @@ void ExprTree::eval(
 				delete Rval();
 				node_type_ = dlval_dv->node_type_;
 				if (node_type_ == et_variable)
-					value_.var_name_ = strdup_alloc(dlval_dv->value_.var_name_);
+					value_.var_name_ = dlval_dv->value_.var_name_;
 				else
 					value_ = dlval_dv->value_;
 				// Löschung der übernommenen Childs verhindern:
@@ -2459,11 +2583,10 @@ void ExprTree::subst_descent(char const * var, ExprTree * const & newE)
 	}
 	else if (isVariable() and strcmp(var,value_.var_name_)==0)
 	{
-		delete[] value_.var_name_;
 		node_type_ = newE->node_type_;
 		
 		if (newE->isVariable())
-			value_.var_name_ = strdup_alloc(newE->value_.var_name_);
+			value_.var_name_ = newE->value_.var_name_;
 		else
 			value_ = newE->value_;
 
@@ -2531,6 +2654,8 @@ void ExprTree::getVarNames_descent(charptr_array & vn) const
 
 size_t ExprTree::semanticHashValue() const
 {
+	// die Kopie und alle Zwischenergebnisse von eval liegen in der Arena
+	Arena arena;
 	ExprTree * copy = clone(this);
 	// Partial Evaluation => Ausgewertete "Normalform"
 	//   => Semantischer-Hash-Wert
@@ -2542,9 +2667,8 @@ size_t ExprTree::semanticHashValue() const
 
 size_t ExprTree::rebuildHashValue() const
 {
-	if (hval_ == 0)
-		hval_ = new size_t;
-	*hval_ = 0;
+	hval_valid_ = true;
+	hval_ = 0;
 
 	if (isOperator())
 	{
@@ -2560,13 +2684,13 @@ size_t ExprTree::rebuildHashValue() const
 
 		for (i=0; i<SIZEOF_SIZE_T; i++)
 		{
-			*hval_ += (lhval.b[i]<<4) + (lhval.b[i]>>4);
-			*hval_ *= 11;
+			hval_ += (lhval.b[i]<<4) + (lhval.b[i]>>4);
+			hval_ *= 11;
 		}
 		for (i=0; i<SIZEOF_SIZE_T; i++)
 		{
-			*hval_ += (rhval.b[i]<<4) + (rhval.b[i]>>4);
-			*hval_ *= 11;
+			hval_ += (rhval.b[i]<<4) + (rhval.b[i]>>4);
+			hval_ *= 11;
 		}
 	}
 	else
@@ -2577,36 +2701,36 @@ size_t ExprTree::rebuildHashValue() const
 			char c;
 			union {	double d; char b[8]; } lv;
 			lv.d = value_.lit_value_;
-			*hval_ = 0xE8CED3A;
+			hval_ = 0xE8CED3A;
 			for (i=0; i<8; i++)
 			{
 				c = lv.b[i];
-				*hval_ += (c<<4) + (c>>4);
-				*hval_ *= 11;
+				hval_ += (c<<4) + (c>>4);
+				hval_ *= 11;
 			}
 		}
 		else
 		{
 			fASSERT( isVariable() );
 			char const *c = value_.var_name_;
-			*hval_ = 0xE8CED3A;
+			hval_ = 0xE8CED3A;
 			while (*c != '\0')
 			{
-				*hval_ += ((*c)<<4) + ((*c)>>4);
-				*hval_ *= 11;
+				hval_ += ((*c)<<4) + ((*c)>>4);
+				hval_ *= 11;
 				c++;
 			}
 		}
 	}
-	return *hval_;
+	return hval_;
 }
 
 size_t ExprTree::hashValue() const
 {
 	// wenn der Hash-Wert schon berechnet wurde, dann wird er einfach
 	// zurückgegeben:
-	if (hval_ != 0)
-		return *hval_;
+	if (hval_valid_)
+		return hval_;
 
 	// Hash-Wert neu berechnen
 	return rebuildHashValue();
@@ -2621,7 +2745,7 @@ void ExprTree::clearAllHashValues()
 
 void ExprTree::clearHashValue()
 {
-	if (hval_) { delete hval_; hval_ = 0; }
+	hval_valid_ = false;
 }
 
 ExprTree * ExprTree::solve0() const
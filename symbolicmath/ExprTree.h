@@ -4,6 +4,8 @@
 #include <string>
 #include <iostream>
 #include <functional>
+#include <utility>
+#include <vector>
 #include <cstdarg>
 extern "C"
 {
@@ -97,8 +99,10 @@ private:
 	ExprType node_type_;
 	/** Markierung des Knotens (wird z.B. f.d. Compiler benötigt) */
 	int8_t mark_;
+	/** true, falls hval_ gültig ist */
+	mutable bool hval_valid_;
 	/** Hash-Wert des Unterbaums (wird rekursiv berechnet) */
-	mutable size_t * hval_;
+	mutable size_t hval_;
 private:
 	/** Wert des Knotens -- je nach Knotentyp <tt>node_type_</tt> */
 	union
@@ -107,15 +111,15 @@ private:
 		struct { ExprTree * Lval_, * Rval_; } childs_;
 		/** Literalwert */
 		double lit_value_;
-		/** Variablenname */
+		/** Variablenname (interniert, siehe internSymbol) */
 		char const * var_name_;
 	} value_;
 
 public:
     inline ExprTree()
-    : node_type_(et_variable), mark_(0), hval_(0)
+    : node_type_(et_variable), mark_(0), hval_valid_(false), hval_(0)
     {
-        value_.var_name_ = strdup_alloc("");
+        value_.var_name_ = internSymbol("");
         hashValue();
     }
 
@@ -133,7 +137,7 @@ public:
 		fASSERT( isOperator() );
 		value_.childs_.Lval_ = lval;
 		value_.childs_.Rval_ = rval;
-		hval_ = 0;
+		hval_valid_ = false;
 		hashValue();
 	}
 	
@@ -152,9 +156,6 @@ public:
 		if (this != &rhs)
 		{
 			//destroy old objects
-			if (hval_ != 0)
-				delete hval_;
-
 			if (isOperator())
 			{
 				if (value_.childs_.Lval_ != 0)
@@ -162,14 +163,12 @@ public:
 				if (value_.childs_.Rval_ != 0)
 					delete value_.childs_.Rval_;
 			}
-			else if (isVariable())
-				delete[] value_.var_name_;
 			// copy new ones
 			node_type_ = rhs.node_type_;
 			switch (node_type_)
 			{
 			case et_variable:
-				value_.var_name_ = strdup_alloc(rhs.value_.var_name_);
+				value_.var_name_ = rhs.value_.var_name_;
 				break;
 			case et_literal:
 				value_.lit_value_ = rhs.value_.lit_value_;
@@ -187,13 +186,8 @@ public:
 				else
 					value_.childs_.Rval_ = 0;
 			}
-			if (rhs.hval_ != 0)
-			{
-				hval_ = new size_t;
-				*hval_ = *(rhs.hval_);
-			}
-			else
-				hval_ = 0;
+			hval_valid_ = rhs.hval_valid_;
+			hval_ = rhs.hval_;
 			mark_ = rhs.mark_;
 		}
 		return *this;
@@ -205,9 +199,9 @@ public:
 	 * @param vname Symbolname
 	 */
 	inline ExprTree(char const * vname)
-		: node_type_(et_variable), mark_(0), hval_(0)
+		: node_type_(et_variable), mark_(0), hval_valid_(false), hval_(0)
 	{
-		value_.var_name_ = strdup_alloc(vname);
+		value_.var_name_ = internSymbol(vname);
 		hashValue();
 	}
 
@@ -217,9 +211,9 @@ public:
 	 * @param vname Symbolname
 	 */
 	inline ExprTree(std::string const & vname)
-		: node_type_(et_variable), mark_(0), hval_(0)
+		: node_type_(et_variable), mark_(0), hval_valid_(false), hval_(0)
 	{
-		value_.var_name_ = strdup_alloc(vname.c_str());
+		value_.var_name_ = internSymbol(vname.c_str());
 		hashValue();
 	}
 
@@ -236,6 +230,133 @@ public:
 	 * löscht linken und rechten Unterbaum.
 	 */
 	~ExprTree();
+
+	/**
+	 * Arena für ExprTree-Knoten. Solange ein Arena-Objekt im aktuellen
+	 * Thread existiert, werden neue Knoten nicht einzeln vom Heap,
+	 * sondern aus großen Blöcken der Arena angelegt; delete auf solche
+	 * Knoten ruft nur den Destructor auf. Der Destructor der Arena gibt
+	 * alle Blöcke en bloc frei -- auch Knoten, die nie gelöscht wurden.
+	 * Das ist zulässig, da ein Knoten außer seinen Nachfolgern keinen
+	 * Speicher besitzt (Hash-Wert im Knoten, Variablennamen interniert).
+	 *
+	 * Arenen sind thread-lokal und werden geschachtelt (LIFO). Knoten
+	 * einer Arena dürfen die Arena nicht überleben und nicht in
+	 * Ausdrücke vom Heap eingehängt werden; Ergebnisse, die bleiben
+	 * sollen, werden mit persist() auf den Heap kopiert bzw. im
+	 * Gültigkeitsbereich eines Suspend-Objekts angelegt.
+	 */
+	class Arena
+	{
+	private:
+		/** umgebende Arena (oder 0) */
+		Arena * prev_;
+		/** Zustand von Suspend beim Betreten */
+		bool prev_suspended_;
+		/** Blöcke (Anfang, Ende) */
+		std::vector< std::pair< char *,char * > > blocks_;
+		/** nächste freie Position im aktuellen Block */
+		char * cur_;
+		/** Ende des aktuellen Blocks */
+		char * end_;
+		/** Anzahl angelegter Knoten */
+		size_t nodes_;
+
+	public:
+		/**
+		 * Constructor. Aktiviert die Arena im aktuellen Thread.
+		 */
+		Arena();
+
+		/**
+		 * Destructor. Deaktiviert die Arena und gibt alle Blöcke frei.
+		 */
+		~Arena();
+
+		/**
+		 * Reserviert Speicher aus der Arena.
+		 *
+		 * @param n Anzahl Bytes
+		 * @return Zeiger auf den Speicher
+		 */
+		void * allocate(size_t n);
+
+		/**
+		 * Prüft, ob ein Zeiger in einen Block der Arena zeigt.
+		 *
+		 * @param p Zeiger
+		 * @return true, falls p aus der Arena stammt
+		 */
+		bool owns(void const * p) const;
+
+		/** @return Anzahl der Blöcke */
+		inline size_t blocks() const { return blocks_.size(); }
+
+		/** @return Anzahl der angelegten Knoten */
+		inline size_t nodes() const { return nodes_; }
+
+		/**
+		 * Kopiert einen Ausdruck auf den Heap (vorbei an allen Arenen).
+		 *
+		 * @param E Ausdruck
+		 * @return Kopie auf dem Heap
+		 */
+		static ExprTree * persist(ExprTree const * E);
+
+		/**
+		 * Setzt die Arena-Allokation im aktuellen Thread für die
+		 * Lebensdauer des Objekts aus (neue Knoten kommen vom Heap).
+		 */
+		class Suspend
+		{
+		private:
+			bool prev_;
+		public:
+			Suspend();
+			~Suspend();
+		};
+
+	private:
+		friend class ExprTree;
+		/** nicht kopierbar */
+		Arena(Arena const &);
+		Arena & operator=(Arena const &);
+
+	}; // class Arena
+
+	/**
+	 * Allokation eines Knotens (aus der aktiven Arena oder vom Heap).
+	 *
+	 * @param n Größe des Objekts
+	 * @return Speicher für den Knoten
+	 */
+	static void * operator new(size_t n);
+
+	/**
+	 * Freigabe eines Knotens (in einer Arena: keine Operation).
+	 *
+	 * @param p Zeiger auf den Knoten
+	 */
+	static void operator delete(void * p);
+
+	/**
+	 * Freigabe eines Knotens mit Größenangabe; wie operator delete(p).
+	 *
+	 * @param p Zeiger auf den Knoten
+	 * @param n Größe des Objekts
+	 */
+	static void operator delete(void * p, size_t n);
+
+	/**
+	 * Interniert einen Symbolnamen. Jeder Name wird genau einmal (für
+	 * die Lebensdauer des Prozesses) gespeichert; gleiche Namen liefern
+	 * denselben Zeiger, der damit auch als Symbol-ID dient.
+	 * Thread-sicher.
+	 *
+	 * @param name Symbolname
+	 * @return internierter Symbolname
+	 */
+	static char const * internSymbol(char const * name);
 	
 public:
 	/**
@@ -434,8 +555,7 @@ public:
 	inline void setVarName(char const * vn)
 	{
 		fASSERT( isVariable() );
-		delete[] value_.var_name_;
-		value_.var_name_ = strdup_alloc(vn);
+		value_.var_name_ = internSymbol(vn);
 	}
 
 	/**
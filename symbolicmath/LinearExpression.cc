@@ -48,7 +48,10 @@ bool LinearExpression::normalizeSigns()
 	return neg > pos; // wurde geflippt? -> Operator flippen
 }
 
-void LinearExpression::rebuildExpression(bool flip_comp_op)
+void LinearExpression::rebuildExpression(
+	ExprType comp_op,
+	bool flip_comp_op
+	)
 {
 	charptr_array vnames = C_.getKeys();
 	charptr_array::const_iterator vni;
@@ -129,7 +132,7 @@ void LinearExpression::rebuildExpression(bool flip_comp_op)
 	// geflippt werden?
 	if (flip_comp_op)
 	{
-		switch (Eq_->getNodeType())
+		switch (comp_op)
 		{
 		case et_op_eq:
 			newEq = ExprTree::eq(sop,Eq_const);
@@ -158,7 +161,7 @@ void LinearExpression::rebuildExpression(bool flip_comp_op)
 	{
 		if (sop == 0)
 			sop = ExprTree::val(0);
-		newEq = new ExprTree(Eq_->getNodeType(),sop,Eq_const);
+		newEq = new ExprTree(comp_op,sop,Eq_const);
 	}
 	delete Eq_;
 	Eq_ = newEq;
@@ -313,28 +316,37 @@ void LinearExpression::extractLinearCoeffs(
 }
 
 LinearExpression::LinearExpression(ExprTree const * E)
+	: Eq_(0)
 {
+	ExprType comp_op;
+	{
+	// Zwischenergebnisse von simplify() liegen in einer Arena; der
+	// Ausdruck wird unten aus den Koeffizienten neu aufgebaut
+	ExprTree::Arena arena;
+	ExprTree * W;
 	if (not (E->isEquality() or E->isInEquality()))
 	{
 		// keine Gleichung; expandieren und vereinfachen:
-		Eq_ = E->clone();
-		Eq_->simplify();
+		W = E->clone();
+		W->simplify();
 		is_solvable_ = false;
 	}
 	else
 	{
 		// Gleichung nach 0 auflösen, expandieren und
 		// vereinfachen ...
-		Eq_ = E->solve0();
+		W = E->solve0();
 		is_solvable_ = true;
 	}
+	comp_op = W->getNodeType();
 	
 	// wirft NonLinearExpressionException, falls es sich nicht
 	// um eine lineare Gleichung / linearen Ausdruck handelt:
 	if (is_solvable_)
-		extractLinearCoeffs(Eq_->Lval());
+		extractLinearCoeffs(W->Lval());
 	else
-		extractLinearCoeffs(Eq_);
+		extractLinearCoeffs(W);
+	}
 
 	// Falls es sonst keine Literale gibt, gibt es zumindest
 	// die 0:
@@ -343,7 +355,7 @@ LinearExpression::LinearExpression(ExprTree const * E)
 	// Vorzeichen der Koeffizienten normalisieren
 	// den Ausdruck neu aufbauen
 	bool signs_flipped = normalizeSigns();
-	rebuildExpression(signs_flipped);
+	rebuildExpression(comp_op,signs_flipped);
 	// korrekte Vorzeichen der Koeffizienten wiederherstellen
 	if (signs_flipped)
 		flipSigns();
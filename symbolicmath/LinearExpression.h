@@ -45,8 +45,11 @@ private:
 	 * ist ein Ausdruck der Form:
 	 *
 	 *  c1*v1+...+cn*vn = const.
+	 *
+	 * @param comp_op Vergleichsoperator (bei (Un-)Gleichungen)
+	 * @param flip_comp_op Vergleichsoperator umkehren
 	 */
-	void rebuildExpression(bool flip_comp_op);
+	void rebuildExpression(ExprType comp_op, bool flip_comp_op);
 
 	/**
 	 * Funktion zum Extrahieren von Koeffizienten aus linearen